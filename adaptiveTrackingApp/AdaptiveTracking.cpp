@@ -13,7 +13,6 @@
 #include "imageio/BobotLandmarkSource.hpp"
 #include "imageio/SingleLandmarkSource.hpp"
 #include "imageio/EmptyLandmarkSource.hpp"
-#include "imageio/CameraImageSource.hpp"
 #include "imageio/VideoImageSource.hpp"
 #include "imageio/KinectImageSource.hpp"
 #include "imageio/DirectoryImageSource.hpp"
@@ -41,6 +40,8 @@
 #include "imageprocessing/ExtendedHogFilter.hpp"
 #include "imageprocessing/IntegralGradientFilter.hpp"
 #include "imageprocessing/GradientSumFilter.hpp"
+#include "imageprocessing/IntegralGradientChannelFilter.hpp"
+#include "imageprocessing/IntegralGradientSumFilter.hpp"
 #include "imageprocessing/ImagePyramid.hpp"
 #include "imageprocessing/DirectImageFeatureExtractor.hpp"
 #include "imageprocessing/FilteringFeatureExtractor.hpp"
@@ -104,8 +105,9 @@ namespace po = boost::program_options;
 const string AdaptiveTracking::videoWindowName = "Image";
 const string AdaptiveTracking::controlWindowName = "Controls";
 
-AdaptiveTracking::AdaptiveTracking(unique_ptr<LabeledImageSource> imageSource, unique_ptr<ImageSink> imageSink, ptree& config) :
-		imageSource(move(imageSource)), imageSink(move(imageSink)) {
+AdaptiveTracking::AdaptiveTracking(unique_ptr<LabeledImageSource> imageSource, unique_ptr<ImageSink> imageSink, ptree& config,
+		shared_ptr<LiveCameraImageSource> liveImageSource) :
+		imageSource(move(imageSource)), imageSink(move(imageSink)), liveImageSource(liveImageSource) {
 	initTracking(config);
 	initGui();
 }
@@ -219,6 +221,14 @@ shared_ptr<FeatureExtractor> AdaptiveTracking::createFeatureExtractor(
 		featureExtractor->addPatchFilter(make_shared<GradientSumFilter>(config.get<int>("cellCount")));
 		featureExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
 		return wrapFeatureExtractor(make_shared<IntegralFeatureExtractor>(featureExtractor), scaleFactor);
+	} else if (config.get_value<string>() == "psurf") { // not interchangeable with surf (dense layer gradients instead of box gradients)
+		pyramidExtractor = createPyramidExtractor(config.get_child("pyramid"), pyramid, true);
+		pyramidExtractor->setPatchSize(pyramidExtractor->getPatchWidth() + 1, pyramidExtractor->getPatchHeight() + 1);
+		pyramidExtractor->addLayerFilter(make_shared<GradientFilter>(config.get<int>("gradientKernel"), config.get<int>("blurKernel")));
+		pyramidExtractor->addLayerFilter(make_shared<IntegralGradientChannelFilter>());
+		pyramidExtractor->addPatchFilter(make_shared<IntegralGradientSumFilter>(config.get<int>("cellCount")));
+		pyramidExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
+		return wrapFeatureExtractor(make_shared<IntegralFeatureExtractor>(pyramidExtractor), scaleFactor);
 	} else if (config.get_value<string>() == "lbp") {
 		pyramidExtractor = createPyramidExtractor(config.get_child("pyramid"), pyramid, true);
 		shared_ptr<LbpFilter> lbpFilter = createLbpFilter(config.get<string>("type"));
@@ -372,6 +382,9 @@ shared_ptr<TrainableProbabilisticClassifier> AdaptiveTracking::createTrainablePr
 		optional<ptree&> thresholdConfig = config.get_child_optional("threshold");
 		if (thresholdConfig)
 			svm->setThreshold(thresholdConfig->get_value<float>());
+		optional<ptree&> compiledConfig = config.get_child_optional("compiled");
+		if (compiledConfig)
+			trainableSvm->setCompiled(true, compiledConfig->get_value<size_t>());
 		return createTrainableProbabilisticSvm(trainableSvm, config.get_child("probabilistic"));
 	} else if (config.get_value<string>() == "libLinear") {
 		shared_ptr<TrainableSvmClassifier> trainableSvm = createLibLinearClassifier(config.get_child("training"));
@@ -914,6 +927,7 @@ void AdaptiveTracking::run() {
 			} else {
 				frames++;
 				frame = imageSource->getImage();
+				updateTimeStep();
 				LandmarkCollection landmarkCollection = imageSource->getLandmarks();
 				shared_ptr<Landmark> landmark;
 				if (!landmarkCollection.isEmpty())
@@ -971,6 +985,8 @@ void AdaptiveTracking::run() {
 				text.precision(2);
 				text << frames << " frame: " << iterationTime.count() << " ms (" << iterationFps << " fps);"
 						<< " condensation: " << condensationTime.count() << " ms (" << condensationFps << " fps)";
+				if (liveImageSource)
+					text << "; dropped: " << liveImageSource->getDroppedFrameCount();
 				log.info(text.str());
 
 				int delay = paused ? 0 : 5;
@@ -995,6 +1011,20 @@ void AdaptiveTracking::stop() {
 	running = false;
 }
 
+void AdaptiveTracking::updateTimeStep() {
+	if (!liveImageSource)
+		return;
+	double frameInterval = liveImageSource->getFrameInterval();
+	if (frameInterval <= 0) // first frame
+		return;
+	double frameRate = liveImageSource->getFrameRate() > 0 ? liveImageSource->getFrameRate() : 30;
+	double timeStep = frameInterval * frameRate;
+	if (opticalFlowTransitionModel)
+		opticalFlowTransitionModel->setTimeStep(timeStep);
+	else
+		simpleTransitionModel->setTimeStep(timeStep);
+}
+
 int main(int argc, char *argv[]) {
 	int verboseLevelText;
 	int verboseLevelImages;
@@ -1066,9 +1096,11 @@ int main(int argc, char *argv[]) {
 	Loggers->getLogger("app").addAppender(make_shared<ConsoleAppender>(LogLevel::Info));
 
 	shared_ptr<ImageSource> imageSource;
-	if (useCamera)
-		imageSource.reset(new CameraImageSource(deviceId));
-	else if (useKinect)
+	shared_ptr<LiveCameraImageSource> liveImageSource;
+	if (useCamera) {
+		liveImageSource.reset(new LiveCameraImageSource(deviceId));
+		imageSource = liveImageSource;
+	} else if (useKinect)
 		imageSource.reset(new KinectImageSource(kinectId));
 	else if (useFile)
 		imageSource.reset(new VideoImageSource(filename));
@@ -1097,7 +1129,7 @@ int main(int argc, char *argv[]) {
 	if (useGroundTruth)
 		config.put("tracking.initial", "groundtruth");
 	try {
-		unique_ptr<AdaptiveTracking> tracker(new AdaptiveTracking(move(labeledImageSource), move(imageSink), config.get_child("tracking")));
+		unique_ptr<AdaptiveTracking> tracker(new AdaptiveTracking(move(labeledImageSource), move(imageSink), config.get_child("tracking"), liveImageSource));
 		tracker->run();
 	} catch (std::exception& exc) {
 		Loggers->getLogger("app").error(string("A wild exception appeared: ") + exc.what());
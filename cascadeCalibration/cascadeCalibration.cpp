@@ -0,0 +1,307 @@
+/*
+ * cascadeCalibration.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <functional>
+#include <thread>
+#include <algorithm>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "imageio/DirectoryImageSource.hpp"
+#include "imageprocessing/GrayscaleFilter.hpp"
+#include "imageprocessing/ResizingFilter.hpp"
+#include "imageprocessing/HistEq64Filter.hpp"
+#include "imageprocessing/ConversionFilter.hpp"
+#include "imageprocessing/ChainedFilter.hpp"
+#include "classification/CascadeCalibration.hpp"
+#include "classification/WvmClassifier.hpp"
+#include "classification/RvmClassifier.hpp"
+#include "classification/ProbabilisticWvmClassifier.hpp"
+#include "classification/ProbabilisticRvmClassifier.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+using namespace classification;
+using namespace imageprocessing;
+namespace po = boost::program_options;
+using imageio::DirectoryImageSource;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::pair;
+using std::function;
+using std::shared_ptr;
+using std::make_shared;
+using boost::filesystem::path;
+using boost::lexical_cast;
+using cv::Mat;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+
+/**
+ * Cascaded classifier loaded by this app, accessed through the functions that the calibration needs.
+ */
+struct Cascade {
+	function<vector<double>(const Mat&)> computeDistances; ///< Computes the hyperplane distances of all stages.
+	function<vector<float>()> getThresholds; ///< Returns the current stage thresholds.
+	function<void(const vector<float>&)> setThresholds; ///< Changes the stage thresholds.
+	function<void(const string&)> save; ///< Stores the classifier in the binary format.
+};
+
+template<class T>
+void bindThresholds(Cascade& cascade, shared_ptr<T> vm) {
+	cascade.computeDistances = [vm](const Mat& patch) { return vm->computeHyperplaneDistances(patch); };
+	cascade.getThresholds = [vm]() { return vm->getHierarchicalThresholds(); };
+	cascade.setThresholds = [vm](const vector<float>& thresholds) { vm->setHierarchicalThresholds(thresholds); };
+}
+
+Cascade loadCascade(const string& type, const path& classifierFile, const path& thresholdsFile) {
+	bool binary = classifierFile.extension() == ".bin";
+	Cascade cascade;
+	if (type == "wvm") {
+		shared_ptr<WvmClassifier> wvm = binary ? WvmClassifier::loadFromBinary(classifierFile.string())
+				: WvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string());
+		bindThresholds(cascade, wvm);
+		cascade.save = [wvm](const string& filename) { wvm->saveToBinary(filename); };
+	} else if (type == "pwvm") {
+		shared_ptr<ProbabilisticWvmClassifier> pwvm = binary ? ProbabilisticWvmClassifier::loadFromBinary(classifierFile.string())
+				: ProbabilisticWvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string());
+		bindThresholds(cascade, pwvm->getWvm());
+		cascade.save = [pwvm](const string& filename) { pwvm->saveToBinary(filename); };
+	} else if (type == "rvm") {
+		shared_ptr<RvmClassifier> rvm = binary ? RvmClassifier::loadFromBinary(classifierFile.string())
+				: RvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string());
+		bindThresholds(cascade, rvm);
+		cascade.save = [rvm](const string& filename) { rvm->saveToBinary(filename); };
+	} else if (type == "prvm") {
+		shared_ptr<ProbabilisticRvmClassifier> prvm;
+		if (binary) {
+			prvm = ProbabilisticRvmClassifier::loadFromBinary(classifierFile.string());
+		} else {
+			pair<double, double> logisticParams = ProbabilisticRvmClassifier::loadSigmoidParamsFromMatlab(thresholdsFile.string());
+			shared_ptr<RvmClassifier> rvm = RvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string());
+			prvm = make_shared<ProbabilisticRvmClassifier>(rvm, logisticParams.first, logisticParams.second);
+		}
+		bindThresholds(cascade, prvm->getRvm());
+		cascade.save = [prvm](const string& filename) { prvm->saveToBinary(filename); };
+	} else {
+		throw std::invalid_argument("Unknown classifier type: " + type);
+	}
+	return cascade;
+}
+
+vector<Mat> loadPatches(const path& directory, const ImageFilter& filter) {
+	vector<Mat> patches;
+	DirectoryImageSource source(directory.string());
+	while (source.next())
+		patches.push_back(filter.applyTo(source.getImage()));
+	return patches;
+}
+
+/**
+ * Computes the hyperplane distances of all patches at every stage, distributing the patches over all cores.
+ */
+vector<vector<double>> computeDistances(const Cascade& cascade, const vector<Mat>& patches) {
+	vector<vector<double>> distances(patches.size());
+	size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+	vector<std::thread> threads;
+	for (size_t t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&, t]() {
+			for (size_t i = t; i < patches.size(); i += threadCount)
+				distances[i] = cascade.computeDistances(patches[i]);
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+	return distances;
+}
+
+string toString(const CascadeCalibration::OperatingPoint& point, size_t stageCount) {
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision(4) << "recall " << point.recall << ", false positive rate " << point.falsePositiveRate
+			<< ", evaluated filters per negative " << std::setprecision(2) << point.averageFilterCount
+			<< " (speedup " << stageCount / std::max(point.averageFilterCount, 1.0) << "x over evaluating all " << stageCount << ")";
+	return stream.str();
+}
+
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	string classifierType;
+	path classifierFile;
+	path thresholdsFile;
+	path positivesDirectory;
+	path negativesDirectory;
+	path outputFile;
+	string feature;
+	bool floatPatches;
+	int patchWidth;
+	int patchHeight;
+	double targetRecall;
+	double targetFilterCount;
+	float thresholdOffset;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO","show messages with INFO loglevel or below."),
+				  "specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("type,t", po::value<string>(&classifierType)->required(),
+				"type of the cascade: wvm, pwvm, rvm or prvm")
+			("classifier,c", po::value<path>(&classifierFile)->required(),
+				"classifier file (.mat or .bin)")
+			("thresholds,s", po::value<path>(&thresholdsFile)->default_value(path()),
+				"thresholds file (.mat), only needed for Matlab classifiers")
+			("positives,p", po::value<path>(&positivesDirectory)->required(),
+				"directory containing the positive patches")
+			("negatives,n", po::value<path>(&negativesDirectory)->required(),
+				"directory containing the negative patches")
+			("feature,f", po::value<string>(&feature)->default_value("hq64"),
+				"feature space of the classifier: gray or hq64")
+			("float-patches", po::value<bool>(&floatPatches)->implicit_value(true)->default_value(false),
+				"convert the patches to CV_32F with values between 0 and 1")
+			("patch-width", po::value<int>(&patchWidth)->default_value(20),
+				"width the patches are resized to")
+			("patch-height", po::value<int>(&patchHeight)->default_value(20),
+				"height the patches are resized to")
+			("recall,r", po::value<double>(&targetRecall),
+				"target recall, the calibrated thresholds keep this fraction of the positive patches")
+			("filters", po::value<double>(&targetFilterCount),
+				"target average number of evaluated filters per negative patch (used if no recall is given)")
+			("offset", po::value<float>(&thresholdOffset)->default_value(0.0f),
+				"offset that is added to the stored thresholds when deploying a WVM (the value of 'threshold' in the pwvm config)")
+			("output,o", po::value<path>(&outputFile),
+				"output file (.bin) for the classifier with calibrated thresholds")
+		;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: cascadeCalibration [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+		if (!vm.count("recall") && !vm.count("filters"))
+			targetRecall = -1; // only report the curve
+		else if (!vm.count("recall"))
+			targetRecall = -2; // calibrate for filter count
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid log level." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	Loggers->getLogger("classification").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("cascadeCalibration").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("cascadeCalibration");
+
+	boost::algorithm::to_lower(classifierType);
+	if (thresholdOffset != 0 && classifierType != "wvm" && classifierType != "pwvm") {
+		appLogger.error("A threshold offset is only added to the thresholds of WVMs.");
+		return EXIT_FAILURE;
+	}
+	Cascade cascade;
+	try {
+		cascade = loadCascade(classifierType, classifierFile, thresholdsFile);
+	} catch (const std::exception& error) {
+		appLogger.error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	ChainedFilter patchFilter;
+	patchFilter.add(make_shared<GrayscaleFilter>());
+	patchFilter.add(make_shared<ResizingFilter>(cv::Size(patchWidth, patchHeight)));
+	if (boost::iequals(feature, "hq64")) {
+		patchFilter.add(make_shared<HistEq64Filter>());
+	} else if (!boost::iequals(feature, "gray")) {
+		appLogger.error("Unknown feature space: " + feature);
+		return EXIT_FAILURE;
+	}
+	if (floatPatches)
+		patchFilter.add(make_shared<ConversionFilter>(CV_32F, 1.0 / 255.0));
+
+	vector<Mat> positives = loadPatches(positivesDirectory, patchFilter);
+	vector<Mat> negatives = loadPatches(negativesDirectory, patchFilter);
+	appLogger.info("Loaded " + lexical_cast<string>(positives.size()) + " positive and " + lexical_cast<string>(negatives.size()) + " negative patches.");
+	if (positives.empty()) {
+		appLogger.error("There are no positive patches.");
+		return EXIT_FAILURE;
+	}
+
+	appLogger.info("Computing the hyperplane distances of all stages using " + lexical_cast<string>(std::max(1u, std::thread::hardware_concurrency())) + " threads...");
+	CascadeCalibration calibration(computeDistances(cascade, positives), computeDistances(cascade, negatives));
+	size_t stageCount = calibration.getStageCount();
+
+	// the calibration works on the raw hyperplane distances, so it needs the effective thresholds that include the
+	// offset of the deployment, while the classifier stores the thresholds without it
+	appLogger.info("Threshold offset of the deployment: " + lexical_cast<string>(thresholdOffset));
+	vector<float> originalThresholds = cascade.getThresholds();
+	originalThresholds.resize(stageCount);
+	for (float& threshold : originalThresholds)
+		threshold += thresholdOffset;
+	appLogger.info("Original thresholds: " + toString(calibration.evaluate(originalThresholds), stageCount));
+
+	appLogger.info("Expected speed/recall curve:");
+	const double recalls[] = { 0.8, 0.85, 0.9, 0.925, 0.95, 0.96, 0.97, 0.98, 0.99, 0.995, 1.0 };
+	for (double recall : recalls)
+		appLogger.info("  target recall " + lexical_cast<string>(recall) + ": " + toString(calibration.evaluate(calibration.computeThresholdsForRecall(recall)), stageCount));
+
+	if (targetRecall == -1)
+		return EXIT_SUCCESS;
+
+	vector<float> thresholds = targetRecall >= 0 ? calibration.computeThresholdsForRecall(targetRecall) : calibration.computeThresholdsForFilterCount(targetFilterCount);
+	appLogger.info("Calibrated thresholds: " + toString(calibration.evaluate(thresholds), stageCount));
+
+	if (!outputFile.empty()) {
+		try {
+			vector<float> allThresholds = cascade.getThresholds();
+			for (size_t i = 0; i < thresholds.size(); ++i) // unused stages keep their thresholds
+				allThresholds[i] = thresholds[i] - thresholdOffset;
+			cascade.setThresholds(allThresholds);
+			cascade.save(outputFile.string());
+			appLogger.info("Stored the classifier with the calibrated thresholds (minus the offset of "
+					+ lexical_cast<string>(thresholdOffset) + ") in " + outputFile.string());
+		} catch (const std::exception& error) {
+			appLogger.error(error.what());
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
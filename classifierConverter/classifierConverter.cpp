@@ -0,0 +1,325 @@
+/*
+ * classifierConverter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "classification/SvmClassifier.hpp"
+#include "classification/WvmClassifier.hpp"
+#include "classification/RvmClassifier.hpp"
+#include "classification/ProbabilisticSvmClassifier.hpp"
+#include "classification/ProbabilisticWvmClassifier.hpp"
+#include "classification/ProbabilisticRvmClassifier.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+using namespace classification;
+namespace po = boost::program_options;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::pair;
+using std::function;
+using std::shared_ptr;
+using std::make_shared;
+using boost::filesystem::path;
+using boost::lexical_cast;
+using cv::Mat;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+
+/**
+ * Classifier loaded by this app together with the means to store it in the binary format.
+ */
+struct LoadedClassifier {
+	shared_ptr<BinaryClassifier> classifier; ///< The classifier.
+	shared_ptr<ProbabilisticClassifier> probabilisticClassifier; ///< The classifier if it is probabilistic, empty otherwise.
+	function<void(const string&)> save; ///< Function that stores the classifier in the binary format.
+};
+
+template<class T>
+LoadedClassifier wrap(shared_ptr<T> classifier) {
+	LoadedClassifier result;
+	result.classifier = classifier;
+	result.save = [classifier](const string& filename) { classifier->saveToBinary(filename); };
+	return result;
+}
+
+template<class T>
+LoadedClassifier wrapProbabilistic(shared_ptr<T> classifier) {
+	LoadedClassifier result = wrap(classifier);
+	result.probabilisticClassifier = classifier;
+	return result;
+}
+
+/**
+ * Loads the sample patches used for verification: either all images of a directory or the images listed in a text
+ * file (one file name per line). The patches are converted to grayscale and scaled to the given size.
+ */
+vector<Mat> loadPatches(const path& patchSource, int patchWidth, int patchHeight) {
+	vector<path> files;
+	if (boost::filesystem::is_directory(patchSource)) {
+		for (boost::filesystem::directory_iterator it(patchSource), end; it != end; ++it) {
+			if (boost::filesystem::is_regular_file(it->path()))
+				files.push_back(it->path());
+		}
+		std::sort(files.begin(), files.end());
+	} else {
+		std::ifstream list(patchSource.string());
+		if (!list.is_open())
+			throw std::invalid_argument("Could not open the patch list " + patchSource.string());
+		string line;
+		while (std::getline(list, line)) {
+			boost::algorithm::trim(line);
+			if (!line.empty())
+				files.push_back(path(line));
+		}
+	}
+	vector<Mat> patches;
+	for (const path& file : files) {
+		Mat image = cv::imread(file.string(), CV_LOAD_IMAGE_GRAYSCALE);
+		if (image.empty())
+			continue;
+		Mat patch;
+		cv::resize(image, patch, cv::Size(patchWidth, patchHeight), 0, 0, cv::INTER_AREA);
+		patches.push_back(patch);
+	}
+	if (patches.empty())
+		throw std::invalid_argument("No readable patches in " + patchSource.string());
+	return patches;
+}
+
+/**
+ * Loads a classifier from its original format (Matlab or, in case of an SVM, text).
+ */
+LoadedClassifier loadOriginal(const string& type, const path& classifierFile, const path& thresholdsFile) {
+	bool matlab = classifierFile.extension() == ".mat";
+	if (type == "svm") {
+		return wrap(matlab ? SvmClassifier::loadFromMatlab(classifierFile.string()) : SvmClassifier::loadFromText(classifierFile.string()));
+	} else if (type == "psvm") {
+		if (matlab)
+			return wrapProbabilistic(ProbabilisticSvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string()));
+		return wrapProbabilistic(make_shared<ProbabilisticSvmClassifier>(SvmClassifier::loadFromText(classifierFile.string())));
+	} else if (type == "wvm") {
+		return wrap(WvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string()));
+	} else if (type == "pwvm") {
+		return wrapProbabilistic(ProbabilisticWvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string()));
+	} else if (type == "rvm") {
+		return wrap(RvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string()));
+	} else if (type == "prvm") {
+		pair<double, double> logisticParams = ProbabilisticRvmClassifier::loadSigmoidParamsFromMatlab(thresholdsFile.string());
+		shared_ptr<RvmClassifier> rvm = RvmClassifier::loadFromMatlab(classifierFile.string(), thresholdsFile.string());
+		return wrapProbabilistic(make_shared<ProbabilisticRvmClassifier>(rvm, logisticParams.first, logisticParams.second));
+	}
+	throw std::invalid_argument("Unknown classifier type: " + type);
+}
+
+/**
+ * Loads a classifier from the binary format.
+ */
+LoadedClassifier loadBinary(const string& type, const path& binaryFile) {
+	if (type == "svm")
+		return wrap(SvmClassifier::loadFromBinary(binaryFile.string()));
+	else if (type == "psvm")
+		return wrapProbabilistic(ProbabilisticSvmClassifier::loadFromBinary(binaryFile.string()));
+	else if (type == "wvm")
+		return wrap(WvmClassifier::loadFromBinary(binaryFile.string()));
+	else if (type == "pwvm")
+		return wrapProbabilistic(ProbabilisticWvmClassifier::loadFromBinary(binaryFile.string()));
+	else if (type == "rvm")
+		return wrap(RvmClassifier::loadFromBinary(binaryFile.string()));
+	else if (type == "prvm")
+		return wrapProbabilistic(ProbabilisticRvmClassifier::loadFromBinary(binaryFile.string()));
+	throw std::invalid_argument("Unknown classifier type: " + type);
+}
+
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	string classifierType;
+	path classifierFile;
+	path thresholdsFile;
+	path outputFile;
+	int verificationCount;
+	path patchSource;
+	int patchWidth;
+	int patchHeight;
+	bool floatPatches;
+	size_t compilationBinCount;
+	int compilationSampleCount;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO","show messages with INFO loglevel or below."),
+				  "specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("type,t", po::value<string>(&classifierType)->required(),
+				"type of the classifier: svm, psvm, wvm, pwvm, rvm or prvm")
+			("classifier,c", po::value<path>(&classifierFile)->required(),
+				"classifier file (.mat, or text file in case of an SVM)")
+			("thresholds,s", po::value<path>(&thresholdsFile)->default_value(path()),
+				"thresholds file (.mat) containing the hierarchical thresholds and logistic parameters")
+			("output,o", po::value<path>(&outputFile)->required(),
+				"output file in the binary format (should have the extension .bin to be recognized by the config loaders)")
+			("verify", po::value<int>(&verificationCount)->default_value(0),
+				"number of random patches to compare the outputs of the original and the converted classifier on")
+			("patches,p", po::value<path>(&patchSource)->default_value(path()),
+				"directory or list file of sample patches (images) to compare the outputs of the original and the converted classifier on")
+			("patch-width", po::value<int>(&patchWidth)->default_value(20),
+				"width of the patches used for verification (sample patches are scaled to it)")
+			("patch-height", po::value<int>(&patchHeight)->default_value(20),
+				"height of the patches used for verification (sample patches are scaled to it)")
+			("float-patches", po::value<bool>(&floatPatches)->implicit_value(true)->default_value(false),
+				"use CV_32F patches with values between 0 and 1 for verification instead of CV_8U patches")
+			("compiled", po::value<size_t>(&compilationBinCount),
+				"measure the error of evaluating the converted SVM (histogram intersection kernel only) with lookup tables of the given number of bins, 0 for exact tables")
+			("compilation-samples", po::value<int>(&compilationSampleCount)->default_value(100),
+				"number of random histograms the error of the compiled SVM is measured on")
+		;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: classifierConverter [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+		if (!vm.count("compiled"))
+			compilationSampleCount = 0;
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid log level." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	Loggers->getLogger("classification").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("classifierConverter").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("classifierConverter");
+
+	boost::algorithm::to_lower(classifierType);
+	LoadedClassifier original, converted;
+	try {
+		auto start = std::chrono::steady_clock::now();
+		original = loadOriginal(classifierType, classifierFile, thresholdsFile);
+		auto originalLoadTime = std::chrono::steady_clock::now() - start;
+
+		original.save(outputFile.string());
+		appLogger.info("Stored the classifier in " + outputFile.string());
+
+		start = std::chrono::steady_clock::now();
+		converted = loadBinary(classifierType, outputFile);
+		auto convertedLoadTime = std::chrono::steady_clock::now() - start;
+
+		appLogger.info("Loading time of the original classifier: "
+				+ lexical_cast<string>(std::chrono::duration_cast<std::chrono::microseconds>(originalLoadTime).count() / 1000.0) + "ms");
+		appLogger.info("Loading time of the converted classifier: "
+				+ lexical_cast<string>(std::chrono::duration_cast<std::chrono::microseconds>(convertedLoadTime).count() / 1000.0) + "ms");
+	}
+	catch (const std::exception& error) {
+		appLogger.error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	vector<Mat> patches;
+	cv::RNG rng;
+	for (int i = 0; i < verificationCount; ++i) {
+		Mat patch(patchHeight, patchWidth, CV_8U);
+		rng.fill(patch, cv::RNG::UNIFORM, 0, 256);
+		patches.push_back(patch);
+	}
+	if (!patchSource.empty()) {
+		try {
+			vector<Mat> samplePatches = loadPatches(patchSource, patchWidth, patchHeight);
+			appLogger.info("Loaded " + lexical_cast<string>(samplePatches.size()) + " sample patches from " + patchSource.string());
+			patches.insert(patches.end(), samplePatches.begin(), samplePatches.end());
+		}
+		catch (const std::exception& error) {
+			appLogger.error(error.what());
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (!patches.empty()) {
+		// the confidence is the hyperplane distance (of the last evaluated cascade level in case of WVMs and RVMs)
+		int labelMismatches = 0;
+		double maxConfidenceDifference = 0;
+		double maxProbabilityDifference = 0;
+		for (Mat& patch : patches) {
+			if (floatPatches)
+				patch.convertTo(patch, CV_32F, 1.0 / 255.0);
+			pair<bool, double> originalConfidence = original.classifier->getConfidence(patch);
+			pair<bool, double> convertedConfidence = converted.classifier->getConfidence(patch);
+			if (originalConfidence.first != convertedConfidence.first)
+				++labelMismatches;
+			maxConfidenceDifference = std::max(maxConfidenceDifference, std::abs(originalConfidence.second - convertedConfidence.second));
+			if (original.probabilisticClassifier) {
+				double originalProbability = original.probabilisticClassifier->getProbability(patch).second;
+				double convertedProbability = converted.probabilisticClassifier->getProbability(patch).second;
+				maxProbabilityDifference = std::max(maxProbabilityDifference, std::abs(originalProbability - convertedProbability));
+			}
+		}
+		appLogger.info("Verified " + lexical_cast<string>(patches.size()) + " patches: " + lexical_cast<string>(labelMismatches)
+				+ " label mismatches, maximum distance difference " + lexical_cast<string>(maxConfidenceDifference)
+				+ ", maximum probability difference " + lexical_cast<string>(maxProbabilityDifference));
+		if (labelMismatches > 0 || maxConfidenceDifference > 0 || maxProbabilityDifference > 0) {
+			appLogger.error("The converted classifier does not produce the same output as the original one.");
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (compilationSampleCount > 0) { // after the verification, which compares the exact evaluations
+		shared_ptr<SvmClassifier> svm = std::dynamic_pointer_cast<SvmClassifier>(converted.classifier);
+		if (shared_ptr<ProbabilisticSvmClassifier> probabilisticSvm = std::dynamic_pointer_cast<ProbabilisticSvmClassifier>(converted.classifier))
+			svm = probabilisticSvm->getSvm();
+		if (svm)
+			svm->setCompiled(true, compilationBinCount);
+		if (!svm || !svm->isCompiled()) {
+			appLogger.error("Only SVMs with a histogram intersection kernel can be compiled.");
+			return EXIT_FAILURE;
+		}
+		appLogger.info("Maximum deviation of the compiled SVM on " + lexical_cast<string>(compilationSampleCount) + " random histograms: "
+				+ lexical_cast<string>(svm->measureCompilationError(compilationSampleCount)));
+	}
+
+	return EXIT_SUCCESS;
+}
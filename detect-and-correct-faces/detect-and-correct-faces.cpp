@@ -67,6 +67,7 @@
 #include "imageio/RectLandmarkSink.hpp"
 
 #include "logging/LoggerFactory.hpp"
+#include "logging/Tracer.hpp"
 
 using namespace imageio;
 namespace po = boost::program_options;
@@ -83,6 +84,7 @@ using cv::Mat;
 using cv::Rect;
 using logging::Logger;
 using logging::LoggerFactory;
+using logging::Tracer;
 using logging::LogLevel;
 
 template<class T>
@@ -104,6 +106,7 @@ int main(int argc, char *argv[])
 	path groundtruthPath, faceDetectorFilename, outputDirectory;
 	string groundtruthType;
 	bool doOutputImages;
+	path traceFilename;
 
 	bool useFileList = false;
 	bool useImgs = false;
@@ -128,6 +131,8 @@ int main(int argc, char *argv[])
 				"output folder to write the detected face boxes to")
 			("output-images,p", po::value<bool>(&doOutputImages)->default_value(false),
 				"true or false, write the detected face and the ground-truth landmarks alongside the face box output")
+			("trace", po::value<path>(&traceFilename),
+				"enable the performance tracing, write the events to the given Chrome trace (.json) file and log a summary at the end")
 		;
 
 		po::variables_map vm;
@@ -256,7 +261,10 @@ int main(int argc, char *argv[])
 	RectLandmarkSink landmarkSink(outputDirectory);
 
 	std::chrono::time_point<std::chrono::system_clock> start, end;
+	if (!traceFilename.empty())
+		Tracers->setEnabled(true);
 	while (imageSource->next()) {
+		TRACE_SCOPE("detect-and-correct-faces::frame");
 		start = std::chrono::system_clock::now();
 		appLogger.info("Starting to process " + imageSource->getName().string());
 		Mat img = imageSource->getImage();
@@ -269,7 +277,10 @@ int main(int argc, char *argv[])
 
 		// face detection
 		//faceCascade.detectMultiScale(img, faces, 1.2, 2, 0, cv::Size(50, 50));
-		faceCascade.detectMultiScale(img, faces);
+		{
+			TRACE_SCOPE("detect-and-correct-faces::faceDetection");
+			faceCascade.detectMultiScale(img, faces);
+		}
 		if (faces.empty()) {
 			// no face found, output nothing
 			continue;
@@ -325,5 +336,10 @@ int main(int argc, char *argv[])
 		appLogger.info("Finished processing. Elapsed time: " + lexical_cast<string>(elapsed_mseconds) + "ms.");
 	}
 
+	if (!traceFilename.empty()) {
+		appLogger.info("Performance trace:\n" + Tracers->getSummary());
+		Tracers->writeChromeTrace(traceFilename.string());
+	}
+
 	return 0;
 }
@@ -85,6 +85,7 @@ int main(int argc, char *argv[])
 	path faceDetectorFilename;
 	path faceBoxesDirectory;
 	path outputDirectory;
+	int numInitialisations;
 
 	try {
 		po::options_description desc("Allowed options");
@@ -103,6 +104,8 @@ int main(int argc, char *argv[])
 				"Path to pre-detected face-box landmarks. Specify either -f or -l.")
 			("output,o", po::value<path>(&outputDirectory)->required(),
 				"Output directory for the result images and landmarks.")
+			("initialisations,k", po::value<int>(&numInitialisations)->default_value(1),
+				"Number of initialisations (perturbed face-boxes) to fit from. The results are combined by their median.")
 		;
 
 		po::positional_options_description p;
@@ -116,6 +119,11 @@ int main(int argc, char *argv[])
 			return EXIT_SUCCESS;
 		}
 		po::notify(vm);
+		if (numInitialisations < 1) {
+			cout << "Error while parsing command-line arguments: the number of initialisations (-k) must be at least 1" << endl;
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
 		if (vm.count("face-detector") + vm.count("face-boxes") != 1) {
 			cout << "Error while parsing command-line arguments: specify either a face-detector (-f) or face-boxes (-l) as input" << endl;
 			cout << desc;
@@ -236,6 +244,8 @@ int main(int argc, char *argv[])
 		faceboxSource = make_shared<DefaultNamedLandmarkSource>(LandmarkFileGatherer::gather(imageSource, ".txt", GatherMethod::ONE_FILE_PER_IMAGE_DIFFERENT_DIRS, vector<path>{ faceBoxesDirectory }), make_shared<SimpleRectLandmarkFormatParser>());
 	}
 	
+	double fittingMillisecondsSum = 0.0; // to compare the runtime of different numbers of initialisations
+	int numFittedImages = 0;
 	while (imageSource->next()) {
 		start = std::chrono::system_clock::now();
 		appLogger.info("Starting to process " + imageSource->getName().string());
@@ -270,11 +280,22 @@ int main(int argc, char *argv[])
 		cv::rectangle(landmarksImage, faces[0], cv::Scalar(0.0f, 0.0f, 255.0f));
 
 		// fit the model
+		std::chrono::time_point<std::chrono::system_clock> fittingStart = std::chrono::system_clock::now();
 		Mat modelShape = lmModel.getMeanShape();
-		modelShape = modelFitter.alignRigid(modelShape, faces[0]);
-		//superviseddescent::drawLandmarks(landmarksImage, modelShape);
-		modelShape = modelFitter.optimize(modelShape, imgGray);
-		//superviseddescent::drawLandmarks(landmarksImage, modelShape);
+		if (numInitialisations > 1) {
+			vector<Mat> initialShapes = modelFitter.alignRigidPerturbed(modelShape, faces[0], numInitialisations);
+			modelShape = modelFitter.optimize(initialShapes, imgGray);
+		}
+		else {
+			modelShape = modelFitter.alignRigid(modelShape, faces[0]);
+			//superviseddescent::drawLandmarks(landmarksImage, modelShape);
+			modelShape = modelFitter.optimize(modelShape, imgGray);
+			//superviseddescent::drawLandmarks(landmarksImage, modelShape);
+		}
+		double fittingMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now() - fittingStart).count();
+		appLogger.debug("Fitting from " + lexical_cast<string>(numInitialisations) + " initialisation(s) took " + lexical_cast<string>(static_cast<int>(fittingMilliseconds)) + "ms.");
+		fittingMillisecondsSum += fittingMilliseconds;
+		++numFittedImages;
 
 		// draw the final result
 		superviseddescent::drawLandmarks(landmarksImage, modelShape, Scalar(0.0f, 255.0f, 0.0f));
@@ -291,6 +312,9 @@ int main(int argc, char *argv[])
 		int elapsed_mseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count();
 		appLogger.info("Finished processing. Elapsed time: " + lexical_cast<string>(elapsed_mseconds) + "ms.");
 	}
+	if (numFittedImages > 0) {
+		appLogger.info("Mean fitting time from " + lexical_cast<string>(numInitialisations) + " initialisation(s): " + lexical_cast<string>(fittingMillisecondsSum / numFittedImages) + "ms over " + lexical_cast<string>(numFittedImages) + " image(s).");
+	}
 
 	return 0;
 }
@@ -0,0 +1,152 @@
+/*
+ * detectionEvaluation.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <iostream>
+#include <chrono>
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "detection/DetectionEvaluation.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+using detection::DetectionEvaluation;
+namespace po = boost::program_options;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::make_shared;
+using boost::filesystem::path;
+using boost::lexical_cast;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+
+DetectionEvaluation::RegionsPerImage loadRegions(const vector<path>& files) {
+	DetectionEvaluation::RegionsPerImage regions;
+	for (const path& file : files) {
+		DetectionEvaluation::RegionsPerImage fileRegions = DetectionEvaluation::loadFddbFile(file.string());
+		for (auto& image : fileRegions) {
+			vector<detection::DetectionRegion>& imageRegions = regions[image.first];
+			imageRegions.insert(imageRegions.end(), image.second.begin(), image.second.end());
+		}
+	}
+	return regions;
+}
+
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	vector<path> annotationFiles;
+	vector<path> detectionFiles;
+	path outputPrefix;
+	double overlapThreshold;
+	size_t threadCount;
+	vector<double> reportedFalsePositives;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO","show messages with INFO loglevel or below."),
+				  "specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("annotations,a", po::value<vector<path>>(&annotationFiles)->required()->multitoken(),
+				"ground-truth files in the FDDB format (e.g. the FDDB-fold-xx-ellipseList.txt files)")
+			("detections,d", po::value<vector<path>>(&detectionFiles)->required()->multitoken(),
+				"detection files in the FDDB format (e.g. as written by FddbLandmarkSink)")
+			("overlap", po::value<double>(&overlapThreshold)->default_value(0.5),
+				"minimum overlap (intersection over union) of a detection and a ground-truth region")
+			("threads,j", po::value<size_t>(&threadCount)->default_value(0),
+				"number of threads used for matching, 0 for the number of cores")
+			("output,o", po::value<path>(&outputPrefix),
+				"prefix of the output files (<prefix>DiscROC.txt, <prefix>ContROC.txt and <prefix>PR.txt)")
+			("report-fp", po::value<vector<double>>(&reportedFalsePositives)->multitoken()->default_value({ 100, 500, 1000, 2000 }, "100 500 1000 2000"),
+				"numbers of false positives at which the true positive rates are reported")
+		;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: detectionEvaluation [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid log level." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	Loggers->getLogger("detection").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("detectionEvaluation").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("detectionEvaluation");
+
+	try {
+		DetectionEvaluation::RegionsPerImage groundTruth = loadRegions(annotationFiles);
+		DetectionEvaluation::RegionsPerImage detections = loadRegions(detectionFiles);
+
+		auto start = std::chrono::steady_clock::now();
+		DetectionEvaluation evaluation(overlapThreshold, threadCount);
+		evaluation.evaluate(groundTruth, detections);
+		vector<DetectionEvaluation::RocPoint> discreteRoc = evaluation.computeRocCurve(false);
+		vector<DetectionEvaluation::RocPoint> continuousRoc = evaluation.computeRocCurve(true);
+		vector<DetectionEvaluation::PrecisionRecallPoint> precisionRecall = evaluation.computePrecisionRecallCurve();
+		double averagePrecision = evaluation.computeAveragePrecision();
+		auto duration = std::chrono::steady_clock::now() - start;
+		appLogger.info("Evaluated " + lexical_cast<string>(evaluation.getImageCount()) + " images in "
+				+ lexical_cast<string>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()) + "ms");
+
+		appLogger.info("Average precision: " + lexical_cast<string>(averagePrecision));
+		for (double falsePositives : reportedFalsePositives) {
+			double discreteRate = 0, continuousRate = 0;
+			for (const DetectionEvaluation::RocPoint& point : discreteRoc)
+				if (point.falsePositives <= falsePositives)
+					discreteRate = point.truePositiveRate;
+			for (const DetectionEvaluation::RocPoint& point : continuousRoc)
+				if (point.falsePositives <= falsePositives)
+					continuousRate = point.truePositiveRate;
+			appLogger.info("True positive rate at " + lexical_cast<string>(falsePositives) + " false positives: "
+					+ lexical_cast<string>(discreteRate) + " (discrete), " + lexical_cast<string>(continuousRate) + " (continuous)");
+		}
+
+		if (!outputPrefix.empty()) {
+			DetectionEvaluation::saveRocCurve(discreteRoc, outputPrefix.string() + "DiscROC.txt");
+			DetectionEvaluation::saveRocCurve(continuousRoc, outputPrefix.string() + "ContROC.txt");
+			DetectionEvaluation::savePrecisionRecallCurve(precisionRecall, outputPrefix.string() + "PR.txt");
+			appLogger.info("Stored the curves with the prefix " + outputPrefix.string());
+		}
+	} catch (const std::exception& error) {
+		appLogger.error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
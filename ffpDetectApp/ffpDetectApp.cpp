@@ -84,6 +84,7 @@
 #include "detection/FiveStageSlidingWindowDetector.hpp"
 
 #include "logging/LoggerFactory.hpp"
+#include "logging/Tracer.hpp"
 #include "imagelogging/ImageLoggerFactory.hpp"
 #include "imagelogging/ImageFileWriter.hpp"
 
@@ -95,6 +96,7 @@ using namespace classification;
 using namespace imageio;
 using logging::Logger;
 using logging::LoggerFactory;
+using logging::Tracer;
 using logging::loglevel;
 using imagelogging::ImageLogger;
 using imagelogging::ImageLoggerFactory;
@@ -199,6 +201,7 @@ int main(int argc, char *argv[])
 	path configFilename;
 	shared_ptr<ImageSource> imageSource;
 	path outputPicsDir;
+	path traceFilename;
 
 	try {
 		po::options_description desc("Allowed options");
@@ -215,6 +218,8 @@ int main(int argc, char *argv[])
 				"input from one or more files, a directory, or a  .lst-file containing a list of images")
 			("output-dir,o", po::value<path>()->default_value("."),
 				"output directory for the result images")
+			("trace", po::value<path>(),
+				"enable the performance tracing, write the events to the given Chrome trace (.json) file and log a summary at the end")
 		;
 
 		po::positional_options_description p;
@@ -247,6 +252,10 @@ int main(int argc, char *argv[])
 		{
 			outputPicsDir = vm["output-dir"].as<path>();
 		}
+		if (vm.count("trace"))
+		{
+			traceFilename = vm["trace"].as<path>();
+		}
 	} catch(std::exception& e) {
 		cout << e.what() << endl;
 		return EXIT_FAILURE;
@@ -545,7 +554,10 @@ int main(int argc, char *argv[])
 
 	std::chrono::time_point<std::chrono::system_clock> start, end;
 	Mat img;
+	if (!traceFilename.empty())
+		Tracers->setEnabled(true);
 	while(imageSource->next()) {
+		TRACE_SCOPE("ffpDetectApp::frame");
 		start = std::chrono::system_clock::now();
 		appLogger.info("Starting to process " + imageSource->getName().string());
 		img = imageSource->getImage();
@@ -667,6 +679,11 @@ int main(int argc, char *argv[])
 	std::cout << "[ffpDetectApp] NOCAND:  " << NOCAND << std::endl;
 	std::cout << "[ffpDetectApp] DONTKNOW:  " << DONTKNOW << std::endl;
 	std::cout << "[ffpDetectApp] =====================================" << std::endl;
+
+	if (!traceFilename.empty()) {
+		appLogger.info("Performance trace:\n" + Tracers->getSummary());
+		Tracers->writeChromeTrace(traceFilename.string());
+	}
 	
 	return 0;
 }
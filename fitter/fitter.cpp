@@ -35,6 +35,15 @@
 #include <chrono>
 #include <memory>
 #include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <algorithm>
 
 #include "opencv2/core/core.hpp"
 #include "opencv2/imgproc/imgproc.hpp"
@@ -60,9 +69,11 @@
 #include "fitting/AffineCameraEstimation.hpp"
 #include "fitting/OpenCVCameraEstimation.hpp"
 #include "fitting/LinearShapeFitting.hpp"
+#include "fitting/MultiFrameShapeFitting.hpp"
 
 #include "render/SoftwareRenderer.hpp"
 #include "render/MeshUtils.hpp"
+#include "render/IsomapFusion.hpp"
 #include "render/utils.hpp"
 
 #include "imageio/ImageSource.hpp"
@@ -79,6 +90,7 @@
 #include "imageio/LandmarkMapper.hpp"
 
 #include "logging/LoggerFactory.hpp"
+#include "logging/Tracer.hpp"
 
 using namespace imageio;
 namespace po = boost::program_options;
@@ -123,6 +135,433 @@ std::ostream& operator<<(std::ostream& os, const std::vector<T>& v)
 	return os;
 }
 
+/**
+ * A queue with a maximum size. Adding blocks while the queue is full, taking
+ * out blocks while it is empty and not yet closed. Used to pass the images
+ * from the reader to the workers, so the reader can't run ahead arbitrarily.
+ * Closing the queue also releases a blocked producer, so the threads can be
+ * stopped when one of them fails.
+ */
+template<class T>
+class BoundedQueue
+{
+public:
+	explicit BoundedQueue(std::size_t capacity) : capacity(std::max(capacity, std::size_t(1))), closed(false) {}
+
+	/**
+	 * Adds an element at the end, waiting while the queue is full.
+	 *
+	 * @param[in] element The element.
+	 * @return False if the queue was closed, the element is dropped then.
+	 */
+	bool push(T element)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notFull.wait(lock, [this] { return elements.size() < capacity || closed; });
+		if (closed) {
+			return false;
+		}
+		elements.push_back(std::move(element));
+		notEmpty.notify_one();
+		return true;
+	}
+
+	/**
+	 * Takes out the first element.
+	 *
+	 * @param[out] element The element.
+	 * @return False if the queue is closed and empty, i.e. there won't be any more elements.
+	 */
+	bool pop(T& element)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notEmpty.wait(lock, [this] { return !elements.empty() || closed; });
+		if (elements.empty()) {
+			return false;
+		}
+		element = std::move(elements.front());
+		elements.pop_front();
+		notFull.notify_one();
+		return true;
+	}
+
+	/**
+	 * Signals that no more elements will be added.
+	 */
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+private:
+	std::size_t capacity;
+	bool closed;
+	std::deque<T> elements;
+	std::mutex mutex;
+	std::condition_variable notFull;
+	std::condition_variable notEmpty;
+};
+
+/**
+ * Brings the results of the workers back into the order of the input images.
+ * A result can only be added if it is less than capacity positions ahead of
+ * the next one to be taken out, so the workers can't run away from an image
+ * that takes long. The worker of the next result is never blocked, so this
+ * can't deadlock.
+ */
+template<class T>
+class ReorderBuffer
+{
+public:
+	explicit ReorderBuffer(std::size_t capacity) : capacity(std::max(capacity, std::size_t(1))), next(0), closed(false) {}
+
+	/**
+	 * Adds a result, waiting while it is too far ahead of the next one.
+	 *
+	 * @param[in] index The position of the result in the input.
+	 * @param[in] element The result.
+	 * @return False if the buffer was closed, the result is dropped then.
+	 */
+	bool push(std::size_t index, T element)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notFull.wait(lock, [&] { return index < next + capacity || closed; });
+		if (closed) {
+			return false;
+		}
+		elements.emplace(index, std::move(element));
+		available.notify_all();
+		return true;
+	}
+
+	/**
+	 * Takes out the next result in the order of the indices.
+	 *
+	 * @param[out] element The result.
+	 * @return False if the buffer is closed and the next result was never added.
+	 */
+	bool pop(T& element)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		available.wait(lock, [this] { return elements.count(next) > 0 || closed; });
+		auto it = elements.find(next);
+		if (it == elements.end()) {
+			return false;
+		}
+		element = std::move(it->second);
+		elements.erase(it);
+		++next;
+		notFull.notify_all();
+		return true;
+	}
+
+	/**
+	 * Signals that no more results will be added.
+	 */
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		available.notify_all();
+		notFull.notify_all();
+	}
+
+private:
+	std::size_t capacity;
+	std::size_t next; ///< The index of the next result to take out.
+	bool closed;
+	std::map<std::size_t, T> elements;
+	std::mutex mutex;
+	std::condition_variable notFull;
+	std::condition_variable available;
+};
+
+/**
+ * An image with its landmarks, as read from the labeled image source.
+ */
+struct FittingInput
+{
+	std::size_t index; ///< The position of the image in the input.
+	path name;
+	Mat image;
+	LandmarkCollection landmarks;
+};
+
+/**
+ * Everything that is written for one image. If the fitting failed, only the
+ * index, name and error are set.
+ */
+struct FittingResult
+{
+	std::size_t index; ///< The position of the image in the input.
+	path name;
+	string error; ///< The error message if the fitting failed, empty otherwise.
+	Mat image;
+	Mat landmarksImage; ///< The input image with the landmarks and the projected mean-face landmarks.
+	Mat fullAffineCam;
+	vector<float> fittedCoeffs;
+	std::size_t numFrames; ///< The number of frames of the multi-frame fitting, if enabled.
+	Mesh mesh;
+	Mat renderedModel;
+	Mat depthBuffer;
+	Mat textureMap;
+	Mat frontalRendering;
+	double fittingTime; ///< The time spent fitting, in milliseconds.
+};
+
+/**
+ * The state a worker owns, so the workers don't share anything writable. The
+ * renderer is re-used as long as the images have the same size.
+ */
+struct FittingWorker
+{
+	explicit FittingWorker(LandmarkMapper landmarkMapper) : landmarkMapper(landmarkMapper), rendererWidth(0), rendererHeight(0) {}
+
+	render::SoftwareRenderer& getRenderer(int width, int height)
+	{
+		if (!renderer || width != rendererWidth || height != rendererHeight) {
+			renderer.reset(new render::SoftwareRenderer(width, height));
+			rendererWidth = width;
+			rendererHeight = height;
+		}
+		return *renderer;
+	}
+
+	LandmarkMapper landmarkMapper;
+	std::unique_ptr<render::SoftwareRenderer> renderer;
+	int rendererWidth;
+	int rendererHeight;
+};
+
+/**
+ * Reads the current image and landmarks of the source.
+ */
+FittingInput readInput(LabeledImageSource& labeledImageSource, std::size_t index)
+{
+	TRACE_SCOPE("fitter::read");
+	FittingInput input;
+	input.index = index;
+	input.name = labeledImageSource.getName();
+	input.image = labeledImageSource.getImage();
+	input.landmarks = labeledImageSource.getLandmarks();
+	return input;
+}
+
+/**
+ * Fits the model to one image and renders the results. Only reads the model,
+ * so any number of workers can fit images at the same time - except with the
+ * multi-frame fitting, which needs the images in order and one at a time.
+ */
+FittingResult fitImage(const FittingInput& input, const morphablemodel::MorphableModel& morphableModel, bool useLandmarkMappings, float lambda, shared_ptr<fitting::MultiFrameShapeFitting> multiFrameFitting, FittingWorker& worker)
+{
+	TRACE_SCOPE("fitter::fit");
+	auto start = std::chrono::steady_clock::now();
+	FittingResult result;
+	result.index = input.index;
+	result.name = input.name;
+	result.numFrames = 0;
+	result.fittingTime = 0;
+	try {
+		Mat img = input.image;
+		LandmarkCollection didLms;
+		if (useLandmarkMappings) {
+			didLms = worker.landmarkMapper.convert(input.landmarks);
+		}
+		else {
+			didLms = input.landmarks;
+		}
+
+		vector<imageio::ModelLandmark> landmarks;
+		Mat landmarksImage = img.clone(); // blue rect = the used landmarks
+		for (const auto& lm : didLms.getLandmarks()) {
+			lm->draw(landmarksImage);
+			landmarks.emplace_back(imageio::ModelLandmark(lm->getName(), lm->getPosition2D()));
+			cv::rectangle(landmarksImage, cv::Point(cvRound(lm->getX() - 2.0f), cvRound(lm->getY() - 2.0f)), cv::Point(cvRound(lm->getX() + 2.0f), cvRound(lm->getY() + 2.0f)), cv::Scalar(255, 0, 0));
+			//cv::putText(landmarksImage, lm->getName(), cv::Point(lm->getX(), lm->getY()), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.5, cv::Scalar(0.0, 0.0, 255.0));
+		}
+
+		// Start affine camera estimation (Aldrian paper)
+		Mat affineCamLandmarksProjectionImage = landmarksImage.clone(); // the affine LMs are currently not used (don't know how to render without z-vals)
+
+		// Convert the landmarks to clip-space, and only convert the ones that exist in the model
+		vector<imageio::ModelLandmark> landmarksClipSpace;
+		for (const auto& lm : landmarks) {
+			if (morphableModel.getShapeModel().landmarkExists(lm.getName())) {
+				cv::Vec2f clipCoords = render::utils::screenToClipSpace(lm.getPosition2D(), img.cols, img.rows);
+				landmarksClipSpace.push_back(imageio::ModelLandmark(lm.getName(), Vec3f(clipCoords[0], clipCoords[1], 0.0f), lm.isVisible()));
+			}
+		}
+
+		Mat affineCam = fitting::estimateAffineCamera(landmarksClipSpace, morphableModel);
+
+		// Render the mean-face landmarks projected using the estimated camera:
+		// Todo/Note: Here we render all landmarks. Shouldn't we only render the ones that exist in the model? (see above, landmarksClipSpace)
+		for (const auto& lm : landmarks) {
+			Vec3f modelPoint;
+			try {
+				modelPoint = morphableModel.getShapeModel().getMeanAtPoint(lm.getName());
+			}
+			catch (std::out_of_range& e) {
+				continue;
+			}
+			cv::Vec2f screenPoint = fitting::projectAffine(modelPoint, affineCam, img.cols, img.rows);
+			cv::circle(affineCamLandmarksProjectionImage, Point2f(screenPoint), 4.0f, Scalar(0.0f, 255.0f, 0.0f));
+		}
+
+		// Estimate the shape coefficients:
+		// Detector variances: Should not be in pixels. Should be normalised by the IED. Normalise by the image dimensions is not a good idea either, it has nothing to do with it. See comment in fitShapeToLandmarksLinear().
+		// Let's just use the hopefully reasonably set default value for now (around 3 pixels)
+		vector<float> fittedCoeffs;
+		if (multiFrameFitting) {
+			multiFrameFitting->addFrame(affineCam, landmarksClipSpace);
+			fittedCoeffs = multiFrameFitting->getFrameShapeCoefficients(multiFrameFitting->getNumFrames() - 1); // the shared identity, plus the residuals of this image if enabled
+			result.numFrames = multiFrameFitting->getNumFrames();
+		}
+		else {
+			fittedCoeffs = fitting::fitShapeToLandmarksLinear(morphableModel, affineCam, landmarksClipSpace, lambda);
+		}
+
+		// Obtain the full mesh and render it using the estimated camera:
+		Mesh mesh = morphableModel.drawSample(fittedCoeffs, vector<float>()); // takes standard-normal (not-normalised) coefficients
+
+		render::SoftwareRenderer& softwareRenderer = worker.getRenderer(img.cols, img.rows);
+		Mat fullAffineCam = fitting::calculateAffineZDirection(affineCam);
+		fullAffineCam.at<float>(2, 3) = fullAffineCam.at<float>(2, 2); // Todo: Find out and document why this is necessary!
+		fullAffineCam.at<float>(2, 2) = 1.0f;
+		softwareRenderer.doBackfaceCulling = true;
+		softwareRenderer.enableTexturing(false); // the renderer is re-used, the last image enabled it for the frontal rendering
+		auto framebuffer = softwareRenderer.render(mesh, fullAffineCam); // hmm, do we have the z-test disabled?
+		Mat renderedModel = framebuffer.first.clone(); // we save that later, and the framebuffer gets overwritten
+
+		// Extract the texture
+		// Todo: check for if hasTexture, we can't do it if the model doesn't have texture coordinates
+		Mat textureMap = render::utils::extractTexture(mesh, fullAffineCam, img.cols, img.rows, img, framebuffer.second);
+
+		// Render the shape-model with the extracted texture from a frontal viewpoint:
+		float aspect = static_cast<float>(img.cols) / static_cast<float>(img.rows);
+		Mat frontalCam = render::utils::MatrixUtils::createOrthogonalProjectionMatrix(-1.0f * aspect, 1.0f * aspect, -1.0f, 1.0f, 0.1f, 100.0f) * render::utils::MatrixUtils::createScalingMatrix(1.0f / 120.0f, 1.0f / 120.0f, 1.0f / 120.0f);
+		softwareRenderer.enableTexturing(true);
+		auto texture = make_shared<render::Texture>();
+		texture->createFromImage(textureMap); // same as reading back the written isomap, but doesn't depend on the writer
+		softwareRenderer.setCurrentTexture(texture);
+		auto frFrontal = softwareRenderer.render(mesh, frontalCam);
+
+		result.image = img;
+		result.landmarksImage = affineCamLandmarksProjectionImage;
+		result.fullAffineCam = fullAffineCam;
+		result.fittedCoeffs = fittedCoeffs;
+		result.mesh = mesh;
+		result.renderedModel = renderedModel;
+		result.depthBuffer = framebuffer.second;
+		result.textureMap = textureMap;
+		result.frontalRendering = frFrontal.first;
+	}
+	catch (const std::exception& e) {
+		result.error = e.what();
+	}
+	result.fittingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+/**
+ * Writes the fitting results of one image, as set in the config file, and adds
+ * the image to the isomap fusion.
+ */
+void writeResult(const FittingResult& result, path outputPath, const ptree& config, float lambda, bool multiFrame, shared_ptr<render::IsomapFusion> isomapFusion)
+{
+	TRACE_SCOPE("fitter::write");
+	const Mat& img = result.image;
+	if (isomapFusion) {
+		isomapFusion->addFrame(result.mesh, result.fullAffineCam, img.cols, img.rows, img, result.depthBuffer);
+	}
+
+	// Save the extracted texture map (isomap):
+	path isomapFilename = outputPath / result.name.stem();
+	isomapFilename += "_isomap.png";
+	cv::imwrite(isomapFilename.string(), result.textureMap);
+
+	// Write the fitting output files containing:
+	// - Camera parameters, fitting parameters, shape coefficients
+	ptree fittingFile;
+	fittingFile.put("camera", string("affine"));
+	fittingFile.put("camera.matrix", affineCameraMatrixToString(result.fullAffineCam));
+
+	fittingFile.put("imageWidth", img.cols);
+	fittingFile.put("imageHeight", img.rows);
+
+	fittingFile.put("fittingParameters.lambda", lambda);
+	if (multiFrame) {
+		fittingFile.put("fittingParameters.multiFrame.numFrames", result.numFrames);
+	}
+
+	fittingFile.put("textureMap", isomapFilename.filename().string());
+	fittingFile.put("model", config.get_child("morphableModel").get<string>("filename")); // This can throw, but the filename should really exist.
+
+	// alphas:
+	fittingFile.put("shapeCoefficients", "");
+	for (size_t i = 0; i < result.fittedCoeffs.size(); ++i) {
+		fittingFile.put("shapeCoefficients." + std::to_string(i), result.fittedCoeffs[i]);
+	}
+
+	// Save the fitting file
+	path fittingFileName = outputPath / result.name.stem();
+	fittingFileName += ".txt";
+	boost::property_tree::write_info(fittingFileName.string(), fittingFile);
+
+	// Additional optional output, as set in the config file:
+	if (config.get_child("output", ptree()).get<bool>("copyInputImage", false)) {
+		path outInputImage = outputPath / result.name.filename();
+		cv::imwrite(outInputImage.string(), img);
+	}
+	if (config.get_child("output", ptree()).get<bool>("landmarksImage", false)) {
+		path outLandmarksImage = outputPath / result.name.stem();
+		outLandmarksImage += "_landmarks.png";
+		cv::imwrite(outLandmarksImage.string(), result.landmarksImage);
+	}
+	if (config.get_child("output", ptree()).get<bool>("writeObj", false)) {
+		path outMesh = outputPath / result.name.stem();
+		outMesh.replace_extension("obj");
+		Mesh::writeObj(result.mesh, outMesh.string());
+	}
+	if (config.get_child("output", ptree()).get<bool>("renderResult", false)) {
+		path outRenderResult = outputPath / result.name.stem();
+		outRenderResult += "_render.png";
+		cv::imwrite(outRenderResult.string(), result.renderedModel);
+	}
+	if (config.get_child("output", ptree()).get<bool>("frontalRendering", false)) {
+		path outFrontalRenderResult = outputPath / result.name.stem();
+		outFrontalRenderResult += "_render_frontal.png";
+		cv::imwrite(outFrontalRenderResult.string(), result.frontalRendering);
+	}
+}
+
+/**
+ * Logs the throughput of the whole batch and of each stage. The busy time of a
+ * stage is the time its threads spent working (not waiting for the other
+ * stages), so the stage with the lowest throughput is the bottleneck.
+ */
+void logThroughput(Logger& logger, std::size_t numImages, double elapsedSeconds, unsigned int numWorkers)
+{
+	std::ostringstream report;
+	report << std::fixed << std::setprecision(2);
+	report << "Processed " << numImages << " images with " << numWorkers << " workers in " << elapsedSeconds << "s ("
+			<< (elapsedSeconds > 0 ? numImages / elapsedSeconds : 0.0) << " images/s).";
+	const vector<std::pair<string, unsigned int>> stages = { { "fitter::read", 1 }, { "fitter::fit", numWorkers }, { "fitter::write", 1 } };
+	for (const auto& stage : stages) {
+		for (const logging::Tracer::Statistics& statistics : logging::Tracers->getStatistics()) {
+			if (statistics.name == stage.first && statistics.total > 0) {
+				double throughput = 1000.0 * statistics.count * stage.second / statistics.total; // all threads of the stage busy all the time
+				report << "\n  " << stage.first << ": " << statistics.count << " images, " << statistics.mean << "ms per image (p95 " << statistics.p95
+						<< "ms), " << stage.second << " thread(s), up to " << throughput << " images/s";
+			}
+		}
+	}
+	logger.info(report.str());
+}
+
 int main(int argc, char *argv[])
 {
 	#ifdef WIN32
@@ -140,6 +579,7 @@ int main(int argc, char *argv[])
 	string landmarkType;
 	path landmarkMappings;
 	path outputPath;
+	unsigned int numWorkers;
 
 	try {
 		po::options_description desc("Allowed options");
@@ -160,6 +600,8 @@ int main(int argc, char *argv[])
 				"an optional mapping-file that maps from the input landmarks to landmark identifiers in the model's format")
 			("output,o", po::value<path>(&outputPath)->default_value("."),
 				"path to an output folder")
+			("workers,w", po::value<unsigned int>(&numWorkers)->default_value(1),
+				"number of images that are fitted in parallel (batch mode), 0 for the number of hardware threads. With 1, the images are processed one after another.")
 		;
 
 		po::variables_map vm;
@@ -316,11 +758,24 @@ int main(int argc, char *argv[])
 		boost::filesystem::create_directory(outputPath);
 	}
 	
-	std::chrono::time_point<std::chrono::system_clock> start, end;
-	Mat img;
-	vector<imageio::ModelLandmark> landmarks;
 	float lambda = config.get_child("fitting", ptree()).get<float>("lambda", 15.0f);
 
+	// Optional: Fit one identity jointly to all the images (e.g. the frames of a video), instead of fitting every image on its own
+	boost::optional<ptree&> multiFrameConfig = config.get_child_optional("fitting.multiFrame");
+	shared_ptr<fitting::MultiFrameShapeFitting> multiFrameFitting;
+	if (multiFrameConfig) {
+		std::size_t windowSize = multiFrameConfig->get<std::size_t>("windowSize", 0);
+		float residualLambda = multiFrameConfig->get<float>("residualLambda", 0.0f);
+		multiFrameFitting = make_shared<fitting::MultiFrameShapeFitting>(morphableModel, lambda, windowSize, residualLambda);
+		appLogger.info("Fitting the identity jointly over " + (windowSize > 0 ? "the last " + lexical_cast<string>(windowSize) : string("all")) + " images.");
+	}
+
+	// Optional: Fuse the isomaps of all images into one (e.g. the frames of a video), weighted by the viewing angle, the distance to occlusion edges and the sharpness
+	shared_ptr<render::IsomapFusion> isomapFusion;
+	if (config.get_child("output", ptree()).get<bool>("fusedIsomap", false)) {
+		isomapFusion = make_shared<render::IsomapFusion>(512, 0); // same resolution as extractTexture(...), all hardware threads
+	}
+
 	//LandmarkMapper landmarkMapper(landmarkMappings);
 	LandmarkMapper landmarkMapper;
 	if (!landmarkMappings.empty()) {
@@ -328,145 +783,131 @@ int main(int argc, char *argv[])
 		landmarkMapper = LandmarkMapper(landmarkMappings);
 	} // Ideas for a better solution: A flag in LandmarkMapper, or polymorphism (IdentityLandmarkMapper), or in Mapper, if mapping empty, return input?, or...?
 
-	while (labeledImageSource->next()) {
-		start = std::chrono::system_clock::now();
-		appLogger.info("Starting to process " + labeledImageSource->getName().string());
-		img = labeledImageSource->getImage();
-
-		LandmarkCollection lms = labeledImageSource->getLandmarks();
-		LandmarkCollection didLms;
-		if (!landmarkMappings.empty()) {
-			didLms = landmarkMapper.convert(lms);
-		}
-		else {
-			didLms = lms;
-		}
-
-		landmarks.clear();
-		Mat landmarksImage = img.clone(); // blue rect = the used landmarks
-		for (const auto& lm : didLms.getLandmarks()) {
-			lm->draw(landmarksImage);
-			landmarks.emplace_back(imageio::ModelLandmark(lm->getName(), lm->getPosition2D()));
-			cv::rectangle(landmarksImage, cv::Point(cvRound(lm->getX() - 2.0f), cvRound(lm->getY() - 2.0f)), cv::Point(cvRound(lm->getX() + 2.0f), cvRound(lm->getY() + 2.0f)), cv::Scalar(255, 0, 0));
-			//cv::putText(landmarksImage, lm->getName(), cv::Point(lm->getX(), lm->getY()), cv::FONT_HERSHEY_COMPLEX_SMALL, 0.5, cv::Scalar(0.0, 0.0, 255.0));
-		}
-
-		// Start affine camera estimation (Aldrian paper)
-		Mat affineCamLandmarksProjectionImage = landmarksImage.clone(); // the affine LMs are currently not used (don't know how to render without z-vals)
+	if (numWorkers == 0) {
+		numWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	if (multiFrameFitting && numWorkers > 1) {
+		appLogger.warn("The multi-frame fitting needs the images one at a time and in order, using one worker.");
+		numWorkers = 1;
+	}
 
-		// Convert the landmarks to clip-space, and only convert the ones that exist in the model
-		vector<imageio::ModelLandmark> landmarksClipSpace;
-		for (const auto& lm : landmarks) {
-			if (morphableModel.getShapeModel().landmarkExists(lm.getName())) {
-				cv::Vec2f clipCoords = render::utils::screenToClipSpace(lm.getPosition2D(), img.cols, img.rows);
-				landmarksClipSpace.push_back(imageio::ModelLandmark(lm.getName(), Vec3f(clipCoords[0], clipCoords[1], 0.0f), lm.isVisible()));
+	if (numWorkers == 1) {
+		std::chrono::time_point<std::chrono::system_clock> start, end;
+		FittingWorker worker(landmarkMapper);
+		std::size_t index = 0;
+		while (labeledImageSource->next()) {
+			start = std::chrono::system_clock::now();
+			appLogger.info("Starting to process " + labeledImageSource->getName().string());
+			FittingInput input = readInput(*labeledImageSource, index++);
+			FittingResult result = fitImage(input, morphableModel, !landmarkMappings.empty(), lambda, multiFrameFitting, worker);
+			if (!result.error.empty()) {
+				appLogger.error("Could not process " + result.name.string() + ": " + result.error);
+				continue;
 			}
+			writeResult(result, outputPath, config, lambda, static_cast<bool>(multiFrameFitting), isomapFusion);
+			end = std::chrono::system_clock::now();
+			int elapsed_mseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+			appLogger.info("Finished processing. Elapsed time: " + lexical_cast<string>(elapsed_mseconds)+"ms.");
 		}
+	}
+	else {
+		// Batch mode: One thread reads the images, the workers fit them, and another thread writes the results
+		// in the order of the input. The queues between the stages are bounded, so only a few images are in memory.
+		appLogger.info("Fitting " + lexical_cast<string>(numWorkers) + " images in parallel.");
+		logging::Tracers->setEnabled(true);
+		auto batchStart = std::chrono::steady_clock::now();
+		BoundedQueue<FittingInput> inputs(2 * numWorkers);
+		ReorderBuffer<FittingResult> results(2 * numWorkers);
+		std::size_t numImages = 0;
+		// The first exception of any thread. The queues are closed then, so the other threads stop instead of
+		// waiting for each other, and it is re-thrown after all of them finished.
+		std::exception_ptr error;
+		std::mutex errorMutex;
+		auto fail = [&](std::exception_ptr exception) {
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error) {
+					error = exception;
+				}
+			}
+			inputs.close();
+			results.close();
+		};
 
-		Mat affineCam = fitting::estimateAffineCamera(landmarksClipSpace, morphableModel);
-
-		// Render the mean-face landmarks projected using the estimated camera:
-		// Todo/Note: Here we render all landmarks. Shouldn't we only render the ones that exist in the model? (see above, landmarksClipSpace)
-		for (const auto& lm : landmarks) {
-			Vec3f modelPoint;
+		std::thread reader([&]() {
 			try {
-				modelPoint = morphableModel.getShapeModel().getMeanAtPoint(lm.getName());
+				while (labeledImageSource->next()) {
+					if (!inputs.push(readInput(*labeledImageSource, numImages++))) {
+						break;
+					}
+				}
+				inputs.close();
 			}
-			catch (std::out_of_range& e) {
-				continue;
+			catch (...) {
+				fail(std::current_exception());
 			}
-			cv::Vec2f screenPoint = fitting::projectAffine(modelPoint, affineCam, img.cols, img.rows);
-			cv::circle(affineCamLandmarksProjectionImage, Point2f(screenPoint), 4.0f, Scalar(0.0f, 255.0f, 0.0f));
+		});
+		vector<std::thread> workers;
+		for (unsigned int i = 0; i < numWorkers; ++i) {
+			workers.emplace_back([&]() {
+				try {
+					FittingWorker worker(landmarkMapper);
+					FittingInput input;
+					while (inputs.pop(input)) {
+						std::size_t index = input.index;
+						if (!results.push(index, fitImage(input, morphableModel, !landmarkMappings.empty(), lambda, multiFrameFitting, worker))) {
+							break;
+						}
+					}
+				}
+				catch (...) {
+					fail(std::current_exception());
+				}
+			});
 		}
+		std::thread writer([&]() {
+			try {
+				FittingResult result;
+				while (results.pop(result)) {
+					if (!result.error.empty()) {
+						appLogger.error("Could not process " + result.name.string() + ": " + result.error);
+						continue;
+					}
+					writeResult(result, outputPath, config, lambda, static_cast<bool>(multiFrameFitting), isomapFusion);
+					appLogger.info("Finished processing " + result.name.string() + ". Fitting time: " + lexical_cast<string>(static_cast<int>(result.fittingTime)) + "ms.");
+				}
+			}
+			catch (...) {
+				fail(std::current_exception());
+			}
+		});
 
-		// Estimate the shape coefficients:
-		// Detector variances: Should not be in pixels. Should be normalised by the IED. Normalise by the image dimensions is not a good idea either, it has nothing to do with it. See comment in fitShapeToLandmarksLinear().
-		// Let's just use the hopefully reasonably set default value for now (around 3 pixels)
-		vector<float> fittedCoeffs = fitting::fitShapeToLandmarksLinear(morphableModel, affineCam, landmarksClipSpace, lambda);
-
-		// Obtain the full mesh and render it using the estimated camera:
-		Mesh mesh = morphableModel.drawSample(fittedCoeffs, vector<float>()); // takes standard-normal (not-normalised) coefficients
-
-		render::SoftwareRenderer softwareRenderer(img.cols, img.rows);
-		Mat fullAffineCam = fitting::calculateAffineZDirection(affineCam);
-		fullAffineCam.at<float>(2, 3) = fullAffineCam.at<float>(2, 2); // Todo: Find out and document why this is necessary!
-		fullAffineCam.at<float>(2, 2) = 1.0f;
-		softwareRenderer.doBackfaceCulling = true;
-		auto framebuffer = softwareRenderer.render(mesh, fullAffineCam); // hmm, do we have the z-test disabled?
-		Mat renderedModel = framebuffer.first.clone(); // we save that later, and the framebuffer gets overwritten
-
-		// Extract the texture
-		// Todo: check for if hasTexture, we can't do it if the model doesn't have texture coordinates
-		Mat textureMap = render::utils::extractTexture(mesh, fullAffineCam, img.cols, img.rows, img, framebuffer.second);
-
-		// Save the extracted texture map (isomap):
-		path isomapFilename = outputPath / labeledImageSource->getName().stem();
-		isomapFilename += "_isomap.png";
-		cv::imwrite(isomapFilename.string(), textureMap);
-
-		// Render the shape-model with the extracted texture from a frontal viewpoint:
-		float aspect = static_cast<float>(img.cols) / static_cast<float>(img.rows);
-		Mat frontalCam = render::utils::MatrixUtils::createOrthogonalProjectionMatrix(-1.0f * aspect, 1.0f * aspect, -1.0f, 1.0f, 0.1f, 100.0f) * render::utils::MatrixUtils::createScalingMatrix(1.0f / 120.0f, 1.0f / 120.0f, 1.0f / 120.0f);
-		softwareRenderer.enableTexturing(true);
-		auto texture = make_shared<render::Texture>();
-		texture->createFromFile(isomapFilename.string());
-		softwareRenderer.setCurrentTexture(texture);
-		auto frFrontal = softwareRenderer.render(mesh, frontalCam);
-
-		// Write the fitting output files containing:
-		// - Camera parameters, fitting parameters, shape coefficients
-		ptree fittingFile;
-		fittingFile.put("camera", string("affine"));
-		fittingFile.put("camera.matrix", affineCameraMatrixToString(fullAffineCam));
-
-		fittingFile.put("imageWidth", img.cols);
-		fittingFile.put("imageHeight", img.rows);
-
-		fittingFile.put("fittingParameters.lambda", lambda);
-
-		fittingFile.put("textureMap", isomapFilename.filename().string());
-		fittingFile.put("model", config.get_child("morphableModel").get<string>("filename")); // This can throw, but the filename should really exist.
-
-		// alphas:
-		fittingFile.put("shapeCoefficients", "");
-		for (size_t i = 0; i < fittedCoeffs.size(); ++i) {
-			fittingFile.put("shapeCoefficients." + std::to_string(i), fittedCoeffs[i]);
-		}
-
-		// Save the fitting file
-		path fittingFileName = outputPath / labeledImageSource->getName().stem();
-		fittingFileName += ".txt";
-		boost::property_tree::write_info(fittingFileName.string(), fittingFile);
-
-		// Additional optional output, as set in the config file:
-		if (config.get_child("output", ptree()).get<bool>("copyInputImage", false)) {
-			path outInputImage = outputPath / labeledImageSource->getName().filename();
-			cv::imwrite(outInputImage.string(), img);
-		}
-		if (config.get_child("output", ptree()).get<bool>("landmarksImage", false)) {
-			path outLandmarksImage = outputPath / labeledImageSource->getName().stem();
-			outLandmarksImage += "_landmarks.png";
-			cv::imwrite(outLandmarksImage.string(), affineCamLandmarksProjectionImage);
-		}
-		if (config.get_child("output", ptree()).get<bool>("writeObj", false)) {
-			path outMesh = outputPath / labeledImageSource->getName().stem();
-			outMesh.replace_extension("obj");
-			Mesh::writeObj(mesh, outMesh.string());
+		reader.join();
+		for (auto& worker : workers) {
+			worker.join();
 		}
-		if (config.get_child("output", ptree()).get<bool>("renderResult", false)) {
-			path outRenderResult = outputPath / labeledImageSource->getName().stem();
-			outRenderResult += "_render.png";
-			cv::imwrite(outRenderResult.string(), renderedModel);
-		}
-		if (config.get_child("output", ptree()).get<bool>("frontalRendering", false)) {
-			path outFrontalRenderResult = outputPath / labeledImageSource->getName().stem();
-			outFrontalRenderResult += "_render_frontal.png";
-			cv::imwrite(outFrontalRenderResult.string(), frFrontal.first);
+		results.close();
+		writer.join();
+		if (error) {
+			try {
+				std::rethrow_exception(error);
+			}
+			catch (const std::exception& e) {
+				appLogger.error(string("The batch fitting was stopped: ") + e.what());
+				return EXIT_FAILURE;
+			}
+			catch (...) {
+				appLogger.error("The batch fitting was stopped by an unknown error.");
+				return EXIT_FAILURE;
+			}
 		}
-
-		end = std::chrono::system_clock::now();
-		int elapsed_mseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-		appLogger.info("Finished processing. Elapsed time: " + lexical_cast<string>(elapsed_mseconds)+"ms.");
+		double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+		logThroughput(appLogger, numImages, elapsedSeconds, numWorkers);
+	}
+	if (isomapFusion && isomapFusion->getNumFrames() > 0) {
+		path fusedIsomapFilename = outputPath / "fused_isomap.png";
+		cv::imwrite(fusedIsomapFilename.string(), isomapFusion->getIsomap());
+		appLogger.info("Fused the isomaps of " + lexical_cast<string>(isomapFusion->getNumFrames()) + " images into " + fusedIsomapFilename.string() + ".");
 	}
 	return 0;
 }
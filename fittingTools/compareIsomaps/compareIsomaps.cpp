@@ -47,6 +47,9 @@
 #include <memory>
 #include <vector>
 #include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
 
 namespace po = boost::program_options;
 namespace fs = boost::filesystem;
@@ -61,6 +64,19 @@ using std::string;
 using std::make_shared;
 using std::vector;
 
+/**
+ * Loads an isomap and converts it to float, so the differences do not saturate.
+ */
+Mat loadIsomap(const path& filename)
+{
+	Mat isomap = cv::imread(filename.string());
+	if (isomap.empty()) {
+		throw std::runtime_error("Could not read the isomap " + filename.string());
+	}
+	isomap.convertTo(isomap, CV_32FC3);
+	return isomap;
+}
+
 
 int main(int argc, char *argv[])
 {
@@ -70,6 +86,9 @@ int main(int argc, char *argv[])
 	#endif
 		
 	string verboseLevelConsole;
+	path fusedIsomap;
+	path groundtruthIsomap;
+	path frameIsomaps;
 
 	try {
 		po::options_description desc("Allowed options");
@@ -78,6 +97,12 @@ int main(int argc, char *argv[])
 				"produce help message")
 			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO", "show messages with INFO loglevel or below."),
 				"specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("fused,f", po::value<path>(&fusedIsomap),
+				"fused isomap (e.g. fused_isomap.png of the fitter) to evaluate against the ground-truth isomap instead of comparing the hard-coded lists")
+			("groundtruth,g", po::value<path>(&groundtruthIsomap),
+				"ground-truth isomap (e.g. of a frontal image) for the evaluation of a fused isomap")
+			("frames,i", po::value<path>(&frameIsomaps),
+				"directory containing the single-image isomaps (*_isomap.png) that were fused, to compare the fused isomap with each of them")
 			;
 
 		po::variables_map vm;
@@ -113,6 +138,43 @@ int main(int argc, char *argv[])
 
 	appLogger.debug("Verbose level for console output: " + logging::logLevelToString(logLevel));
 
+	if (!fusedIsomap.empty()) {
+		// Evaluation of a fused isomap: its difference to the ground truth, compared to the differences of the single-image isomaps
+		if (groundtruthIsomap.empty()) {
+			appLogger.error("Evaluating a fused isomap requires a ground-truth isomap.");
+			return EXIT_FAILURE;
+		}
+		try {
+			Mat groundtruth = loadIsomap(groundtruthIsomap);
+			double fusedNorm = cv::norm(loadIsomap(fusedIsomap), groundtruth, cv::NORM_L2);
+			appLogger.info("Difference norm of the fused isomap: " + std::to_string(fusedNorm));
+			if (!frameIsomaps.empty()) {
+				vector<double> frameNorms;
+				for (fs::directory_iterator it(frameIsomaps), end; it != end; ++it) {
+					string filename = it->path().filename().string();
+					if (!boost::algorithm::ends_with(filename, "_isomap.png") || it->path().filename() == fusedIsomap.filename()) {
+						continue;
+					}
+					double norm = cv::norm(loadIsomap(it->path()), groundtruth, cv::NORM_L2);
+					appLogger.debug("Difference norm of " + filename + ": " + std::to_string(norm));
+					frameNorms.push_back(norm);
+				}
+				if (frameNorms.empty()) {
+					appLogger.error("There are no single-image isomaps in " + frameIsomaps.string());
+					return EXIT_FAILURE;
+				}
+				double bestNorm = *std::min_element(frameNorms.begin(), frameNorms.end());
+				double meanNorm = std::accumulate(frameNorms.begin(), frameNorms.end(), 0.0) / frameNorms.size();
+				appLogger.info("Difference norm of the " + std::to_string(frameNorms.size()) + " single-image isomaps: best " + std::to_string(bestNorm) + ", mean " + std::to_string(meanNorm));
+			}
+		}
+		catch (std::exception& e) {
+			appLogger.error(e.what());
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
 	path testList(R"(C:\Users\Patrik\Documents\GitHub\experiments\MultiPIE\lists\probe_p15.txt)"); // only the basename gets used
 	path groundtruthList(R"(C:\Users\Patrik\Documents\GitHub\experiments\MultiPIE\lists\gallery_frontal.txt)"); // only the basename gets used
 
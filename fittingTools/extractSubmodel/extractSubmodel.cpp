@@ -0,0 +1,176 @@
+/*
+ * extractSubmodel.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifdef WIN32
+	#include <SDKDDKVer.h>
+#endif
+
+#include "morphablemodel/MorphableModel.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/property_tree/ptree.hpp"
+#include "boost/property_tree/info_parser.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include <exception>
+
+namespace po = boost::program_options;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+using cv::Mat;
+using boost::property_tree::ptree;
+using boost::filesystem::path;
+using boost::lexical_cast;
+using std::cout;
+using std::endl;
+using std::string;
+using std::make_shared;
+using std::vector;
+
+/**
+ * Extracts a submodel from a Morphable Model, e.g. only the face region
+ * without the neck, ears and back of the head, and saves it in the .scm
+ * format. The vertices are selected by a list of vertex ids, a mask on
+ * the isomap and/or a radius around landmark vertices. If several are
+ * given, the union of the selected vertices is kept.
+ *
+ * Besides the .scm file, it writes the texture coordinates (<stem>_isomap.txt)
+ * and the vertex ids of the original model (<stem>_vertexIds.txt). Give the
+ * latter as "vertexIds" in the morphableModel config of the fitter, so the
+ * landmarks of the original model can be used with the submodel.
+ */
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	path configFilename;
+	path vertexIdsFilename;
+	path isomapMaskFilename;
+	vector<string> landmarks;
+	float radius;
+	path outputFilename;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO", "show messages with INFO loglevel or below."),
+				"specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("config,c", po::value<path>(&configFilename)->required(),
+				"a config file containing a 'morphableModel' node (e.g. the config of the fitter)")
+			("vertices", po::value<path>(&vertexIdsFilename),
+				"a text file with the vertex ids to keep, one per line")
+			("isomap-mask", po::value<path>(&isomapMaskFilename),
+				"a mask image in the layout of the isomap, the vertices on non-zero pixels are kept")
+			("landmarks", po::value<vector<string>>(&landmarks)->multitoken(),
+				"landmark identifiers (vertex ids), the vertices within the radius around them are kept")
+			("radius", po::value<float>(&radius)->default_value(0.0f),
+				"the radius around the landmarks, in model units")
+			("output,o", po::value<path>(&outputFilename)->required(),
+				"the .scm file to write the submodel to")
+			;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: extractSubmodel [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+		if (!vm.count("vertices") && !vm.count("isomap-mask") && !vm.count("landmarks")) {
+			cout << "Error: At least one of --vertices, --isomap-mask or --landmarks has to be given." << endl;
+			return EXIT_FAILURE;
+		}
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid LogLevel." << endl;
+		return EXIT_FAILURE;
+	}
+
+	Loggers->getLogger("morphablemodel").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("extractSubmodel").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("extractSubmodel");
+
+	appLogger.debug("Verbose level for console output: " + logging::logLevelToString(logLevel));
+
+	morphablemodel::MorphableModel morphableModel;
+	try {
+		ptree config;
+		boost::property_tree::info_parser::read_info(configFilename.string(), config);
+		morphableModel = morphablemodel::MorphableModel::load(config.get_child("morphableModel"));
+	}
+	catch (const std::exception& e) {
+		appLogger.error("Error loading the Morphable Model: " + string(e.what()));
+		return EXIT_FAILURE;
+	}
+
+	vector<int> vertexIds;
+	try {
+		if (!vertexIdsFilename.empty()) {
+			vector<int> listedVertexIds = morphablemodel::MorphableModel::loadVertexIds(vertexIdsFilename);
+			appLogger.info("Vertex list: " + lexical_cast<string>(listedVertexIds.size()) + " vertices.");
+			vertexIds.insert(end(vertexIds), begin(listedVertexIds), end(listedVertexIds));
+		}
+		if (!isomapMaskFilename.empty()) {
+			Mat mask = cv::imread(isomapMaskFilename.string(), 0); // load as grayscale
+			if (mask.empty()) {
+				appLogger.error("Could not load the isomap mask: " + isomapMaskFilename.string());
+				return EXIT_FAILURE;
+			}
+			vector<int> maskVertexIds = morphableModel.getVerticesInIsomapMask(mask);
+			appLogger.info("Isomap mask: " + lexical_cast<string>(maskVertexIds.size()) + " vertices.");
+			vertexIds.insert(end(vertexIds), begin(maskVertexIds), end(maskVertexIds));
+		}
+		if (!landmarks.empty()) {
+			vector<int> landmarkVertexIds = morphableModel.getVerticesAroundLandmarks(landmarks, radius);
+			appLogger.info("Landmarks: " + lexical_cast<string>(landmarkVertexIds.size()) + " vertices within a radius of " + lexical_cast<string>(radius) + ".");
+			vertexIds.insert(end(vertexIds), begin(landmarkVertexIds), end(landmarkVertexIds));
+		}
+
+		morphablemodel::MorphableModel submodel = morphableModel.extractSubmodel(vertexIds);
+		path isomapFilename = outputFilename.parent_path() / path(outputFilename.stem().string() + "_isomap.txt");
+		path outputVertexIdsFilename = outputFilename.parent_path() / path(outputFilename.stem().string() + "_vertexIds.txt");
+		submodel.saveScmModel(outputFilename, isomapFilename, outputVertexIdsFilename);
+		appLogger.info("Saved the submodel with " + lexical_cast<string>(submodel.getShapeModel().getDataDimension() / 3) + " of " + lexical_cast<string>(morphableModel.getShapeModel().getDataDimension() / 3) + " vertices to " + outputFilename.string() + ".");
+	}
+	catch (const std::exception& e) {
+		appLogger.error("Error extracting the submodel: " + string(e.what()));
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
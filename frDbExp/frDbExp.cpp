@@ -41,6 +41,10 @@
 #include "imageio/LandmarkFileGatherer.hpp"
 #include "imageio/DidLandmarkFormatParser.hpp"
 
+#include "facerecognition/FaceRecord.hpp"
+#include "facerecognition/ScoreNormalization.hpp"
+#include "facerecognition/utils.hpp"
+
 #include "logging/LoggerFactory.hpp"
 
 #ifdef WIN32
@@ -62,8 +66,11 @@
 #include <fstream>
 #include <chrono>
 #include <unordered_map>
+#include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <limits>
+#include <tuple>
 
 namespace po = boost::program_options;
 using namespace std;
@@ -71,6 +78,9 @@ using namespace imageio;
 using logging::Logger;
 using logging::LoggerFactory;
 using logging::LogLevel;
+using facerecognition::FaceRecord;
+using facerecognition::ScoreNormalization;
+using cv::Mat;
 using boost::make_indirect_iterator;
 using boost::property_tree::ptree;
 using boost::property_tree::info_parser::read_info;
@@ -108,6 +118,133 @@ void writeAscii(path filename, vector<float> positiveScores, vector<float> negat
 
 
 
+/**
+ * Reads the identifiers and subjects of the records that fulfil the given condition.
+ */
+vector<FaceRecord> queryRecords(QSqlQuery& query, string condition)
+{
+	vector<FaceRecord> records;
+	if (!query.exec(QString::fromStdString("SELECT r.identifier, r.subject FROM records r WHERE " + condition))) {
+		cout << query.lastError().text().toStdString() << endl;
+	}
+	while (query.next()) {
+		FaceRecord record;
+		record.identifier = query.value(0).toString().toStdString();
+		record.subjectId = query.value(1).toString().toStdString();
+		records.push_back(record);
+	}
+	return records;
+}
+
+/**
+ * Reads all scores of an algorithm with a single query, keyed by the probe and
+ * gallery identifier. Failures to enroll are left out.
+ */
+unordered_map<string, float> queryScores(QSqlQuery& query, string algorithm)
+{
+	unordered_map<string, float> scores;
+	if (!query.exec(QString::fromStdString("SELECT s.* FROM scores s WHERE s.algorithm='" + algorithm + "'"))) {
+		cout << query.lastError().text().toStdString() << endl;
+	}
+	while (query.next()) {
+		if (query.value(3).toInt() != 1) {
+			scores.emplace(query.value(0).toString().toStdString() + '\n' + query.value(1).toString().toStdString(), query.value(2).toFloat());
+		}
+	}
+	return scores;
+}
+
+/**
+ * Creates the dense score matrix of the given probes (rows) against the
+ * gallery (columns). Missing scores are NaN.
+ */
+Mat createScoreMatrix(const unordered_map<string, float>& scores, const vector<FaceRecord>& probes, const vector<FaceRecord>& gallery)
+{
+	Mat scoreMatrix(static_cast<int>(probes.size()), static_cast<int>(gallery.size()), CV_32FC1);
+	for (int row = 0; row < scoreMatrix.rows; ++row) {
+		float* rowScores = scoreMatrix.ptr<float>(row);
+		for (int col = 0; col < scoreMatrix.cols; ++col) {
+			auto score = scores.find(probes[row].identifier + '\n' + gallery[col].identifier);
+			rowScores[col] = score != scores.end() ? score->second : std::numeric_limits<float>::quiet_NaN();
+		}
+	}
+	return scoreMatrix;
+}
+
+/**
+ * Evaluates the scores with cohort-based normalization. In contrast to the SQL
+ * statistics in main(), the scores are loaded once into dense matrices, which are
+ * normalized and then split into the genuine and impostor scores for the DET curve.
+ * Probes with missing scores are counted as failures to enroll.
+ */
+void evaluateNormalized(QSqlQuery& query, ScoreNormalization::Method method, path zCohortSigset, path tCohortSigset, path outputFile)
+{
+	string algorithm = "Full_FVSDK_8_7_0";
+	vector<FaceRecord> probes = queryRecords(query, "r.roll=0.0 AND r.pitch=0.0 AND (r.yaw=15.0 OR r.yaw=30.0 OR r.yaw=45.0 OR r.yaw=60.0)");
+	vector<FaceRecord> gallery = queryRecords(query, "r.roll=0.0 AND r.pitch=0.0 AND r.yaw=0.0");
+	bool useZCohort = method == ScoreNormalization::Method::Z_NORM || method == ScoreNormalization::Method::ZT_NORM;
+	bool useTCohort = method == ScoreNormalization::Method::T_NORM || method == ScoreNormalization::Method::ZT_NORM;
+	vector<FaceRecord> zCohort;
+	vector<FaceRecord> tCohort;
+	if (useZCohort) {
+		zCohort = facerecognition::utils::readSigset(zCohortSigset);
+	}
+	if (useTCohort) {
+		tCohort = facerecognition::utils::readSigset(tCohortSigset);
+	}
+	unordered_map<string, float> allScores = queryScores(query, algorithm);
+
+	// Probes without a complete row of scores failed to enroll
+	Mat probeScores = createScoreMatrix(allScores, probes, gallery);
+	Mat probeTCohortScores = createScoreMatrix(allScores, probes, tCohort);
+	Mat scores, probeCohortScores;
+	vector<FaceRecord> enrolledProbes;
+	int numFailureToEnroll = 0;
+	for (int row = 0; row < probeScores.rows; ++row) {
+		if (cv::checkRange(probeScores.row(row)) && (!useTCohort || cv::checkRange(probeTCohortScores.row(row)))) {
+			scores.push_back(probeScores.row(row));
+			if (useTCohort) {
+				probeCohortScores.push_back(probeTCohortScores.row(row));
+			}
+			enrolledProbes.push_back(probes[row]);
+		} else {
+			++numFailureToEnroll;
+		}
+	}
+	Mat galleryCohortScores = createScoreMatrix(allScores, zCohort, gallery);
+	Mat cohortCohortScores = createScoreMatrix(allScores, zCohort, tCohort);
+	if (!cv::checkRange(galleryCohortScores) || !cv::checkRange(cohortCohortScores)) {
+		throw std::runtime_error("The scores of the cohort are incomplete, the cohort records need a score against every gallery and T-cohort record.");
+	}
+
+	ScoreNormalization normalization;
+	Mat normalizedScores = normalization.normalize(method, scores, galleryCohortScores, probeCohortScores, cohortCohortScores);
+
+	vector<float> positiveScores;
+	vector<float> negativeScores;
+	std::tie(positiveScores, negativeScores) = facerecognition::splitGenuineImpostorScores(normalizedScores, enrolledProbes, gallery);
+	sort(begin(positiveScores), end(positiveScores), less<float>());
+	sort(begin(negativeScores), end(negativeScores), greater<float>());
+	writeAscii(outputFile, positiveScores, negativeScores, numFailureToEnroll, "Probes +15, +30, +45, +60 yaw, with FTEs, normalized", "yaw=+15,30,45,60");
+
+	int rank1Matches = 0;
+	for (int row = 0; row < normalizedScores.rows; ++row) {
+		cv::Point bestMatch;
+		cv::minMaxLoc(normalizedScores.row(row), nullptr, nullptr, nullptr, &bestMatch);
+		if (enrolledProbes[row].subjectId == gallery[bestMatch.x].subjectId) {
+			++rank1Matches;
+		}
+	}
+	int numProbes = static_cast<int>(probes.size());
+	cout << "Probes: " << numProbes << ", FTE: " << numFailureToEnroll << ", rank-1 matches: " << rank1Matches << ", no rank-1 matches: " << normalizedScores.rows - rank1Matches << endl;
+	if (numProbes > 0)
+		cout << "rank-1 id percent with fte: " << (float)rank1Matches / (float)numProbes << endl;
+	if (numProbes > numFailureToEnroll)
+		cout << "rank-1 id percent without fte: " << (float)rank1Matches / ((float)numProbes - (float)numFailureToEnroll) << endl;
+	else
+		cout << "rank-1 id percent without fte: undefined, every probe is a failure to enroll" << endl;
+}
+
 int main(int argc, char *argv[])
 {
 	#ifdef WIN32
@@ -115,10 +252,23 @@ int main(int argc, char *argv[])
 	//_CrtSetBreakAlloc(3759128);
 	#endif
 		
+	string normalizationName;
+	path zCohortSigset;
+	path tCohortSigset;
+	path outputFile;
+	ScoreNormalization::Method normalizationMethod;
 	try {
         po::options_description desc("Allowed options");
         desc.add_options()
             ("help,h", "Produce help message.")
+            ("normalization,n", po::value<string>(&normalizationName)->default_value("none"),
+                "Score normalization: none, z, t or zt. Anything but none evaluates dense score matrices instead of the SQL statistics.")
+            ("z-cohort,z", po::value<path>(&zCohortSigset),
+                "Sigset of the Z-cohort (probes scored against the gallery and the T-cohort), needed for z and zt.")
+            ("t-cohort,t", po::value<path>(&tCohortSigset),
+                "Sigset of the T-cohort (templates the probes are scored against), needed for t and zt.")
+            ("output,o", po::value<path>(&outputFile)->default_value("C:/Users/Patrik/Documents/Github/experiments/MultiPIE/00_00002013_FaceVACS_8_7_0_Baseline/scores/p15_30_45_60_normalized.txt"),
+                "Score file for the DET curve of the normalized scores.")
         ;
 
         po::variables_map vm;
@@ -132,6 +282,15 @@ int main(int argc, char *argv[])
             return 0;
         }
 
+        try {
+            normalizationMethod = ScoreNormalization::parseMethod(normalizationName);
+        }
+        catch (std::invalid_argument& e) {
+            cout << e.what() << "\n";
+            cout << "[frDbExp] Usage: frDbExp [options]\n";
+            cout << desc;
+            return 1;
+        }
     }
     catch(std::exception& e) {
         cout << e.what() << "\n";
@@ -152,6 +311,19 @@ int main(int argc, char *argv[])
 		cout << query.lastError().text().toStdString() << endl;
 	}
 
+	if (normalizationMethod != ScoreNormalization::Method::NONE) {
+		query.setForwardOnly(true);
+		try {
+			evaluateNormalized(query, normalizationMethod, zCohortSigset, tCohortSigset, outputFile);
+		}
+		catch (std::exception& e) {
+			cout << e.what() << endl;
+		}
+		db.close();
+		QSqlDatabase::removeDatabase("QSQLITE");
+		return 0;
+	}
+
 	vector<float> positiveScores;
 	vector<float> negativeScores;
 	int numFailureToEnroll = 0;
@@ -0,0 +1,263 @@
+/*
+ * gradientSumCheck.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "imageprocessing/DirectPyramidFeatureExtractor.hpp"
+#include "imageprocessing/DirectImageFeatureExtractor.hpp"
+#include "imageprocessing/IntegralFeatureExtractor.hpp"
+#include "imageprocessing/ImagePyramid.hpp"
+#include "imageprocessing/ImagePyramidLayer.hpp"
+#include "imageprocessing/Patch.hpp"
+#include "imageprocessing/GrayscaleFilter.hpp"
+#include "imageprocessing/GradientFilter.hpp"
+#include "imageprocessing/GradientSumFilter.hpp"
+#include "imageprocessing/IntegralImageFilter.hpp"
+#include "imageprocessing/IntegralGradientFilter.hpp"
+#include "imageprocessing/IntegralGradientChannelFilter.hpp"
+#include "imageprocessing/IntegralGradientSumFilter.hpp"
+#include "imageprocessing/UnitNormFilter.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+using namespace imageprocessing;
+namespace po = boost::program_options;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using boost::lexical_cast;
+using cv::Mat;
+using cv::Size;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+
+/**
+ * Checks the integral gradient channels of the tracking feature 'psurf' against the per-patch filters on sample
+ * patches of an image.
+ *
+ * The patches are taken from random positions of random pyramid layers. On each patch, the cell sums that
+ * IntegralGradientSumFilter reads from the integral gradient channels of the layer are compared to the sums that
+ * GradientSumFilter computes from the gradient patch itself. Both work on the same dense layer gradients of
+ * GradientFilter and must be equal up to the float rounding of the per-pixel accumulation. Otherwise the check fails.
+ *
+ * In addition, the cosine similarity of the normalized psurf and surf features of random image patches is reported.
+ * surf computes box gradients on a grid that depends on each patch's size and position (IntegralGradientFilter) and
+ * psurf cannot share those between patches, so the two features are different and this part is not a pass/fail check.
+ */
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	string imageFile;
+	int patchWidth;
+	int patchHeight;
+	int minWidth;
+	int maxWidth;
+	int interval;
+	int cellCount;
+	int gradientCount;
+	int gradientKernel;
+	int blurKernel;
+	int sampleCount;
+	unsigned int seed;
+	double tolerance;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO","show messages with INFO loglevel or below."),
+				  "specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("image,i", po::value<string>(&imageFile)->required(),
+				"image to take the sample patches from")
+			("width", po::value<int>(&patchWidth)->default_value(30),
+				"patch width on the pyramid layers (pyramid.patch.width)")
+			("height", po::value<int>(&patchHeight)->default_value(30),
+				"patch height on the pyramid layers (pyramid.patch.height)")
+			("min-width", po::value<int>(&minWidth)->default_value(30),
+				"minimum patch width in the image (pyramid.patch.minWidth)")
+			("max-width", po::value<int>(&maxWidth)->default_value(480),
+				"maximum patch width in the image (pyramid.patch.maxWidth)")
+			("interval", po::value<int>(&interval)->default_value(5),
+				"number of pyramid layers per octave (pyramid.interval)")
+			("cells", po::value<int>(&cellCount)->default_value(6),
+				"row and column count of cells over which the gradients are summed (cellCount)")
+			("gradient-count", po::value<int>(&gradientCount)->default_value(30),
+				"row and column count of the box gradients of surf (gradientCount)")
+			("gradient-kernel", po::value<int>(&gradientKernel)->default_value(1),
+				"kernel size of the layer gradients (gradientKernel)")
+			("blur-kernel", po::value<int>(&blurKernel)->default_value(0),
+				"kernel size of the blur before computing the layer gradients (blurKernel)")
+			("samples,n", po::value<int>(&sampleCount)->default_value(1000),
+				"number of sample patches")
+			("seed", po::value<unsigned int>(&seed)->default_value(0),
+				"seed of the random number generator that chooses the patches")
+			("tolerance", po::value<double>(&tolerance)->default_value(1e-4),
+				"maximum difference of the cell sums, relative to the largest absolute sum of the patch (at least 1)")
+		;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: gradientSumCheck [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid log level." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	Loggers->getLogger("ImageProcessing").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("gradientSumCheck").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("gradientSumCheck");
+
+	try {
+		Mat image = cv::imread(imageFile);
+		if (image.empty()) {
+			appLogger.error("Could not read image file '" + imageFile + "'");
+			return EXIT_FAILURE;
+		}
+
+		// per-patch: dense layer gradients that are summed up for each patch
+		shared_ptr<DirectPyramidFeatureExtractor> perPatchExtractor = make_shared<DirectPyramidFeatureExtractor>(
+				patchWidth, patchHeight, minWidth, maxWidth, interval);
+		perPatchExtractor->addImageFilter(make_shared<GrayscaleFilter>());
+		perPatchExtractor->addLayerFilter(make_shared<GradientFilter>(gradientKernel, blurKernel));
+		perPatchExtractor->addPatchFilter(make_shared<GradientSumFilter>(cellCount));
+		perPatchExtractor->update(image);
+
+		// psurf: the same gradients, but integrated once per layer (set up like in the tracking apps)
+		shared_ptr<DirectPyramidFeatureExtractor> psurfExtractor = make_shared<DirectPyramidFeatureExtractor>(
+				patchWidth, patchHeight, minWidth, maxWidth, interval);
+		psurfExtractor->setPatchSize(patchWidth + 1, patchHeight + 1);
+		psurfExtractor->addImageFilter(make_shared<GrayscaleFilter>());
+		psurfExtractor->addLayerFilter(make_shared<GradientFilter>(gradientKernel, blurKernel));
+		psurfExtractor->addLayerFilter(make_shared<IntegralGradientChannelFilter>());
+		psurfExtractor->addPatchFilter(make_shared<IntegralGradientSumFilter>(cellCount));
+		psurfExtractor->update(image);
+
+		vector<int> layerIndices;
+		for (const shared_ptr<ImagePyramidLayer>& layer : psurfExtractor->getPyramid()->getLayers()) {
+			if (layer->getSize().width > patchWidth && layer->getSize().height > patchHeight)
+				layerIndices.push_back(layer->getIndex());
+		}
+		if (layerIndices.empty()) {
+			appLogger.error("The image is too small for a single patch");
+			return EXIT_FAILURE;
+		}
+
+		cv::RNG rng(seed);
+		int mismatches = 0;
+		double maxDifference = 0;
+		for (int i = 0; i < sampleCount; ++i) {
+			int layerIndex = layerIndices[rng.uniform(0, static_cast<int>(layerIndices.size()))];
+			Size layerSize = psurfExtractor->getPyramid()->getLayer(layerIndex)->getSize();
+			int x = rng.uniform(0, layerSize.width - patchWidth);
+			int y = rng.uniform(0, layerSize.height - patchHeight);
+			// both patches start at (x, y) of the layer, the integral one is larger by one row and column
+			shared_ptr<Patch> perPatch = perPatchExtractor->extract(layerIndex, x + patchWidth / 2, y + patchHeight / 2);
+			shared_ptr<Patch> integral = psurfExtractor->extract(layerIndex, x + (patchWidth + 1) / 2, y + (patchHeight + 1) / 2);
+			string position = "patch at (" + lexical_cast<string>(x) + ", " + lexical_cast<string>(y) + ") of layer " + lexical_cast<string>(layerIndex);
+			if (!perPatch || !integral) {
+				appLogger.error("Could not extract the " + position);
+				++mismatches;
+				continue;
+			}
+			double scale = std::max(1.0, cv::norm(perPatch->getData(), cv::NORM_INF));
+			double difference = cv::norm(perPatch->getData(), integral->getData(), cv::NORM_INF) / scale;
+			maxDifference = std::max(maxDifference, difference);
+			if (difference > tolerance) {
+				appLogger.error("The cell sums of the " + position + " differ by " + lexical_cast<string>(difference));
+				++mismatches;
+			}
+		}
+		appLogger.info("Checked " + lexical_cast<string>(sampleCount) + " layer patches: " + lexical_cast<string>(mismatches)
+				+ " mismatches, maximum relative difference " + lexical_cast<string>(maxDifference));
+
+		// surf: box gradients on a grid that depends on the patch size and position (not expected to be equal to psurf)
+		shared_ptr<DirectImageFeatureExtractor> surfImageExtractor = make_shared<DirectImageFeatureExtractor>();
+		surfImageExtractor->addImageFilter(make_shared<GrayscaleFilter>());
+		surfImageExtractor->addImageFilter(make_shared<IntegralImageFilter>());
+		surfImageExtractor->addPatchFilter(make_shared<IntegralGradientFilter>(gradientCount));
+		surfImageExtractor->addPatchFilter(make_shared<GradientSumFilter>(cellCount));
+		surfImageExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
+		IntegralFeatureExtractor surfExtractor(surfImageExtractor);
+		surfExtractor.update(image);
+		IntegralFeatureExtractor psurfImageExtractor(psurfExtractor);
+		UnitNormFilter unitNormFilter(cv::NORM_L2);
+
+		int maxSampleWidth = std::min(maxWidth, std::min(image.cols, image.rows * patchWidth / patchHeight) - 2);
+		if (maxSampleWidth < minWidth) {
+			appLogger.warn("The image is too small to compare psurf with surf");
+		} else {
+			int comparisons = 0;
+			double similaritySum = 0;
+			double minSimilarity = std::numeric_limits<double>::max();
+			for (int i = 0; i < sampleCount; ++i) {
+				int width = rng.uniform(minWidth, maxSampleWidth + 1);
+				int height = width * patchHeight / patchWidth;
+				int x = rng.uniform(width / 2 + 1, image.cols - width / 2 - 1);
+				int y = rng.uniform(height / 2 + 1, image.rows - height / 2 - 1);
+				shared_ptr<Patch> surf = surfExtractor.extract(x, y, width, height);
+				shared_ptr<Patch> psurf = psurfImageExtractor.extract(x, y, width, height);
+				if (!surf || !psurf)
+					continue;
+				double similarity = surf->getData().dot(unitNormFilter.applyTo(psurf->getData()));
+				similaritySum += similarity;
+				minSimilarity = std::min(minSimilarity, similarity);
+				++comparisons;
+			}
+			if (comparisons > 0)
+				appLogger.info("psurf compared to surf on " + lexical_cast<string>(comparisons) + " image patches: mean cosine similarity "
+						+ lexical_cast<string>(similaritySum / comparisons) + ", minimum " + lexical_cast<string>(minSimilarity) + " (for information only)");
+		}
+
+		if (mismatches > 0)
+			return EXIT_FAILURE;
+	}
+	catch (const std::exception& error) {
+		appLogger.error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
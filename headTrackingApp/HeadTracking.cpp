@@ -13,7 +13,6 @@
 #include "imageio/BobotLandmarkSource.hpp"
 #include "imageio/SingleLandmarkSource.hpp"
 #include "imageio/EmptyLandmarkSource.hpp"
-#include "imageio/CameraImageSource.hpp"
 #include "imageio/VideoImageSource.hpp"
 #include "imageio/KinectImageSource.hpp"
 #include "imageio/DirectoryImageSource.hpp"
@@ -40,6 +39,8 @@
 #include "imageprocessing/ExtendedHogFilter.hpp"
 #include "imageprocessing/IntegralGradientFilter.hpp"
 #include "imageprocessing/GradientSumFilter.hpp"
+#include "imageprocessing/IntegralGradientChannelFilter.hpp"
+#include "imageprocessing/IntegralGradientSumFilter.hpp"
 #include "imageprocessing/ImagePyramid.hpp"
 #include "imageprocessing/DirectImageFeatureExtractor.hpp"
 #include "imageprocessing/FilteringFeatureExtractor.hpp"
@@ -107,8 +108,9 @@ namespace po = boost::program_options;
 const string HeadTracking::videoWindowName = "Image";
 const string HeadTracking::controlWindowName = "Controls";
 
-HeadTracking::HeadTracking(unique_ptr<LabeledImageSource> imageSource, unique_ptr<ImageSink> imageSink, ptree& config) :
-		imageSource(move(imageSource)), imageSink(move(imageSink)) {
+HeadTracking::HeadTracking(unique_ptr<LabeledImageSource> imageSource, unique_ptr<ImageSink> imageSink, ptree& config,
+		shared_ptr<LiveCameraImageSource> liveImageSource) :
+		imageSource(move(imageSource)), imageSink(move(imageSink)), liveImageSource(liveImageSource) {
 	initTracking(config);
 	initGui();
 }
@@ -236,6 +238,15 @@ shared_ptr<FeatureExtractor> HeadTracking::createFeatureExtractor(
 		featureExtractor->addPatchFilter(make_shared<GradientSumFilter>(config.get<int>("cellCount")));
 		featureExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
 		return wrapFeatureExtractor(make_shared<IntegralFeatureExtractor>(featureExtractor), scaleFactor);
+	} else if (config.get_value<string>() == "psurf") { // not interchangeable with surf (dense layer gradients instead of box gradients)
+		shared_ptr<DirectPyramidFeatureExtractor> featureExtractor = createPyramidExtractor(
+				config.get_child("pyramid"), pyramid, true);
+		featureExtractor->setPatchSize(featureExtractor->getPatchWidth() + 1, featureExtractor->getPatchHeight() + 1);
+		featureExtractor->addLayerFilter(make_shared<GradientFilter>(config.get<int>("gradientKernel"), config.get<int>("blurKernel")));
+		featureExtractor->addLayerFilter(make_shared<IntegralGradientChannelFilter>());
+		featureExtractor->addPatchFilter(make_shared<IntegralGradientSumFilter>(config.get<int>("cellCount")));
+		featureExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
+		return wrapFeatureExtractor(make_shared<IntegralFeatureExtractor>(featureExtractor), scaleFactor);
 	} else if (config.get_value<string>() == "lbp") {
 		shared_ptr<DirectPyramidFeatureExtractor> featureExtractor = createPyramidExtractor(
 				config.get_child("pyramid"), pyramid, true);
@@ -932,6 +943,7 @@ void HeadTracking::run() {
 		} else {
 			frames++;
 			frame = imageSource->getImage();
+			updateTimeStep();
 			steady_clock::time_point condensationStart = steady_clock::now();
 			bool usedAdaptive = false;
 			bool adapted = false;
@@ -959,6 +971,8 @@ void HeadTracking::run() {
 			text.precision(2);
 			text << frames << " frame: " << iterationTime.count() << " ms (" << iterationFps << " fps);"
 					<< " condensation: " << condensationTime.count() << " ms (" << condensationFps << " fps)";
+			if (liveImageSource)
+				text << "; dropped: " << liveImageSource->getDroppedFrameCount();
 			log.info(text.str());
 
 			int delay = paused ? 0 : 5;
@@ -975,6 +989,20 @@ void HeadTracking::stop() {
 	running = false;
 }
 
+void HeadTracking::updateTimeStep() {
+	if (!liveImageSource)
+		return;
+	double frameInterval = liveImageSource->getFrameInterval();
+	if (frameInterval <= 0) // first frame
+		return;
+	double frameRate = liveImageSource->getFrameRate() > 0 ? liveImageSource->getFrameRate() : 30;
+	double timeStep = frameInterval * frameRate;
+	if (opticalFlowTransitionModel)
+		opticalFlowTransitionModel->setTimeStep(timeStep);
+	else
+		simpleTransitionModel->setTimeStep(timeStep);
+}
+
 int main(int argc, char *argv[]) {
 	int verboseLevelText;
 	int verboseLevelImages;
@@ -1046,9 +1074,11 @@ int main(int argc, char *argv[]) {
 	Loggers->getLogger("app").addAppender(make_shared<ConsoleAppender>(LogLevel::Info));
 
 	shared_ptr<ImageSource> imageSource;
-	if (useCamera)
-		imageSource.reset(new CameraImageSource(deviceId));
-	else if (useKinect)
+	shared_ptr<LiveCameraImageSource> liveImageSource;
+	if (useCamera) {
+		liveImageSource.reset(new LiveCameraImageSource(deviceId));
+		imageSource = liveImageSource;
+	} else if (useKinect)
 		imageSource.reset(new KinectImageSource(kinectId));
 	else if (useFile)
 		imageSource.reset(new VideoImageSource(filename));
@@ -1077,7 +1107,7 @@ int main(int argc, char *argv[]) {
 	if (useGroundTruth)
 		config.put("tracking.initial", "groundtruth");
 	try {
-		unique_ptr<HeadTracking> tracker(new HeadTracking(move(labeledImageSource), move(imageSink), config.get_child("tracking")));
+		unique_ptr<HeadTracking> tracker(new HeadTracking(move(labeledImageSource), move(imageSink), config.get_child("tracking"), liveImageSource));
 		tracker->run();
 	} catch (std::exception& exc) {
 		Loggers->getLogger("app").error(string("A wild exception appeared: ") + exc.what());
@@ -10,6 +10,7 @@
 
 #include "imageio/LabeledImageSource.hpp"
 #include "imageio/ImageSink.hpp"
+#include "imageio/LiveCameraImageSource.hpp"
 #include "imageio/LandmarkCollection.hpp"
 #include "imageprocessing/FeatureExtractor.hpp"
 #include "imageprocessing/DirectPyramidFeatureExtractor.hpp"
@@ -49,7 +50,8 @@ using std::make_shared;
 class HeadTracking {
 public:
 
-	HeadTracking(unique_ptr<LabeledImageSource> imageSource, unique_ptr<ImageSink> imageSink, ptree& config);
+	HeadTracking(unique_ptr<LabeledImageSource> imageSource, unique_ptr<ImageSink> imageSink, ptree& config,
+			shared_ptr<LiveCameraImageSource> liveImageSource = shared_ptr<LiveCameraImageSource>());
 	~HeadTracking();
 
 	void run();
@@ -90,6 +92,7 @@ private:
 			shared_ptr<TrainableSvmClassifier> trainableSvm, ptree& config);
 	void initTracking(ptree& config);
 	void initGui();
+	void updateTimeStep();
 	void drawDebug(Mat& image, bool usedAdaptive);
 	void drawCrosshair(Mat& image);
 	void drawBox(Mat& image);
@@ -103,6 +106,7 @@ private:
 	Mat image;
 	unique_ptr<LabeledImageSource> imageSource;
 	unique_ptr<ImageSink> imageSink;
+	shared_ptr<LiveCameraImageSource> liveImageSource;
 
 	int currentX, currentY;
 	int storedX, storedY;
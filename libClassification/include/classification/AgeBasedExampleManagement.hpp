@@ -29,6 +29,10 @@ public:
 
 	void add(const std::vector<cv::Mat>& newExamples);
 
+	void saveState(BinaryModelWriter& writer) const;
+
+	void loadState(BinaryModelReader& reader);
+
 private:
 
 	size_t insertPosition; ///< The insertion index of new examples.
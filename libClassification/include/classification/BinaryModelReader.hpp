@@ -0,0 +1,182 @@
+/*
+ * BinaryModelReader.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef BINARYMODELREADER_HPP_
+#define BINARYMODELREADER_HPP_
+
+#include "classification/BinaryModelWriter.hpp"
+#include "opencv2/core/core.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace classification {
+
+class Kernel;
+
+/**
+ * Reader of the native binary model format of the vector machines (see BinaryModelWriter).
+ *
+ * The file is memory-mapped. On little-endian platforms, the arrays are not copied, but the returned
+ * matrices point directly into the mapped memory. Those matrices do not own their data, therefore the
+ * mapping must be kept alive as long as they are used (see getStorage()). On big-endian platforms, the
+ * arrays are copied and converted to the native byte order.
+ */
+class BinaryModelReader {
+public:
+
+	/**
+	 * Constructs a new binary model reader that maps the given file and reads its header.
+	 *
+	 * @param[in] filename The name of the file.
+	 */
+	explicit BinaryModelReader(const std::string& filename);
+
+	/**
+	 * @return The type of the model.
+	 */
+	BinaryModelType getType() const {
+		return type;
+	}
+
+	/**
+	 * @return True if the file contains the parameters of a logistic function, false otherwise.
+	 */
+	bool hasLogisticParameters() const {
+		return logistic;
+	}
+
+	/**
+	 * @return The parameters a and b of the logistic function p(x) = 1 / (1 + exp(a + b * x)).
+	 */
+	std::pair<double, double> getLogisticParameters() const {
+		return std::make_pair(logisticA, logisticB);
+	}
+
+	/**
+	 * Ensures that the file contains a model of the expected type.
+	 *
+	 * @param[in] expectedType The expected type of the model.
+	 */
+	void requireType(BinaryModelType expectedType) const;
+
+	/**
+	 * @return The next signed 32-bit integer.
+	 */
+	int32_t readInt();
+
+	/**
+	 * @return The next single precision floating point value.
+	 */
+	float readFloat();
+
+	/**
+	 * @return The next double precision floating point value.
+	 */
+	double readDouble();
+
+	/**
+	 * Reads an aligned array of single precision floating point values.
+	 *
+	 * @param[in] count The number of values.
+	 * @return Row vector of type CV_32F that may point into the mapped memory.
+	 */
+	cv::Mat readFloats(size_t count);
+
+	/**
+	 * Reads an aligned array of double precision floating point values.
+	 *
+	 * @param[in] count The number of values.
+	 * @return Row vector of type CV_64F that may point into the mapped memory.
+	 */
+	cv::Mat readDoubles(size_t count);
+
+	/**
+	 * Reads an aligned array of signed 32-bit integers.
+	 *
+	 * @param[in] count The number of values.
+	 * @return Row vector of type CV_32S that may point into the mapped memory.
+	 */
+	cv::Mat readInts(size_t count);
+
+	/**
+	 * Reads a string that was written using BinaryModelWriter::writeString.
+	 *
+	 * @return The string.
+	 */
+	std::string readString();
+
+	/**
+	 * Reads matrices that were written using BinaryModelWriter::writeMatrices.
+	 *
+	 * @return The matrices, which may point into the mapped memory.
+	 */
+	std::vector<cv::Mat> readMatrices();
+
+	/**
+	 * Reads a kernel that was written using BinaryModelWriter::writeKernel.
+	 *
+	 * @return The kernel.
+	 */
+	std::shared_ptr<Kernel> readKernel();
+
+	/**
+	 * @return The memory mapping that has to be kept alive as long as the read matrices are used.
+	 */
+	std::shared_ptr<const void> getStorage() const {
+		return mapping;
+	}
+
+private:
+
+	class Mapping;
+
+	/**
+	 * Ensures that the given number of bytes can be read at the current position.
+	 *
+	 * @param[in] size The number of bytes.
+	 */
+	void require(size_t size) const;
+
+	/**
+	 * Advances the position to the next multiple of the alignment.
+	 */
+	void align();
+
+	/**
+	 * Reads a little-endian value.
+	 *
+	 * @param[in] size The number of bytes.
+	 * @return The value.
+	 */
+	uint64_t readLittleEndian(size_t size);
+
+	/**
+	 * Reads an aligned array into a row vector.
+	 *
+	 * @param[in] count The number of values.
+	 * @param[in] type The type of the values (CV_8U, CV_32S, CV_32F, ...).
+	 * @return Row vector with the given number of elements of the given type.
+	 */
+	cv::Mat readArray(size_t count, int type);
+
+	std::shared_ptr<Mapping> mapping; ///< The memory-mapped file.
+	const unsigned char* data; ///< Pointer to the beginning of the file content.
+	size_t size; ///< The size of the file content in bytes.
+	size_t position; ///< The current read position.
+	BinaryModelType type; ///< The type of the model.
+	bool logistic; ///< Flag that indicates whether logistic parameters are given.
+	double logisticA; ///< Parameter a of the logistic function.
+	double logisticB; ///< Parameter b of the logistic function.
+	std::string filename; ///< The name of the file (for error messages).
+};
+
+} /* namespace classification */
+#endif /* BINARYMODELREADER_HPP_ */
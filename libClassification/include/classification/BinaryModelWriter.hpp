@@ -0,0 +1,172 @@
+/*
+ * BinaryModelWriter.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef BINARYMODELWRITER_HPP_
+#define BINARYMODELWRITER_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace classification {
+
+class Kernel;
+
+/**
+ * Type of the model that is stored in a binary model file.
+ */
+enum class BinaryModelType : uint32_t {
+	SVM = 1, ///< Support vector machine (SvmClassifier).
+	WVM = 2, ///< Wavelet reduced vector machine (WvmClassifier).
+	RVM = 3, ///< Reduced vector machine cascade (RvmClassifier).
+	TRACKER_STATE = 4 ///< Snapshot of an adaptive tracker and its trainable classifiers (see condensation::AdaptiveCondensationTracker).
+};
+
+/**
+ * Writer of the native binary model format of the vector machines.
+ *
+ * The file consists of a fixed header (magic number, format version, model type, flags and the
+ * parameters of the logistic function used by the probabilistic wrappers) followed by the model
+ * specific data. All values are stored in little-endian byte order regardless of the platform,
+ * and all arrays are aligned to 16 bytes relative to the beginning of the file, so they can be used
+ * directly from a memory-mapped file (see BinaryModelReader).
+ *
+ * The data is collected in memory and written to the file by save().
+ */
+class BinaryModelWriter {
+public:
+
+	/**
+	 * Constructs a new binary model writer.
+	 *
+	 * @param[in] type The type of the model.
+	 */
+	explicit BinaryModelWriter(BinaryModelType type);
+
+	/**
+	 * Sets the parameters of the logistic function p(x) = 1 / (1 + exp(a + b * x)) used by the probabilistic
+	 * classifiers. If not set, the file will not contain logistic parameters.
+	 *
+	 * @param[in] logisticA Parameter a of the logistic function.
+	 * @param[in] logisticB Parameter b of the logistic function.
+	 */
+	void setLogisticParameters(double logisticA, double logisticB);
+
+	/**
+	 * Appends a signed 32-bit integer.
+	 *
+	 * @param[in] value The value.
+	 */
+	void writeInt(int32_t value);
+
+	/**
+	 * Appends a single precision floating point value.
+	 *
+	 * @param[in] value The value.
+	 */
+	void writeFloat(float value);
+
+	/**
+	 * Appends a double precision floating point value.
+	 *
+	 * @param[in] value The value.
+	 */
+	void writeDouble(double value);
+
+	/**
+	 * Appends an aligned array of single precision floating point values (without its size).
+	 *
+	 * @param[in] values Pointer to the first value.
+	 * @param[in] count The number of values.
+	 */
+	void writeFloats(const float* values, size_t count);
+
+	/**
+	 * Appends an aligned array of double precision floating point values (without its size).
+	 *
+	 * @param[in] values Pointer to the first value.
+	 * @param[in] count The number of values.
+	 */
+	void writeDoubles(const double* values, size_t count);
+
+	/**
+	 * Appends an aligned array of signed 32-bit integers (without its size).
+	 *
+	 * @param[in] values Pointer to the first value.
+	 * @param[in] count The number of values.
+	 */
+	void writeInts(const int32_t* values, size_t count);
+
+	/**
+	 * Appends a string (its length followed by its characters).
+	 *
+	 * @param[in] value The string.
+	 */
+	void writeString(const std::string& value);
+
+	/**
+	 * Appends several matrices of the same size and type as one contiguous aligned block. The size and type
+	 * are written, too, so BinaryModelReader::readMatrices can restore the matrices.
+	 *
+	 * @param[in] matrices The matrices.
+	 */
+	void writeMatrices(const std::vector<cv::Mat>& matrices);
+
+	/**
+	 * Appends the type and parameters of a kernel.
+	 *
+	 * @param[in] kernel The kernel.
+	 */
+	void writeKernel(const Kernel& kernel);
+
+	/**
+	 * Writes the collected data to a file.
+	 *
+	 * @param[in] filename The name of the file.
+	 */
+	void save(const std::string& filename) const;
+
+	static const uint32_t magic;   ///< Magic number at the beginning of the file ("FDVM").
+	static const uint32_t version; ///< Current version of the format.
+	static const size_t headerSize; ///< Size of the header in bytes.
+	static const size_t alignment; ///< Alignment of the arrays in bytes.
+
+private:
+
+	/**
+	 * Appends zeros until the data size is a multiple of the alignment.
+	 */
+	void align();
+
+	/**
+	 * Appends the bytes of a value in little-endian order.
+	 *
+	 * @param[in] value The value.
+	 * @param[in] size The number of bytes.
+	 */
+	void writeLittleEndian(uint64_t value, size_t size);
+
+	/**
+	 * Appends the values of an array in little-endian order.
+	 *
+	 * @param[in] values Pointer to the first value.
+	 * @param[in] count The number of values.
+	 * @param[in] size The size of each value in bytes.
+	 */
+	void writeArray(const void* values, size_t count, size_t size);
+
+	std::vector<unsigned char> data; ///< The file content (including the header).
+	BinaryModelType type; ///< The type of the model.
+	bool logistic; ///< Flag that indicates whether logistic parameters are given.
+	double logisticA; ///< Parameter a of the logistic function.
+	double logisticB; ///< Parameter b of the logistic function.
+};
+
+} /* namespace classification */
+#endif /* BINARYMODELWRITER_HPP_ */
@@ -0,0 +1,109 @@
+/*
+ * CascadeCalibration.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef CASCADECALIBRATION_HPP_
+#define CASCADECALIBRATION_HPP_
+
+#include <vector>
+#include <cstddef>
+
+namespace classification {
+
+/**
+ * Calibration of the stage thresholds of a cascaded vector machine (e.g. WvmClassifier or RvmClassifier).
+ *
+ * Is constructed with the hyperplane distances of labeled samples at every stage of the cascade (see
+ * WvmClassifier::computeHyperplaneDistances and RvmClassifier::computeHyperplaneDistances). A sample is
+ * rejected at the first stage whose distance is below the threshold of that stage and is classified
+ * positively if it passes all stages, just like the classifiers do.
+ *
+ * The thresholds for a target recall are computed stage by stage: the allowed number of lost positive samples
+ * is distributed uniformly over the stages, and each threshold is chosen as high as possible without losing
+ * more positive samples than allowed up to that stage. The number of evaluated filters is measured on the
+ * negative samples, as those dominate the cost of a sliding-window detection.
+ */
+class CascadeCalibration {
+public:
+
+	/**
+	 * Expected behavior of the cascade with certain thresholds.
+	 */
+	struct OperatingPoint {
+		double recall;                  ///< Fraction of positive samples that pass all stages.
+		double falsePositiveRate;       ///< Fraction of negative samples that pass all stages.
+		double averageFilterCount;      ///< Average number of evaluated stages per negative sample.
+		double averagePositiveFilterCount; ///< Average number of evaluated stages per positive sample.
+	};
+
+	/**
+	 * Constructs a new cascade calibration.
+	 *
+	 * @param[in] positiveDistances Hyperplane distances of the positive samples at each stage.
+	 * @param[in] negativeDistances Hyperplane distances of the negative samples at each stage.
+	 */
+	CascadeCalibration(std::vector<std::vector<double>> positiveDistances, std::vector<std::vector<double>> negativeDistances);
+
+	/**
+	 * @return The number of stages.
+	 */
+	size_t getStageCount() const {
+		return stageCount;
+	}
+
+	/**
+	 * Determines the expected behavior of the cascade with the given thresholds.
+	 *
+	 * @param[in] thresholds The threshold of each stage.
+	 * @return The operating point.
+	 */
+	OperatingPoint evaluate(const std::vector<float>& thresholds) const;
+
+	/**
+	 * Computes stage thresholds that keep the given fraction of the positive samples.
+	 *
+	 * @param[in] targetRecall The fraction of positive samples that must pass all stages (between zero and one).
+	 * @return The threshold of each stage.
+	 */
+	std::vector<float> computeThresholdsForRecall(double targetRecall) const;
+
+	/**
+	 * Computes the stage thresholds with the highest recall whose average number of evaluated filters
+	 * (on the negative samples) does not exceed the given number.
+	 *
+	 * @param[in] targetFilterCount The maximum average number of evaluated filters.
+	 * @return The threshold of each stage.
+	 */
+	std::vector<float> computeThresholdsForFilterCount(double targetFilterCount) const;
+
+private:
+
+	/**
+	 * Determines the number of stages a sample passes through before being rejected.
+	 *
+	 * @param[in] distances The hyperplane distances of the sample at each stage.
+	 * @param[in] thresholds The threshold of each stage.
+	 * @param[out] accepted Flag that indicates whether the sample passed all stages.
+	 * @return The number of evaluated stages.
+	 */
+	size_t computeEvaluatedStages(const std::vector<double>& distances, const std::vector<float>& thresholds, bool& accepted) const;
+
+	/**
+	 * Converts a distance into the highest float threshold that does not exceed it.
+	 *
+	 * @param[in] distance The distance.
+	 * @return The threshold.
+	 */
+	static float toThreshold(double distance);
+
+	std::vector<std::vector<double>> positiveDistances; ///< Hyperplane distances of the positive samples at each stage.
+	std::vector<std::vector<double>> negativeDistances; ///< Hyperplane distances of the negative samples at each stage.
+	size_t stageCount; ///< The number of stages.
+};
+
+} /* namespace classification */
+#endif /* CASCADECALIBRATION_HPP_ */
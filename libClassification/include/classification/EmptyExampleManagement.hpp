@@ -41,6 +41,10 @@ public:
 		return std::unique_ptr<ExampleIterator>(new EmptyIterator());
 	}
 
+	void saveState(BinaryModelWriter& writer) const {}
+
+	void loadState(BinaryModelReader& reader) {}
+
 private:
 
 	/**
@@ -14,6 +14,9 @@
 
 namespace classification {
 
+class BinaryModelWriter;
+class BinaryModelReader;
+
 /**
  * Stores and manages examples for training a classifier. Typically, the amount of training examples is budgeted,
  * meaning that there is a maximum amount of training examples that may be stored at a time.
@@ -72,6 +75,20 @@ public:
 	 * @return Iterator for iterating over the training examples.
 	 */
 	virtual std::unique_ptr<ExampleIterator> iterator() const = 0;
+
+	/**
+	 * Writes the stored training examples and the bookkeeping needed for continuing the management to a snapshot.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(BinaryModelWriter& writer) const = 0;
+
+	/**
+	 * Replaces the stored training examples by the ones of a snapshot that was written by saveState.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(BinaryModelReader& reader) = 0;
 };
 
 } /* namespace classification */
@@ -37,6 +37,10 @@ public:
 
 	std::unique_ptr<ExampleManagement::ExampleIterator> iterator() const;
 
+	void saveState(BinaryModelWriter& writer) const;
+
+	void loadState(BinaryModelReader& reader);
+
 private:
 
 	std::vector<std::vector<cv::Mat>> examples; ///< Stored training examples, grouped by frames.
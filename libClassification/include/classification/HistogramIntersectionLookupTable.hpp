@@ -0,0 +1,104 @@
+/*
+ * HistogramIntersectionLookupTable.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef HISTOGRAMINTERSECTIONLOOKUPTABLE_HPP_
+#define HISTOGRAMINTERSECTIONLOOKUPTABLE_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <vector>
+
+namespace classification {
+
+/**
+ * Compiled form of the weighted sum over histogram intersection kernel values of a feature vector and several
+ * support vectors, sum<sub>j</sub>(a<sub>j</sub> * sum<sub>i</sub>(min(x<sub>i</sub>, s<sub>ji</sub>))).
+ *
+ * The sum decomposes into one piecewise-linear function per dimension, h<sub>i</sub>(x) = sum<sub>j</sub>(a<sub>j</sub>
+ * * min(x, s<sub>ji</sub>)). In exact mode, the sorted support vector values of each dimension are stored together
+ * with prefix sums, so h<sub>i</sub> is evaluated with a binary search in O(log n). In approximate mode, each
+ * h<sub>i</sub> is sampled at a fixed number of equidistant points between the smallest and largest support vector
+ * value and linearly interpolated in O(1). Either way, the evaluation cost does not depend on the number of support
+ * vectors any more (see Maji et al., Classification using intersection kernel support vector machines is efficient).
+ */
+class HistogramIntersectionLookupTable {
+public:
+
+	/**
+	 * Constructs a new lookup table.
+	 *
+	 * @param[in] supportVectors The support vectors, which must be continuous and have the same size.
+	 * @param[in] coefficients The coefficients of the support vectors.
+	 * @param[in] binCount The number of interpolation points per dimension (at least two), zero for the exact piecewise-linear function.
+	 */
+	HistogramIntersectionLookupTable(const std::vector<cv::Mat>& supportVectors, const std::vector<float>& coefficients, size_t binCount = 0);
+
+	/**
+	 * Computes the weighted sum of the kernel values between a feature vector and the support vectors.
+	 *
+	 * @param[in] featureVector The feature vector of depth CV_8U, CV_32S or CV_32F.
+	 * @return The weighted sum of the kernel values.
+	 */
+	double compute(const cv::Mat& featureVector) const;
+
+	/**
+	 * @return The number of feature vector dimensions.
+	 */
+	size_t getDimensionCount() const {
+		return dimensionCount;
+	}
+
+	/**
+	 * @return The number of interpolation points per dimension, zero if the function is exact.
+	 */
+	size_t getBinCount() const {
+		return binCount;
+	}
+
+private:
+
+	/**
+	 * Computes the weighted sum of the kernel values given the values of a feature vector.
+	 *
+	 * @param[in] values The values of the feature vector.
+	 * @return The weighted sum of the kernel values.
+	 */
+	template<class T>
+	double compute(const T* values) const;
+
+	/**
+	 * Evaluates the exact piecewise-linear function of a dimension.
+	 *
+	 * @param[in] dimension The dimension.
+	 * @param[in] value The feature value.
+	 * @return The function value.
+	 */
+	double computeExact(size_t dimension, double value) const;
+
+	/**
+	 * Evaluates the interpolated function of a dimension.
+	 *
+	 * @param[in] dimension The dimension.
+	 * @param[in] value The feature value.
+	 * @return The function value.
+	 */
+	double computeInterpolated(size_t dimension, double value) const;
+
+	size_t dimensionCount; ///< The number of feature vector dimensions.
+	size_t vectorCount;    ///< The number of support vectors.
+	size_t binCount;       ///< The number of interpolation points per dimension, zero for the exact function.
+	std::vector<float> values;                ///< Sorted support vector values, vectorCount per dimension.
+	std::vector<double> weightedValueSums;    ///< Prefix sums of the coefficient times value, vectorCount + 1 per dimension.
+	std::vector<double> coefficientSums;      ///< Prefix sums of the coefficients (in order of the values), vectorCount + 1 per dimension.
+	std::vector<double> coefficientTotals;    ///< Sum of all coefficients of each dimension.
+	std::vector<double> lowerBounds;          ///< Smallest support vector value of each dimension.
+	std::vector<double> binWidths;            ///< Distance between two interpolation points of each dimension.
+	std::vector<double> table;                ///< Function values at the interpolation points, binCount per dimension.
+};
+
+} /* namespace classification */
+#endif /* HISTOGRAMINTERSECTIONLOOKUPTABLE_HPP_ */
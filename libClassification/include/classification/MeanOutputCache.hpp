@@ -0,0 +1,95 @@
+/*
+ * MeanOutputCache.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef MEANOUTPUTCACHE_HPP_
+#define MEANOUTPUTCACHE_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <unordered_map>
+#include <vector>
+#include <memory>
+
+namespace classification {
+
+class Kernel;
+class SvmClassifier;
+
+/**
+ * Computes the mean SVM output (hyperplane distance) of a set of test examples incrementally across re-trainings.
+ *
+ * The mean output is a weighted sum of the mean kernel values between each support vector and the test examples.
+ * Those kernel values are cached per support vector and test example. After a re-training, only the kernel values
+ * of new support vectors and of test examples that were replaced since the last computation have to be computed,
+ * while support vectors that survived the re-training re-use their cached values. The support vectors are
+ * recognized by their content, as the SVM training creates new matrices.
+ *
+ * SVMs that are compiled into lookup tables are evaluated directly, as those are cheap anyway.
+ */
+class MeanOutputCache {
+public:
+
+	/**
+	 * Constructs a new empty mean output cache.
+	 */
+	MeanOutputCache();
+
+	/**
+	 * Marks a test example as changed, so its cached kernel values are not used anymore.
+	 *
+	 * @param[in] index The index of the test example.
+	 */
+	void invalidate(size_t index);
+
+	/**
+	 * Removes all cached kernel values, must be called when test examples are removed.
+	 */
+	void clear();
+
+	/**
+	 * Computes the mean SVM output of the test examples. The result equals the mean of the hyperplane distances
+	 * (up to rounding).
+	 *
+	 * @param[in] svm The SVM classifier.
+	 * @param[in] examples The test examples, whose changes since the last computation were reported by invalidate.
+	 * @return The mean hyperplane distance of the test examples.
+	 */
+	double computeMeanOutput(const SvmClassifier& svm, const std::vector<cv::Mat>& examples);
+
+private:
+
+	/**
+	 * Cached kernel values of a support vector.
+	 */
+	struct Entry {
+		cv::Mat supportVector; ///< The support vector.
+		std::vector<double> kernelValues; ///< The kernel values of the support vector and each test example.
+	};
+
+	/**
+	 * Computes a hash of the content of a vector.
+	 *
+	 * @param[in] vector The vector.
+	 * @return The hash value.
+	 */
+	static size_t computeHash(const cv::Mat& vector);
+
+	/**
+	 * Determines whether two vectors have the same content.
+	 *
+	 * @param[in] lhs The first vector.
+	 * @param[in] rhs The second vector.
+	 * @return True if both vectors have the same type, size and values, false otherwise.
+	 */
+	static bool isEqual(const cv::Mat& lhs, const cv::Mat& rhs);
+
+	std::shared_ptr<Kernel> kernel; ///< The kernel the cached values were computed with.
+	std::unordered_multimap<size_t, Entry> entries; ///< The cached kernel values per support vector, keyed by the hash of the support vector.
+	std::vector<bool> changed; ///< Flags that indicate which test examples changed since the last computation.
+};
+
+} /* namespace classification */
+#endif /* MEANOUTPUTCACHE_HPP_ */
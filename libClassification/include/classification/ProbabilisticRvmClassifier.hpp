@@ -72,6 +72,23 @@ public:
 	 */
 	static std::pair<double, double> loadSigmoidParamsFromMatlab(const std::string& logisticFilename);
 
+	/**
+	 * Creates a new probabilistic RVM classifier from a file in the native binary format (see BinaryModelWriter), which
+	 * contains the RVM and the logistic function's parameters. If the file has no logistic parameters, the default
+	 * parameters are used.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 * @return The newly created probabilistic RVM classifier.
+	 */
+	static std::shared_ptr<ProbabilisticRvmClassifier> loadFromBinary(const std::string& classifierFilename);
+
+	/**
+	 * Stores the underlying RVM and the logistic function's parameters in a file using the native binary format.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 */
+	void saveToBinary(const std::string& classifierFilename) const;
+
 	/**
 	 * Creates a new probabilistic RVM classifier from the parameters given in the ptree sub-tree. Loads the logistic function's
 	 * parameters, then passes the loading to the underlying RVM which loads the vectors and thresholds
@@ -66,6 +66,13 @@ public:
 	 */
 	void setLogisticParameters(double logisticA, double logisticB);
 
+	/**
+	 * @return The parameters a and b of the logistic function for pseudo-probabilistic output p(x) = 1 / (1 + exp(a + b * x)).
+	 */
+	std::pair<double, double> getLogisticParameters() const {
+		return std::make_pair(logisticA, logisticB);
+	}
+
 	/**
 	 * Creates a new probabilistic WVM classifier from the parameters given in some Matlab file. Loads the logistic function's
 	 * parameters from the matlab file, then passes the loading to the underlying WVM which loads the vectors and thresholds
@@ -89,6 +96,23 @@ public:
 	 */
 	static std::shared_ptr<ProbabilisticSvmClassifier> loadFromMatlab(const std::string& classifierFilename, const std::string& logisticFilename);
 
+	/**
+	 * Creates a new probabilistic SVM classifier from a file in the native binary format (see BinaryModelWriter), which
+	 * contains the SVM and the logistic function's parameters. If the file has no logistic parameters, the default
+	 * parameters are used.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 * @return The newly created probabilistic SVM classifier.
+	 */
+	static std::shared_ptr<ProbabilisticSvmClassifier> loadFromBinary(const std::string& classifierFilename);
+
+	/**
+	 * Stores the underlying SVM and the logistic function's parameters in a file using the native binary format.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 */
+	void saveToBinary(const std::string& classifierFilename) const;
+
 	/**
 	 * Creates a new probabilistic SVM classifier from the parameters given in the ptree sub-tree. Loads the logistic function's
 	 * parameters, then passes the loading to the underlying SVM which loads the vectors and thresholds
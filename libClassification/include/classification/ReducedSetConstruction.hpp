@@ -0,0 +1,81 @@
+/*
+ * ReducedSetConstruction.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef REDUCEDSETCONSTRUCTION_HPP_
+#define REDUCEDSETCONSTRUCTION_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <memory>
+#include <vector>
+
+namespace classification {
+
+class SvmClassifier;
+
+/**
+ * Approximates the decision function of a trained SVM with a smaller number of synthetic vectors.
+ *
+ * The vectors are constructed greedily: each new vector is the pre-image that best approximates the remaining
+ * difference between the original and the current reduced expansion in feature space, found by fixed-point
+ * iteration (Schölkopf et al., Input space versus feature space in kernel-based methods). Afterwards, the
+ * coefficients of all reduced vectors are refit by solving the linear system that minimizes the distance to the
+ * original expansion. Supports RBF and polynomial kernels.
+ *
+ * The synthetic vectors have the same size and type as the original support vectors, so the reduced SVM can be
+ * applied to the same feature vectors. In case of integral types, the vectors are rounded before the coefficients
+ * are refit.
+ */
+class ReducedSetConstruction {
+public:
+
+	/**
+	 * Difference between the hyperplane distances of an original and a reduced SVM.
+	 */
+	struct ApproximationError {
+		double meanAbsoluteDifference; ///< Mean absolute difference of the hyperplane distances.
+		double maxAbsoluteDifference;  ///< Maximum absolute difference of the hyperplane distances.
+		double labelAgreement;         ///< Fraction of feature vectors that are classified the same.
+	};
+
+	/**
+	 * Constructs a new reduced set construction.
+	 *
+	 * @param[in] iterationCount The maximum number of fixed-point iterations per synthetic vector.
+	 * @param[in] restartCount The number of support vectors the fixed-point iteration is started from per synthetic vector.
+	 */
+	explicit ReducedSetConstruction(int iterationCount = 100, int restartCount = 5);
+
+	/**
+	 * Creates an SVM that approximates the given one with fewer vectors. If the SVM does not have more support vectors
+	 * than requested, the returned SVM uses the original support vectors.
+	 *
+	 * @param[in] svm The SVM with an RBF or polynomial kernel.
+	 * @param[in] vectorCount The number of synthetic vectors of the reduced SVM.
+	 * @return The reduced SVM with the same kernel, bias and threshold.
+	 */
+	std::shared_ptr<SvmClassifier> reduce(const SvmClassifier& svm, size_t vectorCount) const;
+
+	/**
+	 * Measures how well a reduced SVM approximates the original one on some feature vectors.
+	 *
+	 * @param[in] original The original SVM.
+	 * @param[in] reduced The reduced SVM.
+	 * @param[in] featureVectors The feature vectors (e.g. validation patches).
+	 * @return The approximation error.
+	 */
+	static ApproximationError computeApproximationError(
+			const SvmClassifier& original, const SvmClassifier& reduced, const std::vector<cv::Mat>& featureVectors);
+
+private:
+
+	int iterationCount; ///< The maximum number of fixed-point iterations per synthetic vector.
+	int restartCount; ///< The number of support vectors the fixed-point iteration is started from per synthetic vector.
+};
+
+} /* namespace classification */
+#endif /* REDUCEDSETCONSTRUCTION_HPP_ */
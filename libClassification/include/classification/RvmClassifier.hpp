@@ -17,6 +17,9 @@
 
 namespace classification {
 
+class BinaryModelReader;
+class BinaryModelWriter;
+
 /**
  * Classifier based on a Reduced Vector Machine.
  * An RVM differs from an SVM in certain points:
@@ -82,6 +85,16 @@ public:
 
 	double computeHyperplaneDistanceCached(const cv::Mat& featureVector, const size_t filterLevel, std::vector<double>& filterEvalCache) const;
 
+	/**
+	 * Computes the distances of a feature vector to the decision hyperplanes of all used filter levels without
+	 * stopping at the hierarchical thresholds. The distances are the same as the ones computed by
+	 * computeHyperplaneDistance(const cv::Mat&) up to the level where it stops.
+	 *
+	 * @param[in] featureVector The feature vector.
+	 * @return The distance to the decision hyperplane of each used filter level.
+	 */
+	std::vector<double> computeHyperplaneDistances(const cv::Mat& featureVector) const;
+
 	/**
 	 * Returns the number of filters (RSVs) this RVM is currently using for classifying.
 	 *
@@ -98,6 +111,20 @@ public:
 	 */
 	void setNumFiltersToUse(const unsigned int numFilters);
 
+	/**
+	 * @return The classification threshold of each filter level.
+	 */
+	const std::vector<float>& getHierarchicalThresholds() const {
+		return hierarchicalThresholds;
+	}
+
+	/**
+	 * Replaces the classification thresholds of the filter levels (e.g. by calibrated ones).
+	 *
+	 * @param[in] thresholds The new thresholds, one for each filter level.
+	 */
+	void setHierarchicalThresholds(const std::vector<float>& thresholds);
+
 	/**
 	 * Creates a new RVM classifier from a Matlab file (.mat) containing the classifier and
 	 * a second .mat file containing the thresholds.
@@ -108,9 +135,41 @@ public:
 	 */
 	static std::shared_ptr<RvmClassifier> loadFromMatlab(const std::string& classifierFilename, const std::string& thresholdsFilename);
 
+	/**
+	 * Creates a new RVM classifier from a file in the native binary format (see BinaryModelWriter). The
+	 * reduced vectors are not copied, but point into the memory-mapped file.
+	 *
+	 * @param[in] classifierFilename The name of the binary file containing the RVM vectors, weights and thresholds.
+	 * @return The newly created RVM classifier.
+	 */
+	static std::shared_ptr<RvmClassifier> loadFromBinary(const std::string& classifierFilename);
+
+	/**
+	 * Creates a new RVM classifier from the model data of a binary model reader.
+	 *
+	 * @param[in] reader The reader, which must be positioned at the beginning of the model data.
+	 * @return The newly created RVM classifier.
+	 */
+	static std::shared_ptr<RvmClassifier> loadFromBinary(BinaryModelReader& reader);
+
+	/**
+	 * Stores the vectors, weights and thresholds of this RVM in a file using the native binary format.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 */
+	void saveToBinary(const std::string& classifierFilename) const;
+
+	/**
+	 * Appends the model data of this RVM to a binary model writer.
+	 *
+	 * @param[in] writer The writer.
+	 */
+	void saveToBinary(BinaryModelWriter& writer) const;
+
 	/**
 	 * Creates a new RVM classifier from the parameters given in the ptree sub-tree. Passes the
-	 * loading to the respective loading routine (at the moment, only Matlab files are supported).
+	 * loading to the respective loading routine (Matlab files or files in the native binary format,
+	 * which are recognized by the extension ".bin").
 	 *
 	 * @param[in] subtree The subtree containing the config information for this classifier.
 	 * @return The newly created RVM classifier.
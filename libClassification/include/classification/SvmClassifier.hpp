@@ -16,6 +16,10 @@
 
 namespace classification {
 
+class BinaryModelReader;
+class BinaryModelWriter;
+class HistogramIntersectionLookupTable;
+
 /**
  * Classifier based on a Support Vector Machine.
  */
@@ -58,6 +62,43 @@ public:
 	 */
 	double computeHyperplaneDistance(const cv::Mat& featureVector) const;
 
+	/**
+	 * Computes the distance of a feature vector to the decision hyperplane by evaluating the kernel against each
+	 * support vector, even if this SVM is compiled.
+	 *
+	 * @param[in] featureVector The feature vector.
+	 * @return The distance of the feature vector to the decision hyperplane.
+	 */
+	double computeExactHyperplaneDistance(const cv::Mat& featureVector) const;
+
+	/**
+	 * Enables or disables the compiled evaluation. Only has an effect in case of a histogram intersection kernel,
+	 * which then is evaluated using a lookup table per dimension instead of being computed against every support
+	 * vector (see HistogramIntersectionLookupTable). The lookup table is rebuilt whenever the SVM parameters change.
+	 *
+	 * @param[in] compiled Flag that indicates whether the SVM should be evaluated using lookup tables.
+	 * @param[in] binCount The number of interpolation points per dimension, zero for an exact evaluation.
+	 */
+	void setCompiled(bool compiled, size_t binCount = 0);
+
+	/**
+	 * @return True if the SVM is currently evaluated using lookup tables, false otherwise.
+	 */
+	bool isCompiled() const {
+		return static_cast<bool>(lookupTable);
+	}
+
+	/**
+	 * Measures the error of the compiled evaluation by comparing it to the exact evaluation on random histograms (with
+	 * values between zero and the largest support vector value of each dimension). This is as expensive as evaluating
+	 * the exact SVM on all samples, so it is not done automatically when the lookup table is built.
+	 *
+	 * @param[in] sampleCount The number of random histograms.
+	 * @return The largest absolute difference between the compiled and exact hyperplane distances, zero if the SVM
+	 *         is not compiled.
+	 */
+	double measureCompilationError(int sampleCount = 100) const;
+
 	/**
 	 * Changes the parameters of this SVM.
 	 *
@@ -83,6 +124,37 @@ public:
 	 */
 	static std::shared_ptr<SvmClassifier> loadFromText(const std::string& classifierFilename);
 
+	/**
+	 * Creates a new SVM classifier from a file in the native binary format (see BinaryModelWriter). The support
+	 * vectors are not copied, but point into the memory-mapped file.
+	 *
+	 * @param[in] classifierFilename The name of the binary file containing the SVM parameters.
+	 * @return The newly created SVM classifier.
+	 */
+	static std::shared_ptr<SvmClassifier> loadFromBinary(const std::string& classifierFilename);
+
+	/**
+	 * Creates a new SVM classifier from the model data of a binary model reader.
+	 *
+	 * @param[in] reader The reader, which must be positioned at the beginning of the model data.
+	 * @return The newly created SVM classifier.
+	 */
+	static std::shared_ptr<SvmClassifier> loadFromBinary(BinaryModelReader& reader);
+
+	/**
+	 * Stores the parameters of this SVM in a file using the native binary format.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 */
+	void saveToBinary(const std::string& classifierFilename) const;
+
+	/**
+	 * Appends the model data of this SVM to a binary model writer.
+	 *
+	 * @param[in] writer The writer.
+	 */
+	void saveToBinary(BinaryModelWriter& writer) const;
+
 	/**
 	 * @return The support vectors.
 	 */
@@ -99,8 +171,16 @@ public:
 
 private:
 
+	/**
+	 * Builds the lookup table if the compiled evaluation is enabled and the kernel is a histogram intersection kernel.
+	 */
+	void compile();
+
 	std::vector<cv::Mat> supportVectors; ///< The support vectors.
 	std::vector<float> coefficients; ///< The coefficients of the support vectors.
+	bool compilationEnabled; ///< Flag that indicates whether the SVM should be evaluated using lookup tables.
+	size_t lookupTableBinCount; ///< The number of interpolation points per dimension of the lookup table, zero for an exact one.
+	std::shared_ptr<HistogramIntersectionLookupTable> lookupTable; ///< Lookup table of the compiled SVM, empty if not compiled.
 };
 
 } /* namespace classification */
@@ -13,6 +13,9 @@
 
 namespace classification {
 
+class BinaryModelWriter;
+class BinaryModelReader;
+
 /**
  * Classifier that may be re-trained using new examples. Re-training is an incremental procedure that adds
  * new examples and refines the classifier. Nevertheless, it may be possible that previous training
@@ -44,6 +47,22 @@ public:
 	 * Resets this classifier.
 	 */
 	virtual void reset() = 0;
+
+	/**
+	 * Writes the learned state of this classifier (trained parameters and stored training examples) to a
+	 * snapshot, so the training can be continued later on with identical results.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(BinaryModelWriter& writer) const = 0;
+
+	/**
+	 * Restores the learned state of this classifier from a snapshot that was written by saveState. The
+	 * configuration (kernel, training parameters, example management types) must be the same.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(BinaryModelReader& reader) = 0;
 };
 
 } /* namespace classification */
@@ -9,6 +9,7 @@
 #define TRAINABLEPROBABILISTICSVMCLASSIFIER_HPP_
 
 #include "classification/TrainableProbabilisticClassifier.hpp"
+#include "classification/MeanOutputCache.hpp"
 #include <memory>
 
 namespace classification {
@@ -20,6 +21,9 @@ class ProbabilisticSvmClassifier;
 /**
  * Probabilistic SVM classifier that can be re-trained. Computes the new parameters of a logistic function by
  * using the mean output of the positive and negative training examples and associated probabilities.
+ *
+ * The mean outputs are computed incrementally (see MeanOutputCache), so after a re-training only the kernel values
+ * of new support vectors and replaced test examples are computed.
  */
 class TrainableProbabilisticSvmClassifier : public TrainableProbabilisticClassifier {
 public:
@@ -53,6 +57,15 @@ public:
 
 	void reset();
 
+	/**
+	 * Writes the state of the trainable SVM, the test examples and the parameters of the logistic function.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	void saveState(BinaryModelWriter& writer) const;
+
+	void loadState(BinaryModelReader& reader);
+
 	/**
 	 * @return The actual probabilistic SVM classifier.
 	 */
@@ -86,25 +99,26 @@ protected:
 	 * @param[in,out] examples The existing test examples.
 	 * @param[in] newExamples The new test examples.
 	 * @param[in,out] insertPosition The insertion index of new examples.
+	 * @param[in,out] outputCache The cache of the mean output of the test examples, informed about replaced examples.
 	 */
-	void addTestExamples(std::vector<cv::Mat>& examples, const std::vector<cv::Mat>& newExamples, size_t& insertPosition);
+	void addTestExamples(std::vector<cv::Mat>& examples, const std::vector<cv::Mat>& newExamples, size_t& insertPosition,
+			MeanOutputCache& outputCache);
 
 	/**
-	 * Computes the parameters of the logistic function given the trained SVM classifier.
+	 * Replaces test examples by the ones read from a snapshot.
 	 *
-	 * @param[in] svm The trained SVM classifier.
-	 * @return A pair containing the parameters a and b of the logistic function p(x) = 1 / (1 + exp(a + b * x)).
+	 * @param[in] reader The reader of the snapshot.
+	 * @param[in,out] examples The test examples.
 	 */
-	virtual std::pair<double, double> computeLogisticParameters(std::shared_ptr<SvmClassifier> svm) const;
+	static void loadTestExamples(BinaryModelReader& reader, std::vector<cv::Mat>& examples);
 
 	/**
-	 * Computes the mean SVM hyperplane distance of the test examples.
+	 * Computes the parameters of the logistic function given the trained SVM classifier.
 	 *
-	 * @param[in] svm The SVM classifier.
-	 * @param[in] examples The test examples.
-	 * @return The mean hyperplane distance of the test examples.
+	 * @param[in] svm The trained SVM classifier.
+	 * @return A pair containing the parameters a and b of the logistic function p(x) = 1 / (1 + exp(a + b * x)).
 	 */
-	double computeMeanOutput(std::shared_ptr<SvmClassifier> svm, const std::vector<cv::Mat>& examples) const;
+	virtual std::pair<double, double> computeLogisticParameters(std::shared_ptr<SvmClassifier> svm) const;
 
 	/**
 	 * Computes the parameters of the logistic function given the mean SVM outputs of the positive and negative training data.
@@ -123,6 +137,8 @@ private:
 	std::vector<cv::Mat> negativeTestExamples; ///< The negative test examples.
 	size_t positiveInsertPosition; ///< The insertion index of new positive examples.
 	size_t negativeInsertPosition; ///< The insertion index of new negative examples.
+	mutable MeanOutputCache positiveOutputCache; ///< The cache of the mean output of the positive test examples.
+	mutable MeanOutputCache negativeOutputCache; ///< The cache of the mean output of the negative test examples.
 	double highProb; ///< The probability of the mean output of positive samples.
 	double lowProb;  ///< The probability of the mean output of negative samples.
 	bool adjustThreshold;     ///< Flag that indicates whether the SVM threshold should be adjusted to a certain probability.
@@ -60,6 +60,14 @@ public:
 		return trainable->reset();
 	}
 
+	void saveState(BinaryModelWriter& writer) const {
+		trainable->saveState(writer);
+	}
+
+	void loadState(BinaryModelReader& reader) {
+		trainable->loadState(reader);
+	}
+
 private:
 
 	std::shared_ptr<TrainableProbabilisticClassifier> trainable; ///< The classifier that will be trained.
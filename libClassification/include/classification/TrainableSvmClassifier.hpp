@@ -11,6 +11,7 @@
 #include "classification/TrainableBinaryClassifier.hpp"
 #include <memory>
 #include <utility>
+#include <cstddef>
 
 namespace classification {
 
@@ -45,6 +46,15 @@ public:
 
 	bool isUsable() const;
 
+	/**
+	 * Enables or disables the compiled evaluation of the actual SVM (see SvmClassifier::setCompiled). As retraining
+	 * replaces the SVM parameters, the lookup table is rebuilt automatically after each retrain.
+	 *
+	 * @param[in] compiled Flag that indicates whether the SVM should be evaluated using lookup tables.
+	 * @param[in] binCount The number of interpolation points per dimension, zero for an exact evaluation.
+	 */
+	void setCompiled(bool compiled, size_t binCount = 0);
+
 	/**
 	 * @return The actual SVM.
 	 */
@@ -55,6 +65,21 @@ public:
 	 */
 	const std::shared_ptr<SvmClassifier> getSvm() const;
 
+	/**
+	 * Writes the parameters of the actual SVM (support vectors, coefficients, bias and threshold). Sub-classes
+	 * that store training examples have to add those.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(BinaryModelWriter& writer) const;
+
+	/**
+	 * Restores the parameters of the actual SVM.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(BinaryModelReader& reader);
+
 protected:
 
 	std::shared_ptr<SvmClassifier> svm; ///< The actual SVM.
@@ -36,6 +36,10 @@ public:
 
 	std::unique_ptr<ExampleManagement::ExampleIterator> iterator() const;
 
+	void saveState(BinaryModelWriter& writer) const;
+
+	void loadState(BinaryModelReader& reader);
+
 protected:
 
 	std::vector<cv::Mat> examples; ///< Stored training examples.
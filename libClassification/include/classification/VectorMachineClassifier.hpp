@@ -75,6 +75,7 @@ protected:
 	float threshold; ///< The threshold to compare the hyperplane distance against for determining the label.
 					 // Larger => weniger patches drueber(mehr rejected, langsamer), dh. mehr fn(FRR), weniger fp(FAR)
 					 // Smaller => mehr patches drueber(mehr nicht rejected, schneller), dh. weniger fn(FRR), mehr fp(FAR)
+	std::shared_ptr<const void> storage; ///< Memory the parameters point into and that must be kept alive (e.g. a memory-mapped model file), may be empty.
 };
 
 } /* namespace classification */
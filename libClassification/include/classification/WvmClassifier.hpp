@@ -17,6 +17,8 @@
 namespace classification {
 
 class IImg;
+class BinaryModelReader;
+class BinaryModelWriter;
 
 /**
  * Classifier based on a Wavelet Reduced Vector Machine.
@@ -60,6 +62,16 @@ public:
 	 */
 	std::pair<int, double> computeHyperplaneDistance(const cv::Mat& featureVector) const;
 
+	/**
+	 * Computes the distances of a feature vector to the decision hyperplanes of all used filter levels without
+	 * stopping at the hierarchical thresholds. In contrast to computeHyperplaneDistance, this function does not
+	 * use the internal buffers of the WVM, so it may be called concurrently from several threads.
+	 *
+	 * @param[in] featureVector The feature vector.
+	 * @return The distance to the decision hyperplane of each used filter level.
+	 */
+	std::vector<double> computeHyperplaneDistances(const cv::Mat& featureVector) const;
+
 	/**
 	 * Creates a new WVM classifier from the parameters given in some Matlab file.
 	 *
@@ -69,11 +81,58 @@ public:
 	 */
 	static std::shared_ptr<WvmClassifier> loadFromMatlab(const std::string& classifierFilename, const std::string& thresholdsFilename);
 
+	/**
+	 * Creates a new WVM classifier from a file in the native binary format (see BinaryModelWriter) that contains
+	 * the filters, weights, approximated reduced set vectors and the hierarchical thresholds.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 * @return The newly created WVM classifier.
+	 */
+	static std::shared_ptr<WvmClassifier> loadFromBinary(const std::string& classifierFilename);
+
+	/**
+	 * Creates a new WVM classifier from the model data of a binary model reader.
+	 *
+	 * @param[in] reader The reader, which must be positioned at the beginning of the model data.
+	 * @return The newly created WVM classifier.
+	 */
+	static std::shared_ptr<WvmClassifier> loadFromBinary(BinaryModelReader& reader);
+
+	/**
+	 * Stores the filters, weights, approximated reduced set vectors and hierarchical thresholds of this WVM
+	 * in a file using the native binary format.
+	 *
+	 * @param[in] classifierFilename The name of the binary file.
+	 */
+	void saveToBinary(const std::string& classifierFilename) const;
+
+	/**
+	 * Appends the model data of this WVM to a binary model writer.
+	 *
+	 * @param[in] writer The writer.
+	 */
+	void saveToBinary(BinaryModelWriter& writer) const;
+
 	int getNumUsedFilters(void);
 	void setNumUsedFilters(int);			 ///< Change the number of currently used wavelet-vectors
 	float getLimitReliabilityFilter(void);
 	void setLimitReliabilityFilter(float);	///< Rewrites the hierarchicalThresholds vector with the new thresholds
 
+	/**
+	 * @return The thresholds of the filter levels without the limit reliability offset.
+	 */
+	const std::vector<float>& getHierarchicalThresholds() const {
+		return hierarchicalThresholdsFromFile;
+	}
+
+	/**
+	 * Replaces the thresholds of the filter levels (e.g. by calibrated ones). The limit reliability offset is
+	 * added to the new thresholds, too.
+	 *
+	 * @param[in] thresholds The new thresholds, one for each filter.
+	 */
+	void setHierarchicalThresholds(const std::vector<float>& thresholds);
+
 protected:
 
 	float linEvalWvmHisteq64(int, int, float*, float*, const IImg*, const IImg*) const;
@@ -126,6 +185,10 @@ protected:
 	Area** area;	///< rectangles and gray values of the appr. rsv
 	double	*app_rsv_convol;	///< convolution of the appr. rsv (pp)
 
+	cv::Mat binaryFilters;		///< filters of a classifier loaded from the binary format, linFilters point into it (otherwise empty)
+	cv::Mat binaryWeights;		///< packed weight triangle of a classifier loaded from the binary format, hkWeights point into it (otherwise empty)
+	cv::Mat binaryConvolutions;	///< convolutions of a classifier loaded from the binary format, app_rsv_convol points into it (otherwise empty)
+
 	float *filter_output;		///< temporary output of each filter level
 	float *u_kernel_eval;		///< temporary cache, size=numFiltersPerLevel (or numLevels?)
 
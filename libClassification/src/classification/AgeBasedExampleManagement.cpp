@@ -6,6 +6,8 @@
  */
 
 #include "classification/AgeBasedExampleManagement.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 
 using cv::Mat;
 using std::vector;
@@ -29,4 +31,14 @@ void AgeBasedExampleManagement::add(const vector<Mat>& newExamples) {
 	}
 }
 
+void AgeBasedExampleManagement::saveState(BinaryModelWriter& writer) const {
+	VectorBasedExampleManagement::saveState(writer);
+	writer.writeInt(static_cast<int32_t>(insertPosition));
+}
+
+void AgeBasedExampleManagement::loadState(BinaryModelReader& reader) {
+	VectorBasedExampleManagement::loadState(reader);
+	insertPosition = reader.readInt();
+}
+
 } /* namespace classification */
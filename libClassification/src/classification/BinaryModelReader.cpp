@@ -0,0 +1,249 @@
+/*
+ * BinaryModelReader.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "classification/BinaryModelReader.hpp"
+#include "classification/LinearKernel.hpp"
+#include "classification/PolynomialKernel.hpp"
+#include "classification/RbfKernel.hpp"
+#include "classification/HistogramIntersectionKernel.hpp"
+#include "boost/lexical_cast.hpp"
+#ifdef WIN32
+	#include <fstream>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+#include <stdexcept>
+#include <cstring>
+#include <climits>
+
+using cv::Mat;
+using boost::lexical_cast;
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using std::runtime_error;
+
+namespace classification {
+
+/**
+ * Read-only view of a whole file. Uses mmap on POSIX systems and reads the file into memory otherwise.
+ */
+class BinaryModelReader::Mapping {
+public:
+
+	explicit Mapping(const string& filename) : data(nullptr), size(0) {
+#ifdef WIN32
+		std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+			throw runtime_error("BinaryModelReader: Could not open file: " + filename);
+		buffer.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		if (!file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()))
+			throw runtime_error("BinaryModelReader: Could not read file: " + filename);
+		data = buffer.data();
+		size = buffer.size();
+#else
+		int descriptor = ::open(filename.c_str(), O_RDONLY);
+		if (descriptor < 0)
+			throw runtime_error("BinaryModelReader: Could not open file: " + filename);
+		struct stat status;
+		if (::fstat(descriptor, &status) != 0) {
+			::close(descriptor);
+			throw runtime_error("BinaryModelReader: Could not determine the size of file: " + filename);
+		}
+		size = static_cast<size_t>(status.st_size);
+		if (size > 0) {
+			void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (address == MAP_FAILED) {
+				::close(descriptor);
+				throw runtime_error("BinaryModelReader: Could not map file: " + filename);
+			}
+			data = static_cast<const unsigned char*>(address);
+		}
+		::close(descriptor);
+#endif
+	}
+
+	~Mapping() {
+#ifndef WIN32
+		if (data != nullptr)
+			::munmap(const_cast<unsigned char*>(data), size);
+#endif
+	}
+
+	const unsigned char* data; ///< Pointer to the beginning of the file content.
+	size_t size; ///< The size of the file content in bytes.
+
+private:
+
+	Mapping(const Mapping&); // not copyable
+	Mapping& operator=(const Mapping&); // not assignable
+
+#ifdef WIN32
+	vector<unsigned char> buffer; ///< The file content.
+#endif
+};
+
+static bool isLittleEndian() {
+	const uint16_t value = 1;
+	return *reinterpret_cast<const unsigned char*>(&value) == 1;
+}
+
+BinaryModelReader::BinaryModelReader(const string& filename) :
+		mapping(make_shared<Mapping>(filename)), data(mapping->data), size(mapping->size), position(0), filename(filename) {
+	if (size < BinaryModelWriter::headerSize)
+		throw runtime_error("BinaryModelReader: File is too small to be a binary model: " + filename);
+	if (readLittleEndian(4) != BinaryModelWriter::magic)
+		throw runtime_error("BinaryModelReader: File is not a binary model: " + filename);
+	uint32_t version = static_cast<uint32_t>(readLittleEndian(4));
+	if (version != BinaryModelWriter::version)
+		throw runtime_error("BinaryModelReader: Unsupported format version " + lexical_cast<string>(version) + " (expected "
+				+ lexical_cast<string>(BinaryModelWriter::version) + "): " + filename);
+	type = static_cast<BinaryModelType>(readLittleEndian(4));
+	logistic = (readLittleEndian(4) & 1) != 0;
+	logisticA = readDouble();
+	logisticB = readDouble();
+	position = BinaryModelWriter::headerSize;
+}
+
+void BinaryModelReader::requireType(BinaryModelType expectedType) const {
+	if (type != expectedType)
+		throw runtime_error("BinaryModelReader: File contains a model of type " + lexical_cast<string>(static_cast<uint32_t>(type))
+				+ ", expected type " + lexical_cast<string>(static_cast<uint32_t>(expectedType)) + ": " + filename);
+}
+
+int32_t BinaryModelReader::readInt() {
+	return static_cast<int32_t>(static_cast<uint32_t>(readLittleEndian(4)));
+}
+
+float BinaryModelReader::readFloat() {
+	uint32_t bits = static_cast<uint32_t>(readLittleEndian(4));
+	float value;
+	std::memcpy(&value, &bits, 4);
+	return value;
+}
+
+double BinaryModelReader::readDouble() {
+	uint64_t bits = readLittleEndian(8);
+	double value;
+	std::memcpy(&value, &bits, 8);
+	return value;
+}
+
+Mat BinaryModelReader::readFloats(size_t count) {
+	return readArray(count, CV_32F);
+}
+
+Mat BinaryModelReader::readDoubles(size_t count) {
+	return readArray(count, CV_64F);
+}
+
+Mat BinaryModelReader::readInts(size_t count) {
+	return readArray(count, CV_32S);
+}
+
+string BinaryModelReader::readString() {
+	int length = readInt();
+	if (length < 0)
+		throw runtime_error("BinaryModelReader: Invalid string length: " + filename);
+	require(length);
+	string value(reinterpret_cast<const char*>(data + position), length);
+	position += length;
+	return value;
+}
+
+vector<Mat> BinaryModelReader::readMatrices() {
+	int count = readInt();
+	int rows = readInt();
+	int cols = readInt();
+	int matrixType = readInt();
+	if (count < 0 || rows < 0 || cols < 0)
+		throw runtime_error("BinaryModelReader: Invalid matrix dimensions: " + filename);
+	// the elements of all matrices are read as one array, whose size must fit into an int
+	size_t channels = CV_MAT_CN(matrixType);
+	if (cols > 0 && static_cast<size_t>(rows) > INT_MAX / cols / channels)
+		throw runtime_error("BinaryModelReader: Invalid matrix dimensions: " + filename);
+	size_t elementsPerMatrix = static_cast<size_t>(rows) * cols * channels;
+	if (elementsPerMatrix > 0 && static_cast<size_t>(count) > INT_MAX / elementsPerMatrix)
+		throw runtime_error("BinaryModelReader: Invalid matrix dimensions: " + filename);
+	Mat block = readArray(count * elementsPerMatrix, CV_MAT_DEPTH(matrixType));
+	vector<Mat> matrices;
+	matrices.reserve(count);
+	if (elementsPerMatrix == 0) {
+		matrices.assign(count, Mat(rows, cols, matrixType));
+		return matrices;
+	}
+	// the matrices share the block, so they keep it alive in case it was copied
+	int matrixSize = static_cast<int>(elementsPerMatrix);
+	for (int i = 0; i < count; ++i)
+		matrices.push_back(block.colRange(i * matrixSize, (i + 1) * matrixSize).reshape(CV_MAT_CN(matrixType), rows));
+	return matrices;
+}
+
+shared_ptr<Kernel> BinaryModelReader::readKernel() {
+	int kernelType = readInt();
+	if (kernelType == 0) {
+		return make_shared<LinearKernel>();
+	} else if (kernelType == 1) {
+		double alpha = readDouble();
+		double constant = readDouble();
+		int degree = readInt();
+		return make_shared<PolynomialKernel>(alpha, constant, degree);
+	} else if (kernelType == 2) {
+		double gamma = readDouble();
+		return make_shared<RbfKernel>(gamma);
+	} else if (kernelType == 3) {
+		return make_shared<HistogramIntersectionKernel>();
+	}
+	throw runtime_error("BinaryModelReader: Unknown kernel type " + lexical_cast<string>(kernelType) + ": " + filename);
+}
+
+void BinaryModelReader::require(size_t bytes) const {
+	if (bytes > size || position > size - bytes)
+		throw runtime_error("BinaryModelReader: Unexpected end of file: " + filename);
+}
+
+void BinaryModelReader::align() {
+	position = (position + BinaryModelWriter::alignment - 1) / BinaryModelWriter::alignment * BinaryModelWriter::alignment;
+}
+
+uint64_t BinaryModelReader::readLittleEndian(size_t bytes) {
+	require(bytes);
+	uint64_t value = 0;
+	for (size_t i = 0; i < bytes; ++i)
+		value |= static_cast<uint64_t>(data[position + i]) << (8 * i);
+	position += bytes;
+	return value;
+}
+
+Mat BinaryModelReader::readArray(size_t count, int depth) {
+	align();
+	require(0); // the padding might already reach beyond the end of a truncated file
+	if (count > INT_MAX)
+		throw runtime_error("BinaryModelReader: Array of " + lexical_cast<string>(count) + " elements is too large: " + filename);
+	size_t elementSize = CV_ELEM_SIZE1(depth);
+	if (count > 0 && elementSize > (size - position) / count)
+		throw runtime_error("BinaryModelReader: Unexpected end of file: " + filename);
+	size_t bytes = count * elementSize;
+	const unsigned char* values = data + position;
+	position += bytes;
+	if (count == 0)
+		return Mat(1, 0, depth);
+	if (isLittleEndian() || elementSize == 1)
+		return Mat(1, static_cast<int>(count), depth, const_cast<unsigned char*>(values));
+	Mat array(1, static_cast<int>(count), depth);
+	for (size_t i = 0; i < count; ++i)
+		for (size_t j = 0; j < elementSize; ++j)
+			array.data[i * elementSize + j] = values[i * elementSize + elementSize - 1 - j];
+	return array;
+}
+
+} /* namespace classification */
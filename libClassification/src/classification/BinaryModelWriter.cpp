@@ -0,0 +1,175 @@
+/*
+ * BinaryModelWriter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/KernelVisitor.hpp"
+#include "classification/Kernel.hpp"
+#include "classification/PolynomialKernel.hpp"
+#include "classification/RbfKernel.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+
+using cv::Mat;
+using std::string;
+using std::vector;
+using std::runtime_error;
+using std::invalid_argument;
+
+namespace classification {
+
+const uint32_t BinaryModelWriter::magic = 0x4D564446; // "FDVM" in little-endian byte order
+const uint32_t BinaryModelWriter::version = 1;
+const size_t BinaryModelWriter::headerSize = 48;
+const size_t BinaryModelWriter::alignment = 16;
+
+/**
+ * Kernel visitor that writes the kernel type and parameters.
+ */
+class KernelWriter : public KernelVisitor {
+public:
+
+	explicit KernelWriter(BinaryModelWriter& writer) : writer(writer) {}
+
+	void visit(const LinearKernel& kernel) {
+		writer.writeInt(0);
+	}
+
+	void visit(const PolynomialKernel& kernel) {
+		writer.writeInt(1);
+		writer.writeDouble(kernel.getAlpha());
+		writer.writeDouble(kernel.getConstant());
+		writer.writeInt(kernel.getDegree());
+	}
+
+	void visit(const RbfKernel& kernel) {
+		writer.writeInt(2);
+		writer.writeDouble(kernel.getGamma());
+	}
+
+	void visit(const HistogramIntersectionKernel& kernel) {
+		writer.writeInt(3);
+	}
+
+private:
+
+	BinaryModelWriter& writer;
+};
+
+BinaryModelWriter::BinaryModelWriter(BinaryModelType type) :
+		data(headerSize, 0), type(type), logistic(false), logisticA(0), logisticB(0) {}
+
+void BinaryModelWriter::setLogisticParameters(double logisticA, double logisticB) {
+	this->logistic = true;
+	this->logisticA = logisticA;
+	this->logisticB = logisticB;
+}
+
+void BinaryModelWriter::writeInt(int32_t value) {
+	writeLittleEndian(static_cast<uint32_t>(value), 4);
+}
+
+void BinaryModelWriter::writeFloat(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, 4);
+	writeLittleEndian(bits, 4);
+}
+
+void BinaryModelWriter::writeDouble(double value) {
+	uint64_t bits;
+	std::memcpy(&bits, &value, 8);
+	writeLittleEndian(bits, 8);
+}
+
+void BinaryModelWriter::writeFloats(const float* values, size_t count) {
+	align();
+	writeArray(values, count, sizeof(float));
+}
+
+void BinaryModelWriter::writeDoubles(const double* values, size_t count) {
+	align();
+	writeArray(values, count, sizeof(double));
+}
+
+void BinaryModelWriter::writeInts(const int32_t* values, size_t count) {
+	align();
+	writeArray(values, count, sizeof(int32_t));
+}
+
+void BinaryModelWriter::writeString(const string& value) {
+	writeInt(static_cast<int32_t>(value.size()));
+	data.insert(data.end(), value.begin(), value.end());
+}
+
+void BinaryModelWriter::writeMatrices(const vector<Mat>& matrices) {
+	int rows = matrices.empty() ? 0 : matrices.front().rows;
+	int cols = matrices.empty() ? 0 : matrices.front().cols;
+	int matrixType = matrices.empty() ? CV_32F : matrices.front().type();
+	writeInt(static_cast<int32_t>(matrices.size()));
+	writeInt(rows);
+	writeInt(cols);
+	writeInt(matrixType);
+	align();
+	for (const Mat& matrix : matrices) {
+		if (matrix.rows != rows || matrix.cols != cols || matrix.type() != matrixType)
+			throw invalid_argument("BinaryModelWriter: all matrices must have the same size and type");
+		Mat continuousMatrix = matrix.isContinuous() ? matrix : matrix.clone();
+		writeArray(continuousMatrix.data, continuousMatrix.total() * continuousMatrix.channels(), continuousMatrix.elemSize1());
+	}
+}
+
+void BinaryModelWriter::writeKernel(const Kernel& kernel) {
+	KernelWriter kernelWriter(*this);
+	kernel.accept(kernelWriter);
+}
+
+void BinaryModelWriter::save(const string& filename) const {
+	BinaryModelWriter headerWriter(type);
+	headerWriter.data.clear();
+	headerWriter.writeLittleEndian(magic, 4);
+	headerWriter.writeLittleEndian(version, 4);
+	headerWriter.writeLittleEndian(static_cast<uint32_t>(type), 4);
+	headerWriter.writeLittleEndian(logistic ? 1 : 0, 4);
+	headerWriter.writeDouble(logisticA);
+	headerWriter.writeDouble(logisticB);
+	headerWriter.data.resize(headerSize, 0);
+
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	if (!file.is_open())
+		throw runtime_error("BinaryModelWriter: Could not open file for writing: " + filename);
+	file.write(reinterpret_cast<const char*>(headerWriter.data.data()), headerSize);
+	file.write(reinterpret_cast<const char*>(data.data() + headerSize), data.size() - headerSize);
+	if (!file)
+		throw runtime_error("BinaryModelWriter: Could not write file: " + filename);
+}
+
+void BinaryModelWriter::align() {
+	data.resize((data.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+void BinaryModelWriter::writeLittleEndian(uint64_t value, size_t size) {
+	for (size_t i = 0; i < size; ++i)
+		data.push_back(static_cast<unsigned char>(value >> (8 * i)));
+}
+
+void BinaryModelWriter::writeArray(const void* values, size_t count, size_t size) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(values);
+	data.reserve(data.size() + count * size);
+	for (size_t i = 0; i < count; ++i, bytes += size) {
+		uint64_t value = 0;
+		switch (size) {
+			case 1: value = bytes[0]; break;
+			case 2: { uint16_t v; std::memcpy(&v, bytes, 2); value = v; break; }
+			case 4: { uint32_t v; std::memcpy(&v, bytes, 4); value = v; break; }
+			case 8: { uint64_t v; std::memcpy(&v, bytes, 8); value = v; break; }
+			default: throw invalid_argument("BinaryModelWriter: unsupported element size");
+		}
+		writeLittleEndian(value, size);
+	}
+}
+
+} /* namespace classification */
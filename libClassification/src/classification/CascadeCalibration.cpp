@@ -0,0 +1,135 @@
+/*
+ * CascadeCalibration.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "classification/CascadeCalibration.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+using std::vector;
+using std::invalid_argument;
+
+namespace classification {
+
+CascadeCalibration::CascadeCalibration(vector<vector<double>> positiveDistances, vector<vector<double>> negativeDistances) :
+		positiveDistances(std::move(positiveDistances)), negativeDistances(std::move(negativeDistances)), stageCount(0) {
+	if (this->positiveDistances.empty())
+		throw invalid_argument("CascadeCalibration: there must be at least one positive sample");
+	stageCount = this->positiveDistances.front().size();
+	if (stageCount == 0)
+		throw invalid_argument("CascadeCalibration: there must be at least one stage");
+	for (const vector<double>& distances : this->positiveDistances)
+		if (distances.size() != stageCount)
+			throw invalid_argument("CascadeCalibration: all samples must have the same number of stages");
+	for (const vector<double>& distances : this->negativeDistances)
+		if (distances.size() != stageCount)
+			throw invalid_argument("CascadeCalibration: all samples must have the same number of stages");
+}
+
+CascadeCalibration::OperatingPoint CascadeCalibration::evaluate(const vector<float>& thresholds) const {
+	if (thresholds.size() != stageCount)
+		throw invalid_argument("CascadeCalibration: the number of thresholds must match the number of stages");
+	OperatingPoint point;
+	size_t acceptedCount = 0;
+	size_t filterCount = 0;
+	for (const vector<double>& distances : positiveDistances) {
+		bool accepted;
+		filterCount += computeEvaluatedStages(distances, thresholds, accepted);
+		if (accepted)
+			++acceptedCount;
+	}
+	point.recall = static_cast<double>(acceptedCount) / positiveDistances.size();
+	point.averagePositiveFilterCount = static_cast<double>(filterCount) / positiveDistances.size();
+	acceptedCount = 0;
+	filterCount = 0;
+	for (const vector<double>& distances : negativeDistances) {
+		bool accepted;
+		filterCount += computeEvaluatedStages(distances, thresholds, accepted);
+		if (accepted)
+			++acceptedCount;
+	}
+	point.falsePositiveRate = negativeDistances.empty() ? 0 : static_cast<double>(acceptedCount) / negativeDistances.size();
+	point.averageFilterCount = negativeDistances.empty() ? 0 : static_cast<double>(filterCount) / negativeDistances.size();
+	return point;
+}
+
+vector<float> CascadeCalibration::computeThresholdsForRecall(double targetRecall) const {
+	if (targetRecall < 0 || targetRecall > 1)
+		throw invalid_argument("CascadeCalibration: the target recall must be between zero and one");
+	size_t allowedLoss = static_cast<size_t>(std::floor((1 - targetRecall) * positiveDistances.size() + 1e-9));
+	vector<float> thresholds(stageCount);
+	vector<const vector<double>*> survivors;
+	survivors.reserve(positiveDistances.size());
+	for (const vector<double>& distances : positiveDistances)
+		survivors.push_back(&distances);
+	size_t loss = 0;
+	vector<double> stageDistances;
+	for (size_t stage = 0; stage < stageCount; ++stage) {
+		if (survivors.empty()) { // nothing left to keep, so reject everything
+			thresholds[stage] = std::numeric_limits<float>::max();
+			continue;
+		}
+		size_t allowedStageLoss = allowedLoss * (stage + 1) / stageCount - loss;
+		stageDistances.clear();
+		for (const vector<double>* distances : survivors)
+			stageDistances.push_back((*distances)[stage]);
+		std::sort(stageDistances.begin(), stageDistances.end());
+		if (allowedStageLoss >= stageDistances.size())
+			thresholds[stage] = std::numeric_limits<float>::max();
+		else
+			thresholds[stage] = toThreshold(stageDistances[allowedStageLoss]);
+		size_t previousCount = survivors.size();
+		float threshold = thresholds[stage];
+		survivors.erase(std::remove_if(survivors.begin(), survivors.end(), [stage, threshold](const vector<double>* distances) {
+			return (*distances)[stage] < threshold;
+		}), survivors.end());
+		loss += previousCount - survivors.size();
+	}
+	return thresholds;
+}
+
+vector<float> CascadeCalibration::computeThresholdsForFilterCount(double targetFilterCount) const {
+	// the number of evaluated filters grows with the recall, so search for the highest recall within the budget
+	double lowerRecall = 0;
+	double upperRecall = 1;
+	vector<float> thresholds = computeThresholdsForRecall(upperRecall);
+	if (evaluate(thresholds).averageFilterCount <= targetFilterCount)
+		return thresholds;
+	thresholds = computeThresholdsForRecall(lowerRecall);
+	for (int iteration = 0; iteration < 30; ++iteration) {
+		double recall = 0.5 * (lowerRecall + upperRecall);
+		vector<float> candidate = computeThresholdsForRecall(recall);
+		if (evaluate(candidate).averageFilterCount <= targetFilterCount) {
+			lowerRecall = recall;
+			thresholds = candidate;
+		} else {
+			upperRecall = recall;
+		}
+	}
+	return thresholds;
+}
+
+size_t CascadeCalibration::computeEvaluatedStages(const vector<double>& distances, const vector<float>& thresholds, bool& accepted) const {
+	for (size_t stage = 0; stage < stageCount; ++stage) {
+		if (distances[stage] < thresholds[stage]) {
+			accepted = false;
+			return stage + 1;
+		}
+	}
+	accepted = true;
+	return stageCount;
+}
+
+float CascadeCalibration::toThreshold(double distance) {
+	float threshold = static_cast<float>(distance);
+	if (threshold > distance)
+		threshold = std::nextafter(threshold, -std::numeric_limits<float>::infinity());
+	return threshold;
+}
+
+} /* namespace classification */
@@ -6,6 +6,9 @@
  */
 
 #include "classification/FrameBasedExampleManagement.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include <stdexcept>
 
 using cv::Mat;
 using std::vector;
@@ -46,6 +49,24 @@ unique_ptr<ExampleManagement::ExampleIterator> FrameBasedExampleManagement::iter
 	return unique_ptr<FrameIterator>(new FrameIterator(examples));
 }
 
+void FrameBasedExampleManagement::saveState(BinaryModelWriter& writer) const {
+	writer.writeInt(static_cast<int32_t>(examples.size()));
+	for (const vector<Mat>& frame : examples)
+		writer.writeMatrices(frame);
+	writer.writeInt(static_cast<int32_t>(oldestEntry));
+}
+
+void FrameBasedExampleManagement::loadState(BinaryModelReader& reader) {
+	if (reader.readInt() != static_cast<int32_t>(examples.size()))
+		throw std::runtime_error("FrameBasedExampleManagement: the frame capacity of the snapshot differs");
+	for (vector<Mat>& frame : examples) {
+		frame.clear();
+		for (const Mat& example : reader.readMatrices())
+			frame.push_back(example.clone());
+	}
+	oldestEntry = reader.readInt();
+}
+
 FrameBasedExampleManagement::FrameIterator::FrameIterator(const vector<vector<Mat>>& examples) :
 		currentFrame(examples.cbegin()), endFrame(examples.cend()), current(currentFrame->begin()), end(currentFrame->end()) {}
 
@@ -0,0 +1,149 @@
+/*
+ * HistogramIntersectionLookupTable.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "classification/HistogramIntersectionLookupTable.hpp"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+using cv::Mat;
+using std::vector;
+using std::invalid_argument;
+
+namespace classification {
+
+template<class T>
+static void copyValues(const Mat& vector, float* values) {
+	const T* source = vector.ptr<T>();
+	size_t size = vector.total() * vector.channels();
+	for (size_t i = 0; i < size; ++i)
+		values[i] = static_cast<float>(source[i]);
+}
+
+HistogramIntersectionLookupTable::HistogramIntersectionLookupTable(
+		const vector<Mat>& supportVectors, const vector<float>& coefficients, size_t binCount) :
+				dimensionCount(0), vectorCount(supportVectors.size()), binCount(binCount) {
+	if (supportVectors.size() != coefficients.size())
+		throw invalid_argument("HistogramIntersectionLookupTable: the number of support vectors and coefficients must be the same");
+	if (binCount == 1)
+		throw invalid_argument("HistogramIntersectionLookupTable: there must be at least two interpolation points");
+	if (supportVectors.empty())
+		return;
+	dimensionCount = supportVectors.front().total() * supportVectors.front().channels();
+
+	// transpose the support vectors, so the values of each dimension are contiguous
+	vector<float> transposed(vectorCount * dimensionCount);
+	vector<float> supportVector(dimensionCount);
+	for (size_t j = 0; j < vectorCount; ++j) {
+		const Mat& vector = supportVectors[j];
+		if (!vector.isContinuous())
+			throw invalid_argument("HistogramIntersectionLookupTable: support vectors have to be continuous");
+		if (vector.total() * vector.channels() != dimensionCount)
+			throw invalid_argument("HistogramIntersectionLookupTable: support vectors have to have the same length");
+		switch (vector.depth()) {
+			case CV_8U: copyValues<uchar>(vector, supportVector.data()); break;
+			case CV_32S: copyValues<int>(vector, supportVector.data()); break;
+			case CV_32F: copyValues<float>(vector, supportVector.data()); break;
+			default: throw invalid_argument("HistogramIntersectionLookupTable: support vectors have to be of depth CV_8U, CV_32S or CV_32F");
+		}
+		for (size_t i = 0; i < dimensionCount; ++i)
+			transposed[i * vectorCount + j] = supportVector[i];
+	}
+
+	values.resize(vectorCount * dimensionCount);
+	weightedValueSums.resize((vectorCount + 1) * dimensionCount);
+	coefficientSums.resize((vectorCount + 1) * dimensionCount);
+	coefficientTotals.resize(dimensionCount);
+	vector<size_t> order(vectorCount);
+	for (size_t i = 0; i < dimensionCount; ++i) {
+		const float* dimensionValues = &transposed[i * vectorCount];
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [dimensionValues](size_t a, size_t b) {
+			return dimensionValues[a] < dimensionValues[b];
+		});
+		float* sortedValues = &values[i * vectorCount];
+		double* weightedValueSum = &weightedValueSums[i * (vectorCount + 1)];
+		double* coefficientSum = &coefficientSums[i * (vectorCount + 1)];
+		weightedValueSum[0] = 0;
+		coefficientSum[0] = 0;
+		for (size_t k = 0; k < vectorCount; ++k) {
+			sortedValues[k] = dimensionValues[order[k]];
+			weightedValueSum[k + 1] = weightedValueSum[k] + static_cast<double>(coefficients[order[k]]) * sortedValues[k];
+			coefficientSum[k + 1] = coefficientSum[k] + coefficients[order[k]];
+		}
+		coefficientTotals[i] = coefficientSum[vectorCount];
+	}
+
+	if (binCount > 0) {
+		lowerBounds.resize(dimensionCount);
+		binWidths.resize(dimensionCount);
+		table.resize(binCount * dimensionCount);
+		for (size_t i = 0; i < dimensionCount; ++i) {
+			double lowerBound = values[i * vectorCount];
+			double upperBound = values[i * vectorCount + vectorCount - 1];
+			lowerBounds[i] = lowerBound;
+			binWidths[i] = (upperBound - lowerBound) / (binCount - 1);
+			for (size_t bin = 0; bin < binCount; ++bin)
+				table[i * binCount + bin] = computeExact(i, lowerBound + bin * binWidths[i]);
+		}
+		// the exact functions are not needed anymore
+		vector<float>().swap(values);
+		vector<double>().swap(weightedValueSums);
+		vector<double>().swap(coefficientSums);
+	}
+}
+
+double HistogramIntersectionLookupTable::compute(const Mat& featureVector) const {
+	if (vectorCount == 0)
+		return 0;
+	if (!featureVector.isContinuous())
+		throw invalid_argument("HistogramIntersectionLookupTable: feature vector has to be continuous");
+	if (featureVector.total() * featureVector.channels() != dimensionCount)
+		throw invalid_argument("HistogramIntersectionLookupTable: feature vector has to have the same length as the support vectors");
+	switch (featureVector.depth()) {
+		case CV_8U: return compute(featureVector.ptr<uchar>());
+		case CV_32S: return compute(featureVector.ptr<int>());
+		case CV_32F: return compute(featureVector.ptr<float>());
+	}
+	throw invalid_argument("HistogramIntersectionLookupTable: feature vector has to be of depth CV_8U, CV_32S or CV_32F");
+}
+
+template<class T>
+double HistogramIntersectionLookupTable::compute(const T* values) const {
+	double sum = 0;
+	if (binCount == 0) {
+		for (size_t i = 0; i < dimensionCount; ++i)
+			sum += computeExact(i, values[i]);
+	} else {
+		for (size_t i = 0; i < dimensionCount; ++i)
+			sum += computeInterpolated(i, values[i]);
+	}
+	return sum;
+}
+
+double HistogramIntersectionLookupTable::computeExact(size_t dimension, double value) const {
+	const float* dimensionValues = &values[dimension * vectorCount];
+	size_t count = std::upper_bound(dimensionValues, dimensionValues + vectorCount, value) - dimensionValues;
+	size_t offset = dimension * (vectorCount + 1);
+	// support vector values up to the feature value contribute themselves, the others contribute the feature value
+	return weightedValueSums[offset + count] + value * (coefficientTotals[dimension] - coefficientSums[offset + count]);
+}
+
+double HistogramIntersectionLookupTable::computeInterpolated(size_t dimension, double value) const {
+	double position = value - lowerBounds[dimension];
+	if (position <= 0) // below all support vector values, so the function is linear
+		return value * coefficientTotals[dimension];
+	const double* dimensionTable = &table[dimension * binCount];
+	double bin = binWidths[dimension] > 0 ? position / binWidths[dimension] : binCount;
+	if (bin >= binCount - 1) // above all support vector values, so the function is constant
+		return dimensionTable[binCount - 1];
+	size_t index = static_cast<size_t>(bin);
+	double weight = bin - index;
+	return (1 - weight) * dimensionTable[index] + weight * dimensionTable[index + 1];
+}
+
+} /* namespace classification */
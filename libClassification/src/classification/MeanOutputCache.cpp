@@ -0,0 +1,108 @@
+/*
+ * MeanOutputCache.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "classification/MeanOutputCache.hpp"
+#include "classification/SvmClassifier.hpp"
+#include "classification/Kernel.hpp"
+#include <cstring>
+
+using cv::Mat;
+using std::vector;
+using std::unordered_multimap;
+using std::make_pair;
+
+namespace classification {
+
+MeanOutputCache::MeanOutputCache() : kernel(), entries(), changed() {}
+
+void MeanOutputCache::invalidate(size_t index) {
+	if (index < changed.size()) // test examples beyond the known ones are new anyway
+		changed[index] = true;
+}
+
+void MeanOutputCache::clear() {
+	kernel.reset();
+	entries.clear();
+	changed.clear();
+}
+
+double MeanOutputCache::computeMeanOutput(const SvmClassifier& svm, const vector<Mat>& examples) {
+	if (svm.isCompiled()) {
+		double sum = 0;
+		for (const Mat& example : examples)
+			sum += svm.computeHyperplaneDistance(example);
+		return sum / examples.size();
+	}
+	if (svm.getKernel() != kernel || examples.size() < changed.size()) {
+		clear();
+		kernel = svm.getKernel();
+	}
+	changed.resize(examples.size(), true);
+
+	const vector<Mat>& supportVectors = svm.getSupportVectors();
+	const vector<float>& coefficients = svm.getCoefficients();
+	unordered_multimap<size_t, Entry> currentEntries;
+	currentEntries.reserve(supportVectors.size());
+	double weightedSum = 0;
+	for (size_t i = 0; i < supportVectors.size(); ++i) {
+		size_t hash = computeHash(supportVectors[i]);
+		Entry entry;
+		auto range = entries.equal_range(hash);
+		auto cached = range.first;
+		while (cached != range.second && !isEqual(cached->second.supportVector, supportVectors[i]))
+			++cached;
+		if (cached != range.second) { // the support vector survived the re-training
+			entry = std::move(cached->second);
+			entries.erase(cached);
+			entry.kernelValues.resize(examples.size());
+			for (size_t j = 0; j < examples.size(); ++j) {
+				if (changed[j])
+					entry.kernelValues[j] = kernel->compute(examples[j], entry.supportVector);
+			}
+		} else {
+			entry.supportVector = supportVectors[i];
+			entry.kernelValues.reserve(examples.size());
+			for (const Mat& example : examples)
+				entry.kernelValues.push_back(kernel->compute(example, entry.supportVector));
+		}
+		double kernelSum = 0;
+		for (double kernelValue : entry.kernelValues)
+			kernelSum += kernelValue;
+		weightedSum += coefficients[i] * kernelSum;
+		currentEntries.insert(make_pair(hash, std::move(entry)));
+	}
+	entries = std::move(currentEntries); // support vectors that were removed by the re-training are forgotten
+	changed.assign(examples.size(), false);
+	return weightedSum / examples.size() - svm.getBias();
+}
+
+size_t MeanOutputCache::computeHash(const Mat& vector) {
+	// FNV-1a over the bytes of the values
+	size_t hash = 2166136261u;
+	size_t rowSize = vector.cols * vector.elemSize();
+	for (int row = 0; row < vector.rows; ++row) {
+		const unsigned char* values = vector.ptr<unsigned char>(row);
+		for (size_t i = 0; i < rowSize; ++i) {
+			hash ^= values[i];
+			hash *= 16777619u;
+		}
+	}
+	return hash;
+}
+
+bool MeanOutputCache::isEqual(const Mat& lhs, const Mat& rhs) {
+	if (lhs.type() != rhs.type() || lhs.rows != rhs.rows || lhs.cols != rhs.cols)
+		return false;
+	size_t rowSize = lhs.cols * lhs.elemSize();
+	for (int row = 0; row < lhs.rows; ++row) {
+		if (std::memcmp(lhs.ptr(row), rhs.ptr(row), rowSize) != 0)
+			return false;
+	}
+	return true;
+}
+
+} /* namespace classification */
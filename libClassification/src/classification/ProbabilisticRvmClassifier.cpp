@@ -7,6 +7,8 @@
 
 #include "classification/ProbabilisticRvmClassifier.hpp"
 #include "classification/RvmClassifier.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include "classification/BinaryModelWriter.hpp"
 #include "logging/LoggerFactory.hpp"
 #ifdef WITH_MATLAB_CLASSIFIER
 	#include "mat.h"
@@ -80,11 +82,33 @@ shared_ptr<ProbabilisticRvmClassifier> ProbabilisticRvmClassifier::load(const pt
 		// Option 1: Make a pair<float sigmA, float sigmB> loadSigmFromML(...); <- changed to this now
 		//        2: Here, first call rvm = RvmClassifier::loadConfig(subtree), loads everything.
 		//			 Then, here, call prvm = ProbRvmClass::loadMatlab/ProbabilisticStuff(rvm, thresholdsFile);
+	} else if (classifierFile.extension() == ".bin") {
+		return loadFromBinary(classifierFile.string());
 	} else {
-		throw logic_error("ProbabilisticRvmClassifier: Only loading of .mat RVMs is supported. If you want to load a non-cascaded RVM, use an SvmClassifier.");
+		throw logic_error("ProbabilisticRvmClassifier: Only loading of .mat and .bin RVMs is supported. If you want to load a non-cascaded RVM, use an SvmClassifier.");
 	}
 }
 
+shared_ptr<ProbabilisticRvmClassifier> ProbabilisticRvmClassifier::loadFromBinary(const string& classifierFilename)
+{
+	Logger logger = Loggers->getLogger("classification");
+	logger.info("Loading probabilistic RVM classifier from binary file: " + classifierFilename);
+	BinaryModelReader reader(classifierFilename);
+	shared_ptr<RvmClassifier> rvm = RvmClassifier::loadFromBinary(reader);
+	if (!reader.hasLogisticParameters())
+		return make_shared<ProbabilisticRvmClassifier>(rvm);
+	pair<double, double> logisticParams = reader.getLogisticParameters();
+	return make_shared<ProbabilisticRvmClassifier>(rvm, logisticParams.first, logisticParams.second);
+}
+
+void ProbabilisticRvmClassifier::saveToBinary(const string& classifierFilename) const
+{
+	BinaryModelWriter writer(BinaryModelType::RVM);
+	writer.setLogisticParameters(logisticA, logisticB);
+	rvm->saveToBinary(writer);
+	writer.save(classifierFilename);
+}
+
 pair<double, double> ProbabilisticRvmClassifier::loadSigmoidParamsFromMatlab(const string& logisticFilename)
 {
 	Logger logger = Loggers->getLogger("classification");
@@ -7,6 +7,8 @@
 
 #include "classification/ProbabilisticSvmClassifier.hpp"
 #include "classification/SvmClassifier.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include "classification/BinaryModelWriter.hpp"
 #include "logging/LoggerFactory.hpp"
 #ifdef WITH_MATLAB_CLASSIFIER
 	#include "mat.h"
@@ -68,6 +70,8 @@ shared_ptr<ProbabilisticSvmClassifier> ProbabilisticSvmClassifier::load(const pt
 	shared_ptr<ProbabilisticSvmClassifier> psvm;
 	if (classifierFile.extension() == ".mat") {
 		psvm = loadFromMatlab(classifierFile.string(), subtree.get<string>("thresholdsFile"));
+	} else if (classifierFile.extension() == ".bin") {
+		psvm = loadFromBinary(classifierFile.string());
 	} else {
 		shared_ptr<SvmClassifier> svm = SvmClassifier::loadFromText(classifierFile.string()); // Todo: Make a ProbabilisticSvmClassifier::loadFromText(...)
 		if (subtree.get("logisticA", 0.0) == 0.0 || subtree.get("logisticB", 0.0) == 0.0) {
@@ -96,6 +100,26 @@ shared_ptr<ProbabilisticSvmClassifier> ProbabilisticSvmClassifier::loadFromMatla
 	return make_shared<ProbabilisticSvmClassifier>(svm, sigmoidParams.first, sigmoidParams.second);
 }
 
+shared_ptr<ProbabilisticSvmClassifier> ProbabilisticSvmClassifier::loadFromBinary(const string& classifierFilename)
+{
+	Logger logger = Loggers->getLogger("classification");
+	logger.info("Loading probabilistic SVM classifier from binary file: " + classifierFilename);
+	BinaryModelReader reader(classifierFilename);
+	shared_ptr<SvmClassifier> svm = SvmClassifier::loadFromBinary(reader);
+	if (!reader.hasLogisticParameters())
+		return make_shared<ProbabilisticSvmClassifier>(svm);
+	pair<double, double> logisticParams = reader.getLogisticParameters();
+	return make_shared<ProbabilisticSvmClassifier>(svm, logisticParams.first, logisticParams.second);
+}
+
+void ProbabilisticSvmClassifier::saveToBinary(const string& classifierFilename) const
+{
+	BinaryModelWriter writer(BinaryModelType::SVM);
+	writer.setLogisticParameters(logisticA, logisticB);
+	svm->saveToBinary(writer);
+	writer.save(classifierFilename);
+}
+
 pair<double, double> ProbabilisticSvmClassifier::loadSigmoidParamsFromMatlab(const string& logisticFilename)
 {
 	Logger logger = Loggers->getLogger("classification");
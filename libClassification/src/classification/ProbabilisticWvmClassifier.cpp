@@ -7,16 +7,24 @@
 
 #include "classification/ProbabilisticWvmClassifier.hpp"
 #include "classification/WvmClassifier.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include "classification/BinaryModelWriter.hpp"
 #include "logging/LoggerFactory.hpp"
 #ifdef WITH_MATLAB_CLASSIFIER
 	#include "mat.h"
 #endif
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/filesystem/path.hpp"
 #include <iostream>
 #include <stdexcept>
 
 using logging::Logger;
 using logging::LoggerFactory;
 using cv::Mat;
+using boost::filesystem::path;
 using boost::property_tree::ptree;
 using std::pair;
 using std::string;
@@ -74,10 +82,16 @@ pair<bool, double> ProbabilisticWvmClassifier::getProbability(pair<int, double>
 
 shared_ptr<ProbabilisticWvmClassifier> ProbabilisticWvmClassifier::load(const ptree& subtree)
 {
-	pair<double, double> sigmoidParams = loadSigmoidParamsFromMatlab(subtree.get<string>("thresholdsFile"));
-	// Load the detector and thresholds:
-	shared_ptr<WvmClassifier> wvm = WvmClassifier::loadFromMatlab(subtree.get<string>("classifierFile"), subtree.get<string>("thresholdsFile"));
-	shared_ptr<ProbabilisticWvmClassifier> pwvm = make_shared<ProbabilisticWvmClassifier>(wvm, sigmoidParams.first, sigmoidParams.second);
+	path classifierFile = subtree.get<path>("classifierFile");
+	shared_ptr<ProbabilisticWvmClassifier> pwvm;
+	if (classifierFile.extension() == ".bin") {
+		pwvm = loadFromBinary(classifierFile.string());
+	} else {
+		pair<double, double> sigmoidParams = loadSigmoidParamsFromMatlab(subtree.get<string>("thresholdsFile"));
+		// Load the detector and thresholds:
+		shared_ptr<WvmClassifier> wvm = WvmClassifier::loadFromMatlab(classifierFile.string(), subtree.get<string>("thresholdsFile"));
+		pwvm = make_shared<ProbabilisticWvmClassifier>(wvm, sigmoidParams.first, sigmoidParams.second);
+	}
 
 	pwvm->getWvm()->setLimitReliabilityFilter(subtree.get("threshold", 0.0f));
 
@@ -92,6 +106,26 @@ shared_ptr<ProbabilisticWvmClassifier> ProbabilisticWvmClassifier::loadFromMatla
 	return make_shared<ProbabilisticWvmClassifier>(wvm, sigmoidParams.first, sigmoidParams.second);
 }
 
+shared_ptr<ProbabilisticWvmClassifier> ProbabilisticWvmClassifier::loadFromBinary(const string& classifierFilename)
+{
+	Logger logger = Loggers->getLogger("classification");
+	logger.info("Loading probabilistic WVM classifier from binary file: " + classifierFilename);
+	BinaryModelReader reader(classifierFilename);
+	shared_ptr<WvmClassifier> wvm = WvmClassifier::loadFromBinary(reader);
+	if (!reader.hasLogisticParameters())
+		return make_shared<ProbabilisticWvmClassifier>(wvm);
+	pair<double, double> logisticParams = reader.getLogisticParameters();
+	return make_shared<ProbabilisticWvmClassifier>(wvm, logisticParams.first, logisticParams.second);
+}
+
+void ProbabilisticWvmClassifier::saveToBinary(const string& classifierFilename) const
+{
+	BinaryModelWriter writer(BinaryModelType::WVM);
+	writer.setLogisticParameters(logisticA, logisticB);
+	wvm->saveToBinary(writer);
+	writer.save(classifierFilename);
+}
+
 pair<double, double> ProbabilisticWvmClassifier::loadSigmoidParamsFromMatlab(const string& thresholdsFilename)
 {
 	Logger logger = Loggers->getLogger("classification");
@@ -0,0 +1,223 @@
+/*
+ * ReducedSetConstruction.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "classification/ReducedSetConstruction.hpp"
+#include "classification/SvmClassifier.hpp"
+#include "classification/RbfKernel.hpp"
+#include "classification/PolynomialKernel.hpp"
+#include "logging/LoggerFactory.hpp"
+#include "boost/lexical_cast.hpp"
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+using logging::Logger;
+using logging::LoggerFactory;
+using boost::lexical_cast;
+using cv::Mat;
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using std::invalid_argument;
+
+namespace classification {
+
+namespace {
+
+/**
+ * Kernel function that operates on rows of double precision matrices.
+ */
+class ReducedSetKernel {
+public:
+
+	explicit ReducedSetKernel(const Kernel& kernel) : rbf(false), gamma(0), alpha(0), constant(0), degree(0) {
+		if (const RbfKernel* rbfKernel = dynamic_cast<const RbfKernel*>(&kernel)) {
+			rbf = true;
+			gamma = rbfKernel->getGamma();
+		} else if (const PolynomialKernel* polynomialKernel = dynamic_cast<const PolynomialKernel*>(&kernel)) {
+			alpha = polynomialKernel->getAlpha();
+			constant = polynomialKernel->getConstant();
+			degree = polynomialKernel->getDegree();
+		} else {
+			throw invalid_argument("ReducedSetConstruction: only RBF and polynomial kernels are supported");
+		}
+	}
+
+	double compute(const Mat& lhs, const Mat& rhs) const {
+		if (rbf)
+			return std::exp(-gamma * cv::norm(lhs, rhs, cv::NORM_L2SQR));
+		return std::pow(alpha * lhs.dot(rhs) + constant, degree);
+	}
+
+	/**
+	 * Computes the weight of a vector within the fixed-point update, which is the derivative of the kernel
+	 * (up to a factor that is the same for all vectors).
+	 */
+	double computeUpdateWeight(const Mat& vector, const Mat& z) const {
+		if (rbf)
+			return compute(vector, z);
+		return std::pow(alpha * vector.dot(z) + constant, degree - 1);
+	}
+
+	/**
+	 * Computes the factor the fixed-point update is scaled with.
+	 */
+	double computeUpdateFactor(const Mat& z) const {
+		if (rbf)
+			return 1;
+		return alpha * z.dot(z) + constant;
+	}
+
+	bool rbf;        ///< Flag that indicates whether this is an RBF kernel (polynomial kernel otherwise).
+	double gamma;    ///< The parameter of the RBF kernel.
+	double alpha;    ///< The slope of the polynomial kernel.
+	double constant; ///< The constant term of the polynomial kernel.
+	int degree;      ///< The degree of the polynomial kernel.
+};
+
+/**
+ * Expansion in feature space, sum<sub>i</sub>(w<sub>i</sub> * phi(v<sub>i</sub>)).
+ */
+struct Expansion {
+	vector<Mat> vectors; ///< The vectors (rows of depth CV_64F).
+	vector<double> weights; ///< The weights of the vectors.
+
+	double computeProjection(const ReducedSetKernel& kernel, const Mat& z) const {
+		double projection = 0;
+		for (size_t i = 0; i < vectors.size(); ++i)
+			projection += weights[i] * kernel.compute(vectors[i], z);
+		return projection;
+	}
+};
+
+} /* anonymous namespace */
+
+ReducedSetConstruction::ReducedSetConstruction(int iterationCount, int restartCount) :
+		iterationCount(iterationCount), restartCount(restartCount) {
+	if (iterationCount < 1 || restartCount < 1)
+		throw invalid_argument("ReducedSetConstruction: the number of iterations and restarts must be positive");
+}
+
+shared_ptr<SvmClassifier> ReducedSetConstruction::reduce(const SvmClassifier& svm, size_t vectorCount) const {
+	Logger logger = Loggers->getLogger("classification");
+	const vector<Mat>& supportVectors = svm.getSupportVectors();
+	const vector<float>& coefficients = svm.getCoefficients();
+	shared_ptr<SvmClassifier> reducedSvm = make_shared<SvmClassifier>(svm.getKernel());
+	reducedSvm->setThreshold(svm.getThreshold());
+	if (supportVectors.size() <= vectorCount) {
+		reducedSvm->setSvmParameters(supportVectors, coefficients, svm.getBias());
+		return reducedSvm;
+	}
+	if (vectorCount == 0)
+		throw invalid_argument("ReducedSetConstruction: the number of vectors must be positive");
+	ReducedSetKernel kernel(*svm.getKernel());
+
+	int rows = supportVectors.front().rows;
+	int type = supportVectors.front().type();
+	Expansion original;
+	for (size_t i = 0; i < supportVectors.size(); ++i) {
+		if (!supportVectors[i].isContinuous())
+			throw invalid_argument("ReducedSetConstruction: support vectors have to be continuous");
+		Mat vector;
+		supportVectors[i].reshape(1, 1).convertTo(vector, CV_64F);
+		original.vectors.push_back(vector);
+		original.weights.push_back(coefficients[i]);
+	}
+
+	vector<Mat> reducedVectors; // in the original type
+	Expansion reduced; // with the coefficients of the reduced vectors
+	cv::RNG rng;
+	for (size_t m = 0; m < vectorCount; ++m) {
+		// the residual is the difference between the original and the current reduced expansion
+		Expansion residual = original;
+		for (size_t k = 0; k < reduced.vectors.size(); ++k) {
+			residual.vectors.push_back(reduced.vectors[k]);
+			residual.weights.push_back(-reduced.weights[k]);
+		}
+
+		// find the pre-image whose projection onto the residual is the largest
+		Mat bestZ;
+		double bestObjective = -1;
+		for (int restart = 0; restart < restartCount; ++restart) {
+			Mat z = original.vectors[rng.uniform(0, static_cast<int>(original.vectors.size()))].clone();
+			for (int iteration = 0; iteration < iterationCount; ++iteration) {
+				double projection = residual.computeProjection(kernel, z);
+				double norm = kernel.compute(z, z);
+				double objective = norm > 0 ? projection * projection / norm : 0;
+				if (objective > bestObjective) {
+					bestObjective = objective;
+					bestZ = z.clone();
+				}
+				// fixed point of the gradient of the objective, the denominator is the projection for both kernels
+				if (std::abs(projection) < std::numeric_limits<double>::epsilon())
+					break;
+				Mat numerator = Mat::zeros(z.size(), CV_64F);
+				for (size_t i = 0; i < residual.vectors.size(); ++i)
+					numerator += (residual.weights[i] * kernel.computeUpdateWeight(residual.vectors[i], z)) * residual.vectors[i];
+				Mat nextZ = (kernel.computeUpdateFactor(z) / projection) * numerator;
+				double change = cv::norm(nextZ, z);
+				z = nextZ;
+				if (change <= 1e-6 * std::max(1.0, cv::norm(z)))
+					break;
+			}
+		}
+
+		// store the vector in the original type and continue with the (possibly rounded) values
+		Mat reducedVector;
+		bestZ.reshape(CV_MAT_CN(type), rows).convertTo(reducedVector, type);
+		reducedVectors.push_back(reducedVector);
+		Mat z;
+		reducedVector.reshape(1, 1).convertTo(z, CV_64F);
+		reduced.vectors.push_back(z);
+
+		// refit the coefficients of all reduced vectors: K_zz * beta = K_zx * alpha
+		size_t count = reduced.vectors.size();
+		Mat kernelMatrix(count, count, CV_64F);
+		Mat projections(count, 1, CV_64F);
+		for (size_t k = 0; k < count; ++k) {
+			for (size_t l = k; l < count; ++l)
+				kernelMatrix.at<double>(k, l) = kernelMatrix.at<double>(l, k) = kernel.compute(reduced.vectors[k], reduced.vectors[l]);
+			projections.at<double>(k) = original.computeProjection(kernel, reduced.vectors[k]);
+		}
+		Mat beta;
+		cv::solve(kernelMatrix, projections, beta, cv::DECOMP_SVD);
+		reduced.weights.assign(beta.ptr<double>(), beta.ptr<double>() + count);
+		logger.debug("ReducedSetConstruction: constructed vector " + lexical_cast<string>(count) + " of " + lexical_cast<string>(vectorCount));
+	}
+
+	vector<float> reducedCoefficients(reduced.weights.begin(), reduced.weights.end());
+	reducedSvm->setSvmParameters(reducedVectors, reducedCoefficients, svm.getBias());
+	logger.info("ReducedSetConstruction: reduced " + lexical_cast<string>(supportVectors.size())
+			+ " support vectors to " + lexical_cast<string>(vectorCount) + " synthetic vectors");
+	return reducedSvm;
+}
+
+ReducedSetConstruction::ApproximationError ReducedSetConstruction::computeApproximationError(
+		const SvmClassifier& original, const SvmClassifier& reduced, const vector<Mat>& featureVectors) {
+	ApproximationError error;
+	error.meanAbsoluteDifference = 0;
+	error.maxAbsoluteDifference = 0;
+	error.labelAgreement = 1;
+	if (featureVectors.empty())
+		return error;
+	size_t agreements = 0;
+	for (const Mat& featureVector : featureVectors) {
+		double originalDistance = original.computeHyperplaneDistance(featureVector);
+		double reducedDistance = reduced.computeHyperplaneDistance(featureVector);
+		double difference = std::abs(originalDistance - reducedDistance);
+		error.meanAbsoluteDifference += difference;
+		error.maxAbsoluteDifference = std::max(error.maxAbsoluteDifference, difference);
+		if (original.classify(originalDistance) == reduced.classify(reducedDistance))
+			++agreements;
+	}
+	error.meanAbsoluteDifference /= featureVectors.size();
+	error.labelAgreement = static_cast<double>(agreements) / featureVectors.size();
+	return error;
+}
+
+} /* namespace classification */
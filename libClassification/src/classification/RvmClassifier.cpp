@@ -6,6 +6,8 @@
  */
 
 #include "classification/RvmClassifier.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include "classification/BinaryModelWriter.hpp"
 #include "classification/PolynomialKernel.hpp"
 #include "classification/RbfKernel.hpp"
 #include "logging/LoggerFactory.hpp"
@@ -112,6 +114,14 @@ double RvmClassifier::computeHyperplaneDistanceCached(const Mat& featureVector,
 	return distance;
 }
 
+vector<double> RvmClassifier::computeHyperplaneDistances(const Mat& featureVector) const {
+	vector<double> distances(static_cast<size_t>(this->numFiltersToUse));
+	vector<double> filterEvalCache(distances.size());
+	for (size_t filterLevel = 0; filterLevel < distances.size(); ++filterLevel)
+		distances[filterLevel] = computeHyperplaneDistanceCached(featureVector, filterLevel, filterEvalCache);
+	return distances;
+}
+
 unsigned int RvmClassifier::getNumFiltersToUse(void) const
 {
 	return numFiltersToUse;
@@ -126,6 +136,13 @@ void RvmClassifier::setNumFiltersToUse(const unsigned int numFilters)
 	}
 }
 
+void RvmClassifier::setHierarchicalThresholds(const vector<float>& thresholds)
+{
+	if (thresholds.size() != this->coefficients.size())
+		throw invalid_argument("RvmClassifier: the number of thresholds has to match the number of filter levels");
+	this->hierarchicalThresholds = thresholds;
+}
+
 shared_ptr<RvmClassifier> RvmClassifier::load(const ptree& subtree)
 {
 	path classifierFile = subtree.get<path>("classifierFile");
@@ -137,9 +154,74 @@ shared_ptr<RvmClassifier> RvmClassifier::load(const ptree& subtree)
 		//wvm->numUsedFilters=280;	// Todo make dynamic (from script)
 		return rvm;
 	}
+	else if (classifierFile.extension() == ".bin") {
+		return loadFromBinary(classifierFile.string());
+	}
 	else {
-		throw logic_error("ProbabilisticRvmClassifier: Only loading of .mat RVMs is supported. If you want to load a non-cascaded RVM, use an SvmClassifier.");
+		throw logic_error("RvmClassifier: Only loading of .mat and .bin RVMs is supported. If you want to load a non-cascaded RVM, use an SvmClassifier.");
+	}
+}
+
+shared_ptr<RvmClassifier> RvmClassifier::loadFromBinary(const string& classifierFilename)
+{
+	Logger logger = Loggers->getLogger("classification");
+	logger.info("Loading RVM classifier from binary file: " + classifierFilename);
+	BinaryModelReader reader(classifierFilename);
+	shared_ptr<RvmClassifier> rvm = loadFromBinary(reader);
+	logger.info("RVM successfully read.");
+	return rvm;
+}
+
+shared_ptr<RvmClassifier> RvmClassifier::loadFromBinary(BinaryModelReader& reader)
+{
+	reader.requireType(BinaryModelType::RVM);
+	shared_ptr<RvmClassifier> rvm = make_shared<RvmClassifier>(reader.readKernel());
+	rvm->bias = reader.readFloat();
+	rvm->supportVectors = reader.readMatrices();
+
+	// The coefficients are stored as a packed triangle: level i has the i + 1 coefficients of the vectors 0 to i
+	int levelCount = reader.readInt();
+	if (levelCount < 0 || static_cast<size_t>(levelCount) > rvm->supportVectors.size())
+		throw runtime_error("RvmClassifier: Invalid binary classifier file, there are more filter levels than reduced vectors");
+	Mat packedCoefficients = reader.readFloats(static_cast<size_t>(levelCount) * (levelCount + 1) / 2);
+	const float* coefficients = packedCoefficients.ptr<float>();
+	rvm->coefficients.reserve(levelCount);
+	for (int level = 0; level < levelCount; ++level) {
+		rvm->coefficients.push_back(vector<float>(coefficients, coefficients + level + 1));
+		coefficients += level + 1;
+	}
+	Mat thresholds = reader.readFloats(levelCount);
+	rvm->hierarchicalThresholds.assign(thresholds.ptr<float>(), thresholds.ptr<float>() + levelCount);
+
+	rvm->storage = reader.getStorage();
+	rvm->setNumFiltersToUse(levelCount);
+	return rvm;
+}
+
+void RvmClassifier::saveToBinary(const string& classifierFilename) const
+{
+	BinaryModelWriter writer(BinaryModelType::RVM);
+	saveToBinary(writer);
+	writer.save(classifierFilename);
+}
+
+void RvmClassifier::saveToBinary(BinaryModelWriter& writer) const
+{
+	if (hierarchicalThresholds.size() != coefficients.size())
+		throw logic_error("RvmClassifier: Cannot store an RVM with a different number of thresholds and filter levels");
+	writer.writeKernel(*kernel);
+	writer.writeFloat(bias);
+	writer.writeMatrices(supportVectors);
+	writer.writeInt(static_cast<int32_t>(coefficients.size()));
+	vector<float> packedCoefficients;
+	packedCoefficients.reserve(coefficients.size() * (coefficients.size() + 1) / 2);
+	for (size_t level = 0; level < coefficients.size(); ++level) {
+		if (coefficients[level].size() != level + 1)
+			throw logic_error("RvmClassifier: Cannot store an RVM whose filter level " + lexical_cast<string>(level) + " does not have " + lexical_cast<string>(level + 1) + " coefficients");
+		packedCoefficients.insert(packedCoefficients.end(), coefficients[level].begin(), coefficients[level].end());
 	}
+	writer.writeFloats(packedCoefficients.data(), packedCoefficients.size());
+	writer.writeFloats(hierarchicalThresholds.data(), hierarchicalThresholds.size());
 }
 
 shared_ptr<RvmClassifier> RvmClassifier::loadFromMatlab(const string& classifierFilename, const string& thresholdsFilename)
@@ -6,17 +6,24 @@
  */
 
 #include "classification/SvmClassifier.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/HistogramIntersectionKernel.hpp"
+#include "classification/HistogramIntersectionLookupTable.hpp"
 #include "classification/PolynomialKernel.hpp"
 #include "classification/RbfKernel.hpp"
 #include "logging/LoggerFactory.hpp"
+#include "boost/lexical_cast.hpp"
 #ifdef WITH_MATLAB_CLASSIFIER
 	#include "mat.h"
 #endif
 #include <stdexcept>
 #include <fstream>
+#include <cmath>
 
 using logging::Logger;
 using logging::LoggerFactory;
+using boost::lexical_cast;
 using cv::Mat;
 using std::pair;
 using std::string;
@@ -30,7 +37,8 @@ using std::runtime_error;
 namespace classification {
 
 SvmClassifier::SvmClassifier(shared_ptr<Kernel> kernel) :
-		VectorMachineClassifier(kernel), supportVectors(), coefficients() {}
+		VectorMachineClassifier(kernel), supportVectors(), coefficients(),
+		compilationEnabled(false), lookupTableBinCount(0), lookupTable() {}
 
 bool SvmClassifier::classify(const Mat& featureVector) const {
 	return classify(computeHyperplaneDistance(featureVector));
@@ -52,6 +60,12 @@ pair<bool, double> SvmClassifier::getConfidence(double hyperplaneDistance) const
 }
 
 double SvmClassifier::computeHyperplaneDistance(const Mat& featureVector) const {
+	if (lookupTable)
+		return lookupTable->compute(featureVector) - bias;
+	return computeExactHyperplaneDistance(featureVector);
+}
+
+double SvmClassifier::computeExactHyperplaneDistance(const Mat& featureVector) const {
 	double distance = -bias;
 	for (size_t i = 0; i < supportVectors.size(); ++i)
 		distance += coefficients[i] * kernel->compute(featureVector, supportVectors[i]);
@@ -62,6 +76,50 @@ void SvmClassifier::setSvmParameters(vector<Mat> supportVectors, vector<float> c
 	this->supportVectors = supportVectors;
 	this->coefficients = coefficients;
 	this->bias = bias;
+	compile();
+}
+
+void SvmClassifier::setCompiled(bool compiled, size_t binCount) {
+	compilationEnabled = compiled;
+	lookupTableBinCount = binCount;
+	compile();
+}
+
+double SvmClassifier::measureCompilationError(int sampleCount) const {
+	if (!lookupTable)
+		return 0;
+	// the error is measured on random histograms that cover the value range of the support vectors, because the
+	// support vectors themselves are no typical inputs (and the interpolation is exact at some of their values)
+	Mat maxValues;
+	for (const Mat& supportVector : supportVectors) {
+		Mat values;
+		supportVector.convertTo(values, CV_32F);
+		if (maxValues.empty())
+			maxValues = values;
+		else
+			maxValues = cv::max(maxValues, values);
+	}
+	double compilationError = 0;
+	cv::RNG rng;
+	for (int i = 0; i < sampleCount; ++i) {
+		Mat sample(maxValues.rows, maxValues.cols, CV_32F);
+		rng.fill(sample, cv::RNG::UNIFORM, 0, 1);
+		sample = sample.mul(maxValues);
+		sample.convertTo(sample, supportVectors.front().type());
+		double exactDistance = computeExactHyperplaneDistance(sample);
+		double compiledDistance = lookupTable->compute(sample) - bias;
+		compilationError = std::max(compilationError, std::abs(exactDistance - compiledDistance));
+	}
+	return compilationError;
+}
+
+void SvmClassifier::compile() {
+	lookupTable.reset();
+	if (!compilationEnabled || supportVectors.empty() || !dynamic_cast<const HistogramIntersectionKernel*>(kernel.get()))
+		return;
+	lookupTable = make_shared<HistogramIntersectionLookupTable>(supportVectors, coefficients, lookupTableBinCount);
+	Loggers->getLogger("classification").debug("SvmClassifier: compiled " + lexical_cast<string>(supportVectors.size())
+			+ " support vectors into a lookup table");
 }
 
 shared_ptr<SvmClassifier> SvmClassifier::loadFromText(const string& classifierFilename)
@@ -143,6 +201,47 @@ shared_ptr<SvmClassifier> SvmClassifier::loadFromText(const string& classifierFi
 	return svm;
 }
 
+shared_ptr<SvmClassifier> SvmClassifier::loadFromBinary(const string& classifierFilename)
+{
+	Logger logger = Loggers->getLogger("classification");
+	logger.info("Loading SVM classifier from binary file: " + classifierFilename);
+	BinaryModelReader reader(classifierFilename);
+	shared_ptr<SvmClassifier> svm = loadFromBinary(reader);
+	logger.info("SVM successfully read.");
+	return svm;
+}
+
+shared_ptr<SvmClassifier> SvmClassifier::loadFromBinary(BinaryModelReader& reader)
+{
+	reader.requireType(BinaryModelType::SVM);
+	shared_ptr<SvmClassifier> svm = make_shared<SvmClassifier>(reader.readKernel());
+	svm->bias = reader.readFloat();
+	int svCount = reader.readInt();
+	Mat coefficients = reader.readFloats(svCount);
+	svm->coefficients.assign(coefficients.ptr<float>(), coefficients.ptr<float>() + svCount);
+	svm->supportVectors = reader.readMatrices();
+	if (svm->supportVectors.size() != svm->coefficients.size())
+		throw runtime_error("SvmClassifier: Invalid binary classifier file, the number of support vectors and coefficients differ");
+	svm->storage = reader.getStorage();
+	return svm;
+}
+
+void SvmClassifier::saveToBinary(const string& classifierFilename) const
+{
+	BinaryModelWriter writer(BinaryModelType::SVM);
+	saveToBinary(writer);
+	writer.save(classifierFilename);
+}
+
+void SvmClassifier::saveToBinary(BinaryModelWriter& writer) const
+{
+	writer.writeKernel(*kernel);
+	writer.writeFloat(bias);
+	writer.writeInt(static_cast<int32_t>(coefficients.size()));
+	writer.writeFloats(coefficients.data(), coefficients.size());
+	writer.writeMatrices(supportVectors);
+}
+
 shared_ptr<SvmClassifier> SvmClassifier::loadFromMatlab(const string& classifierFilename)
 {
 	Logger logger = Loggers->getLogger("classification");
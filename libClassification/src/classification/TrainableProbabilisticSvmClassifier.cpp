@@ -9,6 +9,8 @@
 #include "classification/TrainableSvmClassifier.hpp"
 #include "classification/ProbabilisticSvmClassifier.hpp"
 #include "classification/SvmClassifier.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <cmath>
 
 using cv::Mat;
@@ -24,6 +26,7 @@ TrainableProbabilisticSvmClassifier::TrainableProbabilisticSvmClassifier(
 		shared_ptr<TrainableSvmClassifier> trainableSvm, int positiveCount, int negativeCount, double highProb, double lowProb) :
 				probabilisticSvm(make_shared<ProbabilisticSvmClassifier>(trainableSvm->getSvm())), trainableSvm(trainableSvm),
 				positiveTestExamples(), negativeTestExamples(), positiveInsertPosition(0), negativeInsertPosition(0),
+				positiveOutputCache(), negativeOutputCache(),
 				highProb(highProb), lowProb(lowProb), adjustThreshold(false), targetProbability(0.5) {
 	positiveTestExamples.reserve(positiveCount);
 	negativeTestExamples.reserve(negativeCount);
@@ -54,8 +57,8 @@ bool TrainableProbabilisticSvmClassifier::retrain(const vector<Mat>& newPositive
 bool TrainableProbabilisticSvmClassifier::retrain(const vector<Mat>& newPositiveExamples, const vector<Mat>& newNegativeExamples,
 		const vector<Mat>& newPositiveTestExamples, const vector<Mat>& newNegativeTestExamples) {
 	if (positiveTestExamples.capacity() > 0 && negativeTestExamples.capacity() > 0) {
-		addTestExamples(positiveTestExamples, newPositiveTestExamples, positiveInsertPosition);
-		addTestExamples(negativeTestExamples, newNegativeTestExamples, negativeInsertPosition);
+		addTestExamples(positiveTestExamples, newPositiveTestExamples, positiveInsertPosition, positiveOutputCache);
+		addTestExamples(negativeTestExamples, newNegativeTestExamples, negativeInsertPosition, negativeOutputCache);
 	}
 	if (trainableSvm->retrain(newPositiveExamples, newNegativeExamples)) {
 		pair<double, double> logisticParameters = computeLogisticParameters(probabilisticSvm->getSvm());
@@ -69,7 +72,8 @@ bool TrainableProbabilisticSvmClassifier::retrain(const vector<Mat>& newPositive
 	return false;
 }
 
-void TrainableProbabilisticSvmClassifier::addTestExamples(vector<Mat>& examples, const vector<Mat>& newExamples, size_t& insertPosition) {
+void TrainableProbabilisticSvmClassifier::addTestExamples(vector<Mat>& examples, const vector<Mat>& newExamples, size_t& insertPosition,
+		MeanOutputCache& outputCache) {
 	// add new examples as long as there is space available
 	auto example = newExamples.cbegin();
 	for (; examples.size() < examples.capacity() && example != newExamples.cend(); ++example)
@@ -77,6 +81,7 @@ void TrainableProbabilisticSvmClassifier::addTestExamples(vector<Mat>& examples,
 	// replace the oldest examples by new ones
 	for (; example != newExamples.cend(); ++example) {
 		examples[insertPosition] = *example;
+		outputCache.invalidate(insertPosition);
 		++insertPosition;
 		if (insertPosition == examples.size())
 			insertPosition = 0;
@@ -87,9 +92,41 @@ void TrainableProbabilisticSvmClassifier::addTestExamples(vector<Mat>& examples,
 void TrainableProbabilisticSvmClassifier::reset() {
 	positiveTestExamples.clear();
 	negativeTestExamples.clear();
+	positiveOutputCache.clear();
+	negativeOutputCache.clear();
 	trainableSvm->reset();
 }
 
+void TrainableProbabilisticSvmClassifier::saveState(BinaryModelWriter& writer) const {
+	trainableSvm->saveState(writer);
+	pair<double, double> logisticParameters = probabilisticSvm->getLogisticParameters();
+	writer.writeDouble(logisticParameters.first);
+	writer.writeDouble(logisticParameters.second);
+	writer.writeMatrices(positiveTestExamples);
+	writer.writeInt(static_cast<int32_t>(positiveInsertPosition));
+	writer.writeMatrices(negativeTestExamples);
+	writer.writeInt(static_cast<int32_t>(negativeInsertPosition));
+}
+
+void TrainableProbabilisticSvmClassifier::loadState(BinaryModelReader& reader) {
+	trainableSvm->loadState(reader);
+	double logisticA = reader.readDouble();
+	double logisticB = reader.readDouble();
+	probabilisticSvm->setLogisticParameters(logisticA, logisticB);
+	loadTestExamples(reader, positiveTestExamples);
+	positiveInsertPosition = reader.readInt();
+	loadTestExamples(reader, negativeTestExamples);
+	negativeInsertPosition = reader.readInt();
+	positiveOutputCache.clear();
+	negativeOutputCache.clear();
+}
+
+void TrainableProbabilisticSvmClassifier::loadTestExamples(BinaryModelReader& reader, vector<Mat>& examples) {
+	examples.clear(); // keeps the capacity, which determines the amount of test examples
+	for (const Mat& example : reader.readMatrices())
+		examples.push_back(example.clone());
+}
+
 pair<double, double> TrainableProbabilisticSvmClassifier::computeLogisticParameters(double meanPosOutput, double meanNegOutput) const {
 	double logisticB = (log((1 - lowProb) / lowProb) - log((1 - highProb) / highProb)) / (meanNegOutput - meanPosOutput);
 	double logisticA = log((1 - highProb) / highProb) - logisticB * meanPosOutput;
@@ -97,16 +134,9 @@ pair<double, double> TrainableProbabilisticSvmClassifier::computeLogisticParamet
 }
 
 pair<double, double> TrainableProbabilisticSvmClassifier::computeLogisticParameters(shared_ptr<SvmClassifier> svm) const {
-	double meanPosOutput = computeMeanOutput(svm, positiveTestExamples);
-	double meanNegOutput = computeMeanOutput(svm, negativeTestExamples);
+	double meanPosOutput = positiveOutputCache.computeMeanOutput(*svm, positiveTestExamples);
+	double meanNegOutput = negativeOutputCache.computeMeanOutput(*svm, negativeTestExamples);
 	return computeLogisticParameters(meanPosOutput, meanNegOutput);
 }
 
-double TrainableProbabilisticSvmClassifier::computeMeanOutput(shared_ptr<SvmClassifier> svm, const vector<Mat>& examples) const {
-	double sum = 0;
-	for (const Mat& example : examples)
-		sum += svm->computeHyperplaneDistance(example);
-	return sum / examples.size();
-}
-
 } /* namespace classification */
@@ -8,11 +8,16 @@
 #include "classification/TrainableSvmClassifier.hpp"
 #include "classification/SvmClassifier.hpp"
 #include "classification/Kernel.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include <stdexcept>
 
 using cv::Mat;
 using std::pair;
 using std::shared_ptr;
+using std::vector;
 using std::make_shared;
+using std::runtime_error;
 
 namespace classification {
 
@@ -36,6 +41,10 @@ bool TrainableSvmClassifier::isUsable() const {
 	return usable;
 }
 
+void TrainableSvmClassifier::setCompiled(bool compiled, size_t binCount) {
+	svm->setCompiled(compiled, binCount);
+}
+
 shared_ptr<SvmClassifier> TrainableSvmClassifier::getSvm() {
 	return svm;
 }
@@ -44,4 +53,31 @@ const shared_ptr<SvmClassifier> TrainableSvmClassifier::getSvm() const {
 	return svm;
 }
 
+void TrainableSvmClassifier::saveState(BinaryModelWriter& writer) const {
+	const vector<float>& coefficients = svm->getCoefficients();
+	writer.writeInt(usable ? 1 : 0);
+	writer.writeFloat(svm->getBias());
+	writer.writeFloat(svm->getThreshold());
+	writer.writeInt(static_cast<int32_t>(coefficients.size()));
+	writer.writeFloats(coefficients.data(), coefficients.size());
+	writer.writeMatrices(svm->getSupportVectors());
+}
+
+void TrainableSvmClassifier::loadState(BinaryModelReader& reader) {
+	usable = reader.readInt() != 0;
+	float bias = reader.readFloat();
+	float threshold = reader.readFloat();
+	int count = reader.readInt();
+	Mat coefficientRow = reader.readFloats(count);
+	vector<float> coefficients(coefficientRow.ptr<float>(), coefficientRow.ptr<float>() + count);
+	vector<Mat> supportVectors;
+	supportVectors.reserve(count);
+	for (const Mat& supportVector : reader.readMatrices())
+		supportVectors.push_back(supportVector.clone()); // must not point into the snapshot file
+	if (supportVectors.size() != coefficients.size())
+		throw runtime_error("TrainableSvmClassifier: Invalid snapshot, the number of support vectors and coefficients differ");
+	svm->setSvmParameters(supportVectors, coefficients, bias);
+	svm->setThreshold(threshold);
+}
+
 } /* namespace classification */
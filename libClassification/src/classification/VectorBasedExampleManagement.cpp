@@ -6,6 +6,8 @@
  */
 
 #include "classification/VectorBasedExampleManagement.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 
 using cv::Mat;
 using std::vector;
@@ -36,6 +38,16 @@ unique_ptr<ExampleManagement::ExampleIterator> VectorBasedExampleManagement::ite
 	return unique_ptr<VectorIterator>(new VectorIterator(examples));
 }
 
+void VectorBasedExampleManagement::saveState(BinaryModelWriter& writer) const {
+	writer.writeMatrices(examples);
+}
+
+void VectorBasedExampleManagement::loadState(BinaryModelReader& reader) {
+	examples.clear(); // keeps the capacity
+	for (const Mat& example : reader.readMatrices())
+		examples.push_back(example.clone());
+}
+
 VectorBasedExampleManagement::VectorIterator::VectorIterator(const vector<Mat>& examples) : current(examples.cbegin()), end(examples.cend()) {}
 
 bool VectorBasedExampleManagement::VectorIterator::hasNext() const {
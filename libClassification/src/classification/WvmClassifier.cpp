@@ -7,12 +7,15 @@
 
 #include "classification/WvmClassifier.hpp"
 #include "classification/IImg.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include "classification/BinaryModelWriter.hpp"
 #include "logging/LoggerFactory.hpp"
 #ifdef WITH_MATLAB_CLASSIFIER
 	#include "mat.h"
 #endif
 #include "boost/lexical_cast.hpp"
 #include <stdexcept>
+#include <algorithm>
 
 using logging::Logger;
 using logging::LoggerFactory;
@@ -20,11 +23,13 @@ using cv::Mat;
 using boost::lexical_cast;
 using std::pair;
 using std::string;
+using std::vector;
 using std::shared_ptr;
 using std::make_shared;
 using std::make_pair;
 using std::invalid_argument;
 using std::runtime_error;
+using std::logic_error;
 
 namespace classification {
 
@@ -50,12 +55,13 @@ WvmClassifier::WvmClassifier() : VectorMachineClassifier(nullptr)
 
 WvmClassifier::~WvmClassifier()
 {
-	if (linFilters != NULL) {
+	// the arrays of a classifier loaded from the binary format belong to the binary* matrices
+	if (linFilters != NULL && binaryFilters.empty()) {
 		for (int i = 0; i < numLinFilters; ++i)
 			delete [] linFilters[i];
 	}
 	delete [] linFilters;
-	if (hkWeights != NULL)
+	if (hkWeights != NULL && binaryWeights.empty())
 		for (int i = 0; i < numLinFilters; ++i) delete [] hkWeights[i];
 	delete [] hkWeights;
 	delete [] lin_thresholds;
@@ -67,7 +73,7 @@ WvmClassifier::~WvmClassifier()
 				delete area[i];
 		delete[] area;
 	}
-	if (app_rsv_convol!=NULL) delete [] app_rsv_convol;
+	if (app_rsv_convol!=NULL && binaryConvolutions.empty()) delete [] app_rsv_convol;
 
 	if (filter_output!=NULL) delete [] filter_output;
 	if (u_kernel_eval!=NULL) delete [] u_kernel_eval;
@@ -148,6 +154,32 @@ pair<int, double> WvmClassifier::computeHyperplaneDistance(const Mat& featureVec
 	return make_pair(filter_level, fout);
 }
 
+vector<double> WvmClassifier::computeHyperplaneDistances(const Mat& featureVector) const {
+	if (featureVector.type() != CV_8U || featureVector.total() != static_cast<size_t>(filter_size_x * filter_size_y))
+		throw invalid_argument("WvmClassifier: the feature vector has to be of type CV_8U and have the size of the filters");
+	Mat continuousFeatureVector = featureVector.isContinuous() ? featureVector : featureVector.clone();
+
+	IImg iimg_x(this->filter_size_x, this->filter_size_y, 8);
+	iimg_x.calIImgPatch(continuousFeatureVector.ptr<uchar>(), false);
+	IImg iimg_xx(this->filter_size_x, this->filter_size_y, 8);
+	iimg_xx.calIImgPatch(continuousFeatureVector.ptr<uchar>(), true);
+
+	vector<float> filterOutput(this->numLinFilters);
+	vector<float> kernelEval(this->numFiltersPerLevel, 0.0f);
+	vector<double> distances(this->numUsedFilters);
+	for (int filterLevel = 0; filterLevel < this->numUsedFilters; ++filterLevel)
+		distances[filterLevel] = this->linEvalWvmHisteq64(filterLevel, filterLevel % this->numFiltersPerLevel, filterOutput.data(), kernelEval.data(), &iimg_x, &iimg_xx);
+	return distances;
+}
+
+void WvmClassifier::setHierarchicalThresholds(const vector<float>& thresholds)
+{
+	if (thresholds.size() != static_cast<size_t>(this->numLinFilters))
+		throw invalid_argument("WvmClassifier: the number of thresholds has to match the number of filters");
+	this->hierarchicalThresholdsFromFile = thresholds;
+	setLimitReliabilityFilter(this->limitReliabilityFilter);
+}
+
 void WvmClassifier::setNumUsedFilters(int var)
 {
 	if(var>this->numLinFilters || var==0) {
@@ -769,6 +801,177 @@ shared_ptr<WvmClassifier> WvmClassifier::loadFromMatlab(const string& classifier
 #endif
 }
 
+shared_ptr<WvmClassifier> WvmClassifier::loadFromBinary(const string& classifierFilename)
+{
+	Logger logger = Loggers->getLogger("classification");
+	logger.info("Loading WVM classifier from binary file: " + classifierFilename);
+	BinaryModelReader reader(classifierFilename);
+	shared_ptr<WvmClassifier> wvm = loadFromBinary(reader);
+	logger.info("WVM successfully read.");
+	return wvm;
+}
+
+shared_ptr<WvmClassifier> WvmClassifier::loadFromBinary(BinaryModelReader& reader)
+{
+	reader.requireType(BinaryModelType::WVM);
+	shared_ptr<WvmClassifier> wvm = make_shared<WvmClassifier>();
+	wvm->numUsedFilters = 280; // same default as loadFromMatlab
+	wvm->limitReliabilityFilter = 0.0f;
+
+	wvm->filter_size_x = reader.readInt();
+	wvm->filter_size_y = reader.readInt();
+	wvm->basisParam = reader.readFloat();
+	wvm->bias = reader.readFloat();
+	int filterCount = reader.readInt();
+	wvm->numFiltersPerLevel = reader.readInt();
+	wvm->numLevels = reader.readInt();
+	if (wvm->filter_size_x <= 0 || wvm->filter_size_y <= 0 || filterCount <= 0 || wvm->numFiltersPerLevel * wvm->numLevels != filterCount)
+		throw runtime_error("WvmClassifier: Invalid binary classifier file, the dimensions are not consistent");
+	int filterSize = wvm->filter_size_x * wvm->filter_size_y;
+
+	// The filters, weights and convolutions are not copied, but referenced where the reader put them (the mapped
+	// file or, on big-endian platforms, converted copies), so only the tables of row pointers are allocated
+	wvm->storage = reader.getStorage();
+	wvm->binaryFilters = reader.readFloats(static_cast<size_t>(filterCount) * filterSize);
+	float* filters = wvm->binaryFilters.ptr<float>();
+	wvm->linFilters = new float*[filterCount];
+	wvm->numLinFilters = filterCount;
+	for (int i = 0; i < filterCount; ++i)
+		wvm->linFilters[i] = filters + i * filterSize;
+
+	// The weights are stored as a packed triangle: filter i has the i + 1 weights of the filters 0 to i, which
+	// are the only ones the evaluation reads (see linEvalWvmHisteq64)
+	wvm->binaryWeights = reader.readFloats(static_cast<size_t>(filterCount) * (filterCount + 1) / 2);
+	float* weights = wvm->binaryWeights.ptr<float>();
+	wvm->hkWeights = new float*[filterCount];
+	for (int i = 0; i < filterCount; ++i) {
+		wvm->hkWeights[i] = weights;
+		weights += i + 1;
+	}
+
+	Mat thresholds = reader.readFloats(filterCount);
+	wvm->hierarchicalThresholdsFromFile.assign(thresholds.ptr<float>(), thresholds.ptr<float>() + filterCount);
+
+	wvm->binaryConvolutions = reader.readDoubles(filterCount);
+	wvm->app_rsv_convol = wvm->binaryConvolutions.ptr<double>();
+
+	// The areas are stored as the number of gray values per filter, the number of rectangles per gray value,
+	// the gray values and the rectangles (x1, y1, x2, y2), each concatenated over all filters
+	Mat valueCounts = reader.readInts(filterCount);
+	size_t totalValueCount = 0;
+	for (int i = 0; i < filterCount; ++i) {
+		if (valueCounts.at<int>(i) < 0)
+			throw runtime_error("WvmClassifier: Invalid binary classifier file, negative number of gray values");
+		totalValueCount += valueCounts.at<int>(i);
+	}
+	Mat rectangleCounts = reader.readInts(totalValueCount);
+	size_t totalRectangleCount = 0;
+	for (size_t v = 0; v < totalValueCount; ++v) {
+		if (rectangleCounts.at<int>(v) < 0)
+			throw runtime_error("WvmClassifier: Invalid binary classifier file, negative number of rectangles");
+		totalRectangleCount += rectangleCounts.at<int>(v);
+	}
+	Mat values = reader.readDoubles(totalValueCount);
+	Mat rectangles = reader.readInts(4 * totalRectangleCount);
+	const int* rectangleCount = rectangleCounts.ptr<int>();
+	const double* value = values.ptr<double>();
+	const int* coordinates = rectangles.ptr<int>();
+	int w = wvm->filter_size_x;
+	wvm->area = new Area*[filterCount];
+	for (int i = 0; i < filterCount; ++i)
+		wvm->area[i] = NULL;
+	for (int i = 0; i < filterCount; ++i) {
+		int cntval = valueCounts.at<int>(i);
+		wvm->area[i] = new Area(cntval, const_cast<int*>(rectangleCount));
+		for (int v = 0; v < cntval; ++v) {
+			wvm->area[i]->val[v] = value[v];
+			for (int r = 0; r < rectangleCount[v]; ++r) {
+				TRec* rec = &wvm->area[i]->rec[v][r];
+				rec->x1 = *coordinates++;
+				rec->y1 = *coordinates++;
+				rec->x2 = *coordinates++;
+				rec->y2 = *coordinates++;
+				rec->uull = (rec->y1 - 1)*w + rec->x1 - 1;
+				rec->uur = (rec->y1 - 1)*w + rec->x2;
+				rec->dll = (rec->y2)*w + rec->x1 - 1;
+				rec->dr = (rec->y2)*w + rec->x2;
+			}
+		}
+		rectangleCount += cntval;
+		value += cntval;
+	}
+
+	wvm->lin_thresholds = new float[filterCount];
+	for (int i = 0; i < filterCount; ++i)
+		wvm->lin_thresholds[i] = (float)wvm->bias;
+	wvm->filter_output = new float[filterCount];
+	wvm->u_kernel_eval = new float[filterCount];
+
+	wvm->setLimitReliabilityFilter(wvm->limitReliabilityFilter);	// This initializes the vector hierarchicalThresholds
+	wvm->setNumUsedFilters(wvm->numUsedFilters);
+	return wvm;
+}
+
+void WvmClassifier::saveToBinary(const string& classifierFilename) const
+{
+	BinaryModelWriter writer(BinaryModelType::WVM);
+	saveToBinary(writer);
+	writer.save(classifierFilename);
+}
+
+void WvmClassifier::saveToBinary(BinaryModelWriter& writer) const
+{
+	if (numLinFilters <= 0 || linFilters == NULL || hkWeights == NULL || area == NULL || app_rsv_convol == NULL)
+		throw logic_error("WvmClassifier: Cannot store a WVM that was not loaded completely");
+	if (hierarchicalThresholdsFromFile.size() != static_cast<size_t>(numLinFilters))
+		throw logic_error("WvmClassifier: Cannot store a WVM with a different number of thresholds and filters");
+	writer.writeInt(filter_size_x);
+	writer.writeInt(filter_size_y);
+	writer.writeFloat(basisParam);
+	writer.writeFloat(bias);
+	writer.writeInt(numLinFilters);
+	writer.writeInt(numFiltersPerLevel);
+	writer.writeInt(numLevels);
+
+	int filterSize = filter_size_x * filter_size_y;
+	vector<float> filters;
+	filters.reserve(static_cast<size_t>(numLinFilters) * filterSize);
+	for (int i = 0; i < numLinFilters; ++i)
+		filters.insert(filters.end(), linFilters[i], linFilters[i] + filterSize);
+	writer.writeFloats(filters.data(), filters.size());
+
+	vector<float> weights;
+	weights.reserve(static_cast<size_t>(numLinFilters) * (numLinFilters + 1) / 2);
+	for (int i = 0; i < numLinFilters; ++i)
+		weights.insert(weights.end(), hkWeights[i], hkWeights[i] + i + 1);
+	writer.writeFloats(weights.data(), weights.size());
+
+	writer.writeFloats(hierarchicalThresholdsFromFile.data(), hierarchicalThresholdsFromFile.size());
+	writer.writeDoubles(app_rsv_convol, numLinFilters);
+
+	vector<int32_t> valueCounts;
+	vector<int32_t> rectangleCounts;
+	vector<double> values;
+	vector<int32_t> rectangles;
+	for (int i = 0; i < numLinFilters; ++i) {
+		valueCounts.push_back(area[i]->cntval);
+		for (int v = 0; v < area[i]->cntval; ++v) {
+			rectangleCounts.push_back(area[i]->cntrec[v]);
+			values.push_back(area[i]->val[v]);
+			for (int r = 0; r < area[i]->cntrec[v]; ++r) {
+				const TRec& rec = area[i]->rec[v][r];
+				rectangles.push_back(rec.x1);
+				rectangles.push_back(rec.y1);
+				rectangles.push_back(rec.x2);
+				rectangles.push_back(rec.y2);
+			}
+		}
+	}
+	writer.writeInts(valueCounts.data(), valueCounts.size());
+	writer.writeInts(rectangleCounts.data(), rectangleCounts.size());
+	writer.writeDoubles(values.data(), values.size());
+	writer.writeInts(rectangles.data(), rectangles.size());
+}
 
 WvmClassifier::Area::Area(void)
 {
@@ -13,6 +13,7 @@
 #include "boost/optional.hpp"
 #include <memory>
 #include <vector>
+#include <string>
 
 namespace imageprocessing {
 class VersionedImage;
@@ -21,6 +22,8 @@ class DirectPyramidFeatureExtractor;
 
 namespace classification {
 class ProbabilisticClassifier;
+class BinaryModelWriter;
+class BinaryModelReader;
 }
 
 namespace condensation {
@@ -107,6 +110,36 @@ public:
 	 */
 	void addValidator(std::shared_ptr<StateValidator> validator);
 
+	/**
+	 * Stores the tracking state (samples, target state, sampler and adaptive measurement model) in a file
+	 * using the binary model format, so the tracking can be resumed later by loadState(...).
+	 *
+	 * @param[in] filename The name of the file.
+	 */
+	void saveState(const std::string& filename) const;
+
+	/**
+	 * Appends the tracking state to a binary model writer.
+	 *
+	 * @param[in] writer The writer.
+	 */
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	/**
+	 * Restores the tracking state that was stored by saveState(...). The tracker must have been constructed
+	 * with the same configuration as the one that stored the state.
+	 *
+	 * @param[in] filename The name of the file.
+	 */
+	void loadState(const std::string& filename);
+
+	/**
+	 * Restores the tracking state from a binary model reader.
+	 *
+	 * @param[in] reader The reader, which must be positioned at the beginning of the tracking state.
+	 */
+	void loadState(classification::BinaryModelReader& reader);
+
 private:
 
 	int initialCount; ///< The initial amount of particles.
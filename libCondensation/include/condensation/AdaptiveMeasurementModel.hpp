@@ -10,6 +10,11 @@
 
 #include "condensation/MeasurementModel.hpp"
 
+namespace classification {
+class BinaryModelWriter;
+class BinaryModelReader;
+}
+
 namespace condensation {
 
 /**
@@ -61,6 +66,21 @@ public:
 	 * Resets this model to its original state.
 	 */
 	virtual void reset() = 0;
+
+	/**
+	 * Writes the state of this measurement model (learned classifier, its training examples and random number generators) to a snapshot.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(classification::BinaryModelWriter& writer) const = 0;
+
+	/**
+	 * Restores the state of this measurement model from a snapshot that was written by saveState. The measurement model must be
+	 * configured the same way as the one that wrote the snapshot.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(classification::BinaryModelReader& reader) = 0;
 };
 
 } /* namespace condensation */
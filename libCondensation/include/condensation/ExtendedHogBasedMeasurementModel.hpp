@@ -87,6 +87,10 @@ public:
 
 	void reset();
 
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 	/**
 	 * Returns the positive examples that were actually used for training.
 	 *
@@ -153,6 +157,12 @@ public:
 
 private:
 
+	/**
+	 * Creates the feature extractors (and the heat pyramid when using a sliding window) from the HOG cell counts
+	 * and the patch width range. May reduce the patch width range to the scales of the base pyramid.
+	 */
+	void createFeatureExtractors();
+
 	/**
 	 * Retrieves the peak of the heat map.
 	 *
@@ -33,6 +33,10 @@ public:
 	void sample(const std::vector<std::shared_ptr<Sample>>& samples, std::vector<std::shared_ptr<Sample>>& newSamples,
 			const cv::Mat& image, const std::shared_ptr<Sample> target);
 
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 private:
 
 	int minSize;     ///< The minimum size of a sample.
@@ -0,0 +1,88 @@
+/*
+ * KldSampleCount.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef KLDSAMPLECOUNT_HPP_
+#define KLDSAMPLECOUNT_HPP_
+
+#include <vector>
+#include <memory>
+
+namespace condensation {
+
+class Sample;
+
+/**
+ * Adaptive sample count according to KLD-sampling (Fox, Adapting the Sample Size in Particle Filters Through
+ * KLD-Sampling). The samples are put into bins over position and scale, and the number of samples is chosen
+ * such that the Kullback-Leibler divergence between the sample-based approximation and the true (binned)
+ * distribution stays below an error bound with a given probability. A tight posterior covers few bins and
+ * therefore needs few samples, a spread-out posterior needs many.
+ *
+ * The position bins scale with the sample size, so the resolution is the same relative to the target at every
+ * scale. The scale bins are equally sized on a logarithmic scale.
+ */
+class KldSampleCount {
+public:
+
+	/**
+	 * Constructs a new KLD-based sample count.
+	 *
+	 * @param[in] minCount The minimum number of samples.
+	 * @param[in] maxCount The maximum number of samples.
+	 * @param[in] error The upper bound of the Kullback-Leibler divergence.
+	 * @param[in] normalQuantile The upper quantile of the standard normal distribution that corresponds to the
+	 *                           probability of the error staying below its bound (e.g. 2.33 for 99%).
+	 * @param[in] positionBinSize The size of the position bins relative to the sample size.
+	 * @param[in] scaleBinSize The size of the scale bins on the natural logarithm of the sample size.
+	 */
+	KldSampleCount(size_t minCount, size_t maxCount, double error = 0.05, double normalQuantile = 2.33,
+			double positionBinSize = 0.1, double scaleBinSize = 0.1);
+
+	/**
+	 * Determines how many of the samples are needed, taking them in the given order until the number of samples
+	 * reaches the bound for the number of occupied bins. The samples should therefore be in random order.
+	 *
+	 * @param[in] samples The samples, at least as many as the maximum number of samples.
+	 * @return The number of samples (between the minimum and the maximum one, but not more than given).
+	 */
+	size_t computeCount(const std::vector<std::shared_ptr<Sample>>& samples) const;
+
+	/**
+	 * Computes the number of samples that are needed for the given number of occupied bins, ignoring the
+	 * minimum and maximum.
+	 *
+	 * @param[in] binCount The number of occupied bins.
+	 * @return The number of samples.
+	 */
+	double computeBound(size_t binCount) const;
+
+	/**
+	 * @return The minimum number of samples.
+	 */
+	size_t getMinCount() const {
+		return minCount;
+	}
+
+	/**
+	 * @return The maximum number of samples.
+	 */
+	size_t getMaxCount() const {
+		return maxCount;
+	}
+
+private:
+
+	size_t minCount; ///< The minimum number of samples.
+	size_t maxCount; ///< The maximum number of samples.
+	double error; ///< The upper bound of the Kullback-Leibler divergence.
+	double normalQuantile; ///< The upper quantile of the standard normal distribution.
+	double positionBinSize; ///< The size of the position bins relative to the sample size.
+	double scaleBinSize; ///< The size of the scale bins on the natural logarithm of the sample size.
+};
+
+} /* namespace condensation */
+#endif /* KLDSAMPLECOUNT_HPP_ */
@@ -28,6 +28,10 @@ public:
 	void resample(const std::vector<std::shared_ptr<Sample>>& samples,
 			size_t count, std::vector<std::shared_ptr<Sample>>& newSamples);
 
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 private:
 
 	/**
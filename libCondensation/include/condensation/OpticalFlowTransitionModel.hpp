@@ -40,6 +40,18 @@ public:
 
 	void predict(std::vector<std::shared_ptr<Sample>>& samples, const cv::Mat& image, const std::shared_ptr<Sample> target);
 
+	/**
+	 * Sets the time until the next image, which is forwarded to the fallback model. The optical flow covers the
+	 * whole time step, the velocity of the samples is the flow per nominal frame interval.
+	 *
+	 * @param[in] timeStep The time between the previous and the next image in frame intervals.
+	 */
+	void setTimeStep(double timeStep);
+
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 	/**
 	 * Draws the flow of the chosen points into an image.
 	 *
@@ -105,6 +117,7 @@ private:
 	unsigned int correctFlowCount; ///< The amount of flows that are considered correct and are used for median flow.
 	double positionDeviation; ///< Standard deviation of the translation noise.
 	double sizeDeviation;     ///< Standard deviation of the scale change noise.
+	double timeStep;          ///< The time between the previous and the next image in frame intervals.
 	boost::variate_generator<boost::mt19937, boost::normal_distribution<>> generator; ///< Random number generator.
 };
 
@@ -13,11 +13,17 @@
 #include "boost/optional.hpp"
 #include <memory>
 #include <vector>
+#include <string>
 
 namespace imageprocessing {
 class VersionedImage;
 }
 
+namespace classification {
+class BinaryModelWriter;
+class BinaryModelReader;
+}
+
 namespace condensation {
 
 class Sampler;
@@ -103,6 +109,36 @@ public:
 		return usedAdaptiveModel;
 	}
 
+	/**
+	 * Stores the tracking state (samples, target state, sampler and adaptive measurement model) in a file
+	 * using the binary model format, so the tracking can be resumed later by loadState(...).
+	 *
+	 * @param[in] filename The name of the file.
+	 */
+	void saveState(const std::string& filename) const;
+
+	/**
+	 * Appends the tracking state to a binary model writer.
+	 *
+	 * @param[in] writer The writer.
+	 */
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	/**
+	 * Restores the tracking state that was stored by saveState(...). The tracker must have been constructed
+	 * with the same configuration as the one that stored the state.
+	 *
+	 * @param[in] filename The name of the file.
+	 */
+	void loadState(const std::string& filename);
+
+	/**
+	 * Restores the tracking state from a binary model reader.
+	 *
+	 * @param[in] reader The reader, which must be positioned at the beginning of the tracking state.
+	 */
+	void loadState(classification::BinaryModelReader& reader);
+
 private:
 
 	std::vector<std::shared_ptr<Sample>> samples;    ///< The current samples.
@@ -71,6 +71,10 @@ public:
 
 	void reset();
 
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 	/**
 	 * Changes the amounts of subsequent detections (misses) that lead this model to (not) being usable.
 	 *
@@ -11,6 +11,11 @@
 #include <vector>
 #include <memory>
 
+namespace classification {
+class BinaryModelWriter;
+class BinaryModelReader;
+}
+
 namespace condensation {
 
 class Sample;
@@ -32,6 +37,21 @@ public:
 	 */
 	virtual void resample(const std::vector<std::shared_ptr<Sample>>& samples,
 			size_t count, std::vector<std::shared_ptr<Sample>>& newSamples) = 0;
+
+	/**
+	 * Writes the state of this resampling algorithm (random number generator) to a snapshot.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(classification::BinaryModelWriter& writer) const = 0;
+
+	/**
+	 * Restores the state of this resampling algorithm from a snapshot that was written by saveState. The resampling algorithm must be
+	 * configured the same way as the one that wrote the snapshot.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(classification::BinaryModelReader& reader) = 0;
 };
 
 } /* namespace condensation */
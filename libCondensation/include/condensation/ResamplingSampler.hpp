@@ -18,10 +18,15 @@ namespace condensation {
 
 class ResamplingAlgorithm;
 class TransitionModel;
+class KldSampleCount;
 
 /**
  * Creates new samples by resampling the previous ones and moving them according to a transition model.
  * Additionally, some samples are randomly sampled across the image.
+ *
+ * The number of samples is either fixed or adapted to the spread of the predicted samples each frame using
+ * KLD-sampling. In the adaptive case, the maximum number of samples is resampled and predicted, shuffled (as
+ * systematic resampling produces them ordered by their ancestors), and only as many as needed are kept.
  */
 class ResamplingSampler : public Sampler {
 public:
@@ -44,15 +49,19 @@ public:
 	void sample(const std::vector<std::shared_ptr<Sample>>& samples, std::vector<std::shared_ptr<Sample>>& newSamples,
 			const cv::Mat& image, const std::shared_ptr<Sample> target);
 
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 	/**
-	 * @return The number of samples.
+	 * @return The number of samples (of the last frame in case it is adaptive).
 	 */
 	inline int getCount() {
 		return count;
 	}
 
 	/**
-	 * @param[in] The new number of samples.
+	 * @param[in] The new number of samples, will be overridden by the adaptive number of samples if set.
 	 */
 	inline void setCount(unsigned int count) {
 		this->count = count;
@@ -72,6 +81,20 @@ public:
 		this->randomRate = std::max(0.0, std::min(1.0, randomRate));
 	}
 
+	/**
+	 * @return The adaptive number of samples, null if the number of samples is fixed.
+	 */
+	inline std::shared_ptr<KldSampleCount> getAdaptiveCount() {
+		return adaptiveCount;
+	}
+
+	/**
+	 * @param[in] adaptiveCount The adaptive number of samples, null to use a fixed number of samples.
+	 */
+	inline void setAdaptiveCount(std::shared_ptr<KldSampleCount> adaptiveCount) {
+		this->adaptiveCount = adaptiveCount;
+	}
+
 private:
 
 	/**
@@ -86,6 +109,7 @@ private:
 	double randomRate;  ///< The percentage of samples that should be equally distributed.
 	std::shared_ptr<ResamplingAlgorithm> resamplingAlgorithm; ///< The resampling algorithm.
 	std::shared_ptr<TransitionModel> transitionModel;         ///< The transition model.
+	std::shared_ptr<KldSampleCount> adaptiveCount;            ///< The adaptive number of samples, null if the number is fixed.
 
 	int minSize; ///< The minimum size of a sample.
 	int maxSize; ///< The maximum size of a sample.
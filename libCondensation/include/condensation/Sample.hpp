@@ -10,8 +10,14 @@
 
 #include "opencv2/core/core.hpp"
 #include <memory>
+#include <vector>
 #include <stdexcept>
 
+namespace classification {
+class BinaryModelWriter;
+class BinaryModelReader;
+}
+
 namespace condensation {
 
 /**
@@ -327,6 +333,23 @@ public:
 		return nextClusterId++;
 	}
 
+	/**
+	 * Writes samples including their ancestors, the aspect ratio and the next cluster ID. Samples that are
+	 * shared between the given ones (e.g. common ancestors) are written only once.
+	 *
+	 * @param[in] writer The writer.
+	 * @param[in] samples The samples.
+	 */
+	static void saveSamples(classification::BinaryModelWriter& writer, const std::vector<std::shared_ptr<Sample>>& samples);
+
+	/**
+	 * Reads samples that were written by saveSamples(...) and restores the aspect ratio and the next cluster ID.
+	 *
+	 * @param[in] reader The reader.
+	 * @return The samples (null entries stay null).
+	 */
+	static std::vector<std::shared_ptr<Sample>> loadSamples(classification::BinaryModelReader& reader);
+
 	static double aspectRatio; ///< The aspect ratio of all samples. Cannot be made private, because C++.
 	static int nextClusterId;  ///< The next cluster ID that was not assigned to any sample before.
 
@@ -12,6 +12,11 @@
 #include <vector>
 #include <memory>
 
+namespace classification {
+class BinaryModelWriter;
+class BinaryModelReader;
+}
+
 namespace condensation {
 
 class Sample;
@@ -41,6 +46,21 @@ public:
 	 */
 	virtual void sample(const std::vector<std::shared_ptr<Sample>>& samples, std::vector<std::shared_ptr<Sample>>& newSamples,
 			const cv::Mat& image, const std::shared_ptr<Sample> target) = 0;
+
+	/**
+	 * Writes the state of this sampler (random number generators and any state adapted to the images) to a snapshot.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(classification::BinaryModelWriter& writer) const = 0;
+
+	/**
+	 * Restores the state of this sampler from a snapshot that was written by saveState. The sampler must be
+	 * configured the same way as the one that wrote the snapshot.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(classification::BinaryModelReader& reader) = 0;
 };
 
 } /* namespace condensation */
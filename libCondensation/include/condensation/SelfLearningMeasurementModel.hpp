@@ -66,6 +66,10 @@ public:
 
 	void reset();
 
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 private:
 
 	/**
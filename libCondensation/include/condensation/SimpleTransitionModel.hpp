@@ -34,6 +34,18 @@ public:
 
 	void predict(std::vector<std::shared_ptr<Sample>>& samples, const cv::Mat& image, const std::shared_ptr<Sample> target);
 
+	/**
+	 * Sets the time until the next image. The velocity stays per nominal frame interval, the position changes by
+	 * the velocity times the time step and the noise grows with the square root of the time step.
+	 *
+	 * @param[in] timeStep The time between the previous and the next image in frame intervals.
+	 */
+	void setTimeStep(double timeStep);
+
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 	/**
 	 * @return The standard deviation of the translation noise.
 	 */
@@ -66,6 +78,7 @@ private:
 
 	double positionDeviation; ///< Standard deviation of the translation noise.
 	double sizeDeviation;     ///< Standard deviation of the scale change noise.
+	double timeStep;          ///< The time between the previous and the next image in frame intervals.
 	boost::variate_generator<boost::mt19937, boost::normal_distribution<>> generator; ///< Random number generator.
 };
 
@@ -12,6 +12,11 @@
 #include <vector>
 #include <memory>
 
+namespace classification {
+class BinaryModelWriter;
+class BinaryModelReader;
+}
+
 namespace condensation {
 
 class Sample;
@@ -39,6 +44,29 @@ public:
 	 * @param[in] target The previous target state.
 	 */
 	virtual void predict(std::vector<std::shared_ptr<Sample>>& samples, const cv::Mat& image, const std::shared_ptr<Sample> target) = 0;
+
+	/**
+	 * Sets the time that passes until the next image, relative to the nominal frame interval (1 if no frame was dropped).
+	 * Affects the following calls of predict. Transition models that do not depend on the time ignore it.
+	 *
+	 * @param[in] timeStep The time between the previous and the next image in frame intervals.
+	 */
+	virtual void setTimeStep(double timeStep) {}
+
+	/**
+	 * Writes the state of this transition model (random number generator and the data kept from the previous image) to a snapshot.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	virtual void saveState(classification::BinaryModelWriter& writer) const = 0;
+
+	/**
+	 * Restores the state of this transition model from a snapshot that was written by saveState. The transition model must be
+	 * configured the same way as the one that wrote the snapshot.
+	 *
+	 * @param[in] reader The reader of the snapshot.
+	 */
+	virtual void loadState(classification::BinaryModelReader& reader) = 0;
 };
 
 } /* namespace condensation */
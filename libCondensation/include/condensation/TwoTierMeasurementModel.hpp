@@ -0,0 +1,95 @@
+/*
+ * TwoTierMeasurementModel.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef TWOTIERMEASUREMENTMODEL_HPP_
+#define TWOTIERMEASUREMENTMODEL_HPP_
+
+#include "condensation/AdaptiveMeasurementModel.hpp"
+
+namespace condensation {
+
+/**
+ * Measurement model that evaluates the samples coarse-to-fine. A cheap coarse model scores all samples, but only
+ * the most promising ones are evaluated by the expensive fine model. A sample is promising if its coarse weight
+ * is at least a fraction of the maximum coarse weight, but at most a fixed share of the samples (the ones with the
+ * highest coarse weights) is evaluated by the fine model. The remaining samples are not regarded as the target
+ * and receive a low weight that is calibrated against the fine weights: their coarse weight relative to the lowest
+ * coarse weight of the finely evaluated samples, multiplied by the lowest fine weight of those.
+ *
+ * Both models are kept up-to-date; adaptation is forwarded to the fine model and to the coarse model if it is
+ * adaptive, too.
+ *
+ * So far, only trackingBenchmarkApp configures this model (using a PositionDependentMeasurementModel as the coarse
+ * tier), the adaptive and head tracking apps do not use it.
+ */
+class TwoTierMeasurementModel : public AdaptiveMeasurementModel {
+public:
+
+	/**
+	 * Constructs a new two-tier measurement model.
+	 *
+	 * @param[in] coarseModel The cheap model that evaluates all samples.
+	 * @param[in] fineModel The expensive model that evaluates the promising samples only.
+	 * @param[in] fineFraction The maximum share of the samples that is evaluated by the fine model (between zero and one).
+	 * @param[in] relativeThreshold The minimum coarse weight relative to the maximum one of a sample to be evaluated
+	 *                              by the fine model (between zero and one).
+	 */
+	TwoTierMeasurementModel(std::shared_ptr<MeasurementModel> coarseModel,
+			std::shared_ptr<AdaptiveMeasurementModel> fineModel, double fineFraction, double relativeThreshold);
+
+	void update(std::shared_ptr<imageprocessing::VersionedImage> image);
+
+	/**
+	 * Evaluates the sample using the fine model only.
+	 *
+	 * @param[in] sample The sample whose weight will be changed according to the likelihood.
+	 */
+	void evaluate(Sample& sample) const;
+
+	void evaluate(std::shared_ptr<imageprocessing::VersionedImage> image, std::vector<std::shared_ptr<Sample>>& samples);
+
+	bool isUsable() const;
+
+	bool initialize(std::shared_ptr<imageprocessing::VersionedImage> image, Sample& target);
+
+	bool adapt(std::shared_ptr<imageprocessing::VersionedImage> image, const std::vector<std::shared_ptr<Sample>>& samples, const Sample& target);
+
+	bool adapt(std::shared_ptr<imageprocessing::VersionedImage> image, const std::vector<std::shared_ptr<Sample>>& samples);
+
+	void reset();
+
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
+	/**
+	 * @return The number of samples that were evaluated by the fine model since construction or the last reset.
+	 */
+	size_t getFineEvaluationCount() const {
+		return fineEvaluationCount;
+	}
+
+	/**
+	 * @return The number of samples that were evaluated by the coarse model since construction or the last reset.
+	 */
+	size_t getCoarseEvaluationCount() const {
+		return coarseEvaluationCount;
+	}
+
+private:
+
+	std::shared_ptr<MeasurementModel> coarseModel; ///< The cheap model that evaluates all samples.
+	std::shared_ptr<AdaptiveMeasurementModel> adaptiveCoarseModel; ///< The coarse model if it is adaptive, null otherwise.
+	std::shared_ptr<AdaptiveMeasurementModel> fineModel; ///< The expensive model that evaluates the promising samples only.
+	double fineFraction; ///< The maximum share of the samples that is evaluated by the fine model.
+	double relativeThreshold; ///< The minimum coarse weight relative to the maximum one of a sample to be evaluated by the fine model.
+	size_t fineEvaluationCount; ///< The number of samples that were evaluated by the fine model.
+	size_t coarseEvaluationCount; ///< The number of samples that were evaluated by the coarse model.
+};
+
+} /* namespace condensation */
+#endif /* TWOTIERMEASUREMENTMODEL_HPP_ */
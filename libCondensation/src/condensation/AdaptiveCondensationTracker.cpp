@@ -13,12 +13,18 @@
 #include "condensation/StateExtractor.hpp"
 #include "condensation/StateValidator.hpp"
 #include "imageprocessing/VersionedImage.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <stdexcept>
 
 using imageprocessing::VersionedImage;
+using classification::BinaryModelType;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using cv::Rect;
 using boost::optional;
+using std::string;
 using std::vector;
 using std::shared_ptr;
 using std::make_shared;
@@ -118,4 +124,39 @@ void AdaptiveCondensationTracker::addValidator(shared_ptr<StateValidator> valida
 	validators.push_back(validator);
 }
 
+void AdaptiveCondensationTracker::saveState(const string& filename) const {
+	BinaryModelWriter writer(BinaryModelType::TRACKER_STATE);
+	saveState(writer);
+	writer.save(filename);
+}
+
+void AdaptiveCondensationTracker::saveState(BinaryModelWriter& writer) const {
+	// the state is stored as an additional sample, so it may share its ancestors with the samples
+	vector<shared_ptr<Sample>> samplesAndState(samples);
+	samplesAndState.push_back(state);
+	Sample::saveSamples(writer, samplesAndState);
+	writer.writeInt(adapted ? 1 : 0);
+	sampler->saveState(writer);
+	measurementModel->saveState(writer);
+}
+
+void AdaptiveCondensationTracker::loadState(const string& filename) {
+	BinaryModelReader reader(filename);
+	loadState(reader);
+}
+
+void AdaptiveCondensationTracker::loadState(BinaryModelReader& reader) {
+	reader.requireType(BinaryModelType::TRACKER_STATE);
+	vector<shared_ptr<Sample>> samplesAndState = Sample::loadSamples(reader);
+	if (samplesAndState.empty())
+		throw runtime_error("AdaptiveCondensationTracker: Invalid snapshot, target state is missing");
+	state = samplesAndState.back();
+	samplesAndState.pop_back();
+	samples.swap(samplesAndState);
+	oldSamples.clear();
+	adapted = reader.readInt() != 0;
+	sampler->loadState(reader);
+	measurementModel->loadState(reader);
+}
+
 } /* namespace condensation */
@@ -11,6 +11,7 @@
 #include "condensation/MeasurementModel.hpp"
 #include "condensation/StateExtractor.hpp"
 #include "imageprocessing/VersionedImage.hpp"
+#include "logging/Tracer.hpp"
 
 using imageprocessing::VersionedImage;
 using cv::Mat;
@@ -36,9 +37,15 @@ optional<Rect> CondensationTracker::process(const Mat& imageData) {
 	image->setData(imageData);
 	samples.swap(oldSamples);
 	samples.clear();
-	sampler->sample(oldSamples, samples, image->getData(), state);
+	{
+		TRACE_SCOPE("CondensationTracker::sample");
+		sampler->sample(oldSamples, samples, image->getData(), state);
+	}
 	// evaluate samples and extract position
-	measurementModel->evaluate(image, samples);
+	{
+		TRACE_SCOPE("CondensationTracker::evaluate");
+		measurementModel->evaluate(image, samples);
+	}
 	state = extractor->extract(samples);
 	// return position
 	if (state)
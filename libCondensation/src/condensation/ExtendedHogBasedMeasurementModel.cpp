@@ -25,7 +25,10 @@
 #include "classification/LinearKernel.hpp"
 #include "classification/BinaryClassifier.hpp"
 #include "classification/ProbabilisticClassifier.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <stdexcept>
+#include <sstream>
 
 using imageprocessing::Patch;
 using imageprocessing::VersionedImage;
@@ -43,10 +46,14 @@ using imageprocessing::ExtendedHogFeatureExtractor;
 using classification::LinearKernel;
 using classification::ProbabilisticSvmClassifier;
 using classification::TrainableProbabilisticSvmClassifier;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using cv::Rect;
 using std::pair;
 using std::vector;
+using std::ostringstream;
+using std::istringstream;
 using std::make_pair;
 using std::shared_ptr;
 using std::make_shared;
@@ -240,81 +247,7 @@ bool ExtendedHogBasedMeasurementModel::initialize(shared_ptr<VersionedImage> ima
 			maxWidth = image->getData().cols;
 		}
 
-		shared_ptr<CompleteExtendedHogFilter> hogFilter;
-		if (signedAndUnsigned)
-			hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 18, true, true, interpolateBins, interpolateCells, 0.2);
-		else
-			hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 9, false, true, interpolateBins, interpolateCells, 0.48);
-
-		if (basePyramid) {
-			positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(basePyramid, hogFilter, cellColumnCount, cellRowCount);
-			int patchWidth = positiveFeatureExtractor->getPatchWidth();
-			minWidth = std::max(minWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMaxScaleFactor())));
-			maxWidth = std::min(maxWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMinScaleFactor())));
-		} else { // no base pyramid given
-			positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(
-					hogFilter, cellColumnCount, cellRowCount, minWidth, maxWidth, octaveLayerCount);
-		}
-
-		if (useSlidingWindow) {
-			shared_ptr<ImagePyramid> featurePyramid = make_shared<ImagePyramid>(positiveFeatureExtractor->getPyramid());
-			featurePyramid->addLayerFilter(hogFilter);
-			heatPyramid = make_shared<ImagePyramid>(featurePyramid);
-			heatPyramid->addLayerFilter(convolutionFilter);
-			featureExtractor = make_shared<CellBasedPyramidFeatureExtractor>(featurePyramid, cellSize, cellColumnCount, cellRowCount);
-			heatExtractor = make_shared<CellBasedPyramidFeatureExtractor>(heatPyramid, cellSize, cellColumnCount, cellRowCount);
-		} else {
-			featureExtractor = positiveFeatureExtractor;
-		}
-
-		// TODO alternative with other hog filter for non-sliding-window - why worse (especially on ball video)?
-//		if (useSlidingWindow) {
-//			shared_ptr<CompleteExtendedHogFilter> hogFilter;
-//			if (signedAndUnsigned)
-//				hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 18, true, true, interpolateBins, interpolateCells, 0.2);
-//			else
-//				hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 9, false, true, interpolateBins, interpolateCells, 0.48);
-//			if (basePyramid) {
-//				positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(basePyramid, hogFilter, cellColumnCount, cellRowCount);
-//				int patchWidth = positiveFeatureExtractor->getPatchWidth();
-//				minWidth = std::max(minWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMaxScaleFactor())));
-//				maxWidth = std::min(maxWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMinScaleFactor())));
-//			} else { // no base pyramid given
-//				positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(
-//						hogFilter, cellColumnCount, cellRowCount, minWidth, maxWidth, octaveLayerCount);
-//			}
-//			shared_ptr<ImagePyramid> featurePyramid = make_shared<ImagePyramid>(positiveFeatureExtractor->getPyramid());
-//			featurePyramid->addLayerFilter(hogFilter);
-//			heatPyramid = make_shared<ImagePyramid>(featurePyramid);
-//			heatPyramid->addLayerFilter(convolutionFilter);
-//			featureExtractor = make_shared<CellBasedPyramidFeatureExtractor>(featurePyramid, cellSize, cellColumnCount, cellRowCount);
-//			heatExtractor = make_shared<CellBasedPyramidFeatureExtractor>(heatPyramid, cellSize, cellColumnCount, cellRowCount);
-//		} else {
-//			shared_ptr<GradientFilter> gradientFilter = make_shared<GradientFilter>(1, 0);
-//			shared_ptr<GradientBinningFilter> binningFilter;
-//			shared_ptr<ExtendedHogFilter> hogFilter;
-//			if (signedAndUnsigned) {
-//				binningFilter = make_shared<GradientBinningFilter>(18, true, interpolateBins);
-//				hogFilter = make_shared<ExtendedHogFilter>(18, cellSize, interpolateCells, true, 0.2);
-//			} else {
-//				binningFilter = make_shared<GradientBinningFilter>(9, false, interpolateBins);
-//				hogFilter = make_shared<ExtendedHogFilter>(9, cellSize, interpolateCells, false, 0.48);
-//			}
-//			if (basePyramid) {
-//				shared_ptr<ImagePyramid> featurePyramid = make_shared<ImagePyramid>(basePyramid);
-//				featurePyramid->addLayerFilter(gradientFilter);
-//				featurePyramid->addLayerFilter(binningFilter);
-//				positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(featurePyramid, hogFilter, cellColumnCount, cellRowCount);
-//				int patchWidth = positiveFeatureExtractor->getPatchWidth();
-//				minWidth = std::max(minWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMaxScaleFactor())));
-//				maxWidth = std::min(maxWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMinScaleFactor())));
-//			} else {
-//				positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(
-//						gradientFilter, binningFilter, hogFilter, cellColumnCount, cellRowCount, minWidth, maxWidth, octaveLayerCount);
-//			}
-//			featureExtractor = positiveFeatureExtractor;
-//		}
-
+		createFeatureExtractors();
 		initialized = true;
 	}
 
@@ -431,6 +364,176 @@ void ExtendedHogBasedMeasurementModel::reset() {
 	pastFeatureExtractors.clear();
 }
 
+void ExtendedHogBasedMeasurementModel::saveState(BinaryModelWriter& writer) const {
+	if (!pastFeatureExtractors.empty())
+		throw runtime_error("ExtendedHogBasedMeasurementModel: the state of the corrected trajectory learning cannot be saved");
+	writer.writeInt(initialized ? 1 : 0);
+	writer.writeInt(usable ? 1 : 0);
+	writer.writeInt(targetLost ? 1 : 0);
+	writer.writeInt(cellRowCount);
+	writer.writeInt(cellColumnCount);
+	writer.writeInt(minWidth);
+	writer.writeInt(maxWidth);
+	ostringstream randomState;
+	randomState.precision(17);
+	randomState << generator << ' ' << uniformIntDistribution << ' ' << normalDistribution;
+	writer.writeString(randomState.str());
+	vector<Mat> initialExamples;
+	if (!initialFeatures.empty())
+		initialExamples.push_back(initialFeatures);
+	writer.writeMatrices(initialExamples);
+	writer.writeMatrices(trajectoryFeatures);
+	vector<int32_t> trajectory;
+	trajectory.reserve(5 * trajectoryToLearn.size());
+	for (const pair<int, Rect>& entry : trajectoryToLearn) {
+		trajectory.push_back(entry.first);
+		trajectory.push_back(entry.second.x);
+		trajectory.push_back(entry.second.y);
+		trajectory.push_back(entry.second.width);
+		trajectory.push_back(entry.second.height);
+	}
+	writer.writeInt(trajectoryToLearn.size());
+	writer.writeInts(trajectory.data(), trajectory.size());
+	vector<int32_t> learnedBounds;
+	learnedBounds.reserve(5 * learned.size());
+	for (const pair<const size_t, Rect>& entry : learned) {
+		learnedBounds.push_back(entry.first);
+		learnedBounds.push_back(entry.second.x);
+		learnedBounds.push_back(entry.second.y);
+		learnedBounds.push_back(entry.second.width);
+		learnedBounds.push_back(entry.second.height);
+	}
+	writer.writeInt(learned.size());
+	writer.writeInts(learnedBounds.data(), learnedBounds.size());
+	writer.writeInt(frameIndex);
+	trainable->saveState(writer);
+}
+
+void ExtendedHogBasedMeasurementModel::loadState(BinaryModelReader& reader) {
+	initialized = reader.readInt() != 0;
+	usable = reader.readInt() != 0;
+	targetLost = reader.readInt() != 0;
+	cellRowCount = reader.readInt();
+	cellColumnCount = reader.readInt();
+	minWidth = reader.readInt();
+	maxWidth = reader.readInt();
+	istringstream randomState(reader.readString());
+	randomState >> generator >> uniformIntDistribution >> normalDistribution;
+	vector<Mat> initialExamples = reader.readMatrices();
+	initialFeatures = initialExamples.empty() ? Mat() : initialExamples[0].clone();
+	vector<Mat> trajectoryExamples = reader.readMatrices();
+	trajectoryFeatures.clear();
+	for (const Mat& example : trajectoryExamples)
+		trajectoryFeatures.push_back(example.clone());
+	int trajectoryCount = reader.readInt();
+	if (trajectoryCount < 0)
+		throw runtime_error("ExtendedHogBasedMeasurementModel: Invalid snapshot, negative trajectory length");
+	Mat trajectory = reader.readInts(5 * trajectoryCount);
+	trajectoryToLearn.clear();
+	for (int i = 0; i < trajectoryCount; ++i) {
+		const int32_t* entry = trajectory.ptr<int32_t>() + 5 * i;
+		trajectoryToLearn.push_back(make_pair(entry[0], Rect(entry[1], entry[2], entry[3], entry[4])));
+	}
+	int learnedCount = reader.readInt();
+	if (learnedCount < 0)
+		throw runtime_error("ExtendedHogBasedMeasurementModel: Invalid snapshot, negative count of learned positions");
+	Mat learnedBounds = reader.readInts(5 * learnedCount);
+	learned.clear();
+	for (int i = 0; i < learnedCount; ++i) {
+		const int32_t* entry = learnedBounds.ptr<int32_t>() + 5 * i;
+		learned.emplace(entry[0], Rect(entry[1], entry[2], entry[3], entry[4]));
+	}
+	frameIndex = reader.readInt();
+	pastFeatureExtractors.clear();
+	if (initialized)
+		createFeatureExtractors();
+	trainable->loadState(reader);
+	if (usable && useSlidingWindow) {
+		if (classifier->getSvm()->getSupportVectors().size() != 1)
+			throw runtime_error("ExtendedHogBasedMeasurementModel: the amount of support vectors has to be one (w)");
+		convolutionFilter->setKernel(classifier->getSvm()->getSupportVectors()[0]);
+		convolutionFilter->setDelta(-classifier->getSvm()->getBias());
+	}
+}
+
+void ExtendedHogBasedMeasurementModel::createFeatureExtractors() {
+	shared_ptr<CompleteExtendedHogFilter> hogFilter;
+	if (signedAndUnsigned)
+		hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 18, true, true, interpolateBins, interpolateCells, 0.2);
+	else
+		hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 9, false, true, interpolateBins, interpolateCells, 0.48);
+
+	if (basePyramid) {
+		positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(basePyramid, hogFilter, cellColumnCount, cellRowCount);
+		int patchWidth = positiveFeatureExtractor->getPatchWidth();
+		minWidth = std::max(minWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMaxScaleFactor())));
+		maxWidth = std::min(maxWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMinScaleFactor())));
+	} else { // no base pyramid given
+		positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(
+				hogFilter, cellColumnCount, cellRowCount, minWidth, maxWidth, octaveLayerCount);
+	}
+
+	if (useSlidingWindow) {
+		shared_ptr<ImagePyramid> featurePyramid = make_shared<ImagePyramid>(positiveFeatureExtractor->getPyramid());
+		featurePyramid->addLayerFilter(hogFilter);
+		heatPyramid = make_shared<ImagePyramid>(featurePyramid);
+		heatPyramid->addLayerFilter(convolutionFilter);
+		heatPyramid->setLayerThreadCount(0); // the convolution filter is thread-safe, so the layers can be scored concurrently
+		featureExtractor = make_shared<CellBasedPyramidFeatureExtractor>(featurePyramid, cellSize, cellColumnCount, cellRowCount);
+		heatExtractor = make_shared<CellBasedPyramidFeatureExtractor>(heatPyramid, cellSize, cellColumnCount, cellRowCount);
+	} else {
+		featureExtractor = positiveFeatureExtractor;
+	}
+
+	// TODO alternative with other hog filter for non-sliding-window - why worse (especially on ball video)?
+//	if (useSlidingWindow) {
+//		shared_ptr<CompleteExtendedHogFilter> hogFilter;
+//		if (signedAndUnsigned)
+//			hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 18, true, true, interpolateBins, interpolateCells, 0.2);
+//		else
+//			hogFilter = make_shared<CompleteExtendedHogFilter>(cellSize, 9, false, true, interpolateBins, interpolateCells, 0.48);
+//		if (basePyramid) {
+//			positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(basePyramid, hogFilter, cellColumnCount, cellRowCount);
+//			int patchWidth = positiveFeatureExtractor->getPatchWidth();
+//			minWidth = std::max(minWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMaxScaleFactor())));
+//			maxWidth = std::min(maxWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMinScaleFactor())));
+//		} else { // no base pyramid given
+//			positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(
+//					hogFilter, cellColumnCount, cellRowCount, minWidth, maxWidth, octaveLayerCount);
+//		}
+//		shared_ptr<ImagePyramid> featurePyramid = make_shared<ImagePyramid>(positiveFeatureExtractor->getPyramid());
+//		featurePyramid->addLayerFilter(hogFilter);
+//		heatPyramid = make_shared<ImagePyramid>(featurePyramid);
+//		heatPyramid->addLayerFilter(convolutionFilter);
+//		featureExtractor = make_shared<CellBasedPyramidFeatureExtractor>(featurePyramid, cellSize, cellColumnCount, cellRowCount);
+//		heatExtractor = make_shared<CellBasedPyramidFeatureExtractor>(heatPyramid, cellSize, cellColumnCount, cellRowCount);
+//	} else {
+//		shared_ptr<GradientFilter> gradientFilter = make_shared<GradientFilter>(1, 0);
+//		shared_ptr<GradientBinningFilter> binningFilter;
+//		shared_ptr<ExtendedHogFilter> hogFilter;
+//		if (signedAndUnsigned) {
+//			binningFilter = make_shared<GradientBinningFilter>(18, true, interpolateBins);
+//			hogFilter = make_shared<ExtendedHogFilter>(18, cellSize, interpolateCells, true, 0.2);
+//		} else {
+//			binningFilter = make_shared<GradientBinningFilter>(9, false, interpolateBins);
+//			hogFilter = make_shared<ExtendedHogFilter>(9, cellSize, interpolateCells, false, 0.48);
+//		}
+//		if (basePyramid) {
+//			shared_ptr<ImagePyramid> featurePyramid = make_shared<ImagePyramid>(basePyramid);
+//			featurePyramid->addLayerFilter(gradientFilter);
+//			featurePyramid->addLayerFilter(binningFilter);
+//			positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(featurePyramid, hogFilter, cellColumnCount, cellRowCount);
+//			int patchWidth = positiveFeatureExtractor->getPatchWidth();
+//			minWidth = std::max(minWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMaxScaleFactor())));
+//			maxWidth = std::min(maxWidth, static_cast<size_t>(round(patchWidth / basePyramid->getMinScaleFactor())));
+//		} else {
+//			positiveFeatureExtractor = make_shared<ExtendedHogFeatureExtractor>(
+//					gradientFilter, binningFilter, hogFilter, cellColumnCount, cellRowCount, minWidth, maxWidth, octaveLayerCount);
+//		}
+//		featureExtractor = positiveFeatureExtractor;
+//	}
+}
+
 pair<double, Rect> ExtendedHogBasedMeasurementModel::getHeatPeak() const {
 	double bestScore = std::numeric_limits<double>::lowest();
 	Rect bestBounds;
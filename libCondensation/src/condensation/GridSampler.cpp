@@ -7,9 +7,13 @@
 
 #include "condensation/GridSampler.hpp"
 #include "condensation/Sample.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <algorithm>
 #include <stdexcept>
 
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using std::min;
 using std::max;
@@ -52,4 +56,8 @@ void GridSampler::sample(const vector<shared_ptr<Sample>>& samples, vector<share
 	}
 }
 
+void GridSampler::saveState(BinaryModelWriter& writer) const {}
+
+void GridSampler::loadState(BinaryModelReader& reader) {}
+
 } /* namespace condensation */
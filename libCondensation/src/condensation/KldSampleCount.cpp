@@ -0,0 +1,70 @@
+/*
+ * KldSampleCount.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "condensation/KldSampleCount.hpp"
+#include "condensation/Sample.hpp"
+#include <set>
+#include <tuple>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+using std::set;
+using std::tuple;
+using std::vector;
+using std::shared_ptr;
+using std::invalid_argument;
+
+namespace condensation {
+
+KldSampleCount::KldSampleCount(size_t minCount, size_t maxCount, double error, double normalQuantile,
+		double positionBinSize, double scaleBinSize) :
+				minCount(minCount),
+				maxCount(maxCount),
+				error(error),
+				normalQuantile(normalQuantile),
+				positionBinSize(positionBinSize),
+				scaleBinSize(scaleBinSize) {
+	if (minCount < 1)
+		throw invalid_argument("KldSampleCount: the minimum count must be greater than zero");
+	if (maxCount < minCount)
+		throw invalid_argument("KldSampleCount: the maximum count must not be smaller than the minimum count");
+	if (error <= 0)
+		throw invalid_argument("KldSampleCount: the error bound must be greater than zero");
+	if (positionBinSize <= 0 || scaleBinSize <= 0)
+		throw invalid_argument("KldSampleCount: the bin sizes must be greater than zero");
+}
+
+size_t KldSampleCount::computeCount(const vector<shared_ptr<Sample>>& samples) const {
+	size_t availableCount = std::min(maxCount, samples.size());
+	set<tuple<int, int, int>> bins;
+	double bound = 0;
+	for (size_t i = 0; i < availableCount; ++i) {
+		const Sample& sample = *samples[i];
+		int scaleBin = static_cast<int>(std::floor(std::log(std::max(1, sample.getSize())) / scaleBinSize));
+		double positionBinWidth = positionBinSize * std::exp(scaleBin * scaleBinSize);
+		int xBin = static_cast<int>(std::floor(sample.getX() / positionBinWidth));
+		int yBin = static_cast<int>(std::floor(sample.getY() / positionBinWidth));
+		if (bins.emplace(xBin, yBin, scaleBin).second)
+			bound = computeBound(bins.size());
+		if (i + 1 >= minCount && i + 1 >= bound)
+			return i + 1;
+	}
+	return availableCount;
+}
+
+double KldSampleCount::computeBound(size_t binCount) const {
+	if (binCount < 2)
+		return 0;
+	// Wilson-Hilferty approximation of the chi-square quantile with binCount - 1 degrees of freedom
+	double k = static_cast<double>(binCount - 1);
+	double a = 2.0 / (9.0 * k);
+	double b = 1.0 - a + std::sqrt(a) * normalQuantile;
+	return k / (2.0 * error) * b * b * b;
+}
+
+} /* namespace condensation */
@@ -7,9 +7,16 @@
 
 #include "condensation/LowVarianceSampling.hpp"
 #include "condensation/Sample.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <ctime>
+#include <sstream>
 
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using std::vector;
+using std::ostringstream;
+using std::istringstream;
 using std::shared_ptr;
 
 namespace condensation {
@@ -28,7 +35,7 @@ void LowVarianceSampling::resample(const vector<shared_ptr<Sample>>& samples, si
 			double weightSum = (*sample)->getWeight();
 			for (unsigned int i = 0; i < count; ++i) {
 				double weightPointer = start + i * step;
-				while (weightPointer > weightSum) {
+				while (weightPointer > weightSum && sample + 1 != samples.cend()) { // rounding errors must not lead beyond the last sample
 					++sample;
 					weightSum += (*sample)->getWeight();
 				}
@@ -38,6 +45,18 @@ void LowVarianceSampling::resample(const vector<shared_ptr<Sample>>& samples, si
 	}
 }
 
+void LowVarianceSampling::saveState(BinaryModelWriter& writer) const {
+	ostringstream randomState;
+	randomState.precision(17);
+	randomState << generator << ' ' << distribution;
+	writer.writeString(randomState.str());
+}
+
+void LowVarianceSampling::loadState(BinaryModelReader& reader) {
+	istringstream randomState(reader.readString());
+	randomState >> generator >> distribution;
+}
+
 double LowVarianceSampling::computeWeightSum(const vector<shared_ptr<Sample>>& samples) {
 	double weightSum = 0;
 	for (const shared_ptr<Sample> sample : samples)
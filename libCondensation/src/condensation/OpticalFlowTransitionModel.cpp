@@ -8,9 +8,14 @@
 #include "condensation/OpticalFlowTransitionModel.hpp"
 #include "condensation/Sample.hpp"
 #include "opencv2/video/video.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <ctime>
+#include <sstream>
 #include <cmath>
 
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using cv::Size;
 using cv::Scalar;
@@ -19,6 +24,8 @@ using cv::BORDER_REPLICATE;
 using std::sort;
 using std::pair;
 using std::vector;
+using std::ostringstream;
+using std::istringstream;
 using std::make_pair;
 using std::shared_ptr;
 
@@ -43,6 +50,7 @@ OpticalFlowTransitionModel::OpticalFlowTransitionModel(shared_ptr<TransitionMode
 				correctFlowCount(0),
 				positionDeviation(positionDeviation),
 				sizeDeviation(sizeDeviation),
+				timeStep(1),
 				generator(boost::mt19937(time(0)), boost::normal_distribution<>()) {
 //	float gridY = 1 / static_cast<float>(gridSize.height);
 //	float gridX = 1 / static_cast<float>(gridSize.width);
@@ -87,6 +95,11 @@ void OpticalFlowTransitionModel::init(const Mat& image) {
 	cv::buildOpticalFlowPyramid(makeGrayscale(image), previousPyramid, windowSize, maxLevel, true, BORDER_REPLICATE, BORDER_REPLICATE);
 }
 
+void OpticalFlowTransitionModel::setTimeStep(double timeStep) {
+	this->timeStep = timeStep;
+	fallback->setTimeStep(timeStep);
+}
+
 void OpticalFlowTransitionModel::predict(vector<shared_ptr<Sample>>& samples, const Mat& image, const shared_ptr<Sample> target) {
 	points.clear();
 	forwardPoints.clear();
@@ -170,26 +183,46 @@ void OpticalFlowTransitionModel::predict(vector<shared_ptr<Sample>>& samples, co
 	float medianRatio = sqrt(squaredRatios[squaredRatios.size() / 2]);
 
 	// predict samples according to median flow and random noise
+	double deviationScale = std::sqrt(timeStep);
 	for (shared_ptr<Sample> sample : samples) {
-		// add noise to velocity
-		double vx = medianX;
-		double vy = medianY;
-		double vs = medianRatio;
-		// diffuse
-		vx += positionDeviation * generator();
-		vy += positionDeviation * generator();
-		vs *= pow(2, sizeDeviation * generator());
-		// round to integer
-		sample->setVx(static_cast<int>(std::round(vx)));
-		sample->setVy(static_cast<int>(std::round(vy)));
+		// add noise to the flow, which covers the whole time step
+		double dx = medianX + deviationScale * positionDeviation * generator();
+		double dy = medianY + deviationScale * positionDeviation * generator();
+		double vs = pow(medianRatio, 1 / timeStep) * pow(2, deviationScale * sizeDeviation * generator());
+		// change position according to the flow, the position is rounded only once
+		sample->setX(sample->getX() + static_cast<int>(std::round(dx)));
+		sample->setY(sample->getY() + static_cast<int>(std::round(dy)));
+		sample->setSize(static_cast<int>(std::round(sample->getSize() * pow(vs, timeStep))));
+		// the velocity per frame interval is only used by the fallback
+		sample->setVx(static_cast<int>(std::round(dx / timeStep)));
+		sample->setVy(static_cast<int>(std::round(dy / timeStep)));
 		sample->setVSize(vs);
-		// change position according to velocity
-		sample->setX(sample->getX() + sample->getVx());
-		sample->setY(sample->getY() + sample->getVy());
-		sample->setSize(static_cast<int>(std::round(sample->getSize() * sample->getVSize())));
 	}
 }
 
+void OpticalFlowTransitionModel::saveState(BinaryModelWriter& writer) const {
+	ostringstream randomState;
+	randomState.precision(17);
+	randomState << generator.engine() << ' ' << generator.distribution();
+	writer.writeString(randomState.str());
+	// the pyramid levels are views into padded buffers, so only the previous image is stored and the pyramid is rebuilt from it
+	vector<Mat> previousImage;
+	if (!previousPyramid.empty())
+		previousImage.push_back(previousPyramid[0].clone());
+	writer.writeMatrices(previousImage);
+	fallback->saveState(writer);
+}
+
+void OpticalFlowTransitionModel::loadState(BinaryModelReader& reader) {
+	istringstream randomState(reader.readString());
+	randomState >> generator.engine() >> generator.distribution();
+	vector<Mat> previousImage = reader.readMatrices();
+	previousPyramid.clear();
+	if (!previousImage.empty())
+		cv::buildOpticalFlowPyramid(previousImage[0].clone(), previousPyramid, windowSize, maxLevel, true, BORDER_REPLICATE, BORDER_REPLICATE);
+	fallback->loadState(reader);
+}
+
 void OpticalFlowTransitionModel::drawFlow(Mat& image, int thickness, Scalar color, Scalar badColor) const {
 	if (thickness < 0) {
 		for (unsigned int i = 0; i < correctFlowCount; ++i) {
@@ -12,14 +12,22 @@
 #include "condensation/AdaptiveMeasurementModel.hpp"
 #include "condensation/StateExtractor.hpp"
 #include "imageprocessing/VersionedImage.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include <stdexcept>
 
 using imageprocessing::VersionedImage;
+using classification::BinaryModelType;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using cv::Rect;
 using boost::optional;
+using std::string;
 using std::vector;
 using std::shared_ptr;
 using std::make_shared;
+using std::runtime_error;
 
 namespace condensation {
 
@@ -70,4 +78,41 @@ void PartiallyAdaptiveCondensationTracker::setUseAdaptiveModel(bool useAdaptive)
 		measurementModel->reset();
 }
 
+void PartiallyAdaptiveCondensationTracker::saveState(const string& filename) const {
+	BinaryModelWriter writer(BinaryModelType::TRACKER_STATE);
+	saveState(writer);
+	writer.save(filename);
+}
+
+void PartiallyAdaptiveCondensationTracker::saveState(BinaryModelWriter& writer) const {
+	// the state is stored as an additional sample, so it may share its ancestors with the samples
+	vector<shared_ptr<Sample>> samplesAndState(samples);
+	samplesAndState.push_back(state);
+	Sample::saveSamples(writer, samplesAndState);
+	writer.writeInt(useAdaptiveModel ? 1 : 0);
+	writer.writeInt(usedAdaptiveModel ? 1 : 0);
+	sampler->saveState(writer);
+	measurementModel->saveState(writer);
+}
+
+void PartiallyAdaptiveCondensationTracker::loadState(const string& filename) {
+	BinaryModelReader reader(filename);
+	loadState(reader);
+}
+
+void PartiallyAdaptiveCondensationTracker::loadState(BinaryModelReader& reader) {
+	reader.requireType(BinaryModelType::TRACKER_STATE);
+	vector<shared_ptr<Sample>> samplesAndState = Sample::loadSamples(reader);
+	if (samplesAndState.empty())
+		throw runtime_error("PartiallyAdaptiveCondensationTracker: Invalid snapshot, target state is missing");
+	state = samplesAndState.back();
+	samplesAndState.pop_back();
+	samples.swap(samplesAndState);
+	oldSamples.clear();
+	useAdaptiveModel = reader.readInt() != 0;
+	usedAdaptiveModel = reader.readInt() != 0;
+	sampler->loadState(reader);
+	measurementModel->loadState(reader);
+}
+
 } /* namespace condensation */
@@ -12,13 +12,20 @@
 #include "imageprocessing/FeatureExtractor.hpp"
 #include "imageprocessing/VersionedImage.hpp"
 #include "classification/TrainableProbabilisticClassifier.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include <sstream>
 
 using imageprocessing::Patch;
 using imageprocessing::VersionedImage;
 using imageprocessing::FeatureExtractor;
 using classification::TrainableProbabilisticClassifier;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using std::vector;
+using std::ostringstream;
+using std::istringstream;
 using std::function;
 using std::shared_ptr;
 using std::make_shared;
@@ -86,6 +93,23 @@ void PositionDependentMeasurementModel::reset() {
 	usable = false;
 }
 
+void PositionDependentMeasurementModel::saveState(BinaryModelWriter& writer) const {
+	writer.writeInt(usable ? 1 : 0);
+	writer.writeInt(frameCount);
+	ostringstream randomState;
+	randomState << generator << ' ' << distribution;
+	writer.writeString(randomState.str());
+	classifier->saveState(writer);
+}
+
+void PositionDependentMeasurementModel::loadState(BinaryModelReader& reader) {
+	usable = reader.readInt() != 0;
+	frameCount = reader.readInt();
+	istringstream randomState(reader.readString());
+	randomState >> generator >> distribution;
+	classifier->loadState(reader);
+}
+
 bool PositionDependentMeasurementModel::initialize(shared_ptr<VersionedImage> image, Sample& target) {
 	vector<shared_ptr<Sample>> empty;
 	return adapt(image, empty, target);
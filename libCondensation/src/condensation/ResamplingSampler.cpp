@@ -9,12 +9,21 @@
 #include "condensation/Sample.hpp"
 #include "condensation/ResamplingAlgorithm.hpp"
 #include "condensation/TransitionModel.hpp"
+#include "condensation/KldSampleCount.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <algorithm>
+#include <sstream>
 #include <ctime>
 #include <stdexcept>
 
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
+using std::string;
 using std::vector;
+using std::ostringstream;
+using std::istringstream;
 using std::shared_ptr;
 using std::invalid_argument;
 using std::make_shared;
@@ -27,6 +36,7 @@ ResamplingSampler::ResamplingSampler(unsigned int count, double randomRate,
 				randomRate(randomRate),
 				resamplingAlgorithm(resamplingAlgorithm),
 				transitionModel(transitionModel),
+				adaptiveCount(),
 				minSize(minSize),
 				maxSize(maxSize),
 				generator(boost::mt19937(time(0))),
@@ -49,8 +59,17 @@ void ResamplingSampler::init(const Mat& image) {
 
 void ResamplingSampler::sample(const vector<shared_ptr<Sample>>& samples, vector<shared_ptr<Sample>>& newSamples,
 		const Mat& image, const shared_ptr<Sample> target) {
-	resamplingAlgorithm->resample(samples, (int)((1 - randomRate) * count), newSamples);
-	transitionModel->predict(newSamples, image, target);
+	if (adaptiveCount) {
+		resamplingAlgorithm->resample(samples, adaptiveCount->getMaxCount(), newSamples);
+		for (size_t i = newSamples.size(); i > 1; --i) // systematic resampling orders the samples by their ancestors
+			std::swap(newSamples[i - 1], newSamples[intDistribution(generator, i)]);
+		transitionModel->predict(newSamples, image, target);
+		count = std::max(adaptiveCount->getMinCount(), adaptiveCount->computeCount(newSamples));
+		newSamples.resize(std::min(newSamples.size(), static_cast<size_t>((1 - randomRate) * count)));
+	} else {
+		resamplingAlgorithm->resample(samples, (int)((1 - randomRate) * count), newSamples);
+		transitionModel->predict(newSamples, image, target);
+	}
 	while (newSamples.size() < count) {
 		shared_ptr<Sample> newSample = make_shared<Sample>();
 		sampleValues(*newSample, image);
@@ -58,6 +77,26 @@ void ResamplingSampler::sample(const vector<shared_ptr<Sample>>& samples, vector
 	}
 }
 
+void ResamplingSampler::saveState(BinaryModelWriter& writer) const {
+	writer.writeInt(count);
+	writer.writeInt(maxSize);
+	ostringstream randomState;
+	randomState.precision(17);
+	randomState << generator << ' ' << intDistribution << ' ' << realDistribution;
+	writer.writeString(randomState.str());
+	resamplingAlgorithm->saveState(writer);
+	transitionModel->saveState(writer);
+}
+
+void ResamplingSampler::loadState(BinaryModelReader& reader) {
+	count = reader.readInt();
+	maxSize = reader.readInt();
+	istringstream randomState(reader.readString());
+	randomState >> generator >> intDistribution >> realDistribution;
+	resamplingAlgorithm->loadState(reader);
+	transitionModel->loadState(reader);
+}
+
 void ResamplingSampler::sampleValues(Sample& sample, const Mat& image) {
 	double sizeFactor = realDistribution(generator) * (static_cast<double>(maxSize) / static_cast<double>(minSize) - 1.0) + 1.0;
 	int size = cvRound(sizeFactor * minSize);
@@ -6,10 +6,126 @@
  */
 
 #include "condensation/Sample.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include <unordered_map>
+
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
+using cv::Mat;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using std::unordered_map;
+using std::runtime_error;
 
 namespace condensation {
 
 double Sample::aspectRatio = 1;
 int Sample::nextClusterId = 0;
 
+/**
+ * Adds a sample and its ancestors to the list of nodes, so that each ancestor comes before its descendants.
+ *
+ * @param[in] sample The sample.
+ * @param[in,out] nodes The samples that were added so far.
+ * @param[in,out] indices The index of each sample within the nodes.
+ * @return The index of the sample within the nodes, -1 if the sample is null.
+ */
+static int addNode(shared_ptr<Sample> sample, vector<shared_ptr<Sample>>& nodes, unordered_map<const Sample*, int>& indices) {
+	if (!sample)
+		return -1;
+	// the ancestor chains may be long, so they are collected iteratively instead of recursively
+	vector<shared_ptr<Sample>> chain;
+	while (sample && indices.find(sample.get()) == indices.end()) {
+		chain.push_back(sample);
+		sample = sample->getAncestor();
+	}
+	for (auto node = chain.rbegin(); node != chain.rend(); ++node) {
+		indices[node->get()] = static_cast<int>(nodes.size());
+		nodes.push_back(*node);
+	}
+	return indices.at(chain.empty() ? sample.get() : chain.front().get());
+}
+
+void Sample::saveSamples(BinaryModelWriter& writer, const vector<shared_ptr<Sample>>& samples) {
+	vector<shared_ptr<Sample>> nodes;
+	unordered_map<const Sample*, int> indices;
+	vector<int32_t> references;
+	references.reserve(samples.size());
+	for (const shared_ptr<Sample>& sample : samples)
+		references.push_back(addNode(sample, nodes, indices));
+
+	writer.writeDouble(aspectRatio);
+	writer.writeInt(nextClusterId);
+	writer.writeInt(nodes.size());
+	vector<int32_t> values;
+	vector<float> sizeChanges;
+	vector<double> weightsAndScores;
+	values.reserve(8 * nodes.size());
+	sizeChanges.reserve(nodes.size());
+	weightsAndScores.reserve(2 * nodes.size());
+	for (const shared_ptr<Sample>& node : nodes) {
+		values.push_back(node->x);
+		values.push_back(node->y);
+		values.push_back(node->size);
+		values.push_back(node->vx);
+		values.push_back(node->vy);
+		values.push_back(node->target ? 1 : 0);
+		values.push_back(node->clusterId);
+		values.push_back(node->ancestor ? indices.at(node->ancestor.get()) : -1);
+		sizeChanges.push_back(node->vsize);
+		weightsAndScores.push_back(node->weight);
+		weightsAndScores.push_back(node->score);
+	}
+	writer.writeInts(values.data(), values.size());
+	writer.writeFloats(sizeChanges.data(), sizeChanges.size());
+	writer.writeDoubles(weightsAndScores.data(), weightsAndScores.size());
+	writer.writeInt(references.size());
+	writer.writeInts(references.data(), references.size());
+}
+
+vector<shared_ptr<Sample>> Sample::loadSamples(BinaryModelReader& reader) {
+	double aspectRatio = reader.readDouble();
+	int nextClusterId = reader.readInt();
+	int nodeCount = reader.readInt();
+	if (nodeCount < 0)
+		throw runtime_error("Sample: Invalid snapshot, negative sample count");
+	Mat values = reader.readInts(8 * nodeCount);
+	Mat sizeChanges = reader.readFloats(nodeCount);
+	Mat weightsAndScores = reader.readDoubles(2 * nodeCount);
+	vector<shared_ptr<Sample>> nodes;
+	nodes.reserve(nodeCount);
+	for (int i = 0; i < nodeCount; ++i) {
+		const int32_t* value = values.ptr<int32_t>() + 8 * i;
+		int ancestorIndex = value[7];
+		if (ancestorIndex >= i)
+			throw runtime_error("Sample: Invalid snapshot, ancestor does not precede its descendant");
+		shared_ptr<Sample> node = make_shared<Sample>(value[0], value[1], value[2], value[3], value[4], sizeChanges.ptr<float>()[i]);
+		node->target = value[5] != 0;
+		node->clusterId = value[6];
+		node->weight = weightsAndScores.ptr<double>()[2 * i];
+		node->score = weightsAndScores.ptr<double>()[2 * i + 1];
+		if (ancestorIndex >= 0)
+			node->ancestor = nodes[ancestorIndex];
+		nodes.push_back(node);
+	}
+	int referenceCount = reader.readInt();
+	if (referenceCount < 0)
+		throw runtime_error("Sample: Invalid snapshot, negative reference count");
+	Mat references = reader.readInts(referenceCount);
+	vector<shared_ptr<Sample>> samples;
+	samples.reserve(referenceCount);
+	for (int i = 0; i < referenceCount; ++i) {
+		int index = references.ptr<int32_t>()[i];
+		if (index >= nodeCount)
+			throw runtime_error("Sample: Invalid snapshot, sample reference out of range");
+		samples.push_back(index < 0 ? shared_ptr<Sample>() : nodes[index]);
+	}
+	// the constructors above took new cluster IDs, so the counter is restored afterwards
+	Sample::aspectRatio = aspectRatio;
+	Sample::nextClusterId = nextClusterId;
+	return samples;
+}
+
 } /* namespace condensation */
@@ -10,6 +10,8 @@
 #include "imageprocessing/Patch.hpp"
 #include "imageprocessing/FeatureExtractor.hpp"
 #include "classification/TrainableProbabilisticClassifier.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include "detection/ClassifiedPatch.hpp"
 #include "boost/iterator/indirect_iterator.hpp"
 #include <algorithm>
@@ -19,6 +21,8 @@ using imageprocessing::Patch;
 using imageprocessing::VersionedImage;
 using imageprocessing::FeatureExtractor;
 using classification::TrainableProbabilisticClassifier;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using detection::ClassifiedPatch;
 using cv::Mat;
 using boost::make_indirect_iterator;
@@ -78,6 +82,17 @@ void SelfLearningMeasurementModel::reset() {
 	usable = false;
 }
 
+void SelfLearningMeasurementModel::saveState(BinaryModelWriter& writer) const {
+	writer.writeInt(usable ? 1 : 0);
+	classifier->saveState(writer);
+}
+
+void SelfLearningMeasurementModel::loadState(BinaryModelReader& reader) {
+	usable = reader.readInt() != 0;
+	cache.clear();
+	classifier->loadState(reader);
+}
+
 bool SelfLearningMeasurementModel::initialize(shared_ptr<VersionedImage> image, Sample& target) {
 	return false;
 }
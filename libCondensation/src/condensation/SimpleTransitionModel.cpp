@@ -7,40 +7,64 @@
 
 #include "condensation/SimpleTransitionModel.hpp"
 #include "condensation/Sample.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <ctime>
+#include <sstream>
 #include <cmath>
 
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using cv::Mat;
 using std::vector;
+using std::ostringstream;
+using std::istringstream;
 using std::shared_ptr;
 
 namespace condensation {
 
 SimpleTransitionModel::SimpleTransitionModel(double positionDeviation, double sizeDeviation) :
-		positionDeviation(positionDeviation), sizeDeviation(sizeDeviation),
+		positionDeviation(positionDeviation), sizeDeviation(sizeDeviation), timeStep(1),
 		generator(boost::mt19937(time(0)), boost::normal_distribution<>()) {}
 
 void SimpleTransitionModel::init(const Mat& image) {}
 
+void SimpleTransitionModel::setTimeStep(double timeStep) {
+	this->timeStep = timeStep;
+}
+
 void SimpleTransitionModel::predict(vector<shared_ptr<Sample>>& samples, const Mat& image, const shared_ptr<Sample> target) {
+	double deviationScale = std::sqrt(timeStep);
 	for (shared_ptr<Sample> sample : samples) {
 		// add noise to velocity
 		double vx = sample->getVx();
 		double vy = sample->getVy();
 		double vs = sample->getVSize();
 		// diffuse
-		vx += positionDeviation * generator();
-		vy += positionDeviation * generator();
-		vs *= pow(2, sizeDeviation * generator());
-		// round to integer
+		vx += deviationScale * positionDeviation * generator();
+		vy += deviationScale * positionDeviation * generator();
+		vs *= pow(2, deviationScale * sizeDeviation * generator());
+		// change position according to the unrounded velocity, the position is rounded only once
+		sample->setX(sample->getX() + static_cast<int>(std::round(vx * timeStep)));
+		sample->setY(sample->getY() + static_cast<int>(std::round(vy * timeStep)));
+		sample->setSize(static_cast<int>(std::round(sample->getSize() * pow(vs, timeStep))));
+		// round to integer for the state
 		sample->setVx(static_cast<int>(std::round(vx)));
 		sample->setVy(static_cast<int>(std::round(vy)));
 		sample->setVSize(vs);
-		// change position according to velocity
-		sample->setX(sample->getX() + sample->getVx());
-		sample->setY(sample->getY() + sample->getVy());
-		sample->setSize(static_cast<int>(std::round(sample->getSize() * sample->getVSize())));
 	}
 }
 
+void SimpleTransitionModel::saveState(BinaryModelWriter& writer) const {
+	ostringstream randomState;
+	randomState.precision(17);
+	randomState << generator.engine() << ' ' << generator.distribution();
+	writer.writeString(randomState.str());
+}
+
+void SimpleTransitionModel::loadState(BinaryModelReader& reader) {
+	istringstream randomState(reader.readString());
+	randomState >> generator.engine() >> generator.distribution();
+}
+
 } /* namespace condensation */
@@ -0,0 +1,148 @@
+/*
+ * TwoTierMeasurementModel.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "condensation/TwoTierMeasurementModel.hpp"
+#include "condensation/Sample.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using imageprocessing::VersionedImage;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
+using std::vector;
+using std::shared_ptr;
+using std::invalid_argument;
+
+namespace condensation {
+
+TwoTierMeasurementModel::TwoTierMeasurementModel(shared_ptr<MeasurementModel> coarseModel,
+		shared_ptr<AdaptiveMeasurementModel> fineModel, double fineFraction, double relativeThreshold) :
+				coarseModel(coarseModel),
+				adaptiveCoarseModel(std::dynamic_pointer_cast<AdaptiveMeasurementModel>(coarseModel)),
+				fineModel(fineModel),
+				fineFraction(fineFraction),
+				relativeThreshold(relativeThreshold),
+				fineEvaluationCount(0),
+				coarseEvaluationCount(0) {
+	if (fineFraction <= 0 || fineFraction > 1)
+		throw invalid_argument("TwoTierMeasurementModel: the fine fraction must be greater than zero and at most one");
+	if (relativeThreshold < 0 || relativeThreshold > 1)
+		throw invalid_argument("TwoTierMeasurementModel: the relative threshold must be between zero and one");
+}
+
+void TwoTierMeasurementModel::update(shared_ptr<VersionedImage> image) {
+	coarseModel->update(image);
+	fineModel->update(image);
+}
+
+void TwoTierMeasurementModel::evaluate(Sample& sample) const {
+	fineModel->evaluate(sample);
+}
+
+void TwoTierMeasurementModel::evaluate(shared_ptr<VersionedImage> image, vector<shared_ptr<Sample>>& samples) {
+	if (samples.empty()) {
+		update(image);
+		return;
+	}
+	// the fine model might take the prior weights into account, so they have to be restored before the fine evaluation
+	vector<double> priorWeights(samples.size());
+	for (size_t i = 0; i < samples.size(); ++i)
+		priorWeights[i] = samples[i]->getWeight();
+	coarseModel->evaluate(image, samples);
+	coarseEvaluationCount += samples.size();
+	vector<double> coarseWeights(samples.size());
+	for (size_t i = 0; i < samples.size(); ++i)
+		coarseWeights[i] = samples[i]->getWeight();
+
+	// select the samples with the highest coarse weights that exceed the threshold
+	vector<size_t> order(samples.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	size_t maxFineCount = std::max(static_cast<size_t>(1), static_cast<size_t>(std::ceil(fineFraction * samples.size())));
+	std::partial_sort(order.begin(), order.begin() + maxFineCount, order.end(), [&](size_t a, size_t b) {
+		return coarseWeights[a] > coarseWeights[b];
+	});
+	double coarseThreshold = relativeThreshold * coarseWeights[order.front()];
+	size_t fineCount = 1;
+	while (fineCount < maxFineCount && coarseWeights[order[fineCount]] >= coarseThreshold)
+		++fineCount;
+	vector<shared_ptr<Sample>> fineSamples;
+	fineSamples.reserve(fineCount);
+	for (size_t i = 0; i < fineCount; ++i) {
+		samples[order[i]]->setWeight(priorWeights[order[i]]);
+		fineSamples.push_back(samples[order[i]]);
+	}
+	fineModel->evaluate(image, fineSamples);
+	fineEvaluationCount += fineCount;
+
+	// calibrate the weights of the remaining samples against the lowest fine weight
+	double lowestCoarseWeight = coarseWeights[order[fineCount - 1]];
+	double lowestFineWeight = fineSamples.front()->getWeight();
+	for (const shared_ptr<Sample>& sample : fineSamples)
+		lowestFineWeight = std::min(lowestFineWeight, sample->getWeight());
+	double calibrationFactor = lowestCoarseWeight > 0 ? lowestFineWeight / lowestCoarseWeight : 0;
+	for (size_t i = fineCount; i < order.size(); ++i) {
+		shared_ptr<Sample>& sample = samples[order[i]];
+		sample->setWeight(calibrationFactor * coarseWeights[order[i]]);
+		sample->setTarget(false);
+	}
+}
+
+bool TwoTierMeasurementModel::isUsable() const {
+	return fineModel->isUsable() && (!adaptiveCoarseModel || adaptiveCoarseModel->isUsable());
+}
+
+bool TwoTierMeasurementModel::initialize(shared_ptr<VersionedImage> image, Sample& target) {
+	bool initialized = fineModel->initialize(image, target);
+	if (adaptiveCoarseModel)
+		initialized = adaptiveCoarseModel->initialize(image, target) || initialized;
+	return initialized;
+}
+
+bool TwoTierMeasurementModel::adapt(shared_ptr<VersionedImage> image, const vector<shared_ptr<Sample>>& samples, const Sample& target) {
+	bool adapted = fineModel->adapt(image, samples, target);
+	if (adaptiveCoarseModel)
+		adapted = adaptiveCoarseModel->adapt(image, samples, target) || adapted;
+	return adapted;
+}
+
+bool TwoTierMeasurementModel::adapt(shared_ptr<VersionedImage> image, const vector<shared_ptr<Sample>>& samples) {
+	bool adapted = fineModel->adapt(image, samples);
+	if (adaptiveCoarseModel)
+		adapted = adaptiveCoarseModel->adapt(image, samples) || adapted;
+	return adapted;
+}
+
+void TwoTierMeasurementModel::reset() {
+	fineModel->reset();
+	if (adaptiveCoarseModel)
+		adaptiveCoarseModel->reset();
+	fineEvaluationCount = 0;
+	coarseEvaluationCount = 0;
+}
+
+void TwoTierMeasurementModel::saveState(BinaryModelWriter& writer) const {
+	// the counts are written as doubles, as they may exceed the range of 32 bit integers
+	writer.writeDouble(static_cast<double>(fineEvaluationCount));
+	writer.writeDouble(static_cast<double>(coarseEvaluationCount));
+	if (adaptiveCoarseModel)
+		adaptiveCoarseModel->saveState(writer);
+	fineModel->saveState(writer);
+}
+
+void TwoTierMeasurementModel::loadState(BinaryModelReader& reader) {
+	fineEvaluationCount = static_cast<size_t>(reader.readDouble());
+	coarseEvaluationCount = static_cast<size_t>(reader.readDouble());
+	if (adaptiveCoarseModel)
+		adaptiveCoarseModel->loadState(reader);
+	fineModel->loadState(reader);
+}
+
+} /* namespace condensation */
@@ -0,0 +1,182 @@
+/*
+ * DetectionEvaluation.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef DETECTIONEVALUATION_HPP_
+#define DETECTIONEVALUATION_HPP_
+
+#include "detection/DetectionRegion.hpp"
+#include "opencv2/core/core.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace detection {
+
+/**
+ * Evaluation of detections against ground-truth annotations in the style of the FDDB face-detection benchmark
+ * (Jain and Learned-Miller, FDDB: A Benchmark for Face Detection in Unconstrained Settings).
+ *
+ * The detections of each image are matched to its ground-truth regions by a maximum-weight bipartite matching
+ * (Hungarian algorithm) on the overlaps, where overlaps below the threshold do not count. A matched detection
+ * counts as one true positive for the discrete score and as its overlap for the continuous score, while each
+ * unmatched detection counts as one false positive for both scores (as in the FDDB evaluation). The
+ * matching is computed once per image using all detections, which is done in parallel; the curves are then
+ * obtained by sweeping a threshold over the detection scores.
+ */
+class DetectionEvaluation {
+public:
+
+	/**
+	 * Regions of several images, indexed by the image name.
+	 */
+	typedef std::map<std::string, std::vector<DetectionRegion>> RegionsPerImage;
+
+	/**
+	 * Detection together with its overlap with the matched ground-truth region.
+	 */
+	struct MatchedDetection {
+		double score;   ///< The detection score.
+		double overlap; ///< Overlap with the matched ground-truth region, zero if the detection was not matched.
+	};
+
+	/**
+	 * Point of a ROC curve.
+	 */
+	struct RocPoint {
+		double threshold;      ///< The score threshold, only detections with a score of at least this value count.
+		double truePositives;  ///< The (possibly fractional) number of true positives.
+		double falsePositives; ///< The number of false positives (unmatched detections).
+		double truePositiveRate; ///< The true positives divided by the number of ground-truth regions.
+	};
+
+	/**
+	 * Point of a precision-recall curve.
+	 */
+	struct PrecisionRecallPoint {
+		double threshold; ///< The score threshold, only detections with a score of at least this value count.
+		double precision; ///< Fraction of the detections that are true positives.
+		double recall;    ///< Fraction of the ground-truth regions that were detected.
+	};
+
+	/**
+	 * Constructs a new detection evaluation.
+	 *
+	 * @param[in] overlapThreshold The minimum overlap of a detection and a ground-truth region to be matched.
+	 * @param[in] threadCount The number of threads used for matching, zero for the number of cores.
+	 */
+	explicit DetectionEvaluation(double overlapThreshold = 0.5, size_t threadCount = 0);
+
+	/**
+	 * Matches the detections to the ground-truth regions. Images without ground-truth regions contribute only
+	 * false positives, images without detections only misses. Replaces the result of previous evaluations.
+	 *
+	 * @param[in] groundTruth The ground-truth regions of each image.
+	 * @param[in] detections The detections of each image.
+	 */
+	void evaluate(const RegionsPerImage& groundTruth, const RegionsPerImage& detections);
+
+	/**
+	 * Computes the ROC curve with one point per distinct detection score, ordered by decreasing threshold.
+	 *
+	 * @param[in] continuous Flag that indicates whether matched detections count as their overlap instead of one.
+	 * @return The ROC curve.
+	 */
+	std::vector<RocPoint> computeRocCurve(bool continuous) const;
+
+	/**
+	 * Computes the precision-recall curve (using the discrete score) with one point per distinct detection score,
+	 * ordered by decreasing threshold.
+	 *
+	 * @return The precision-recall curve.
+	 */
+	std::vector<PrecisionRecallPoint> computePrecisionRecallCurve() const;
+
+	/**
+	 * Computes the average precision, which is the area under the precision-recall curve.
+	 *
+	 * @return The average precision.
+	 */
+	double computeAveragePrecision() const;
+
+	/**
+	 * @return The matched detections of all images, ordered by decreasing score.
+	 */
+	const std::vector<MatchedDetection>& getMatchedDetections() const {
+		return matchedDetections;
+	}
+
+	/**
+	 * @return The number of ground-truth regions over all images.
+	 */
+	size_t getGroundTruthCount() const {
+		return groundTruthCount;
+	}
+
+	/**
+	 * @return The number of evaluated images.
+	 */
+	size_t getImageCount() const {
+		return imageCount;
+	}
+
+	/**
+	 * Loads regions from a file in the FDDB format. Each image starts with a line containing its name, followed
+	 * by a line with the number of regions and one line per region. A region is either a rectangle
+	 * "left top width height score" or an ellipse "majorRadius minorRadius angle centerX centerY score".
+	 *
+	 * @param[in] filename The name of the file.
+	 * @return The regions of each image.
+	 */
+	static RegionsPerImage loadFddbFile(const std::string& filename);
+
+	/**
+	 * Stores a ROC curve in the format of the FDDB evaluation, one line "truePositiveRate falsePositives threshold"
+	 * per point.
+	 *
+	 * @param[in] curve The ROC curve.
+	 * @param[in] filename The name of the file.
+	 */
+	static void saveRocCurve(const std::vector<RocPoint>& curve, const std::string& filename);
+
+	/**
+	 * Stores a precision-recall curve, one line "precision recall threshold" per point.
+	 *
+	 * @param[in] curve The precision-recall curve.
+	 * @param[in] filename The name of the file.
+	 */
+	static void savePrecisionRecallCurve(const std::vector<PrecisionRecallPoint>& curve, const std::string& filename);
+
+	/**
+	 * Computes the maximum-weight assignment of rows to columns using the Hungarian algorithm.
+	 *
+	 * @param[in] weights The non-negative weights with one row per element of the first and one column per
+	 *                    element of the second set.
+	 * @return The assigned column of each row, -1 if the row was not assigned or only with zero weight.
+	 */
+	static std::vector<int> computeOptimalAssignment(const cv::Mat_<double>& weights);
+
+private:
+
+	/**
+	 * Matches the detections of one image to its ground-truth regions.
+	 *
+	 * @param[in] groundTruth The ground-truth regions of the image.
+	 * @param[in] detections The detections of the image.
+	 * @return The detections with their overlaps.
+	 */
+	std::vector<MatchedDetection> match(const std::vector<DetectionRegion>& groundTruth, const std::vector<DetectionRegion>& detections) const;
+
+	double overlapThreshold; ///< The minimum overlap of a detection and a ground-truth region to be matched.
+	size_t threadCount; ///< The number of threads used for matching.
+	std::vector<MatchedDetection> matchedDetections; ///< The matched detections of all images, ordered by decreasing score.
+	size_t groundTruthCount; ///< The number of ground-truth regions over all images.
+	size_t imageCount; ///< The number of evaluated images.
+};
+
+} /* namespace detection */
+#endif /* DETECTIONEVALUATION_HPP_ */
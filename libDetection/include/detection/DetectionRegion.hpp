@@ -0,0 +1,109 @@
+/*
+ * DetectionRegion.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef DETECTIONREGION_HPP_
+#define DETECTIONREGION_HPP_
+
+#include "opencv2/core/core.hpp"
+
+namespace detection {
+
+/**
+ * Image region of a detection or ground-truth annotation, either an axis-aligned rectangle or a rotated
+ * ellipse (as used by the FDDB face-detection benchmark, http://vis-www.cs.umass.edu/fddb/).
+ */
+class DetectionRegion {
+public:
+
+	/**
+	 * Creates a rectangular region.
+	 *
+	 * @param[in] x The x coordinate of the upper left corner.
+	 * @param[in] y The y coordinate of the upper left corner.
+	 * @param[in] width The width.
+	 * @param[in] height The height.
+	 * @param[in] score The detection score (irrelevant for ground-truth regions).
+	 * @return The region.
+	 */
+	static DetectionRegion createRectangle(double x, double y, double width, double height, double score = 1);
+
+	/**
+	 * Creates an elliptical region.
+	 *
+	 * @param[in] centerX The x coordinate of the center.
+	 * @param[in] centerY The y coordinate of the center.
+	 * @param[in] majorRadius The radius along the (rotated) major axis.
+	 * @param[in] minorRadius The radius along the (rotated) minor axis.
+	 * @param[in] angle The angle between the major axis and the x axis in radians.
+	 * @param[in] score The detection score (irrelevant for ground-truth regions).
+	 * @return The region.
+	 */
+	static DetectionRegion createEllipse(double centerX, double centerY, double majorRadius, double minorRadius, double angle, double score = 1);
+
+	/**
+	 * Computes the overlap of this region with another one, which is the area of their intersection divided by the
+	 * area of their union. The overlap of two rectangles is computed exactly, the overlap involving an ellipse is
+	 * approximated by sampling the union of the bounding boxes on a regular grid.
+	 *
+	 * @param[in] other The other region.
+	 * @return The overlap between zero and one.
+	 */
+	double computeOverlap(const DetectionRegion& other) const;
+
+	/**
+	 * Determines whether a point lies inside this region.
+	 *
+	 * @param[in] x The x coordinate of the point.
+	 * @param[in] y The y coordinate of the point.
+	 * @return True if the point lies inside this region, false otherwise.
+	 */
+	bool contains(double x, double y) const;
+
+	/**
+	 * @return The bounding box of this region.
+	 */
+	cv::Rect_<double> getBoundingBox() const {
+		return boundingBox;
+	}
+
+	/**
+	 * @return True if this region is an ellipse, false if it is a rectangle.
+	 */
+	bool isEllipse() const {
+		return ellipse;
+	}
+
+	/**
+	 * @return The detection score.
+	 */
+	double getScore() const {
+		return score;
+	}
+
+private:
+
+	/**
+	 * Constructs a new empty rectangular region.
+	 */
+	DetectionRegion();
+
+	bool ellipse; ///< Flag that indicates whether this region is an ellipse (rectangle otherwise).
+	double centerX; ///< The x coordinate of the center.
+	double centerY; ///< The y coordinate of the center.
+	double radiusX; ///< Half of the width (rectangle) or radius along the major axis (ellipse).
+	double radiusY; ///< Half of the height (rectangle) or radius along the minor axis (ellipse).
+	double cosAngle; ///< Cosine of the rotation angle.
+	double sinAngle; ///< Sine of the rotation angle.
+	cv::Rect_<double> boundingBox; ///< The axis-aligned bounding box.
+	double score; ///< The detection score.
+
+	static const int samplesPerSide = 100; ///< Number of grid samples per side used for approximating overlaps with ellipses.
+};
+
+} /* namespace detection */
+#endif /* DETECTIONREGION_HPP_ */
@@ -0,0 +1,278 @@
+/*
+ * DetectionEvaluation.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "detection/DetectionEvaluation.hpp"
+#include "logging/LoggerFactory.hpp"
+#include "boost/lexical_cast.hpp"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+
+using logging::Logger;
+using logging::LoggerFactory;
+using boost::lexical_cast;
+using cv::Mat_;
+using std::string;
+using std::vector;
+using std::runtime_error;
+
+namespace detection {
+
+DetectionEvaluation::DetectionEvaluation(double overlapThreshold, size_t threadCount) :
+		overlapThreshold(overlapThreshold), threadCount(threadCount), matchedDetections(), groundTruthCount(0), imageCount(0) {
+	if (this->threadCount == 0)
+		this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void DetectionEvaluation::evaluate(const RegionsPerImage& groundTruth, const RegionsPerImage& detections) {
+	vector<string> imageNames;
+	groundTruthCount = 0;
+	for (const auto& image : groundTruth) {
+		imageNames.push_back(image.first);
+		groundTruthCount += image.second.size();
+	}
+	for (const auto& image : detections) {
+		if (groundTruth.find(image.first) == groundTruth.end())
+			imageNames.push_back(image.first);
+	}
+	imageCount = imageNames.size();
+
+	// the images are distributed dynamically, as their number of regions (and therefore cost) varies a lot
+	const vector<DetectionRegion> noRegions;
+	vector<vector<MatchedDetection>> matchesPerImage(imageNames.size());
+	std::atomic<size_t> nextImage(0);
+	auto worker = [&]() {
+		for (size_t i = nextImage++; i < imageNames.size(); i = nextImage++) {
+			auto groundTruthIterator = groundTruth.find(imageNames[i]);
+			auto detectionsIterator = detections.find(imageNames[i]);
+			matchesPerImage[i] = match(
+					groundTruthIterator == groundTruth.end() ? noRegions : groundTruthIterator->second,
+					detectionsIterator == detections.end() ? noRegions : detectionsIterator->second);
+		}
+	};
+	vector<std::thread> threads;
+	for (size_t t = 1; t < threadCount; ++t)
+		threads.emplace_back(worker);
+	worker();
+	for (std::thread& thread : threads)
+		thread.join();
+
+	matchedDetections.clear();
+	for (const vector<MatchedDetection>& matches : matchesPerImage)
+		matchedDetections.insert(matchedDetections.end(), matches.begin(), matches.end());
+	std::sort(matchedDetections.begin(), matchedDetections.end(), [](const MatchedDetection& a, const MatchedDetection& b) {
+		return a.score > b.score;
+	});
+
+	Logger logger = Loggers->getLogger("detection");
+	logger.info("DetectionEvaluation: matched " + lexical_cast<string>(matchedDetections.size()) + " detections to "
+			+ lexical_cast<string>(groundTruthCount) + " ground-truth regions in " + lexical_cast<string>(imageCount) + " images");
+}
+
+vector<DetectionEvaluation::MatchedDetection> DetectionEvaluation::match(
+		const vector<DetectionRegion>& groundTruth, const vector<DetectionRegion>& detections) const {
+	vector<MatchedDetection> matches(detections.size());
+	for (size_t i = 0; i < detections.size(); ++i) {
+		matches[i].score = detections[i].getScore();
+		matches[i].overlap = 0;
+	}
+	if (groundTruth.empty() || detections.empty())
+		return matches;
+	Mat_<double> overlaps(static_cast<int>(detections.size()), static_cast<int>(groundTruth.size()));
+	for (size_t i = 0; i < detections.size(); ++i) {
+		for (size_t j = 0; j < groundTruth.size(); ++j) {
+			double overlap = detections[i].computeOverlap(groundTruth[j]);
+			overlaps(i, j) = overlap >= overlapThreshold ? overlap : 0;
+		}
+	}
+	vector<int> assignment = computeOptimalAssignment(overlaps);
+	for (size_t i = 0; i < detections.size(); ++i) {
+		if (assignment[i] >= 0)
+			matches[i].overlap = overlaps(i, assignment[i]);
+	}
+	return matches;
+}
+
+vector<DetectionEvaluation::RocPoint> DetectionEvaluation::computeRocCurve(bool continuous) const {
+	vector<RocPoint> curve;
+	double truePositives = 0;
+	double falsePositives = 0;
+	for (size_t i = 0; i < matchedDetections.size(); ++i) {
+		const MatchedDetection& detection = matchedDetections[i];
+		// only unmatched detections are false positives, even if a matched one adds less than one true positive
+		if (detection.overlap == 0)
+			falsePositives += 1;
+		else if (continuous)
+			truePositives += detection.overlap;
+		else
+			truePositives += 1;
+		// only add a point after the last detection of a score
+		if (i + 1 < matchedDetections.size() && matchedDetections[i + 1].score == detection.score)
+			continue;
+		RocPoint point;
+		point.threshold = detection.score;
+		point.truePositives = truePositives;
+		point.falsePositives = falsePositives;
+		point.truePositiveRate = groundTruthCount == 0 ? 0 : truePositives / groundTruthCount;
+		curve.push_back(point);
+	}
+	return curve;
+}
+
+vector<DetectionEvaluation::PrecisionRecallPoint> DetectionEvaluation::computePrecisionRecallCurve() const {
+	vector<RocPoint> rocCurve = computeRocCurve(false);
+	vector<PrecisionRecallPoint> curve;
+	curve.reserve(rocCurve.size());
+	for (const RocPoint& rocPoint : rocCurve) {
+		PrecisionRecallPoint point;
+		point.threshold = rocPoint.threshold;
+		point.precision = rocPoint.truePositives / (rocPoint.truePositives + rocPoint.falsePositives);
+		point.recall = rocPoint.truePositiveRate;
+		curve.push_back(point);
+	}
+	return curve;
+}
+
+double DetectionEvaluation::computeAveragePrecision() const {
+	vector<PrecisionRecallPoint> curve = computePrecisionRecallCurve();
+	double averagePrecision = 0;
+	double previousRecall = 0;
+	for (const PrecisionRecallPoint& point : curve) {
+		averagePrecision += (point.recall - previousRecall) * point.precision;
+		previousRecall = point.recall;
+	}
+	return averagePrecision;
+}
+
+DetectionEvaluation::RegionsPerImage DetectionEvaluation::loadFddbFile(const string& filename) {
+	std::ifstream file(filename.c_str());
+	if (!file.is_open())
+		throw runtime_error("DetectionEvaluation: Could not open file: " + filename);
+	RegionsPerImage regions;
+	string imageName;
+	string line;
+	while (std::getline(file, imageName)) {
+		if (imageName.empty() || imageName == "\r")
+			continue;
+		if (imageName.back() == '\r')
+			imageName.pop_back();
+		int count;
+		if (!std::getline(file, line) || !(std::istringstream(line) >> count) || count < 0)
+			throw runtime_error("DetectionEvaluation: Missing number of regions for image " + imageName + " in file " + filename);
+		vector<DetectionRegion>& imageRegions = regions[imageName];
+		for (int i = 0; i < count; ++i) {
+			if (!std::getline(file, line))
+				throw runtime_error("DetectionEvaluation: Unexpected end of file " + filename);
+			std::istringstream lineStream(line);
+			vector<double> values;
+			double value;
+			while (lineStream >> value)
+				values.push_back(value);
+			if (values.size() == 5)
+				imageRegions.push_back(DetectionRegion::createRectangle(values[0], values[1], values[2], values[3], values[4]));
+			else if (values.size() == 6)
+				imageRegions.push_back(DetectionRegion::createEllipse(values[3], values[4], values[0], values[1], values[2], values[5]));
+			else
+				throw runtime_error("DetectionEvaluation: Invalid region \"" + line + "\" in file " + filename);
+		}
+	}
+	return regions;
+}
+
+void DetectionEvaluation::saveRocCurve(const vector<RocPoint>& curve, const string& filename) {
+	std::ofstream file(filename.c_str());
+	if (!file.is_open())
+		throw runtime_error("DetectionEvaluation: Could not open file: " + filename);
+	file.precision(8);
+	for (const RocPoint& point : curve)
+		file << point.truePositiveRate << " " << point.falsePositives << " " << point.threshold << "\n";
+}
+
+void DetectionEvaluation::savePrecisionRecallCurve(const vector<PrecisionRecallPoint>& curve, const string& filename) {
+	std::ofstream file(filename.c_str());
+	if (!file.is_open())
+		throw runtime_error("DetectionEvaluation: Could not open file: " + filename);
+	file.precision(8);
+	for (const PrecisionRecallPoint& point : curve)
+		file << point.precision << " " << point.recall << " " << point.threshold << "\n";
+}
+
+vector<int> DetectionEvaluation::computeOptimalAssignment(const Mat_<double>& weights) {
+	int rows = weights.rows;
+	int cols = weights.cols;
+	if (rows > cols) { // the algorithm needs at least as many columns as rows
+		vector<int> transposedAssignment = computeOptimalAssignment(Mat_<double>(weights.t()));
+		vector<int> assignment(rows, -1);
+		for (int col = 0; col < cols; ++col) {
+			if (transposedAssignment[col] >= 0)
+				assignment[transposedAssignment[col]] = col;
+		}
+		return assignment;
+	}
+	double maxWeight = 0;
+	for (int row = 0; row < rows; ++row)
+		for (int col = 0; col < cols; ++col)
+			maxWeight = std::max(maxWeight, weights(row, col));
+
+	// Hungarian algorithm minimizing the costs maxWeight - weight, with one-based indices and potentials u and v
+	const double infinity = std::numeric_limits<double>::infinity();
+	vector<double> u(rows + 1, 0), v(cols + 1, 0);
+	vector<int> rowOfCol(cols + 1, 0), way(cols + 1, 0);
+	for (int row = 1; row <= rows; ++row) {
+		rowOfCol[0] = row;
+		int col0 = 0;
+		vector<double> minValues(cols + 1, infinity);
+		vector<bool> used(cols + 1, false);
+		do {
+			used[col0] = true;
+			int row0 = rowOfCol[col0];
+			double delta = infinity;
+			int col1 = 0;
+			for (int col = 1; col <= cols; ++col) {
+				if (used[col])
+					continue;
+				double current = (maxWeight - weights(row0 - 1, col - 1)) - u[row0] - v[col];
+				if (current < minValues[col]) {
+					minValues[col] = current;
+					way[col] = col0;
+				}
+				if (minValues[col] < delta) {
+					delta = minValues[col];
+					col1 = col;
+				}
+			}
+			for (int col = 0; col <= cols; ++col) {
+				if (used[col]) {
+					u[rowOfCol[col]] += delta;
+					v[col] -= delta;
+				} else {
+					minValues[col] -= delta;
+				}
+			}
+			col0 = col1;
+		} while (rowOfCol[col0] != 0);
+		do {
+			int col1 = way[col0];
+			rowOfCol[col0] = rowOfCol[col1];
+			col0 = col1;
+		} while (col0 != 0);
+	}
+
+	vector<int> assignment(rows, -1);
+	for (int col = 1; col <= cols; ++col) {
+		int row = rowOfCol[col];
+		if (row != 0 && weights(row - 1, col - 1) > 0)
+			assignment[row - 1] = col - 1;
+	}
+	return assignment;
+}
+
+} /* namespace detection */
@@ -0,0 +1,86 @@
+/*
+ * DetectionRegion.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "detection/DetectionRegion.hpp"
+#include <algorithm>
+#include <cmath>
+
+using cv::Rect_;
+
+namespace detection {
+
+DetectionRegion::DetectionRegion() :
+		ellipse(false), centerX(0), centerY(0), radiusX(0), radiusY(0), cosAngle(1), sinAngle(0), boundingBox(), score(1) {}
+
+DetectionRegion DetectionRegion::createRectangle(double x, double y, double width, double height, double score) {
+	DetectionRegion region;
+	region.centerX = x + 0.5 * width;
+	region.centerY = y + 0.5 * height;
+	region.radiusX = 0.5 * width;
+	region.radiusY = 0.5 * height;
+	region.boundingBox = Rect_<double>(x, y, width, height);
+	region.score = score;
+	return region;
+}
+
+DetectionRegion DetectionRegion::createEllipse(double centerX, double centerY, double majorRadius, double minorRadius, double angle, double score) {
+	DetectionRegion region;
+	region.ellipse = true;
+	region.centerX = centerX;
+	region.centerY = centerY;
+	region.radiusX = majorRadius;
+	region.radiusY = minorRadius;
+	region.cosAngle = std::cos(angle);
+	region.sinAngle = std::sin(angle);
+	// half extents of the rotated ellipse
+	double halfWidth = std::sqrt(majorRadius * majorRadius * region.cosAngle * region.cosAngle + minorRadius * minorRadius * region.sinAngle * region.sinAngle);
+	double halfHeight = std::sqrt(majorRadius * majorRadius * region.sinAngle * region.sinAngle + minorRadius * minorRadius * region.cosAngle * region.cosAngle);
+	region.boundingBox = Rect_<double>(centerX - halfWidth, centerY - halfHeight, 2 * halfWidth, 2 * halfHeight);
+	region.score = score;
+	return region;
+}
+
+bool DetectionRegion::contains(double x, double y) const {
+	double dx = x - centerX;
+	double dy = y - centerY;
+	if (!ellipse)
+		return std::abs(dx) <= radiusX && std::abs(dy) <= radiusY;
+	double u = (dx * cosAngle + dy * sinAngle) / radiusX;
+	double v = (-dx * sinAngle + dy * cosAngle) / radiusY;
+	return u * u + v * v <= 1;
+}
+
+double DetectionRegion::computeOverlap(const DetectionRegion& other) const {
+	Rect_<double> intersection = boundingBox & other.boundingBox;
+	if (intersection.width <= 0 || intersection.height <= 0)
+		return 0;
+	if (!ellipse && !other.ellipse) {
+		double unionArea = boundingBox.area() + other.boundingBox.area() - intersection.area();
+		return intersection.area() / unionArea;
+	}
+	// count the samples inside of the intersection and union, only the union of the bounding boxes may contain any
+	Rect_<double> bounds = boundingBox | other.boundingBox;
+	double stepX = bounds.width / samplesPerSide;
+	double stepY = bounds.height / samplesPerSide;
+	int intersectionCount = 0;
+	int unionCount = 0;
+	for (int row = 0; row < samplesPerSide; ++row) {
+		double y = bounds.y + (row + 0.5) * stepY;
+		for (int col = 0; col < samplesPerSide; ++col) {
+			double x = bounds.x + (col + 0.5) * stepX;
+			bool inThis = contains(x, y);
+			bool inOther = other.contains(x, y);
+			if (inThis && inOther)
+				++intersectionCount;
+			if (inThis || inOther)
+				++unionCount;
+		}
+	}
+	return unionCount == 0 ? 0 : static_cast<double>(intersectionCount) / unionCount;
+}
+
+} /* namespace detection */
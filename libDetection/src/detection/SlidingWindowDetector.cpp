@@ -12,6 +12,7 @@
 #include "classification/ProbabilisticClassifier.hpp"
 #include "detection/ClassifiedPatch.hpp"
 #include "imagelogging/ImageLoggerFactory.hpp"
+#include "logging/Tracer.hpp"
 
 #include "opencv2/core/core.hpp"
 #include "opencv2/imgproc/imgproc.hpp"
@@ -69,6 +70,7 @@ vector<shared_ptr<ClassifiedPatch>> SlidingWindowDetector::detect(const Mat& ima
 	vector<shared_ptr<ClassifiedPatch>> classifiedPatches;
 	vector<shared_ptr<Patch>> pyramidPatches = featureExtractor->extract(stepSizeX, stepSizeY, roi);
 
+	TRACE_SCOPE("SlidingWindowDetector::classify");
 	for (unsigned int i = 0; i < pyramidPatches.size(); ++i) {
 		pair<bool, double> res = classifier->getProbability(pyramidPatches[i]->getData());
 		if(res.first==true)
@@ -89,6 +91,7 @@ vector<shared_ptr<ClassifiedPatch>> SlidingWindowDetector::detect() const
 	vector<shared_ptr<ClassifiedPatch>> classifiedPatches;
 	vector<shared_ptr<Patch>> pyramidPatches = featureExtractor->extract(stepSizeX, stepSizeY);
 
+	TRACE_SCOPE("SlidingWindowDetector::classify");
 	for (unsigned int i = 0; i < pyramidPatches.size(); ++i) {
 		pair<bool, double> res = classifier->getProbability(pyramidPatches[i]->getData());
 		if(res.first==true)
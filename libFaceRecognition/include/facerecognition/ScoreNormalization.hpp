@@ -0,0 +1,174 @@
+/*
+ * ScoreNormalization.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef SCORENORMALIZATION_HPP_
+#define SCORENORMALIZATION_HPP_
+
+#include "facerecognition/FaceRecord.hpp"
+
+#include "opencv2/core/core.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace facerecognition {
+
+/**
+ * Cohort-based normalization of verification scores. All scores are given as
+ * dense matrices (CV_32FC1), where the rows correspond to the probes and the
+ * columns to the gallery templates:
+ *   - scores: probes x gallery, the scores to normalize,
+ *   - galleryCohortScores: cohort x gallery, the scores of the (Z-)cohort
+ *     probes against the gallery, i.e. impostor scores of each gallery template,
+ *   - probeCohortScores: probes x cohort, the scores of the probes against the
+ *     (T-)cohort templates, i.e. impostor scores of each probe,
+ *   - cohortCohortScores: cohort x cohort, the scores of the Z-cohort probes
+ *     against the T-cohort templates (only needed for ZT-norm).
+ *
+ * Z-norm normalizes each column by the mean and standard deviation of the
+ * gallery template's impostor scores, T-norm normalizes each row by the
+ * statistics of the probe's impostor scores. ZT-norm applies Z-norm to the
+ * scores and to the probe cohort scores first, and T-norm afterwards.
+ *
+ * The statistics and the normalization are computed on whole rows at once
+ * and are distributed over several threads, each one working on its own rows
+ * (or columns), so the normalization of large score sets takes seconds. The
+ * scores must be finite, missing scores (e.g. failures to enroll) have to be
+ * removed beforehand.
+ */
+class ScoreNormalization
+{
+public:
+	/**
+	 * The normalization method.
+	 */
+	enum class Method {
+		NONE, ///< No normalization.
+		Z_NORM, ///< Normalization by the impostor statistics of each gallery template.
+		T_NORM, ///< Normalization by the impostor statistics of each probe.
+		ZT_NORM ///< Z-norm followed by T-norm.
+	};
+
+	/**
+	 * Constructs a new score normalization.
+	 *
+	 * @param[in] threadCount The number of threads, 0 for the number of hardware threads.
+	 * @param[in] minDeviation The lower bound of the standard deviations, to avoid divisions by zero for constant cohort scores.
+	 */
+	explicit ScoreNormalization(unsigned int threadCount = 0, float minDeviation = 1e-6f);
+
+	/**
+	 * Applies the Z-norm, i.e. normalizes each column of the scores by the
+	 * mean and standard deviation of the corresponding column of the cohort scores.
+	 *
+	 * @param[in] scores The scores (probes x gallery).
+	 * @param[in] galleryCohortScores The scores of the cohort probes against the gallery (cohort x gallery).
+	 * @return The normalized scores (probes x gallery).
+	 */
+	cv::Mat zNorm(cv::Mat scores, cv::Mat galleryCohortScores) const;
+
+	/**
+	 * Applies the T-norm, i.e. normalizes each row of the scores by the mean
+	 * and standard deviation of the corresponding row of the cohort scores.
+	 *
+	 * @param[in] scores The scores (probes x gallery).
+	 * @param[in] probeCohortScores The scores of the probes against the cohort templates (probes x cohort).
+	 * @return The normalized scores (probes x gallery).
+	 */
+	cv::Mat tNorm(cv::Mat scores, cv::Mat probeCohortScores) const;
+
+	/**
+	 * Applies the ZT-norm. The scores and the probe cohort scores are Z-normalized
+	 * (the latter using the scores of the Z-cohort against the T-cohort), followed
+	 * by the T-norm of the scores with the Z-normalized probe cohort scores.
+	 *
+	 * @param[in] scores The scores (probes x gallery).
+	 * @param[in] galleryCohortScores The scores of the Z-cohort probes against the gallery (Z-cohort x gallery).
+	 * @param[in] probeCohortScores The scores of the probes against the T-cohort templates (probes x T-cohort).
+	 * @param[in] cohortCohortScores The scores of the Z-cohort probes against the T-cohort templates (Z-cohort x T-cohort).
+	 * @return The normalized scores (probes x gallery).
+	 */
+	cv::Mat ztNorm(cv::Mat scores, cv::Mat galleryCohortScores, cv::Mat probeCohortScores, cv::Mat cohortCohortScores) const;
+
+	/**
+	 * Applies the given normalization method. Cohort scores that the method
+	 * does not need may be empty.
+	 *
+	 * @param[in] method The normalization method.
+	 * @param[in] scores The scores (probes x gallery).
+	 * @param[in] galleryCohortScores The scores of the Z-cohort probes against the gallery (Z-cohort x gallery).
+	 * @param[in] probeCohortScores The scores of the probes against the T-cohort templates (probes x T-cohort).
+	 * @param[in] cohortCohortScores The scores of the Z-cohort probes against the T-cohort templates (Z-cohort x T-cohort).
+	 * @return The normalized scores (probes x gallery).
+	 */
+	cv::Mat normalize(Method method, cv::Mat scores, cv::Mat galleryCohortScores, cv::Mat probeCohortScores, cv::Mat cohortCohortScores) const;
+
+	/**
+	 * Computes the mean and standard deviation of each row of a score matrix.
+	 *
+	 * @param[in] scores The scores (CV_32FC1).
+	 * @return The means and standard deviations as column vectors (rows x 1, CV_32FC1).
+	 */
+	std::pair<cv::Mat, cv::Mat> computeRowStatistics(cv::Mat scores) const;
+
+	/**
+	 * Computes the mean and standard deviation of each column of a score matrix.
+	 *
+	 * @param[in] scores The scores (CV_32FC1).
+	 * @return The means and standard deviations as row vectors (1 x cols, CV_32FC1).
+	 */
+	std::pair<cv::Mat, cv::Mat> computeColumnStatistics(cv::Mat scores) const;
+
+	/**
+	 * Parses the name of a normalization method ("none", "z", "t" or "zt").
+	 *
+	 * @param[in] name The name of the method.
+	 * @return The normalization method.
+	 */
+	static Method parseMethod(const std::string& name);
+
+private:
+	/**
+	 * @return The number of threads used for the given number of rows (at least one, at most one per row).
+	 */
+	unsigned int getNumThreads(int rows) const;
+
+	/**
+	 * Runs a function on the row ranges [begin, end) of the given number of rows,
+	 * distributed over the threads. The function gets the index of the thread
+	 * (0 to getNumThreads(rows) - 1), the begin and the end of its rows.
+	 */
+	template<class Function>
+	void forEachRowRange(int rows, Function function) const;
+
+	/**
+	 * Normalizes the scores by the given means and standard deviations, which
+	 * are either row vectors (one value per column) or column vectors (one value per row).
+	 */
+	cv::Mat apply(cv::Mat scores, cv::Mat means, cv::Mat deviations, bool perColumn) const;
+
+	unsigned int threadCount; ///< The number of threads, 0 for the number of hardware threads.
+	float minDeviation; ///< The lower bound of the standard deviations.
+};
+
+/**
+ * Splits a score matrix into the genuine and impostor scores, as they are
+ * needed for ROC and DET curves. A score is genuine if the subject IDs of the
+ * probe and the gallery record are equal.
+ *
+ * @param[in] scores The scores (probes x gallery, CV_32FC1).
+ * @param[in] probes The records of the probes, one per row.
+ * @param[in] gallery The records of the gallery, one per column.
+ * @return The genuine and the impostor scores.
+ */
+std::pair<std::vector<float>, std::vector<float>> splitGenuineImpostorScores(cv::Mat scores, const std::vector<FaceRecord>& probes, const std::vector<FaceRecord>& gallery);
+
+} /* namespace facerecognition */
+
+#endif /* SCORENORMALIZATION_HPP_ */
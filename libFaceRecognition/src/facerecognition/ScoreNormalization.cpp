@@ -0,0 +1,229 @@
+/*
+ * ScoreNormalization.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "facerecognition/ScoreNormalization.hpp"
+
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+using cv::Mat;
+using std::vector;
+using std::string;
+using std::pair;
+using std::make_pair;
+using std::invalid_argument;
+
+namespace facerecognition {
+
+ScoreNormalization::ScoreNormalization(unsigned int threadCount/*=0*/, float minDeviation/*=1e-6f*/) : threadCount(threadCount), minDeviation(minDeviation)
+{
+}
+
+unsigned int ScoreNormalization::getNumThreads(int rows) const
+{
+	unsigned int numThreads = threadCount > 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+	return std::max(std::min(numThreads, static_cast<unsigned int>(rows)), 1u);
+}
+
+template<class Function>
+void ScoreNormalization::forEachRowRange(int rows, Function function) const
+{
+	// Every thread processes its own rows, so they don't need to be synchronised
+	unsigned int numThreads = getNumThreads(rows);
+	vector<std::thread> threads;
+	for (unsigned int i = 1; i < numThreads; ++i) {
+		int rowBegin = static_cast<int>(static_cast<long>(rows) * i / numThreads);
+		int rowEnd = static_cast<int>(static_cast<long>(rows) * (i + 1) / numThreads);
+		threads.emplace_back([=, &function]() {
+			function(i, rowBegin, rowEnd);
+		});
+	}
+	function(0, 0, rows / static_cast<int>(numThreads));
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+Mat ScoreNormalization::zNorm(Mat scores, Mat galleryCohortScores) const
+{
+	if (scores.type() != CV_32FC1 || galleryCohortScores.type() != CV_32FC1) {
+		throw invalid_argument("ScoreNormalization: The scores have to be of type CV_32FC1.");
+	}
+	if (galleryCohortScores.rows == 0 || galleryCohortScores.cols != scores.cols) {
+		throw invalid_argument("ScoreNormalization: The gallery cohort scores need a column for each gallery template.");
+	}
+	Mat means, deviations;
+	std::tie(means, deviations) = computeColumnStatistics(galleryCohortScores);
+	return apply(scores, means, deviations, true);
+}
+
+Mat ScoreNormalization::tNorm(Mat scores, Mat probeCohortScores) const
+{
+	if (scores.type() != CV_32FC1 || probeCohortScores.type() != CV_32FC1) {
+		throw invalid_argument("ScoreNormalization: The scores have to be of type CV_32FC1.");
+	}
+	if (probeCohortScores.cols == 0 || probeCohortScores.rows != scores.rows) {
+		throw invalid_argument("ScoreNormalization: The probe cohort scores need a row for each probe.");
+	}
+	Mat means, deviations;
+	std::tie(means, deviations) = computeRowStatistics(probeCohortScores);
+	return apply(scores, means, deviations, false);
+}
+
+Mat ScoreNormalization::ztNorm(Mat scores, Mat galleryCohortScores, Mat probeCohortScores, Mat cohortCohortScores) const
+{
+	if (cohortCohortScores.rows != galleryCohortScores.rows || cohortCohortScores.cols != probeCohortScores.cols) {
+		throw invalid_argument("ScoreNormalization: The cohort-cohort scores need a row for each Z-cohort probe and a column for each T-cohort template.");
+	}
+	// The probe cohort scores are Z-normalized like the scores, so the T-norm statistics are on the same scale
+	Mat zNormalizedScores = zNorm(scores, galleryCohortScores);
+	Mat zNormalizedProbeCohortScores = zNorm(probeCohortScores, cohortCohortScores);
+	return tNorm(zNormalizedScores, zNormalizedProbeCohortScores);
+}
+
+Mat ScoreNormalization::normalize(Method method, Mat scores, Mat galleryCohortScores, Mat probeCohortScores, Mat cohortCohortScores) const
+{
+	switch (method) {
+	case Method::NONE:
+		return scores.clone();
+	case Method::Z_NORM:
+		return zNorm(scores, galleryCohortScores);
+	case Method::T_NORM:
+		return tNorm(scores, probeCohortScores);
+	case Method::ZT_NORM:
+		return ztNorm(scores, galleryCohortScores, probeCohortScores, cohortCohortScores);
+	default:
+		throw invalid_argument("ScoreNormalization: Unknown normalization method.");
+	}
+}
+
+pair<Mat, Mat> ScoreNormalization::computeRowStatistics(Mat scores) const
+{
+	Mat means(scores.rows, 1, CV_32FC1);
+	Mat deviations(scores.rows, 1, CV_32FC1);
+	forEachRowRange(scores.rows, [&](unsigned int thread, int rowBegin, int rowEnd) {
+		for (int row = rowBegin; row < rowEnd; ++row) {
+			cv::Scalar mean, deviation;
+			cv::meanStdDev(scores.row(row), mean, deviation);
+			means.at<float>(row) = static_cast<float>(mean[0]);
+			deviations.at<float>(row) = static_cast<float>(deviation[0]);
+		}
+	});
+	return make_pair(means, deviations);
+}
+
+pair<Mat, Mat> ScoreNormalization::computeColumnStatistics(Mat scores) const
+{
+	// Every thread sums up its own rows, the partial sums are added afterwards. The variance is
+	// computed in a second pass around the mean, which is numerically more stable than the sum of squares.
+	vector<Mat> partialSums(getNumThreads(scores.rows));
+	forEachRowRange(scores.rows, [&](unsigned int thread, int rowBegin, int rowEnd) {
+		Mat sum = Mat::zeros(1, scores.cols, CV_64FC1);
+		Mat row;
+		for (int r = rowBegin; r < rowEnd; ++r) {
+			scores.row(r).convertTo(row, CV_64F);
+			sum += row;
+		}
+		partialSums[thread] = sum;
+	});
+	Mat mean = Mat::zeros(1, scores.cols, CV_64FC1);
+	for (const auto& sum : partialSums) {
+		if (!sum.empty()) {
+			mean += sum;
+		}
+	}
+	mean /= scores.rows;
+
+	forEachRowRange(scores.rows, [&](unsigned int thread, int rowBegin, int rowEnd) {
+		Mat sum = Mat::zeros(1, scores.cols, CV_64FC1);
+		Mat row;
+		for (int r = rowBegin; r < rowEnd; ++r) {
+			scores.row(r).convertTo(row, CV_64F);
+			cv::subtract(row, mean, row);
+			cv::multiply(row, row, row);
+			sum += row;
+		}
+		partialSums[thread] = sum;
+	});
+	Mat variance = Mat::zeros(1, scores.cols, CV_64FC1);
+	for (const auto& sum : partialSums) {
+		if (!sum.empty()) {
+			variance += sum;
+		}
+	}
+	variance /= scores.rows;
+
+	Mat means, deviations;
+	mean.convertTo(means, CV_32F);
+	cv::sqrt(variance, variance);
+	variance.convertTo(deviations, CV_32F);
+	return make_pair(means, deviations);
+}
+
+ScoreNormalization::Method ScoreNormalization::parseMethod(const string& name)
+{
+	if (name == "none") {
+		return Method::NONE;
+	}
+	else if (name == "z") {
+		return Method::Z_NORM;
+	}
+	else if (name == "t") {
+		return Method::T_NORM;
+	}
+	else if (name == "zt") {
+		return Method::ZT_NORM;
+	}
+	throw invalid_argument("ScoreNormalization: Unknown normalization method '" + name + "', expected none, z, t or zt.");
+}
+
+Mat ScoreNormalization::apply(Mat scores, Mat means, Mat deviations, bool perColumn) const
+{
+	Mat inverseDeviations = cv::max(deviations, minDeviation);
+	cv::divide(1.0, inverseDeviations, inverseDeviations);
+	Mat normalizedScores(scores.size(), CV_32FC1);
+	forEachRowRange(scores.rows, [&](unsigned int thread, int rowBegin, int rowEnd) {
+		for (int row = rowBegin; row < rowEnd; ++row) {
+			Mat normalizedRow = normalizedScores.row(row);
+			if (perColumn) {
+				cv::subtract(scores.row(row), means, normalizedRow);
+				cv::multiply(normalizedRow, inverseDeviations, normalizedRow);
+			}
+			else {
+				float scale = inverseDeviations.at<float>(row);
+				scores.row(row).convertTo(normalizedRow, CV_32F, scale, -means.at<float>(row) * scale);
+			}
+		}
+	});
+	return normalizedScores;
+}
+
+pair<vector<float>, vector<float>> splitGenuineImpostorScores(Mat scores, const vector<FaceRecord>& probes, const vector<FaceRecord>& gallery)
+{
+	if (scores.type() != CV_32FC1 || scores.rows != static_cast<int>(probes.size()) || scores.cols != static_cast<int>(gallery.size())) {
+		throw invalid_argument("splitGenuineImpostorScores: The score matrix needs a row for each probe and a column for each gallery record.");
+	}
+	vector<float> genuineScores;
+	vector<float> impostorScores;
+	impostorScores.reserve(scores.total());
+	for (int row = 0; row < scores.rows; ++row) {
+		const float* rowScores = scores.ptr<float>(row);
+		for (int col = 0; col < scores.cols; ++col) {
+			if (probes[row].subjectId == gallery[col].subjectId) {
+				genuineScores.push_back(rowScores[col]);
+			}
+			else {
+				impostorScores.push_back(rowScores[col]);
+			}
+		}
+	}
+	return make_pair(genuineScores, impostorScores);
+}
+
+} /* namespace facerecognition */
@@ -0,0 +1,125 @@
+/*
+ * MultiFrameShapeFitting.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef MULTIFRAMESHAPEFITTING_HPP_
+#define MULTIFRAMESHAPEFITTING_HPP_
+
+#include "morphablemodel/MorphableModel.hpp"
+
+#include "imageio/ModelLandmark.hpp"
+
+#include "opencv2/core/core.hpp"
+
+#include <vector>
+#include <deque>
+
+namespace fitting {
+
+/**
+ * Fits one set of shape coefficients (the identity) of a Morphable Model
+ * jointly to the landmarks of several frames of a video, each with its own
+ * affine camera. It is the multi-frame version of fitShapeToLandmarksLinear(...):
+ * Every frame contributes its normal equations to one shared linear system,
+ * which is regularised once towards the mean.
+ *
+ * Optionally, every frame gets its own residual coefficients on top of the
+ * shared ones (e.g. for the expression), with their own, usually much
+ * stronger, regularisation. The residuals are eliminated from the system
+ * per frame (Schur complement), so the shared system keeps the size of the
+ * number of principal components.
+ *
+ * The frames are kept in a sliding window. Adding (and removing) a frame
+ * only adds (subtracts) its contribution to the system, which costs
+ * O(numLandmarks * numComponents^2) (plus O(numLandmarks^3) with residuals)
+ * instead of refitting all frames.
+ *
+ * The fitting is done in clip-coords, the given cam matrices should transform there.
+ */
+class MultiFrameShapeFitting
+{
+public:
+	/**
+	 * Constructs a new multi-frame fitting without any frames.
+	 *
+	 * @param[in] morphableModel The Morphable Model whose shape (coefficients) are fitted.
+	 * @param[in] lambda The regularisation parameter of the shared coefficients (weight of the prior towards the mean). Unlike in fitShapeToLandmarksLinear(...), it is applied once for all frames.
+	 * @param[in] windowSize The maximum number of frames. When adding a frame to a full window, the oldest one is removed. 0 means no limit.
+	 * @param[in] residualLambda The regularisation parameter of the per-frame residual coefficients. 0 disables the residuals.
+	 * @param[in] detectorStandardDeviation The 2D standard deviation of the landmark detector, in clip-coords. See fitShapeToLandmarksLinear(...).
+	 */
+	MultiFrameShapeFitting(morphablemodel::MorphableModel morphableModel, float lambda = 20.0f, std::size_t windowSize = 0, float residualLambda = 0.0f, float detectorStandardDeviation = 0.003f);
+
+	/**
+	 * Adds the landmarks of one frame to the fitting. Removes the oldest
+	 * frame if the window is full. Landmarks that don't exist in the model
+	 * are ignored.
+	 *
+	 * @param[in] affineCameraMatrix A 3x4 affine camera matrix from world to clip-space of this frame.
+	 * @param[in] landmarks 2D landmarks of this frame, given in clip-coordinates.
+	 */
+	void addFrame(cv::Mat affineCameraMatrix, std::vector<imageio::ModelLandmark> landmarks);
+
+	/**
+	 * Removes the oldest frame from the fitting. Does nothing if there are no frames.
+	 */
+	void removeOldestFrame();
+
+	/**
+	 * Removes all frames.
+	 */
+	void reset();
+
+	/**
+	 * @return The number of frames currently in the window.
+	 */
+	std::size_t getNumFrames() const;
+
+	/**
+	 * Solves the shared system. Costs O(numComponents^3), independent of the
+	 * number of frames. Returns the mean (all zeros) if there are no frames.
+	 *
+	 * @return The fitted shared shape-coefficients (alphas), the identity.
+	 */
+	std::vector<float> getShapeCoefficients() const;
+
+	/**
+	 * Computes the coefficients of one frame, i.e. the shared ones plus the
+	 * residuals of the frame. Equal to the shared coefficients if the
+	 * residuals are disabled.
+	 *
+	 * @param[in] frame The index of the frame in the window, 0 is the oldest, getNumFrames() - 1 the newest.
+	 * @return The shape-coefficients of the frame.
+	 */
+	std::vector<float> getFrameShapeCoefficients(std::size_t frame) const;
+
+private:
+	/**
+	 * The contribution of one frame to the shared system, and what is
+	 * needed to compute its residuals.
+	 */
+	struct Frame
+	{
+		cv::Mat A; ///< 2N x m, the camera times the basis at the landmarks
+		cv::Mat b; ///< 2N x 1, the camera times the mean at the landmarks, minus the landmarks
+		cv::Mat AtW; ///< m x 2N, A^t times the (effective) weight matrix of the frame
+		cv::Mat AtWA; ///< m x m, the contribution to the left-hand side of the shared system
+		cv::Mat AtWb; ///< m x 1, the contribution to the right-hand side of the shared system
+	};
+
+	morphablemodel::PcaModel shapeModel; ///< The shape model of the Morphable Model (copied once, getShapeModel() returns a copy).
+	float lambda; ///< The regularisation parameter of the shared coefficients.
+	std::size_t windowSize; ///< The maximum number of frames, 0 for no limit.
+	float residualLambda; ///< The regularisation parameter of the per-frame residuals, 0 if disabled.
+	float detectorStandardDeviation; ///< The 2D standard deviation of the landmark detector, in clip-coords.
+	std::deque<Frame> frames; ///< The frames in the window, the oldest first.
+	cv::Mat AtWA; ///< m x m, the sum of the contributions of all frames (accumulated in double precision, as it is updated incrementally)
+	cv::Mat AtWb; ///< m x 1, the sum of the contributions of all frames
+};
+
+} /* namespace fitting */
+#endif /* MULTIFRAMESHAPEFITTING_HPP_ */
@@ -0,0 +1,139 @@
+/*
+ * MultiFrameShapeFitting.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "fitting/MultiFrameShapeFitting.hpp"
+
+#include <stdexcept>
+
+using morphablemodel::MorphableModel;
+using cv::Mat;
+using std::vector;
+
+namespace fitting {
+
+MultiFrameShapeFitting::MultiFrameShapeFitting(MorphableModel morphableModel, float lambda/*=20.0f*/, std::size_t windowSize/*=0*/, float residualLambda/*=0.0f*/, float detectorStandardDeviation/*=0.003f*/) : shapeModel(morphableModel.getShapeModel()), lambda(lambda), windowSize(windowSize), residualLambda(residualLambda), detectorStandardDeviation(detectorStandardDeviation)
+{
+	if (residualLambda < 0.0f) {
+		throw std::invalid_argument("MultiFrameShapeFitting: The regularisation of the residuals must not be negative.");
+	}
+	reset();
+}
+
+void MultiFrameShapeFitting::addFrame(Mat affineCameraMatrix, vector<imageio::ModelLandmark> landmarks)
+{
+	int numShapePc = shapeModel.getNumberOfPrincipalComponents();
+	vector<imageio::ModelLandmark> modelLandmarks;
+	for (const auto& lm : landmarks) {
+		if (shapeModel.landmarkExists(lm.getName())) {
+			modelLandmarks.push_back(lm);
+		}
+	}
+	Mat camera;
+	affineCameraMatrix.convertTo(camera, CV_64FC1);
+	Mat cameraLinear = camera(cv::Range(0, 2), cv::Range(0, 3)); // The homogeneous (3rd) row of the affine camera is (0, 0, 0, 1) and doesn't contribute, so we only need the x- and y-rows
+	Mat cameraTranslation = camera(cv::Range(0, 2), cv::Range(3, 4));
+
+	// Same as in fitShapeToLandmarksLinear(...), but built per landmark instead of with the block diagonal camera matrix and without the rows of the homogeneous coordinate (they are all zero)
+	Frame frame;
+	frame.A = Mat(2 * modelLandmarks.size(), numShapePc, CV_64FC1); // camera times the basis
+	frame.b = Mat(2 * modelLandmarks.size(), 1, CV_64FC1); // camera times the mean, minus the landmarks
+	for (size_t i = 0; i < modelLandmarks.size(); ++i) {
+		Mat basisRows;
+		shapeModel.getNormalizedPcaBasis(modelLandmarks[i].getName()).convertTo(basisRows, CV_64FC1);
+		Mat projectedBasis = cameraLinear * basisRows;
+		projectedBasis.copyTo(frame.A.rowRange(2 * i, 2 * i + 2));
+		cv::Vec3f modelMean = shapeModel.getMeanAtPoint(modelLandmarks[i].getName());
+		Mat modelMeanPoint = (cv::Mat_<double>(3, 1) << modelMean[0], modelMean[1], modelMean[2]);
+		Mat projectedMean = cameraLinear * modelMeanPoint + cameraTranslation;
+		frame.b.at<double>(2 * i, 0) = projectedMean.at<double>(0, 0) - modelLandmarks[i].getX();
+		frame.b.at<double>(2 * i + 1, 0) = projectedMean.at<double>(1, 0) - modelLandmarks[i].getY();
+	}
+
+	// The weight matrix: Without residuals, it's Omega, i.e. the identity divided by the detector variance (see fitShapeToLandmarksLinear(...)).
+	// With residuals, eliminating them (Schur complement) results in the effective weight matrix W = (A * A^t / residualLambda + Omega^-1)^-1 of the frame.
+	// It's 2N x 2N, so inverting it is cheap, and the shared system keeps its size.
+	double detectorVariance = static_cast<double>(detectorStandardDeviation) * detectorStandardDeviation;
+	if (residualLambda > 0.0f) {
+		Mat WInv = frame.A * frame.A.t() / residualLambda + detectorVariance * Mat::eye(frame.A.rows, frame.A.rows, CV_64FC1);
+		Mat W;
+		cv::invert(WInv, W, cv::DECOMP_CHOLESKY); // WInv is symmetric positive definite
+		frame.AtW = frame.A.t() * W;
+	}
+	else {
+		frame.AtW = frame.A.t() / detectorVariance;
+	}
+	frame.AtWA = frame.AtW * frame.A;
+	frame.AtWb = frame.AtW * frame.b;
+
+	AtWA += frame.AtWA;
+	AtWb += frame.AtWb;
+	frames.push_back(frame);
+	if (windowSize > 0 && frames.size() > windowSize) {
+		removeOldestFrame();
+	}
+}
+
+void MultiFrameShapeFitting::removeOldestFrame()
+{
+	if (frames.empty()) {
+		return;
+	}
+	AtWA -= frames.front().AtWA;
+	AtWb -= frames.front().AtWb;
+	frames.pop_front();
+	if (frames.empty()) {
+		reset(); // start from exact zeros again, so rounding errors of the incremental updates don't accumulate forever
+	}
+}
+
+void MultiFrameShapeFitting::reset()
+{
+	int numShapePc = shapeModel.getNumberOfPrincipalComponents();
+	frames.clear();
+	AtWA = Mat::zeros(numShapePc, numShapePc, CV_64FC1);
+	AtWb = Mat::zeros(numShapePc, 1, CV_64FC1);
+}
+
+std::size_t MultiFrameShapeFitting::getNumFrames() const
+{
+	return frames.size();
+}
+
+vector<float> MultiFrameShapeFitting::getShapeCoefficients() const
+{
+	int numShapePc = shapeModel.getNumberOfPrincipalComponents();
+	Mat AtWAReg = AtWA + lambda * Mat::eye(numShapePc, numShapePc, CV_64FC1);
+	Mat minusAtWb = -AtWb;
+	Mat c_s;
+	if (!cv::solve(AtWAReg, minusAtWb, c_s, cv::DECOMP_CHOLESKY)) {
+		cv::solve(AtWAReg, minusAtWb, c_s, cv::DECOMP_SVD); // e.g. lambda = 0 and not enough landmarks, calculates the least-squares solution
+	}
+	Mat coefficients;
+	c_s.convertTo(coefficients, CV_32FC1);
+	return vector<float>(coefficients);
+}
+
+vector<float> MultiFrameShapeFitting::getFrameShapeCoefficients(std::size_t frame) const
+{
+	if (frame >= frames.size()) {
+		throw std::out_of_range("MultiFrameShapeFitting: There is no frame with the given index.");
+	}
+	vector<float> coefficients = getShapeCoefficients();
+	if (residualLambda > 0.0f) {
+		// The residuals that were eliminated from the shared system: d = -1/residualLambda * A^t * W * (A * c + b)
+		const Frame& currentFrame = frames[frame];
+		Mat c_s(coefficients, true);
+		c_s.convertTo(c_s, CV_64FC1);
+		Mat residuals = -currentFrame.AtW * (currentFrame.A * c_s + currentFrame.b) / residualLambda;
+		for (size_t i = 0; i < coefficients.size(); ++i) {
+			coefficients[i] += static_cast<float>(residuals.at<double>(i, 0));
+		}
+	}
+	return coefficients;
+}
+
+} /* namespace fitting */
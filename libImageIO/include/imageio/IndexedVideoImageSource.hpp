@@ -0,0 +1,126 @@
+/*
+ * IndexedVideoImageSource.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef INDEXEDVIDEOIMAGESOURCE_HPP_
+#define INDEXEDVIDEOIMAGESOURCE_HPP_
+
+#include "imageio/ImageSource.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <memory>
+#include <limits>
+
+namespace imageio {
+
+class VideoIndex;
+
+/**
+ * Image source that takes images from a video file and supports random access to its frames by using a video index.
+ * To get to a certain frame, the video is positioned at the closest seek point of the index and decoded from there.
+ *
+ * Each instance has its own decoder, so several instances may be created over the same index (and therefore the same
+ * video file) to process different ranges of frames independently, e.g. in parallel.
+ */
+class IndexedVideoImageSource : public ImageSource {
+public:
+
+	/**
+	 * Constructs a new indexed video image source over all frames of a video. Loads the index from the cache file
+	 * next to the video or builds it if necessary.
+	 *
+	 * @param[in] video The name of the video file.
+	 */
+	explicit IndexedVideoImageSource(const std::string& video);
+
+	/**
+	 * Constructs a new indexed video image source over a range of frames of a video.
+	 *
+	 * @param[in] index The index of the video.
+	 * @param[in] firstFrame The index of the first frame of the range (starting at zero).
+	 * @param[in] endFrame The index of the frame after the last frame of the range (will be limited to the frame count).
+	 */
+	explicit IndexedVideoImageSource(std::shared_ptr<const VideoIndex> index,
+			size_t firstFrame = 0, size_t endFrame = std::numeric_limits<size_t>::max());
+
+	virtual ~IndexedVideoImageSource();
+
+	void reset();
+
+	bool next();
+
+	const cv::Mat getImage() const;
+
+	boost::filesystem::path getName() const;
+
+	std::vector<boost::filesystem::path> getNames() const;
+
+	/**
+	 * Changes the position, so the next call of next() will proceed to the given frame. The frame must be inside
+	 * the range of this source.
+	 *
+	 * @param[in] frame The index of the frame (starting at zero).
+	 */
+	void seek(size_t frame);
+
+	/**
+	 * @return The index of the current frame (starting at zero) or the index of the first frame minus one if next() was not called yet.
+	 */
+	long getFrameIndex() const {
+		return static_cast<long>(nextFrame) - 1;
+	}
+
+	/**
+	 * @return The index of the first frame of the range (starting at zero).
+	 */
+	size_t getFirstFrame() const {
+		return firstFrame;
+	}
+
+	/**
+	 * @return The index of the frame after the last frame of the range.
+	 */
+	size_t getEndFrame() const {
+		return endFrame;
+	}
+
+	/**
+	 * @return The index of the video.
+	 */
+	std::shared_ptr<const VideoIndex> getIndex() const {
+		return index;
+	}
+
+private:
+
+	/**
+	 * Positions the decoder, so the current frame or the frame that is decoded next is the given one.
+	 *
+	 * @param[in] frame The index of the frame.
+	 * @return True if the decoder could be positioned, false otherwise.
+	 */
+	bool moveTo(size_t frame);
+
+	/**
+	 * Positions the decoder at a seek point and verifies that the decoded frame is the expected one.
+	 *
+	 * @param[in] seekPointIndex The index of the seek point.
+	 * @return True if the decoder is at the seek point, false otherwise.
+	 */
+	bool moveToSeekPoint(size_t seekPointIndex);
+
+	std::shared_ptr<const VideoIndex> index; ///< The index of the video.
+	size_t firstFrame; ///< The index of the first frame of the range.
+	size_t endFrame; ///< The index of the frame after the last frame of the range.
+	size_t nextFrame; ///< The index of the frame that is retrieved by the next call of next().
+	cv::VideoCapture capture; ///< The video capture.
+	cv::Mat frame; ///< The most recently decoded frame.
+	size_t frameIndex; ///< The index of the most recently decoded frame (maximum value if there is none).
+	size_t position; ///< The index of the frame that is decoded next by the video capture.
+	std::vector<bool> unreliableSeekPoints; ///< Flags that indicate seek points where the video capture did not arrive at the expected frame.
+};
+
+} /* namespace imageio */
+#endif /* INDEXEDVIDEOIMAGESOURCE_HPP_ */
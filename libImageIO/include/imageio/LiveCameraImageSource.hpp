@@ -0,0 +1,146 @@
+/*
+ * LiveCameraImageSource.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef LIVECAMERAIMAGESOURCE_HPP_
+#define LIVECAMERAIMAGESOURCE_HPP_
+
+#include "imageio/ImageSource.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+
+namespace imageio {
+
+/**
+ * Image source that takes images from a camera device, grabbing and decoding them in a background thread. Unlike
+ * CameraImageSource, the consumer does not wait for the exposure and decoding, and frames do not pile up in the
+ * driver while the consumer is busy. Only the newest frames (up to the queue size) are kept, older ones are dropped,
+ * so next() always proceeds to a recent image.
+ *
+ * The frames are decoded into a fixed pool of buffers that are re-used, so there are no copies and (after the
+ * first frames) no allocations. The image of getImage() stays valid until the next call of next() or reset(), when
+ * its buffer is handed back to the grabbing thread. If the consumer still holds a reference to the image by then,
+ * the buffer is not overwritten, but replaced by a new one.
+ */
+class LiveCameraImageSource : public ImageSource {
+public:
+
+	/**
+	 * Constructs a new live camera image source and starts grabbing.
+	 *
+	 * @param[in] device ID of the video capturing device.
+	 * @param[in] queueSize The maximum number of frames waiting for the consumer. With 1, only the newest frame is kept.
+	 */
+	explicit LiveCameraImageSource(int device, size_t queueSize = 1);
+
+	virtual ~LiveCameraImageSource();
+
+	void reset();
+
+	/**
+	 * Proceeds to the oldest frame that is waiting, blocks until there is one.
+	 *
+	 * @return True if successful, false if the camera could not deliver any more frames.
+	 */
+	bool next();
+
+	const cv::Mat getImage() const;
+
+	boost::filesystem::path getName() const;
+
+	std::vector<boost::filesystem::path> getNames() const;
+
+	/**
+	 * @return The time at which the current frame was grabbed.
+	 */
+	std::chrono::steady_clock::time_point getTimestamp() const;
+
+	/**
+	 * @return The time in seconds between the grabbing of the previous and the current frame, zero for the first frame.
+	 */
+	double getFrameInterval() const;
+
+	/**
+	 * @return The number of the current frame, counting all grabbed frames (including the dropped ones) since the start.
+	 */
+	unsigned long getFrameNumber() const;
+
+	/**
+	 * @return The number of grabbed frames that were dropped since the start, because newer ones replaced them.
+	 */
+	unsigned long getDroppedFrameCount() const;
+
+	/**
+	 * @return The frame rate reported by the camera driver, zero if it is unknown.
+	 */
+	double getFrameRate() const;
+
+private:
+
+	/**
+	 * Captured frame.
+	 */
+	struct Frame {
+		cv::Mat image; ///< The image (buffer that is re-used).
+		std::chrono::steady_clock::time_point timestamp; ///< The time at which the frame was grabbed.
+		unsigned long number; ///< The number of the frame since the start.
+	};
+
+	/**
+	 * Opens the device and starts the grabbing thread.
+	 */
+	void start();
+
+	/**
+	 * Stops the grabbing thread and releases the device.
+	 */
+	void stop();
+
+	/**
+	 * Grabs and decodes frames until stopped or the camera fails. Runs in the grabbing thread.
+	 */
+	void grab();
+
+	/**
+	 * Grabs the next frame of the camera.
+	 *
+	 * @return True if a frame was grabbed, false if the camera failed (also if OpenCV threw an exception).
+	 */
+	bool grabFrame();
+
+	/**
+	 * Decodes the grabbed frame.
+	 *
+	 * @param[out] image The image, re-uses its memory if possible.
+	 * @return True if the frame was decoded, false if the camera failed (also if OpenCV threw an exception).
+	 */
+	bool retrieveFrame(cv::Mat& image);
+
+	int device;       ///< ID of the video capturing device.
+	size_t queueSize; ///< The maximum number of frames waiting for the consumer.
+	cv::VideoCapture capture; ///< The video capture, only used by the grabbing thread while it is running.
+	double frameRate; ///< The frame rate reported by the camera driver, zero if it is unknown.
+	std::vector<Frame> frames;    ///< The buffers: one is filled by the grabbing thread, one is held by the consumer, one was handed back last, the others wait.
+	std::deque<size_t> freeFrames;    ///< Indices of the buffers that can be filled, the one that was handed back last is at the end.
+	std::deque<size_t> waitingFrames; ///< Indices of the buffers that wait for the consumer, oldest first.
+	size_t currentFrame; ///< Index of the buffer held by the consumer (frames.size() if there is none).
+	std::chrono::steady_clock::time_point previousTimestamp; ///< The time at which the previous frame of the consumer was grabbed.
+	unsigned long droppedFrameCount; ///< The number of dropped frames.
+	bool failed;  ///< Flag that indicates whether the camera could not deliver a frame.
+	std::atomic<bool> running; ///< Flag that indicates whether the grabbing thread should keep running.
+	std::thread grabber;   ///< The grabbing thread.
+	mutable std::mutex mutex;  ///< Guards the buffer indices, the counters and the failure flag.
+	std::condition_variable frameAvailable; ///< Notified when a frame is waiting or the camera failed.
+};
+
+} /* namespace imageio */
+#endif /* LIVECAMERAIMAGESOURCE_HPP_ */
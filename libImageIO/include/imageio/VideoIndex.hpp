@@ -0,0 +1,143 @@
+/*
+ * VideoIndex.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef VIDEOINDEX_HPP_
+#define VIDEOINDEX_HPP_
+
+#include "opencv2/core/core.hpp"
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/filesystem/path.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ctime>
+
+namespace imageio {
+
+/**
+ * Index of seek points of a video file. The index is built by decoding the whole video once, remembering frames
+ * as seek points together with a signature of their content. The signature is used to verify that seeking actually
+ * arrived at the expected frame, because the seeking of some video backends is not frame-accurate.
+ *
+ * OpenCV does not tell which frames are keyframes, so while building the index, each candidate frame is probed by
+ * seeking to it with a second decoder. Only frames that seeking arrives at exactly (usually the keyframes) become
+ * seek points. After a seek point, the next candidate is the frame that is one interval later, and if there is no
+ * reachable frame within an interval after that, the search continues at the next interval.
+ *
+ * The index is cached in a file next to the video (the video file name with an additional extension ".index")
+ * and re-used as long as the size and modification time of the video do not change. The index is immutable after
+ * construction, so it can be shared between several IndexedVideoImageSource instances (even across threads).
+ */
+class VideoIndex {
+public:
+
+	/**
+	 * Seek point of the video.
+	 */
+	struct SeekPoint {
+		size_t frame; ///< The index of the frame (starting at zero).
+		uint64_t signature; ///< The signature of the frame content.
+	};
+
+	/**
+	 * Constructs a new video index by loading it from the cache file or building it if there is no (valid) cache file.
+	 *
+	 * @param[in] video The name of the video file.
+	 * @param[in] interval The minimum number of frames between two seek points (only used when building the index).
+	 */
+	explicit VideoIndex(const std::string& video, size_t interval = 100);
+
+	/**
+	 * Determines the seek point that is closest to the given frame without being after it.
+	 *
+	 * @param[in] frame The index of the frame (starting at zero).
+	 * @return The index of the seek point.
+	 */
+	size_t getSeekPointIndex(size_t frame) const;
+
+	/**
+	 * @return The number of seek points.
+	 */
+	size_t getSeekPointCount() const {
+		return seekPoints.size();
+	}
+
+	/**
+	 * @param[in] index The index of the seek point.
+	 * @return The seek point.
+	 */
+	const SeekPoint& getSeekPoint(size_t index) const {
+		return seekPoints[index];
+	}
+
+	/**
+	 * @return The name of the video file.
+	 */
+	const std::string& getVideo() const {
+		return video;
+	}
+
+	/**
+	 * @return The number of frames of the video.
+	 */
+	size_t getFrameCount() const {
+		return frameCount;
+	}
+
+	/**
+	 * @return The minimum number of frames between two seek points.
+	 */
+	size_t getInterval() const {
+		return interval;
+	}
+
+	/**
+	 * Computes the signature of a decoded frame.
+	 *
+	 * @param[in] frame The frame.
+	 * @return The signature of the frame content.
+	 */
+	static uint64_t computeSignature(const cv::Mat& frame);
+
+private:
+
+	/**
+	 * Loads the index from the cache file.
+	 *
+	 * @param[in] indexFile The cache file.
+	 * @return True if the cache file existed and belonged to the current video file, false otherwise.
+	 */
+	bool load(const boost::filesystem::path& indexFile);
+
+	/**
+	 * Builds the index by decoding the whole video.
+	 */
+	void build();
+
+	/**
+	 * Saves the index to the cache file.
+	 *
+	 * @param[in] indexFile The cache file.
+	 * @return True if the index could be written, false otherwise.
+	 */
+	bool save(const boost::filesystem::path& indexFile) const;
+
+	static const int formatVersion = 2; ///< The version of the cache file format.
+
+	std::string video; ///< The name of the video file.
+	uintmax_t videoSize; ///< The size of the video file in bytes.
+	std::time_t videoTime; ///< The modification time of the video file.
+	size_t interval; ///< The minimum number of frames between two seek points.
+	size_t frameCount; ///< The number of frames of the video.
+	std::vector<SeekPoint> seekPoints; ///< The seek points, ordered by frame.
+};
+
+} /* namespace imageio */
+#endif /* VIDEOINDEX_HPP_ */
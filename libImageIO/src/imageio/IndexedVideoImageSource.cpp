@@ -0,0 +1,131 @@
+/*
+ * IndexedVideoImageSource.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageio/IndexedVideoImageSource.hpp"
+#include "imageio/VideoIndex.hpp"
+#include <stdexcept>
+
+using cv::Mat;
+using boost::filesystem::path;
+using std::vector;
+using std::string;
+using std::shared_ptr;
+using std::make_shared;
+using std::invalid_argument;
+using std::out_of_range;
+using std::runtime_error;
+
+namespace imageio {
+
+static const size_t noFrame = std::numeric_limits<size_t>::max();
+
+IndexedVideoImageSource::IndexedVideoImageSource(const string& video) :
+		IndexedVideoImageSource(make_shared<VideoIndex>(video)) {}
+
+IndexedVideoImageSource::IndexedVideoImageSource(shared_ptr<const VideoIndex> index, size_t firstFrame, size_t endFrame) :
+		ImageSource(index->getVideo()), index(index),
+		firstFrame(firstFrame), endFrame(std::min(endFrame, index->getFrameCount())), nextFrame(firstFrame),
+		capture(index->getVideo()), frame(), frameIndex(noFrame), position(0),
+		unreliableSeekPoints(index->getSeekPointCount(), false) {
+	if (!capture.isOpened())
+		throw invalid_argument("IndexedVideoImageSource: could not open video file '" + index->getVideo() + "'");
+	if (this->firstFrame > this->endFrame)
+		throw invalid_argument("IndexedVideoImageSource: the first frame must not be after the end of the range");
+}
+
+IndexedVideoImageSource::~IndexedVideoImageSource() {
+	capture.release();
+}
+
+void IndexedVideoImageSource::reset() {
+	nextFrame = firstFrame;
+}
+
+void IndexedVideoImageSource::seek(size_t frame) {
+	if (frame < firstFrame || frame >= endFrame)
+		throw out_of_range("IndexedVideoImageSource: frame " + std::to_string(frame) + " is outside of the range ["
+				+ std::to_string(firstFrame) + ", " + std::to_string(endFrame) + ")");
+	nextFrame = frame;
+}
+
+bool IndexedVideoImageSource::next() {
+	if (nextFrame >= endFrame)
+		return false;
+	if (!moveTo(nextFrame))
+		return false;
+	if (frameIndex != nextFrame) {
+		if (!capture.read(frame))
+			return false;
+		frameIndex = position;
+		++position;
+	}
+	++nextFrame;
+	return true;
+}
+
+bool IndexedVideoImageSource::moveTo(size_t target) {
+	if (frameIndex == target || position == target)
+		return true;
+	size_t seekPointIndex = index->getSeekPointIndex(target);
+	// seek if decoding forward is impossible or there is a seek point between the current position and the target
+	if (position == noFrame || target < position || index->getSeekPoint(seekPointIndex).frame > position) {
+		while (!moveToSeekPoint(seekPointIndex)) {
+			if (seekPointIndex == 0)
+				throw runtime_error("IndexedVideoImageSource: could not re-open video file '" + index->getVideo() + "'");
+			--seekPointIndex;
+		}
+		if (frameIndex == target)
+			return true;
+	}
+	while (position < target) {
+		if (!capture.grab())
+			return false;
+		++position;
+	}
+	return true;
+}
+
+bool IndexedVideoImageSource::moveToSeekPoint(size_t seekPointIndex) {
+	const VideoIndex::SeekPoint& seekPoint = index->getSeekPoint(seekPointIndex);
+	if (seekPoint.frame == 0) { // re-opening the video is always exact
+		capture.release();
+		frameIndex = noFrame;
+		position = 0;
+		return capture.open(index->getVideo());
+	}
+	if (unreliableSeekPoints[seekPointIndex])
+		return false;
+	capture.set(CV_CAP_PROP_POS_FRAMES, static_cast<double>(seekPoint.frame));
+	if (!capture.read(frame) || VideoIndex::computeSignature(frame) != seekPoint.signature) {
+		// the backend did not arrive at the expected frame, so the decoder position is unknown and this seek point is not used anymore
+		unreliableSeekPoints[seekPointIndex] = true;
+		frameIndex = noFrame;
+		position = noFrame;
+		return false;
+	}
+	frameIndex = seekPoint.frame;
+	position = seekPoint.frame + 1;
+	return true;
+}
+
+const Mat IndexedVideoImageSource::getImage() const {
+	if (nextFrame == firstFrame || frameIndex != nextFrame - 1)
+		return Mat();
+	return frame;
+}
+
+path IndexedVideoImageSource::getName() const {
+	return path(std::to_string(nextFrame));
+}
+
+vector<path> IndexedVideoImageSource::getNames() const {
+	vector<path> tmp;
+	tmp.push_back(path(std::to_string(nextFrame)));
+	return tmp;
+}
+
+} /* namespace imageio */
@@ -0,0 +1,180 @@
+/*
+ * LiveCameraImageSource.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageio/LiveCameraImageSource.hpp"
+#include <string>
+#include <stdexcept>
+
+using boost::filesystem::path;
+using cv::Mat;
+using std::string;
+using std::vector;
+using std::invalid_argument;
+using std::runtime_error;
+using std::chrono::steady_clock;
+
+namespace imageio {
+
+LiveCameraImageSource::LiveCameraImageSource(int device, size_t queueSize) :
+		ImageSource(std::to_string(device)), device(device), queueSize(queueSize), capture(), frameRate(0),
+		frames(queueSize + 3), freeFrames(), waitingFrames(), currentFrame(queueSize + 3), previousTimestamp(),
+		droppedFrameCount(0), failed(false), running(false), grabber(), mutex(), frameAvailable() {
+	if (queueSize == 0)
+		throw invalid_argument("LiveCameraImageSource: the queue size must be at least one");
+	if (!capture.open(device))
+		throw invalid_argument("Could not open stream from device " + std::to_string(device));
+	start();
+}
+
+LiveCameraImageSource::~LiveCameraImageSource() {
+	stop();
+}
+
+void LiveCameraImageSource::reset() {
+	stop();
+	if (!capture.open(device))
+		throw runtime_error("Could not open stream from device " + std::to_string(device));
+	start();
+}
+
+void LiveCameraImageSource::start() {
+	frameRate = capture.get(CV_CAP_PROP_FPS);
+	freeFrames.clear();
+	for (size_t i = 0; i < frames.size(); ++i)
+		freeFrames.push_back(i);
+	waitingFrames.clear();
+	currentFrame = frames.size();
+	previousTimestamp = steady_clock::time_point();
+	droppedFrameCount = 0;
+	failed = false;
+	running = true;
+	grabber = std::thread(&LiveCameraImageSource::grab, this);
+}
+
+void LiveCameraImageSource::stop() {
+	running = false;
+	if (grabber.joinable())
+		grabber.join(); // the grabbing thread notices the flag after the current frame at the latest
+	capture.release();
+}
+
+void LiveCameraImageSource::grab() {
+	unsigned long frameNumber = 0;
+	while (running) {
+		// waiting for the exposure and decoding happens outside of the lock, so the consumer is never blocked by it
+		if (!grabFrame())
+			break;
+		steady_clock::time_point timestamp = steady_clock::now();
+		++frameNumber;
+		size_t index;
+		{
+			// there are queueSize + 3 buffers, but at most queueSize are waiting and one is held by the consumer, so
+			// the buffer that was handed back last (and might still be referenced by the consumer) is not taken yet
+			std::lock_guard<std::mutex> lock(mutex);
+			index = freeFrames.front();
+			freeFrames.pop_front();
+		}
+		Frame& frame = frames[index];
+		// do not overwrite an image that the consumer still references (OpenCV 2.4 reference counter)
+		if (frame.image.refcount && *frame.image.refcount > 1)
+			frame.image = Mat();
+		if (!retrieveFrame(frame.image)) {
+			std::lock_guard<std::mutex> lock(mutex);
+			freeFrames.push_front(index);
+			break;
+		}
+		frame.timestamp = timestamp;
+		frame.number = frameNumber;
+		std::lock_guard<std::mutex> lock(mutex);
+		waitingFrames.push_back(index);
+		if (waitingFrames.size() > queueSize) { // drop the oldest frame
+			freeFrames.push_front(waitingFrames.front());
+			waitingFrames.pop_front();
+			++droppedFrameCount;
+		}
+		frameAvailable.notify_one();
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	failed = true;
+	frameAvailable.notify_all();
+}
+
+bool LiveCameraImageSource::grabFrame() {
+	try {
+		return capture.grab();
+	} catch (cv::Exception&) { // an exception must not leave the grabbing thread, the camera is treated as failed instead
+		return false;
+	}
+}
+
+bool LiveCameraImageSource::retrieveFrame(Mat& image) {
+	try {
+		return capture.retrieve(image);
+	} catch (cv::Exception&) {
+		return false;
+	}
+}
+
+bool LiveCameraImageSource::next() {
+	std::unique_lock<std::mutex> lock(mutex);
+	if (currentFrame < frames.size()) { // hand the buffer of the current image back
+		previousTimestamp = frames[currentFrame].timestamp;
+		freeFrames.push_back(currentFrame);
+		currentFrame = frames.size();
+	}
+	frameAvailable.wait(lock, [this] { return !waitingFrames.empty() || failed; });
+	if (waitingFrames.empty())
+		return false;
+	currentFrame = waitingFrames.front();
+	waitingFrames.pop_front();
+	return true;
+}
+
+const Mat LiveCameraImageSource::getImage() const {
+	if (currentFrame < frames.size())
+		return frames[currentFrame].image;
+	return Mat();
+}
+
+path LiveCameraImageSource::getName() const {
+	return path(std::to_string(getFrameNumber()));
+}
+
+vector<path> LiveCameraImageSource::getNames() const {
+	vector<path> tmp;
+	tmp.push_back(getName());
+	return tmp;
+}
+
+steady_clock::time_point LiveCameraImageSource::getTimestamp() const {
+	if (currentFrame < frames.size())
+		return frames[currentFrame].timestamp;
+	return steady_clock::time_point();
+}
+
+double LiveCameraImageSource::getFrameInterval() const {
+	if (currentFrame >= frames.size() || previousTimestamp == steady_clock::time_point())
+		return 0;
+	return std::chrono::duration<double>(frames[currentFrame].timestamp - previousTimestamp).count();
+}
+
+unsigned long LiveCameraImageSource::getFrameNumber() const {
+	if (currentFrame < frames.size())
+		return frames[currentFrame].number;
+	return 0;
+}
+
+unsigned long LiveCameraImageSource::getDroppedFrameCount() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return droppedFrameCount;
+}
+
+double LiveCameraImageSource::getFrameRate() const {
+	return frameRate;
+}
+
+} /* namespace imageio */
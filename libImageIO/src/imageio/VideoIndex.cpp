@@ -0,0 +1,138 @@
+/*
+ * VideoIndex.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageio/VideoIndex.hpp"
+#include "logging/LoggerFactory.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "boost/filesystem.hpp"
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+using logging::LoggerFactory;
+using cv::Mat;
+using boost::filesystem::path;
+using std::string;
+using std::vector;
+using std::ifstream;
+using std::ofstream;
+using std::invalid_argument;
+using std::runtime_error;
+
+namespace imageio {
+
+VideoIndex::VideoIndex(const string& video, size_t interval) :
+		video(video), videoSize(0), videoTime(0), interval(interval), frameCount(0), seekPoints() {
+	if (interval == 0)
+		throw invalid_argument("VideoIndex: the interval must be greater than zero");
+	path videoFile(video);
+	if (!boost::filesystem::exists(videoFile))
+		throw invalid_argument("VideoIndex: video file '" + video + "' does not exist");
+	videoSize = boost::filesystem::file_size(videoFile);
+	videoTime = boost::filesystem::last_write_time(videoFile);
+	path indexFile(video + ".index");
+	if (!load(indexFile)) {
+		build();
+		if (!save(indexFile))
+			Loggers->getLogger("imageio").warn("VideoIndex: could not write index file '" + indexFile.string() + "'");
+	}
+}
+
+size_t VideoIndex::getSeekPointIndex(size_t frame) const {
+	auto it = std::upper_bound(seekPoints.begin(), seekPoints.end(), frame, [](size_t frame, const SeekPoint& seekPoint) {
+		return frame < seekPoint.frame;
+	});
+	if (it == seekPoints.begin())
+		return 0;
+	return static_cast<size_t>(it - seekPoints.begin()) - 1;
+}
+
+uint64_t VideoIndex::computeSignature(const Mat& frame) {
+	// FNV-1a hash over the pixel data of each row (the rows might not be continuous in memory)
+	uint64_t hash = 14695981039346656037ULL;
+	size_t rowSize = frame.cols * frame.elemSize();
+	for (int row = 0; row < frame.rows; ++row) {
+		const uchar* values = frame.ptr<uchar>(row);
+		for (size_t i = 0; i < rowSize; ++i) {
+			hash ^= values[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+bool VideoIndex::load(const path& indexFile) {
+	if (!boost::filesystem::exists(indexFile))
+		return false;
+	ifstream stream(indexFile.string());
+	if (!stream.is_open())
+		return false;
+	int version;
+	uintmax_t size;
+	std::time_t time;
+	size_t loadedInterval, loadedFrameCount, count;
+	stream >> version >> size >> time >> loadedInterval >> loadedFrameCount >> count;
+	if (stream.fail() || version != formatVersion || size != videoSize || time != videoTime || count == 0)
+		return false;
+	vector<SeekPoint> loadedSeekPoints(count);
+	for (SeekPoint& seekPoint : loadedSeekPoints)
+		stream >> seekPoint.frame >> seekPoint.signature;
+	if (stream.fail() || loadedSeekPoints.front().frame != 0)
+		return false;
+	interval = loadedInterval;
+	frameCount = loadedFrameCount;
+	seekPoints.swap(loadedSeekPoints);
+	return true;
+}
+
+void VideoIndex::build() {
+	cv::VideoCapture capture(video);
+	if (!capture.isOpened())
+		throw invalid_argument("VideoIndex: could not open video file '" + video + "'");
+	// second decoder that probes whether seeking arrives at a candidate frame, which is usually only the case for keyframes
+	cv::VideoCapture probe(video);
+	if (!probe.isOpened())
+		throw invalid_argument("VideoIndex: could not open video file '" + video + "'");
+	seekPoints.clear();
+	frameCount = 0;
+	size_t candidate = 0; // the first frame that might become the next seek point
+	Mat frame, probeFrame;
+	while (capture.grab()) {
+		if (frameCount >= candidate) {
+			if (!capture.retrieve(frame))
+				throw runtime_error("VideoIndex: could not decode frame " + std::to_string(frameCount) + " of video file '" + video + "'");
+			uint64_t signature = computeSignature(frame);
+			bool reachable = frameCount == 0; // re-opening the video is always exact
+			if (!reachable) {
+				probe.set(CV_CAP_PROP_POS_FRAMES, static_cast<double>(frameCount));
+				reachable = probe.read(probeFrame) && computeSignature(probeFrame) == signature;
+			}
+			if (reachable) {
+				seekPoints.push_back(SeekPoint{ frameCount, signature });
+				candidate = frameCount + interval;
+			} else if (frameCount - candidate + 1 >= interval) { // no reachable frame within a whole interval, try the next one
+				candidate += interval;
+			}
+		}
+		++frameCount;
+	}
+	if (seekPoints.empty())
+		throw runtime_error("VideoIndex: video file '" + video + "' does not contain any frames");
+}
+
+bool VideoIndex::save(const path& indexFile) const {
+	ofstream stream(indexFile.string());
+	if (!stream.is_open())
+		return false;
+	stream << formatVersion << ' ' << videoSize << ' ' << videoTime << '\n';
+	stream << interval << ' ' << frameCount << ' ' << seekPoints.size() << '\n';
+	for (const SeekPoint& seekPoint : seekPoints)
+		stream << seekPoint.frame << ' ' << seekPoint.signature << '\n';
+	return !stream.fail();
+}
+
+} /* namespace imageio */
@@ -57,6 +57,13 @@ public:
 	 */
 	void add(std::shared_ptr<ImageFilter> filter);
 
+	/**
+	 * @return True if there are no filters, false otherwise.
+	 */
+	bool empty() const {
+		return filters.empty();
+	}
+
 	using ImageFilter::applyTo;
 
 	cv::Mat applyTo(const cv::Mat& image, cv::Mat& filtered) const;
@@ -13,7 +13,8 @@
 namespace imageprocessing {
 
 /**
- * Image filter that converts images from one color space to another.
+ * Image filter that converts images from one color space to another. Optionally, only a single channel of the
+ * converted image is kept (e.g. the hue of HSV or the lightness of Lab).
  */
 class ColorSpaceConversionFilter : public ImageFilter {
 public:
@@ -22,16 +23,32 @@ public:
 	 * Constructs a new color space conversion filter.
 	 *
 	 * @param[in] conversion The conversion code, see cv::cvtColor for details.
+	 * @param[in] channel The index of the channel that is kept, negative to keep all channels.
 	 */
-	explicit ColorSpaceConversionFilter(int conversion);
+	explicit ColorSpaceConversionFilter(int conversion, int channel = -1);
 
 	using ImageFilter::applyTo;
 
 	cv::Mat applyTo(const cv::Mat& image, cv::Mat& filtered) const;
 
+	/**
+	 * @return The conversion code, see cv::cvtColor for details.
+	 */
+	int getConversion() const {
+		return conversion;
+	}
+
+	/**
+	 * @return The index of the channel that is kept, negative if all channels are kept.
+	 */
+	int getChannel() const {
+		return channel;
+	}
+
 private:
 
 	int conversion; ///< The conversion code, see cv::cvtColor for details.
+	int channel; ///< The index of the channel that is kept, negative to keep all channels.
 };
 
 } /* namespace imageprocessing */
@@ -9,11 +9,15 @@
 #define CONVOLUTIONFILTER_HPP_
 
 #include "imageprocessing/ImageFilter.hpp"
+#include "imageprocessing/MultiChannelCorrelation.hpp"
 
 namespace imageprocessing {
 
 /**
- * Filter that convolves the image with a kernel.
+ * Filter that convolves the image with a kernel. The responses of all channels are summed up.
+ *
+ * Images and kernels of depth CV_32F with a filtered depth of CV_32F are correlated by a MultiChannelCorrelation
+ * directly on the interleaved channels, everything else by applying cv::filter2D to each channel.
  */
 class ConvolutionFilter : public ImageFilter {
 public:
@@ -55,6 +59,7 @@ public:
 private:
 
 	std::vector<cv::Mat> kernels; ///< The kernels per channel.
+	MultiChannelCorrelation correlation; ///< Correlation with the interleaved kernel, used for floating point images.
 	cv::Point anchor; ///< The anchor point within the kernels.
 	double delta; ///< The value that is added to the convolution result.
 	int depth; ///< The desired depth of the filted image.
@@ -0,0 +1,81 @@
+/*
+ * ImageArena.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef IMAGEARENA_HPP_
+#define IMAGEARENA_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <vector>
+#include <utility>
+
+namespace imageprocessing {
+
+/**
+ * Pre-allocated storage for a fixed set of images (slots) of known sizes and types, e.g. the layers of an image pyramid.
+ * The images of the same element depth are placed into one contiguous block, each slot starting at a cache line
+ * boundary. The slots are continuous images that reference their block, so they stay valid as long as they are used,
+ * even if the arena is reserved again. Passing a slot as the output of an OpenCV function or image filter that creates
+ * an image of the same size and type writes into the slot without allocating memory.
+ */
+class ImageArena {
+public:
+
+	/**
+	 * Constructs a new empty arena.
+	 */
+	ImageArena();
+
+	/**
+	 * Reserves the slots for images of the given sizes and types. Does nothing if the layout did not change, so the
+	 * slots keep their addresses.
+	 *
+	 * @param[in] layout The size and type of each slot.
+	 */
+	void reserve(const std::vector<std::pair<cv::Size, int>>& layout);
+
+	/**
+	 * Releases the memory, the slots that are still used elsewhere stay valid.
+	 */
+	void clear();
+
+	/**
+	 * @param[in] index The index of the slot.
+	 * @return The slot with the given index, an empty image if there is no such slot.
+	 */
+	cv::Mat getSlot(size_t index) const;
+
+	/**
+	 * @return The size and type of each slot.
+	 */
+	const std::vector<std::pair<cv::Size, int>>& getLayout() const {
+		return layout;
+	}
+
+	/**
+	 * @return The number of bytes that are reserved.
+	 */
+	size_t getByteCount() const;
+
+	/**
+	 * @return The number of times the memory was allocated (once per reservation with a changed layout).
+	 */
+	size_t getAllocationCount() const {
+		return allocationCount;
+	}
+
+private:
+
+	static const size_t alignment = 64; ///< The alignment of the slots in bytes (size of a cache line).
+
+	std::vector<std::pair<cv::Size, int>> layout; ///< The size and type of each slot.
+	std::vector<cv::Mat> blocks; ///< The single-row blocks of memory, one per element depth.
+	std::vector<cv::Mat> slots; ///< The images that reference parts of the blocks.
+	size_t allocationCount; ///< The number of times the memory was allocated.
+};
+
+} /* namespace imageprocessing */
+#endif /* IMAGEARENA_HPP_ */
@@ -10,6 +10,7 @@
 #ifndef IMAGEPYRAMID_HPP_
 #define IMAGEPYRAMID_HPP_
 
+#include "imageprocessing/ImageArena.hpp"
 #include "opencv2/core/core.hpp"
 #include <vector>
 #include <memory>
@@ -124,6 +125,22 @@ public:
 	 */
 	void addImageFilter(const std::shared_ptr<ImageFilter>& filter);
 
+	/**
+	 * Enables or disables the fusion of the color conversion with the scaling, which is disabled by default.
+	 *
+	 * If enabled, the only image filter is a GrayscaleFilter or a ColorSpaceConversionFilter from BGR to gray, HSV or
+	 * Lab and the source is a BGR image of depth CV_8U, then the conversion is fused with the scaling of the first
+	 * octave: each row of a layer is interpolated from the BGR image and converted right away, so the converted image
+	 * of full size is not computed unless it is a layer itself or getFilteredImage() is called.
+	 *
+	 * The layers are not exactly the same as without fusion: the interpolation uses 8-bit weights instead of the 11-bit
+	 * weights of cv::resize and happens before the conversion, which is non-linear for HSV and Lab. Classifiers that
+	 * were trained on layers of a pyramid without fusion might therefore behave slightly different.
+	 *
+	 * @param[in] enabled Flag that indicates whether the conversion should be fused with the scaling.
+	 */
+	void setFusedConversion(bool enabled);
+
 	/**
 	 * Adds a new filter that is applied to the down-scaled images after the currently existing layer filters.
 	 *
@@ -131,6 +148,35 @@ public:
 	 */
 	void addLayerFilter(const std::shared_ptr<ImageFilter>& filter);
 
+	/**
+	 * Changes the number of threads that apply the layer filters if the source is another pyramid. With more than one
+	 * thread, the layers are filtered concurrently, so the layer filters must be thread-safe.
+	 *
+	 * @param[in] threadCount The number of threads, zero for the number of cores.
+	 */
+	void setLayerThreadCount(size_t threadCount);
+
+	/**
+	 * Enables or disables the arena storage. With arena storage, the scaled and filtered images of all layers are placed
+	 * into one pre-allocated arena per image size and type, and the layer objects are reused. As long as the size of the
+	 * source does not change, an update does not allocate large images and the layers keep their addresses. The first
+	 * update after a size change measures the layout and allocates as usual.
+	 *
+	 * The images of the layers are overwritten by the next update, so data that must outlive an update (e.g. stored
+	 * patches or training examples) has to be copied. Filters that do not write into the given output image (e.g. the
+	 * in-place application of chained filters) still work, but allocate their own memory.
+	 *
+	 * @param[in] enabled Flag that indicates whether the arena storage should be used.
+	 */
+	void setArenaStorage(bool enabled);
+
+	/**
+	 * @return The arena that holds the images if the arena storage is enabled.
+	 */
+	const ImageArena& getArena() const {
+		return arena;
+	}
+
 	/**
 	 * Determines the pyramid layer with the given index.
 	 *
@@ -201,8 +247,29 @@ public:
 	 */
 	cv::Size getImageSize() const;
 
+	/**
+	 * Determines the original image after applying the image filters (but before scaling). If the update did not need
+	 * it because of the fused color conversion, it is computed on the first call.
+	 *
+	 * @return The filtered image of full size, empty if there is no source.
+	 */
+	cv::Mat getFilteredImage() const;
+
 private:
 
+	/**
+	 * Creates a layer or reuses a layer of the previous update with the same index and scale factor (arena storage only).
+	 *
+	 * @param[in] previousLayers The layers of the previous update.
+	 * @param[in] previousFirstLayer The index of the first layer of the previous update.
+	 * @param[in] index The index of the layer.
+	 * @param[in] scaleFactor The scale factor of the layer.
+	 * @param[in] scaledImage The scaled image of the layer.
+	 * @return The layer.
+	 */
+	std::shared_ptr<ImagePyramidLayer> createLayer(const std::vector<std::shared_ptr<ImagePyramidLayer>>& previousLayers,
+			int previousFirstLayer, int index, double scaleFactor, const cv::Mat& scaledImage) const;
+
 	size_t octaveLayerCount; ///< The number of layers per octave.
 	double incrementalScaleFactor; ///< The incremental scale factor between two layers of the pyramid.
 	double minScaleFactor; ///< The minimum scale factor (the scale factor of the smallest scaled (last) image is bigger or equal).
@@ -216,6 +283,13 @@ private:
 
 	std::shared_ptr<ChainedFilter> imageFilter; ///< Filter that is applied to the image before down-scaling.
 	std::shared_ptr<ChainedFilter> layerFilter; ///< Filter that is applied to the down-scaled images of the layers.
+	bool fusedConversionEnabled; ///< Flag that indicates whether the conversion may be fused with the scaling.
+	int fusedConversion; ///< The conversion code of the image filter if it can be fused with the scaling, negative otherwise.
+	int fusedChannel; ///< The channel that is kept by the fused conversion, negative to keep all channels.
+	mutable cv::Mat filteredImage; ///< The filtered image of full size, empty if it was not computed yet.
+	size_t layerThreadCount; ///< The number of threads that apply the layer filter to the layers of a source pyramid.
+	bool arenaStorage; ///< Flag that indicates whether the images are placed into the arena.
+	ImageArena arena; ///< The storage of the scaled and filtered images if the arena storage is enabled.
 };
 
 } /* namespace imageprocessing */
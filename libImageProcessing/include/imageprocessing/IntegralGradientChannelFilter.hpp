@@ -0,0 +1,37 @@
+/*
+ * IntegralGradientChannelFilter.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef INTEGRALGRADIENTCHANNELFILTER_HPP_
+#define INTEGRALGRADIENTCHANNELFILTER_HPP_
+
+#include "imageprocessing/ImageFilter.hpp"
+
+namespace imageprocessing {
+
+/**
+ * Filter that expects a two-channel gradient image and creates an integral image of the gradient values and absolute
+ * gradient values. The resulting image has four channels containing the integrals over dx, dy, |dx| and |dy|, so the
+ * sums needed by a GradientSumFilter can be computed for arbitrary cells with four lookups each. This way, the gradient
+ * sums have to be computed only once per image (or pyramid layer) instead of once per patch, see IntegralGradientSumFilter.
+ * The input image has to be of type CV_8UC2 (with 127 being the neutral value), the result will be of type CV_32SC4 and
+ * will be larger than the input image by one row and column.
+ */
+class IntegralGradientChannelFilter : public ImageFilter {
+public:
+
+	/**
+	 * Constructs a new integral gradient channel filter.
+	 */
+	IntegralGradientChannelFilter();
+
+	using ImageFilter::applyTo;
+
+	cv::Mat applyTo(const cv::Mat& image, cv::Mat& filtered) const;
+};
+
+} /* namespace imageprocessing */
+#endif /* INTEGRALGRADIENTCHANNELFILTER_HPP_ */
@@ -0,0 +1,51 @@
+/*
+ * IntegralGradientSumFilter.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef INTEGRALGRADIENTSUMFILTER_HPP_
+#define INTEGRALGRADIENTSUMFILTER_HPP_
+
+#include "imageprocessing/ImageFilter.hpp"
+
+namespace imageprocessing {
+
+/**
+ * Filter that expects an integral gradient image as created by IntegralGradientChannelFilter and creates the same
+ * vector as GradientSumFilter would create from the underlying gradient image. Instead of iterating over every pixel
+ * of a cell, the four sums of each cell are computed with four lookups into the integral image. The input image has
+ * to be of type CV_32SC4 and must be larger than the patch by one row and column (see IntegralFeatureExtractor), the
+ * result will be a row-vector of type CV_32FC1.
+ */
+class IntegralGradientSumFilter : public ImageFilter {
+public:
+
+	/**
+	 * Constructs a new integral gradient sum filter.
+	 *
+	 * @param[in] rows Row count of cells over which to sum up the gradients.
+	 * @param[in] cols Column count of cells over which to sum up the gradients.
+	 */
+	IntegralGradientSumFilter(int rows, int cols);
+
+	/**
+	 * Constructs a new integral gradient sum filter with square cells.
+	 *
+	 * @param[in] count Row and column count of cells over which to sum up the gradients.
+	 */
+	explicit IntegralGradientSumFilter(int count);
+
+	using ImageFilter::applyTo;
+
+	cv::Mat applyTo(const cv::Mat& image, cv::Mat& filtered) const;
+
+private:
+
+	int rows; ///< Row count of cells over which to sum up the gradients.
+	int cols; ///< Column count of cells over which to sum up the gradients.
+};
+
+} /* namespace imageprocessing */
+#endif /* INTEGRALGRADIENTSUMFILTER_HPP_ */
@@ -0,0 +1,125 @@
+/*
+ * MultiChannelCorrelation.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#ifndef MULTICHANNELCORRELATION_HPP_
+#define MULTICHANNELCORRELATION_HPP_
+
+#include "opencv2/core/core.hpp"
+#include <vector>
+#include <map>
+#include <mutex>
+
+namespace imageprocessing {
+
+/**
+ * Correlates multi-channel images with linear templates (e.g. the weight vector of a linear SVM over HOG cells),
+ * summing the responses of all channels. Images and templates are of type CV_32F with their channels interleaved,
+ * the result has a single channel. The anchor of the templates is their center and the image is padded with zeros,
+ * so the result equals cv::filter2D applied to each channel with BORDER_CONSTANT, summed up (apart from rounding).
+ *
+ * There are two methods. The direct one computes the dot products of the interleaved template rows and image rows,
+ * four values at a time using SSE if available. The FFT one transforms each channel of the image once and shares
+ * that spectrum among all templates, whose spectra are cached per transform size. Which one is used is either
+ * fixed or chosen per image by estimating their costs, the direct method being faster for small templates.
+ *
+ * Correlating is thread-safe, so several images (e.g. the layers of a pyramid) may be processed concurrently.
+ */
+class MultiChannelCorrelation {
+public:
+
+	/**
+	 * Method of computing the correlation.
+	 */
+	enum class Method {
+		AUTOMATIC, ///< Chooses the method with the lower estimated cost per image.
+		DIRECT, ///< Dot products of the interleaved rows in the spatial domain.
+		FFT ///< Multiplication of the spectra in the frequency domain.
+	};
+
+	/**
+	 * Constructs a new multi-channel correlation without templates.
+	 *
+	 * @param[in] method The method of computing the correlation.
+	 */
+	explicit MultiChannelCorrelation(Method method = Method::AUTOMATIC);
+
+	/**
+	 * Changes the templates. All templates must have the same size and number of channels.
+	 *
+	 * @param[in] templates The templates of type CV_32F with interleaved channels.
+	 */
+	void setTemplates(const std::vector<cv::Mat>& templates);
+
+	/**
+	 * Correlates an image with all templates.
+	 *
+	 * @param[in] image The image of type CV_32F with the same number of channels as the templates.
+	 * @param[out] results The correlation results of type CV_32FC1 and the size of the image, one per template. Results
+	 *             that already have this size and type are written into, so their memory is re-used.
+	 * @param[in] delta The value that is added to each result.
+	 */
+	void correlate(const cv::Mat& image, std::vector<cv::Mat>& results, double delta = 0) const;
+
+	/**
+	 * Determines the method that is used for an image of the given size.
+	 *
+	 * @param[in] imageSize The size of the image.
+	 * @return The method (either direct or FFT).
+	 */
+	Method chooseMethod(cv::Size imageSize) const;
+
+	/**
+	 * @return The number of templates.
+	 */
+	size_t getTemplateCount() const {
+		return templates.size();
+	}
+
+	/**
+	 * @return The number of channels of the templates.
+	 */
+	int getChannelCount() const {
+		return channelCount;
+	}
+
+private:
+
+	/**
+	 * Correlates an image with all templates in the spatial domain.
+	 */
+	void correlateDirect(const cv::Mat& image, std::vector<cv::Mat>& results, double delta) const;
+
+	/**
+	 * Correlates an image with all templates in the frequency domain.
+	 */
+	void correlateFft(const cv::Mat& image, std::vector<cv::Mat>& results, double delta) const;
+
+	/**
+	 * Retrieves the spectra of the channels of a template for the given transform size, computing them if necessary.
+	 */
+	const std::vector<cv::Mat>& getTemplateSpectra(size_t templateIndex, cv::Size dftSize) const;
+
+	/**
+	 * Comparison of sizes, so they can be used as keys of a map.
+	 */
+	struct SizeComparison {
+		bool operator()(const cv::Size& a, const cv::Size& b) const {
+			return a.height < b.height || (a.height == b.height && a.width < b.width);
+		}
+	};
+
+	Method method; ///< The method of computing the correlation.
+	std::vector<cv::Mat> templates; ///< The templates with interleaved channels.
+	cv::Size templateSize; ///< The size of the templates.
+	int channelCount; ///< The number of channels of the templates.
+	cv::Point anchor; ///< The anchor point within the templates.
+	mutable std::map<cv::Size, std::vector<std::vector<cv::Mat>>, SizeComparison> templateSpectra; ///< The spectra of the channels of each template per transform size.
+	mutable std::mutex templateSpectraMutex; ///< Mutex for accessing the cached template spectra.
+};
+
+} /* namespace imageprocessing */
+#endif /* MULTICHANNELCORRELATION_HPP_ */
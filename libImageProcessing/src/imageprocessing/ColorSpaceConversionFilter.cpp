@@ -12,10 +12,18 @@ using cv::Mat;
 
 namespace imageprocessing {
 
-ColorSpaceConversionFilter::ColorSpaceConversionFilter(int conversion) : conversion(conversion) {}
+ColorSpaceConversionFilter::ColorSpaceConversionFilter(int conversion, int channel) : conversion(conversion), channel(channel) {}
 
 Mat ColorSpaceConversionFilter::applyTo(const Mat& image, Mat& filtered) const {
-	cv::cvtColor(image, filtered, conversion);
+	if (channel < 0) {
+		cv::cvtColor(image, filtered, conversion);
+	} else {
+		Mat converted;
+		cv::cvtColor(image, converted, conversion);
+		filtered.create(converted.rows, converted.cols, CV_MAKETYPE(converted.depth(), 1));
+		int fromTo[] = { channel, 0 };
+		cv::mixChannels(&converted, 1, &filtered, 1, fromTo, 1);
+	}
 	return filtered;
 }
 
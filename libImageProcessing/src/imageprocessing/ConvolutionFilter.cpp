@@ -15,11 +15,24 @@ using std::invalid_argument;
 
 namespace imageprocessing {
 
-ConvolutionFilter::ConvolutionFilter(const Mat& kernel, double delta, int depth) : delta(delta), depth(depth) {}
+ConvolutionFilter::ConvolutionFilter(const Mat& kernel, double delta, int depth) : correlation(), delta(delta), depth(depth) {
+	setKernel(kernel);
+}
 
-ConvolutionFilter::ConvolutionFilter(int depth) : kernels(), delta(0), depth(depth) {}
+ConvolutionFilter::ConvolutionFilter(int depth) : kernels(), correlation(), delta(0), depth(depth) {}
 
 Mat ConvolutionFilter::applyTo(const Mat& image, Mat& filtered) const {
+	if (image.depth() == CV_32F && correlation.getTemplateCount() == 1 && (depth == CV_32F || depth < 0)) {
+		if (image.channels() != correlation.getChannelCount())
+			throw invalid_argument("the amount of channels of the kernel and the image have to be the same");
+		// the result is written into the memory of the filtered image if possible (unless it is the input image)
+		vector<Mat> results(1);
+		if (filtered.data != image.data)
+			results.front() = filtered;
+		correlation.correlate(image, results, delta);
+		filtered = results.front();
+		return filtered;
+	}
 	cv::Point anchor = cv::Point(-1, -1);
 	vector<Mat> channels;
 	cv::split(image, channels);
@@ -39,6 +52,10 @@ void ConvolutionFilter::setKernel(const cv::Mat& kernel) {
 	anchor = cv::Point(kernel.cols / 2, kernel.rows / 2);
 	kernels.clear();
 	cv::split(kernel, kernels);
+	if (kernel.depth() == CV_32F)
+		correlation.setTemplates(vector<Mat>{ kernel });
+	else
+		correlation.setTemplates(vector<Mat>());
 }
 
 void ConvolutionFilter::setDelta(double delta) {
@@ -10,6 +10,7 @@
 #include "imageprocessing/ImagePyramidLayer.hpp"
 #include "imageprocessing/Patch.hpp"
 #include "imageprocessing/ChainedFilter.hpp"
+#include "logging/Tracer.hpp"
 #include <stdexcept>
 
 using cv::Mat;
@@ -78,6 +79,7 @@ shared_ptr<Patch> DirectPyramidFeatureExtractor::extract(int x, int y, int width
 
 vector<shared_ptr<Patch>> DirectPyramidFeatureExtractor::extract(int stepX, int stepY, Rect roi,
 		int firstLayer, int lastLayer, int stepLayer) const {
+	TRACE_SCOPE("DirectPyramidFeatureExtractor::extract");
 	if (stepX < 1)
 		throw invalid_argument("DirectPyramidFeatureExtractor: stepX has to be greater than zero");
 	if (stepY < 1)
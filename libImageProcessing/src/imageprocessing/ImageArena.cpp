@@ -0,0 +1,75 @@
+/*
+ * ImageArena.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageprocessing/ImageArena.hpp"
+
+using cv::Mat;
+using cv::Size;
+using std::pair;
+using std::vector;
+
+namespace imageprocessing {
+
+const size_t ImageArena::alignment;
+
+ImageArena::ImageArena() : layout(), blocks(), slots(), allocationCount(0) {}
+
+void ImageArena::reserve(const vector<pair<Size, int>>& layout) {
+	if (layout == this->layout)
+		return;
+	clear();
+	this->layout = layout;
+	// offsets (in elements) of each slot within the block of its depth, aligned to the cache lines
+	vector<size_t> offsets(layout.size());
+	vector<size_t> blockSizes(CV_DEPTH_MAX, 0);
+	for (size_t i = 0; i < layout.size(); ++i) {
+		int depth = CV_MAT_DEPTH(layout[i].second);
+		size_t elementSize = CV_ELEM_SIZE1(depth);
+		offsets[i] = cv::alignSize(blockSizes[depth] * elementSize, static_cast<int>(alignment)) / elementSize;
+		blockSizes[depth] = offsets[i] + static_cast<size_t>(layout[i].first.area()) * CV_MAT_CN(layout[i].second);
+	}
+	blocks.resize(CV_DEPTH_MAX);
+	++allocationCount;
+	for (int depth = 0; depth < CV_DEPTH_MAX; ++depth) {
+		if (blockSizes[depth] > 0) // cv::Mat data is aligned to 16 bytes only, the slack aligns the start of the block
+			blocks[depth].create(1, static_cast<int>(blockSizes[depth] + alignment / CV_ELEM_SIZE1(depth)), CV_MAKETYPE(depth, 1));
+	}
+	slots.resize(layout.size());
+	for (size_t i = 0; i < layout.size(); ++i) {
+		const Size& size = layout[i].first;
+		int depth = CV_MAT_DEPTH(layout[i].second);
+		int channels = CV_MAT_CN(layout[i].second);
+		if (size.area() == 0)
+			continue;
+		const Mat& block = blocks[depth];
+		size_t startShift = (cv::alignPtr(block.data, static_cast<int>(alignment)) - block.data) / CV_ELEM_SIZE1(depth);
+		int begin = static_cast<int>(startShift + offsets[i]);
+		// a single row is continuous, so it can be reshaped into an image that keeps a reference to the block
+		slots[i] = block.colRange(begin, begin + size.area() * channels).reshape(channels, size.height);
+	}
+}
+
+void ImageArena::clear() {
+	layout.clear();
+	blocks.clear();
+	slots.clear();
+}
+
+Mat ImageArena::getSlot(size_t index) const {
+	if (index >= slots.size())
+		return Mat();
+	return slots[index];
+}
+
+size_t ImageArena::getByteCount() const {
+	size_t byteCount = 0;
+	for (const Mat& block : blocks)
+		byteCount += block.total() * block.elemSize();
+	return byteCount;
+}
+
+} /* namespace imageprocessing */
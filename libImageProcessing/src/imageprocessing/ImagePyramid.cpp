@@ -9,12 +9,24 @@
 #include "imageprocessing/ImagePyramidLayer.hpp"
 #include "imageprocessing/VersionedImage.hpp"
 #include "imageprocessing/ChainedFilter.hpp"
+#include "imageprocessing/GrayscaleFilter.hpp"
+#include "imageprocessing/ColorSpaceConversionFilter.hpp"
 #include "logging/LoggerFactory.hpp"
 #include "logging/Logger.hpp"
+#include "logging/Tracer.hpp"
 #include "opencv2/imgproc/imgproc.hpp"
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGEPYRAMID_USE_SSE2
+#endif
 
 using logging::LoggerFactory;
 using cv::Mat;
@@ -37,11 +49,116 @@ static T createException(const string& file, int line, const string& message) {
 	return T(text.str());
 }
 
+/**
+ * Blends two rows of 8-bit values, the weights summing up to 256.
+ */
+static void blendRows(const uchar* a, const uchar* b, ushort* result, int length, int weightA, int weightB) {
+	int i = 0;
+#ifdef IMAGEPYRAMID_USE_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128i weightsA = _mm_set1_epi16(static_cast<short>(weightA));
+	__m128i weightsB = _mm_set1_epi16(static_cast<short>(weightB));
+	for (; i <= length - 16; i += 16) {
+		__m128i valuesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+		__m128i valuesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+		// the sums do not exceed 255 * 256, so they fit into unsigned 16 bit
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(valuesA, zero), weightsA),
+				_mm_mullo_epi16(_mm_unpacklo_epi8(valuesB, zero), weightsB));
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(valuesA, zero), weightsA),
+				_mm_mullo_epi16(_mm_unpackhi_epi8(valuesB, zero), weightsB));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), low);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(result + i + 8), high);
+	}
+#endif
+	for (; i < length; ++i)
+		result[i] = static_cast<ushort>(a[i] * weightA + b[i] * weightB);
+}
+
+/**
+ * Determines the source positions and weights of the bilinear interpolation along one axis, using the same sampling
+ * positions as cv::resize with INTER_LINEAR.
+ */
+static void computeInterpolation(int sourceLength, int length, vector<int>& first, vector<int>& second, vector<int>& weights) {
+	double scale = static_cast<double>(sourceLength) / length;
+	first.resize(length);
+	second.resize(length);
+	weights.resize(length);
+	for (int i = 0; i < length; ++i) {
+		double position = (i + 0.5) * scale - 0.5;
+		int index = cvFloor(position);
+		int weight = cvRound((position - index) * 256);
+		if (index < 0) {
+			index = 0;
+			weight = 0;
+		}
+		if (index >= sourceLength - 1) {
+			index = sourceLength - 1;
+			weight = 0;
+		}
+		first[i] = index;
+		second[i] = std::min(index + 1, sourceLength - 1);
+		weights[i] = weight;
+	}
+}
+
+/**
+ * Converts a BGR image of depth CV_8U and scales it to the given size in one pass. Each row of the result is
+ * interpolated bilinearly from the two nearest rows of the image (vertically using SSE2 if available) and is
+ * converted right away by cv::cvtColor, so neither a converted nor a scaled BGR image of full size is created.
+ *
+ * @param[in] image The BGR image of depth CV_8U.
+ * @param[out] result The converted and scaled image.
+ * @param[in] size The size of the result.
+ * @param[in] conversion The conversion code, see cv::cvtColor for details.
+ * @param[in] channel The index of the channel that is kept, negative to keep all channels.
+ */
+static void scaleAndConvert(const Mat& image, Mat& result, Size size, int conversion, int channel) {
+	result.create(size, channel >= 0 || conversion == CV_BGR2GRAY ? CV_8UC1 : CV_8UC3);
+	Mat converted;
+	auto convertRow = [&](const Mat& row, Mat& resultRow) {
+		if (channel < 0) {
+			cv::cvtColor(row, resultRow, conversion);
+		} else {
+			cv::cvtColor(row, converted, conversion);
+			int fromTo[] = { channel, 0 };
+			cv::mixChannels(&converted, 1, &resultRow, 1, fromTo, 1);
+		}
+	};
+	if (size == image.size()) {
+		for (int y = 0; y < size.height; ++y) {
+			Mat resultRow = result.row(y);
+			convertRow(image.row(y), resultRow);
+		}
+		return;
+	}
+	vector<int> firstColumns, secondColumns, columnWeights, firstRows, secondRows, rowWeights;
+	computeInterpolation(image.cols, size.width, firstColumns, secondColumns, columnWeights);
+	computeInterpolation(image.rows, size.height, firstRows, secondRows, rowWeights);
+	vector<ushort> blendedRow(image.cols * 3);
+	Mat scaledRow(1, size.width, CV_8UC3);
+	uchar* scaledValues = scaledRow.ptr<uchar>();
+	for (int y = 0; y < size.height; ++y) {
+		blendRows(image.ptr<uchar>(firstRows[y]), image.ptr<uchar>(secondRows[y]), blendedRow.data(), image.cols * 3, 256 - rowWeights[y], rowWeights[y]);
+		for (int x = 0; x < size.width; ++x) {
+			const ushort* left = &blendedRow[3 * firstColumns[x]];
+			const ushort* right = &blendedRow[3 * secondColumns[x]];
+			int rightWeight = columnWeights[x];
+			int leftWeight = 256 - rightWeight;
+			for (int c = 0; c < 3; ++c)
+				scaledValues[3 * x + c] = static_cast<uchar>((left[c] * leftWeight + right[c] * rightWeight + (1 << 15)) >> 16);
+		}
+		Mat resultRow = result.row(y);
+		convertRow(scaledRow, resultRow);
+	}
+}
+
 ImagePyramid::ImagePyramid(size_t octaveLayerCount, double minScaleFactor, double maxScaleFactor) :
 		octaveLayerCount(octaveLayerCount), incrementalScaleFactor(0),
 		minScaleFactor(minScaleFactor), maxScaleFactor(maxScaleFactor),
 		firstLayer(0), layers(), sourceImage(), sourcePyramid(), version(-1),
-		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()) {
+		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()),
+		fusedConversionEnabled(false), fusedConversion(-1), fusedChannel(-1), filteredImage(), layerThreadCount(1),
+		arenaStorage(false), arena() {
 	if (octaveLayerCount == 0)
 		throw createException<invalid_argument>(__FILE__, __LINE__, "the number of layers per octave must be greater than zero");
 	if (minScaleFactor <= 0)
@@ -55,7 +172,9 @@ ImagePyramid::ImagePyramid(double incrementalScaleFactor, double minScaleFactor,
 		octaveLayerCount(0), incrementalScaleFactor(0),
 		minScaleFactor(minScaleFactor), maxScaleFactor(maxScaleFactor),
 		firstLayer(0), layers(), sourceImage(), sourcePyramid(), version(-1),
-		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()) {
+		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()),
+		fusedConversionEnabled(false), fusedConversion(-1), fusedChannel(-1), filteredImage(), layerThreadCount(1),
+		arenaStorage(false), arena() {
 	if (incrementalScaleFactor <= 0 || incrementalScaleFactor >= 1)
 		throw createException<invalid_argument>(__FILE__, __LINE__, "the incremental scale factor must be greater than zero and smaller than one");
 	if (minScaleFactor <= 0)
@@ -70,13 +189,17 @@ ImagePyramid::ImagePyramid(double minScaleFactor, double maxScaleFactor) :
 		octaveLayerCount(0), incrementalScaleFactor(0),
 		minScaleFactor(minScaleFactor), maxScaleFactor(maxScaleFactor),
 		firstLayer(0), layers(), sourceImage(), sourcePyramid(), version(-1),
-		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()) {}
+		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()),
+		fusedConversionEnabled(false), fusedConversion(-1), fusedChannel(-1), filteredImage(), layerThreadCount(1),
+		arenaStorage(false), arena() {}
 
 ImagePyramid::ImagePyramid(shared_ptr<ImagePyramid> pyramid, double minScaleFactor, double maxScaleFactor) :
 		octaveLayerCount(pyramid->octaveLayerCount), incrementalScaleFactor(pyramid->incrementalScaleFactor),
 		minScaleFactor(minScaleFactor), maxScaleFactor(maxScaleFactor),
 		firstLayer(0), layers(), sourceImage(), sourcePyramid(pyramid), version(-1),
-		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()) {}
+		imageFilter(make_shared<ChainedFilter>()), layerFilter(make_shared<ChainedFilter>()),
+		fusedConversionEnabled(false), fusedConversion(-1), fusedChannel(-1), filteredImage(), layerThreadCount(1),
+		arenaStorage(false), arena() {}
 
 void ImagePyramid::setSource(const Mat& image) {
 	setSource(make_shared<VersionedImage>(image));
@@ -100,24 +223,70 @@ void ImagePyramid::setSource(const shared_ptr<ImagePyramid>& pyramid) {
 void ImagePyramid::update() {
 	if (sourceImage) {
 		if (version != sourceImage->getVersion()) {
-			layers.clear();
-			Mat filteredImage = imageFilter->applyTo(sourceImage->getData());
+			TRACE_SCOPE("ImagePyramid::update");
+			// with arena storage, every image that is computed gets the next slot and its size and type are recorded
+			vector<pair<Size, int>> layout;
+			auto nextSlot = [&]() -> Mat {
+				return arenaStorage ? arena.getSlot(layout.size()) : Mat();
+			};
+			auto recordSlot = [&](const Mat& image) {
+				if (arenaStorage)
+					layout.emplace_back(image.size(), image.type());
+			};
+			vector<shared_ptr<ImagePyramidLayer>> previousLayers;
+			previousLayers.swap(layers);
+			int previousFirstLayer = firstLayer;
+			const Mat& image = sourceImage->getData();
+			bool fused = fusedConversionEnabled && fusedConversion >= 0 && image.type() == CV_8UC3;
+			filteredImage = Mat();
+			if (!fused) {
+				filteredImage = nextSlot();
+				imageFilter->applyTo(image, filteredImage);
+				recordSlot(filteredImage);
+			}
 			// TODO wenn maxscale <= 0.5 -> erstmal pyrdown auf bild (etc pp)
 			for (size_t i = 0; i < octaveLayerCount; ++i) {
 				double scaleFactor = pow(incrementalScaleFactor, i);
+				size_t j = 0;
 				Mat scaledImage;
-				Size scaledImageSize(cvRound(filteredImage.cols * scaleFactor), cvRound(filteredImage.rows * scaleFactor));
-				resize(filteredImage, scaledImage, scaledImageSize, 0, 0, cv::INTER_LINEAR);
-				if (scaleFactor <= maxScaleFactor && scaleFactor >= minScaleFactor)
-					layers.push_back(make_shared<ImagePyramidLayer>(i, scaleFactor, layerFilter->applyTo(scaledImage)));
-				Mat previousScaledImage = scaledImage;
-				scaleFactor *= 0.5;
-				for (size_t j = 1; scaleFactor >= minScaleFactor; ++j, scaleFactor *= 0.5) {
-					Mat downSampledImage;
-					pyrDown(previousScaledImage, scaledImage);
-					if (scaleFactor <= maxScaleFactor)
-						layers.push_back(make_shared<ImagePyramidLayer>(i + j * octaveLayerCount, scaleFactor, layerFilter->applyTo(scaledImage)));
-					previousScaledImage = scaledImage;
+				if (!fused) {
+					scaledImage = nextSlot();
+					Size scaledImageSize(cvRound(filteredImage.cols * scaleFactor), cvRound(filteredImage.rows * scaleFactor));
+					resize(filteredImage, scaledImage, scaledImageSize, 0, 0, cv::INTER_LINEAR);
+					recordSlot(scaledImage);
+				} else if (scaleFactor == 1 && scaleFactor > maxScaleFactor) {
+					// the image of full size is no layer, so the BGR image is reduced before converting it
+					if (0.5 < minScaleFactor)
+						continue;
+					Mat reducedImage = nextSlot();
+					pyrDown(image, reducedImage);
+					recordSlot(reducedImage);
+					scaledImage = nextSlot();
+					scaleAndConvert(reducedImage, scaledImage, reducedImage.size(), fusedConversion, fusedChannel);
+					recordSlot(scaledImage);
+					j = 1;
+					scaleFactor *= 0.5;
+				} else {
+					scaledImage = nextSlot();
+					Size scaledImageSize(cvRound(image.cols * scaleFactor), cvRound(image.rows * scaleFactor));
+					scaleAndConvert(image, scaledImage, scaledImageSize, fusedConversion, fusedChannel);
+					recordSlot(scaledImage);
+					if (scaleFactor == 1)
+						filteredImage = scaledImage;
+				}
+				for (size_t firstOctave = j; scaleFactor >= minScaleFactor; ++j, scaleFactor *= 0.5) {
+					if (j > firstOctave) {
+						Mat previousScaledImage = scaledImage;
+						scaledImage = nextSlot();
+						pyrDown(previousScaledImage, scaledImage);
+						recordSlot(scaledImage);
+					}
+					if (scaleFactor <= maxScaleFactor) {
+						Mat filteredLayer = nextSlot();
+						layerFilter->applyTo(scaledImage, filteredLayer);
+						recordSlot(filteredLayer);
+						layers.push_back(createLayer(previousLayers, previousFirstLayer, i + j * octaveLayerCount, scaleFactor, filteredLayer));
+					}
 				}
 			}
 			std::sort(layers.begin(), layers.end(), [](const shared_ptr<ImagePyramidLayer>& a, const shared_ptr<ImagePyramidLayer>& b) {
@@ -125,22 +294,63 @@ void ImagePyramid::update() {
 			});
 			if (!layers.empty())
 				firstLayer = layers.front()->getIndex();
+			if (arenaStorage)
+				arena.reserve(layout); // only allocates if the layout changed, the images of this update keep their memory
 			version = sourceImage->getVersion();
 		}
 	} else if (sourcePyramid) {
 		if (version != sourcePyramid->getVersion()) {
+			TRACE_SCOPE("ImagePyramid::update");
 			incrementalScaleFactor = sourcePyramid->incrementalScaleFactor;
-			layers.clear();
+			vector<shared_ptr<ImagePyramidLayer>> previousLayers;
+			previousLayers.swap(layers);
+			int previousFirstLayer = firstLayer;
+			vector<shared_ptr<ImagePyramidLayer>> sourceLayers;
 			for (const shared_ptr<ImagePyramidLayer>& layer : sourcePyramid->layers) {
 				if (layer->getScaleFactor() > maxScaleFactor)
 					continue;
 				if (layer->getScaleFactor() < minScaleFactor)
 					break;
-				layers.push_back(make_shared<ImagePyramidLayer>(
-						layer->getIndex(), layer->getScaleFactor(), layerFilter->applyTo(layer->getScaledImage())));
+				sourceLayers.push_back(layer);
+			}
+			// the layers are distributed dynamically, as the bigger ones take much longer to filter
+			vector<Mat> filteredImages(sourceLayers.size());
+			if (arenaStorage) {
+				for (size_t i = 0; i < sourceLayers.size(); ++i)
+					filteredImages[i] = arena.getSlot(i);
 			}
+			std::atomic<size_t> nextLayer(0);
+			std::exception_ptr error;
+			std::mutex errorMutex;
+			auto worker = [&]() {
+				try {
+					for (size_t i = nextLayer++; i < sourceLayers.size(); i = nextLayer++)
+						layerFilter->applyTo(sourceLayers[i]->getScaledImage(), filteredImages[i]);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(errorMutex);
+					if (!error)
+						error = std::current_exception();
+				}
+			};
+			vector<std::thread> threads;
+			for (size_t t = 1; t < std::min(layerThreadCount, sourceLayers.size()); ++t)
+				threads.emplace_back(worker);
+			worker();
+			for (std::thread& thread : threads)
+				thread.join();
+			if (error)
+				std::rethrow_exception(error);
+			for (size_t i = 0; i < sourceLayers.size(); ++i)
+				layers.push_back(createLayer(previousLayers, previousFirstLayer,
+						sourceLayers[i]->getIndex(), sourceLayers[i]->getScaleFactor(), filteredImages[i]));
 			if (!layers.empty())
 				firstLayer = layers.front()->getIndex();
+			if (arenaStorage) {
+				vector<pair<Size, int>> layout;
+				for (const Mat& filteredImage : filteredImages)
+					layout.emplace_back(filteredImage.size(), filteredImage.type());
+				arena.reserve(layout);
+			}
 			version = sourcePyramid->getVersion();
 		}
 	} else { // neither source pyramid nor source image are set, therefore the other parameters are missing, too
@@ -169,13 +379,57 @@ void ImagePyramid::update(const shared_ptr<VersionedImage>& image) {
 }
 
 void ImagePyramid::addImageFilter(const shared_ptr<ImageFilter>& filter) {
+	fusedConversion = -1;
+	fusedChannel = -1;
+	if (imageFilter->empty()) {
+		if (std::dynamic_pointer_cast<GrayscaleFilter>(filter)) {
+			fusedConversion = CV_BGR2GRAY;
+		} else if (shared_ptr<ColorSpaceConversionFilter> conversionFilter = std::dynamic_pointer_cast<ColorSpaceConversionFilter>(filter)) {
+			int conversion = conversionFilter->getConversion();
+			if (conversion == CV_BGR2GRAY || conversion == CV_BGR2HSV || conversion == CV_BGR2HSV_FULL || conversion == CV_BGR2Lab) {
+				fusedConversion = conversion;
+				fusedChannel = conversionFilter->getChannel();
+			}
+		}
+	}
 	imageFilter->add(filter);
 }
 
+void ImagePyramid::setFusedConversion(bool enabled) {
+	if (fusedConversionEnabled != enabled)
+		version = -1; // the layers are computed differently
+	fusedConversionEnabled = enabled;
+}
+
 void ImagePyramid::addLayerFilter(const shared_ptr<ImageFilter>& filter) {
 	layerFilter->add(filter);
 }
 
+void ImagePyramid::setLayerThreadCount(size_t threadCount) {
+	layerThreadCount = threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount;
+}
+
+void ImagePyramid::setArenaStorage(bool enabled) {
+	arenaStorage = enabled;
+	if (!arenaStorage)
+		arena.clear();
+}
+
+shared_ptr<ImagePyramidLayer> ImagePyramid::createLayer(const vector<shared_ptr<ImagePyramidLayer>>& previousLayers,
+		int previousFirstLayer, int index, double scaleFactor, const Mat& scaledImage) const {
+	if (arenaStorage) {
+		int previousIndex = index - previousFirstLayer;
+		if (previousIndex >= 0 && previousIndex < static_cast<int>(previousLayers.size())) {
+			const shared_ptr<ImagePyramidLayer>& previousLayer = previousLayers[previousIndex];
+			if (previousLayer->getIndex() == index && previousLayer->getScaleFactor() == scaleFactor) {
+				previousLayer->getScaledImage() = scaledImage;
+				return previousLayer;
+			}
+		}
+	}
+	return make_shared<ImagePyramidLayer>(index, scaleFactor, scaledImage);
+}
+
 Size ImagePyramid::getImageSize() const {
 	if (sourceImage)
 		return Size(sourceImage->getData().cols, sourceImage->getData().rows);
@@ -185,6 +439,14 @@ Size ImagePyramid::getImageSize() const {
 		return Size();
 }
 
+Mat ImagePyramid::getFilteredImage() const {
+	if (sourcePyramid)
+		return sourcePyramid->getFilteredImage();
+	if (filteredImage.empty() && sourceImage)
+		imageFilter->applyTo(sourceImage->getData(), filteredImage);
+	return filteredImage;
+}
+
 const shared_ptr<ImagePyramidLayer> ImagePyramid::getLayer(int index) const {
 	int realIndex = index - firstLayer;
 	if (realIndex < 0 || realIndex >= (int)layers.size())
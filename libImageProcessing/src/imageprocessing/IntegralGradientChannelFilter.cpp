@@ -0,0 +1,47 @@
+/*
+ * IntegralGradientChannelFilter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageprocessing/IntegralGradientChannelFilter.hpp"
+#include <stdexcept>
+
+using cv::Mat;
+using cv::Vec2b;
+using cv::Vec4i;
+using std::invalid_argument;
+
+namespace imageprocessing {
+
+IntegralGradientChannelFilter::IntegralGradientChannelFilter() {}
+
+Mat IntegralGradientChannelFilter::applyTo(const Mat& image, Mat& filtered) const {
+	if (image.type() != CV_8UC2)
+		throw invalid_argument("IntegralGradientChannelFilter: the image must be of type CV_8UC2");
+
+	filtered.create(image.rows + 1, image.cols + 1, CV_32SC4);
+	Vec4i* firstRow = filtered.ptr<Vec4i>(0);
+	for (int col = 0; col < filtered.cols; ++col)
+		firstRow[col] = Vec4i(0, 0, 0, 0);
+	for (int row = 0; row < image.rows; ++row) {
+		const Vec2b* gradients = image.ptr<Vec2b>(row);
+		const Vec4i* previousSums = filtered.ptr<Vec4i>(row);
+		Vec4i* sums = filtered.ptr<Vec4i>(row + 1);
+		sums[0] = Vec4i(0, 0, 0, 0);
+		Vec4i rowSum(0, 0, 0, 0);
+		for (int col = 0; col < image.cols; ++col) {
+			int dx = static_cast<int>(gradients[col][0]) - 127;
+			int dy = static_cast<int>(gradients[col][1]) - 127;
+			rowSum[0] += dx;
+			rowSum[1] += dy;
+			rowSum[2] += std::abs(dx);
+			rowSum[3] += std::abs(dy);
+			sums[col + 1] = previousSums[col + 1] + rowSum;
+		}
+	}
+	return filtered;
+}
+
+} /* namespace imageprocessing */
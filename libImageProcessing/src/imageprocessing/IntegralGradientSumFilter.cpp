@@ -0,0 +1,53 @@
+/*
+ * IntegralGradientSumFilter.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageprocessing/IntegralGradientSumFilter.hpp"
+#include <stdexcept>
+
+using cv::Mat;
+using cv::Vec4i;
+using std::invalid_argument;
+
+namespace imageprocessing {
+
+IntegralGradientSumFilter::IntegralGradientSumFilter(int rows, int cols) : rows(rows), cols(cols) {}
+
+IntegralGradientSumFilter::IntegralGradientSumFilter(int count) : rows(count), cols(count) {}
+
+Mat IntegralGradientSumFilter::applyTo(const Mat& image, Mat& filtered) const {
+	if (image.type() != CV_32SC4)
+		throw invalid_argument("IntegralGradientSumFilter: the image must be of type CV_32SC4");
+	int width = image.cols - 1;
+	int height = image.rows - 1;
+	if (height % rows != 0)
+		throw invalid_argument("IntegralGradientSumFilter: patch row count (" + std::to_string(height) + ") is not divisible by cell count (" + std::to_string(rows) + ")");
+	if (width % cols != 0)
+		throw invalid_argument("IntegralGradientSumFilter: patch column count (" + std::to_string(width) + ") is not divisible by cell count (" + std::to_string(cols) + ")");
+
+	filtered.create(1, rows * cols * 4, CV_32FC1);
+	int cellWidth = width / cols;
+	int cellHeight = height / rows;
+	float* values = filtered.ptr<float>();
+	float normalizer = 1.f / 127.f;
+	for (int row = 0; row < rows; ++row) {
+		const Vec4i* topSums = image.ptr<Vec4i>(row * cellHeight);
+		const Vec4i* bottomSums = image.ptr<Vec4i>((row + 1) * cellHeight);
+		for (int col = 0; col < cols; ++col) {
+			int left = col * cellWidth;
+			int right = left + cellWidth;
+			Vec4i sums = bottomSums[right] - bottomSums[left] - topSums[right] + topSums[left];
+			values[0] = normalizer * sums[0];
+			values[1] = normalizer * sums[1];
+			values[2] = normalizer * sums[2];
+			values[3] = normalizer * sums[3];
+			values += 4;
+		}
+	}
+	return filtered;
+}
+
+} /* namespace imageprocessing */
@@ -0,0 +1,157 @@
+/*
+ * MultiChannelCorrelation.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "imageprocessing/MultiChannelCorrelation.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MULTICHANNELCORRELATION_USE_SSE
+#endif
+
+using cv::Mat;
+using cv::Size;
+using std::vector;
+using std::invalid_argument;
+
+namespace imageprocessing {
+
+/**
+ * Computes the dot product of two float arrays.
+ */
+static float dotProduct(const float* a, const float* b, int length) {
+	int i = 0;
+	float sum = 0;
+#ifdef MULTICHANNELCORRELATION_USE_SSE
+	__m128 sums = _mm_setzero_ps();
+	for (; i <= length - 4; i += 4)
+		sums = _mm_add_ps(sums, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+	float partialSums[4];
+	_mm_storeu_ps(partialSums, sums);
+	sum = (partialSums[0] + partialSums[1]) + (partialSums[2] + partialSums[3]);
+#endif
+	for (; i < length; ++i)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+MultiChannelCorrelation::MultiChannelCorrelation(Method method) :
+		method(method), templates(), templateSize(), channelCount(0), anchor(), templateSpectra(), templateSpectraMutex() {}
+
+void MultiChannelCorrelation::setTemplates(const vector<Mat>& templates) {
+	for (const Mat& templ : templates) {
+		if (templ.depth() != CV_32F)
+			throw invalid_argument("MultiChannelCorrelation: the templates must be of depth CV_32F");
+		if (templ.size() != templates.front().size() || templ.channels() != templates.front().channels())
+			throw invalid_argument("MultiChannelCorrelation: the templates must have the same size and number of channels");
+	}
+	this->templates.clear();
+	for (const Mat& templ : templates)
+		this->templates.push_back(templ.isContinuous() ? templ : templ.clone());
+	templateSize = templates.empty() ? Size() : templates.front().size();
+	channelCount = templates.empty() ? 0 : templates.front().channels();
+	anchor = cv::Point(templateSize.width / 2, templateSize.height / 2);
+	std::lock_guard<std::mutex> lock(templateSpectraMutex);
+	templateSpectra.clear();
+}
+
+void MultiChannelCorrelation::correlate(const Mat& image, vector<Mat>& results, double delta) const {
+	if (image.depth() != CV_32F)
+		throw invalid_argument("MultiChannelCorrelation: the image must be of depth CV_32F");
+	if (image.channels() != channelCount)
+		throw invalid_argument("MultiChannelCorrelation: the amount of channels of the templates and the image have to be the same");
+	results.resize(templates.size());
+	if (chooseMethod(image.size()) == Method::FFT)
+		correlateFft(image, results, delta);
+	else
+		correlateDirect(image, results, delta);
+}
+
+MultiChannelCorrelation::Method MultiChannelCorrelation::chooseMethod(Size imageSize) const {
+	if (method != Method::AUTOMATIC)
+		return method;
+	// rough operation counts, the transforms being shared among the templates
+	double templateCount = static_cast<double>(templates.size());
+	double directCost = templateCount * imageSize.area() * templateSize.area() * channelCount / 4.0; // four values per SSE instruction
+	Size dftSize(cv::getOptimalDFTSize(imageSize.width + templateSize.width - 1), cv::getOptimalDFTSize(imageSize.height + templateSize.height - 1));
+	double dftCost = 2.5 * dftSize.area() * std::log2(static_cast<double>(dftSize.area())); // real-valued transform
+	double fftCost = channelCount * dftCost + templateCount * (channelCount * 3.0 * dftSize.area() + dftCost);
+	return fftCost < directCost ? Method::FFT : Method::DIRECT;
+}
+
+void MultiChannelCorrelation::correlateDirect(const Mat& image, vector<Mat>& results, double delta) const {
+	for (size_t t = 0; t < templates.size(); ++t) {
+		const Mat& templ = templates[t];
+		Mat& result = results[t];
+		result.create(image.rows, image.cols, CV_32FC1);
+		for (int y = 0; y < image.rows; ++y) {
+			float* resultValues = result.ptr<float>(y);
+			std::fill(resultValues, resultValues + image.cols, static_cast<float>(delta));
+			for (int templateY = std::max(0, anchor.y - y); templateY < std::min(templateSize.height, image.rows + anchor.y - y); ++templateY) {
+				const float* templateRow = templ.ptr<float>(templateY);
+				const float* imageRow = image.ptr<float>(y + templateY - anchor.y);
+				for (int x = 0; x < image.cols; ++x) {
+					// the template row and the corresponding part of the image row are contiguous, as the channels are interleaved
+					int templateStartX = std::max(0, anchor.x - x);
+					int templateEndX = std::min(templateSize.width, image.cols + anchor.x - x);
+					int imageStart = (x + templateStartX - anchor.x) * channelCount;
+					int length = (templateEndX - templateStartX) * channelCount;
+					if (length > 0)
+						resultValues[x] += dotProduct(templateRow + templateStartX * channelCount, imageRow + imageStart, length);
+				}
+			}
+		}
+	}
+}
+
+void MultiChannelCorrelation::correlateFft(const Mat& image, vector<Mat>& results, double delta) const {
+	// padding the image such that the anchor is at the origin and the correlation does not wrap around
+	Size dftSize(cv::getOptimalDFTSize(image.cols + templateSize.width - 1), cv::getOptimalDFTSize(image.rows + templateSize.height - 1));
+	vector<Mat> channels;
+	cv::split(image, channels);
+	vector<Mat> imageSpectra(channelCount);
+	for (int c = 0; c < channelCount; ++c) {
+		Mat paddedChannel;
+		cv::copyMakeBorder(channels[c], paddedChannel, anchor.y, dftSize.height - image.rows - anchor.y,
+				anchor.x, dftSize.width - image.cols - anchor.x, cv::BORDER_CONSTANT, cv::Scalar(0));
+		cv::dft(paddedChannel, imageSpectra[c], 0, anchor.y + image.rows);
+	}
+	Mat spectrumSum, spectrumProduct, correlation;
+	for (size_t t = 0; t < templates.size(); ++t) {
+		const vector<Mat>& spectra = getTemplateSpectra(t, dftSize);
+		spectrumSum = Mat::zeros(dftSize, CV_32FC1);
+		for (int c = 0; c < channelCount; ++c) {
+			cv::mulSpectrums(imageSpectra[c], spectra[c], spectrumProduct, 0, true);
+			spectrumSum += spectrumProduct;
+		}
+		cv::dft(spectrumSum, correlation, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT, image.rows);
+		correlation(cv::Rect(0, 0, image.cols, image.rows)).convertTo(results[t], CV_32F, 1, delta);
+	}
+}
+
+const vector<Mat>& MultiChannelCorrelation::getTemplateSpectra(size_t templateIndex, Size dftSize) const {
+	std::lock_guard<std::mutex> lock(templateSpectraMutex);
+	vector<vector<Mat>>& spectra = templateSpectra[dftSize];
+	if (spectra.empty()) {
+		spectra.resize(templates.size());
+		for (size_t t = 0; t < templates.size(); ++t) {
+			vector<Mat> channels;
+			cv::split(templates[t], channels);
+			spectra[t].resize(channelCount);
+			for (int c = 0; c < channelCount; ++c) {
+				Mat paddedChannel;
+				cv::copyMakeBorder(channels[c], paddedChannel, 0, dftSize.height - templateSize.height,
+						0, dftSize.width - templateSize.width, cv::BORDER_CONSTANT, cv::Scalar(0));
+				cv::dft(paddedChannel, spectra[t][c], 0, templateSize.height);
+			}
+		}
+	}
+	return spectra[templateIndex]; // references to map elements stay valid until the templates change
+}
+
+} /* namespace imageprocessing */
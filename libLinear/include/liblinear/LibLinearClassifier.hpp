@@ -46,6 +46,16 @@ public:
 
 	void reset();
 
+	/**
+	 * Writes the parameters of the SVM and the stored positive and negative training examples. The static negative
+	 * training examples are not written, they have to be loaded from their file again before restoring.
+	 *
+	 * @param[in] writer The writer of the snapshot.
+	 */
+	void saveState(classification::BinaryModelWriter& writer) const;
+
+	void loadState(classification::BinaryModelReader& reader);
+
 	/**
 	 * @param[in] positiveExamples Storage of positive training examples.
 	 */
@@ -11,11 +11,15 @@
 #include "classification/ExampleManagement.hpp"
 #include "classification/UnlimitedExampleManagement.hpp"
 #include "classification/EmptyExampleManagement.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include <fstream>
 #include <stdexcept>
 
 using classification::LinearKernel;
 using classification::ExampleManagement;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using classification::UnlimitedExampleManagement;
 using classification::EmptyExampleManagement;
 using cv::Mat;
@@ -154,4 +158,16 @@ void LibLinearClassifier::reset() {
 	negativeExamples->clear();
 }
 
+void LibLinearClassifier::saveState(BinaryModelWriter& writer) const {
+	TrainableSvmClassifier::saveState(writer);
+	positiveExamples->saveState(writer);
+	negativeExamples->saveState(writer);
+}
+
+void LibLinearClassifier::loadState(BinaryModelReader& reader) {
+	TrainableSvmClassifier::loadState(reader);
+	positiveExamples->loadState(reader);
+	negativeExamples->loadState(reader);
+}
+
 } /* namespace liblinear */
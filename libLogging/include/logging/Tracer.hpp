@@ -0,0 +1,222 @@
+/*
+ * Tracer.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef TRACER_HPP_
+#define TRACER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <ostream>
+
+namespace logging {
+
+#define Tracers Tracer::Instance()
+
+/**
+ * Measures the time spent in named scopes of the code. The scopes are marked by TRACE_SCOPE("name") (or
+ * by a TraceScope object), which measures the time until the end of the enclosing block. The name has to
+ * be a string literal (or live as long as the program), because only the pointer is stored.
+ *
+ * Each thread records into its own buffer, so tracing does not synchronize the threads. The durations
+ * are aggregated into a histogram per scope name, from which the summary (count, mean and percentiles)
+ * is computed. Additionally, the individual events are kept (up to a limit per thread), so they can be
+ * written as a Chrome trace file and viewed in chrome://tracing.
+ *
+ * Tracing is disabled by default. A disabled scope costs a single check of a flag. If LOGGING_NO_TRACING
+ * is defined, the TRACE_SCOPE macro expands to nothing at all.
+ */
+class Tracer
+{
+private:
+	/* Private constructor, destructor and copy constructor - we only want one instance of the tracer. */
+	Tracer();
+	~Tracer();
+	Tracer(const Tracer &);
+	Tracer& operator=(const Tracer &);
+
+public:
+	/**
+	 * Timing statistics of a scope. All times are in milliseconds. The percentiles are estimated from a
+	 * histogram with logarithmic bins, their relative error is below 5%.
+	 */
+	struct Statistics
+	{
+		std::string name; ///< The name of the scope.
+		std::size_t count; ///< The number of times the scope was executed.
+		double total; ///< The total time spent in the scope.
+		double mean; ///< The mean duration.
+		double p50; ///< The median duration.
+		double p95; ///< The 95th percentile of the durations.
+		double p99; ///< The 99th percentile of the durations.
+		double max; ///< The maximum duration.
+	};
+
+	static Tracer* Instance();
+
+	/**
+	 * Enables or disables the tracing. Scopes that are entered while the tracing is disabled are not recorded.
+	 *
+	 * @param[in] enabled Flag that indicates whether the scopes should be recorded.
+	 */
+	void setEnabled(bool enabled);
+
+	/**
+	 * @return True if the scopes are recorded, false otherwise.
+	 */
+	bool isEnabled() const {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Changes the maximum number of events that are kept per thread for the Chrome trace. Further events are
+	 * still aggregated into the statistics. The default is 100000.
+	 *
+	 * @param[in] limit The maximum number of events per thread.
+	 */
+	void setEventLimit(std::size_t limit);
+
+	/**
+	 * Records the execution of a scope by the calling thread.
+	 *
+	 * @param[in] name The name of the scope, must outlive the tracer.
+	 * @param[in] start The time the scope was entered, see now().
+	 * @param[in] end The time the scope was left, see now().
+	 */
+	void record(const char* name, std::int64_t start, std::int64_t end);
+
+	/**
+	 * @return The current time in nanoseconds of a monotonic clock.
+	 */
+	static std::int64_t now();
+
+	/**
+	 * Aggregates the recordings of all threads.
+	 *
+	 * @return The statistics of each scope, ordered by the total time (descending).
+	 */
+	std::vector<Statistics> getStatistics() const;
+
+	/**
+	 * Creates a table of the statistics of all scopes, one line per scope.
+	 *
+	 * @return The summary table.
+	 */
+	std::string getSummary() const;
+
+	/**
+	 * Writes the recorded events in the Chrome trace event format (JSON), which can be viewed with
+	 * chrome://tracing or similar tools.
+	 *
+	 * @param[in] filename The name of the file to write.
+	 */
+	void writeChromeTrace(const std::string& filename) const;
+
+	/**
+	 * Removes all recordings.
+	 */
+	void reset();
+
+private:
+	/**
+	 * Histogram of the durations of a scope with logarithmic bins (eight per power of two nanoseconds).
+	 */
+	struct Histogram
+	{
+		std::vector<std::uint32_t> bins; ///< The number of durations per bin.
+		std::size_t count; ///< The number of durations.
+		double total; ///< The sum of the durations in nanoseconds.
+		std::int64_t max; ///< The maximum duration in nanoseconds.
+	};
+
+	/**
+	 * Execution of a scope.
+	 */
+	struct Event
+	{
+		const char* name; ///< The name of the scope.
+		std::int64_t start; ///< The time the scope was entered in nanoseconds.
+		std::int64_t end; ///< The time the scope was left in nanoseconds.
+	};
+
+	/**
+	 * Recordings of a single thread. The mutex is only contended while the recordings are read or reset.
+	 */
+	struct ThreadBuffer
+	{
+		int threadId; ///< The number of the thread, in order of the first recording.
+		std::mutex mutex; ///< Mutex for accessing the recordings.
+		std::map<const char*, Histogram> histograms; ///< The histogram of each scope name (the names are compared by address).
+		std::vector<Event> events; ///< The events, up to the event limit.
+	};
+
+	/**
+	 * @return The buffer of the calling thread, which is created on the first call.
+	 */
+	ThreadBuffer& getThreadBuffer();
+
+	/**
+	 * Estimates the duration at the given quantile of a histogram.
+	 *
+	 * @return The duration in milliseconds.
+	 */
+	static double getQuantile(const std::vector<std::uint64_t>& bins, std::size_t count, double quantile);
+
+	std::atomic<bool> enabled; ///< Flag that indicates whether the scopes are recorded.
+	std::atomic<std::size_t> eventLimit; ///< The maximum number of events that are kept per thread.
+	mutable std::mutex buffersMutex; ///< Mutex for accessing the list of buffers.
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers; ///< The buffers of all threads that recorded something (they outlive their threads).
+};
+
+/**
+ * Measures the time from its construction until its destruction and records it with the tracer, if the
+ * tracing was enabled at the construction.
+ */
+class TraceScope
+{
+public:
+	/**
+	 * Enters a scope.
+	 *
+	 * @param[in] name The name of the scope, must outlive the tracer (e.g. a string literal).
+	 */
+	explicit TraceScope(const char* name) : name(Tracers->isEnabled() ? name : nullptr), start(0) {
+		if (this->name)
+			start = Tracer::now();
+	}
+
+	/**
+	 * Leaves the scope.
+	 */
+	~TraceScope() {
+		if (name)
+			Tracers->record(name, start, Tracer::now());
+	}
+
+private:
+	TraceScope(const TraceScope &);
+	TraceScope& operator=(const TraceScope &);
+
+	const char* name; ///< The name of the scope, null if the tracing was disabled.
+	std::int64_t start; ///< The time the scope was entered.
+};
+
+#define TRACE_SCOPE_CONCATENATE_(a, b) a##b
+#define TRACE_SCOPE_CONCATENATE(a, b) TRACE_SCOPE_CONCATENATE_(a, b)
+#ifdef LOGGING_NO_TRACING
+	#define TRACE_SCOPE(name)
+#else
+	#define TRACE_SCOPE(name) logging::TraceScope TRACE_SCOPE_CONCATENATE(traceScope, __LINE__)(name)
+#endif
+
+} /* namespace logging */
+#endif /* TRACER_HPP_ */
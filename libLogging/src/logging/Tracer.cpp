@@ -0,0 +1,246 @@
+/*
+ * Tracer.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "logging/Tracer.hpp"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <ios>
+
+using std::string;
+using std::vector;
+using std::map;
+using std::shared_ptr;
+using std::make_shared;
+using std::ostringstream;
+using std::ofstream;
+using std::ios_base;
+using std::int64_t;
+using std::uint32_t;
+using std::uint64_t;
+
+namespace logging {
+
+static const int binsPerOctave = 8; ///< The number of histogram bins per power of two nanoseconds.
+static const int binCount = 48 * binsPerOctave; ///< The number of histogram bins (up to 2^48 ns, about three days).
+
+/**
+ * Determines the histogram bin of a duration.
+ */
+static int getBin(int64_t duration)
+{
+	if (duration <= 1)
+		return 0;
+	int bin = static_cast<int>(std::log2(static_cast<double>(duration)) * binsPerOctave);
+	return std::min(bin, binCount - 1);
+}
+
+/**
+ * Escapes a string for use in JSON.
+ */
+static string escapeJson(const string& text)
+{
+	ostringstream escaped;
+	for (char c : text) {
+		if (c == '"' || c == '\\')
+			escaped << '\\' << c;
+		else if (static_cast<unsigned char>(c) < 0x20)
+			escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+		else
+			escaped << c;
+	}
+	return escaped.str();
+}
+
+Tracer::Tracer() : enabled(false), eventLimit(100000), buffersMutex(), buffers()
+{
+}
+
+Tracer::~Tracer()
+{
+}
+
+Tracer* Tracer::Instance()
+{
+	static Tracer instance;
+	return &instance;
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+	this->enabled.store(enabled);
+}
+
+void Tracer::setEventLimit(std::size_t limit)
+{
+	eventLimit.store(limit);
+}
+
+int64_t Tracer::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Tracer::ThreadBuffer& Tracer::getThreadBuffer()
+{
+	static thread_local ThreadBuffer* threadBuffer = nullptr;
+	if (!threadBuffer) {
+		shared_ptr<ThreadBuffer> buffer = make_shared<ThreadBuffer>();
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffer->threadId = static_cast<int>(buffers.size());
+		buffers.push_back(buffer);
+		threadBuffer = buffer.get();
+	}
+	return *threadBuffer;
+}
+
+void Tracer::record(const char* name, int64_t start, int64_t end)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+	int64_t duration = end - start;
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	Histogram& histogram = buffer.histograms[name];
+	if (histogram.bins.empty()) {
+		histogram.bins.resize(binCount, 0);
+		histogram.count = 0;
+		histogram.total = 0;
+		histogram.max = 0;
+	}
+	++histogram.bins[getBin(duration)];
+	++histogram.count;
+	histogram.total += duration;
+	histogram.max = std::max(histogram.max, duration);
+	if (buffer.events.size() < eventLimit.load(std::memory_order_relaxed))
+		buffer.events.push_back(Event{ name, start, end });
+}
+
+double Tracer::getQuantile(const vector<uint64_t>& bins, std::size_t count, double quantile)
+{
+	uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * count));
+	uint64_t sum = 0;
+	for (std::size_t bin = 0; bin < bins.size(); ++bin) {
+		sum += bins[bin];
+		if (sum >= rank && sum > 0)
+			return std::pow(2.0, (bin + 0.5) / binsPerOctave) * 1e-6; // geometric center of the bin
+	}
+	return 0;
+}
+
+vector<Tracer::Statistics> Tracer::getStatistics() const
+{
+	struct Aggregate
+	{
+		vector<uint64_t> bins;
+		std::size_t count;
+		double total;
+		int64_t max;
+	};
+	map<string, Aggregate> aggregates; // the same name may have different addresses in different translation units
+	{
+		std::lock_guard<std::mutex> buffersLock(buffersMutex);
+		for (const shared_ptr<ThreadBuffer>& buffer : buffers) {
+			std::lock_guard<std::mutex> lock(buffer->mutex);
+			for (const auto& histogram : buffer->histograms) {
+				Aggregate& aggregate = aggregates[histogram.first];
+				if (aggregate.bins.empty()) {
+					aggregate.bins.resize(binCount, 0);
+					aggregate.count = 0;
+					aggregate.total = 0;
+					aggregate.max = 0;
+				}
+				for (int bin = 0; bin < binCount; ++bin)
+					aggregate.bins[bin] += histogram.second.bins[bin];
+				aggregate.count += histogram.second.count;
+				aggregate.total += histogram.second.total;
+				aggregate.max = std::max(aggregate.max, histogram.second.max);
+			}
+		}
+	}
+	vector<Statistics> statistics;
+	statistics.reserve(aggregates.size());
+	for (const auto& aggregate : aggregates) {
+		const Aggregate& values = aggregate.second;
+		double max = values.max * 1e-6;
+		Statistics scope;
+		scope.name = aggregate.first;
+		scope.count = values.count;
+		scope.total = values.total * 1e-6;
+		scope.mean = scope.total / values.count;
+		scope.p50 = std::min(max, getQuantile(values.bins, values.count, 0.50));
+		scope.p95 = std::min(max, getQuantile(values.bins, values.count, 0.95));
+		scope.p99 = std::min(max, getQuantile(values.bins, values.count, 0.99));
+		scope.max = max;
+		statistics.push_back(scope);
+	}
+	std::sort(statistics.begin(), statistics.end(), [](const Statistics& a, const Statistics& b) {
+		return a.total > b.total;
+	});
+	return statistics;
+}
+
+string Tracer::getSummary() const
+{
+	vector<Statistics> statistics = getStatistics();
+	std::size_t nameWidth = 5;
+	for (const Statistics& scope : statistics)
+		nameWidth = std::max(nameWidth, scope.name.size());
+	ostringstream summary;
+	summary << std::left << std::setw(nameWidth) << "scope" << std::right
+			<< std::setw(10) << "count" << std::setw(12) << "total [ms]" << std::setw(11) << "mean [ms]"
+			<< std::setw(11) << "p50 [ms]" << std::setw(11) << "p95 [ms]" << std::setw(11) << "p99 [ms]" << std::setw(11) << "max [ms]" << '\n';
+	summary << std::fixed << std::setprecision(3);
+	for (const Statistics& scope : statistics) {
+		summary << std::left << std::setw(nameWidth) << scope.name << std::right
+				<< std::setw(10) << scope.count << std::setw(12) << scope.total << std::setw(11) << scope.mean
+				<< std::setw(11) << scope.p50 << std::setw(11) << scope.p95 << std::setw(11) << scope.p99 << std::setw(11) << scope.max << '\n';
+	}
+	return summary.str();
+}
+
+void Tracer::writeChromeTrace(const string& filename) const
+{
+	ofstream file(filename);
+	if (!file.is_open())
+		throw ios_base::failure("Error: Could not open or create the trace file: " + filename);
+	std::lock_guard<std::mutex> buffersLock(buffersMutex);
+	int64_t origin = std::numeric_limits<int64_t>::max();
+	for (const shared_ptr<ThreadBuffer>& buffer : buffers) {
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+		for (const Event& event : buffer->events)
+			origin = std::min(origin, event.start);
+	}
+	file << "{\"traceEvents\":[";
+	file << std::fixed << std::setprecision(3);
+	bool first = true;
+	for (const shared_ptr<ThreadBuffer>& buffer : buffers) {
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+		for (const Event& event : buffer->events) {
+			file << (first ? "\n" : ",\n");
+			first = false;
+			// the timestamps and durations are in microseconds
+			file << "{\"name\":\"" << escapeJson(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+					<< ",\"ts\":" << (event.start - origin) * 1e-3 << ",\"dur\":" << (event.end - event.start) * 1e-3 << "}";
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Tracer::reset()
+{
+	std::lock_guard<std::mutex> buffersLock(buffersMutex);
+	for (const shared_ptr<ThreadBuffer>& buffer : buffers) {
+		std::lock_guard<std::mutex> lock(buffer->mutex);
+		buffer->histograms.clear();
+		buffer->events.clear();
+	}
+}
+
+} /* namespace logging */
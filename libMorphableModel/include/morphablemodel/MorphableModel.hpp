@@ -63,6 +63,62 @@ public:
 	static MorphableModel loadStatismoModel(boost::filesystem::path h5file);
 
 	static std::vector<cv::Vec2f> loadIsomap(boost::filesystem::path isomapFile);
+
+	/**
+	 * Loads the vertex ids of the original model of a submodel,
+	 * one id per line.
+	 *
+	 * @param[in] vertexIdsFile A text file containing the vertex ids.
+	 * @return The vertex ids of the original model.
+	 */
+	static std::vector<int> loadVertexIds(boost::filesystem::path vertexIdsFile);
+
+	/**
+	 * Saves the model in the Surrey .scm format, i.e. in the format
+	 * that loadScmModel(...) reads. The isomap and the vertex ids of
+	 * the original model (if it's a submodel) are stored in separate
+	 * text files, they are skipped if the paths are empty.
+	 * Note: When loading the isomap again, the texture coordinates
+	 * are rescaled to [0, 1], so the isomap of a submodel covers the
+	 * whole texture map.
+	 *
+	 * @param[in] modelFile The binary .scm-file to write the shape- and color model to.
+	 * @param[in] isomapFile The text file to write the texture coordinates to.
+	 * @param[in] vertexIdsFile The text file to write the vertex ids of the original model to.
+	 */
+	void saveScmModel(boost::filesystem::path modelFile, boost::filesystem::path isomapFile, boost::filesystem::path vertexIdsFile) const;
+
+	/**
+	 * Extracts a submodel that only consists of the given vertices, e.g.
+	 * only the face without the neck, ears and back of the head. Fitting
+	 * and rendering the submodel only touches these vertices. The shape-
+	 * and color models and the texture coordinates are sliced, and the
+	 * triangles are re-indexed (see PcaModel::extractSubmodel(...)).
+	 *
+	 * @param[in] vertexIds The vertex ids of this model to keep.
+	 * @return The submodel.
+	 */
+	MorphableModel extractSubmodel(std::vector<int> vertexIds) const;
+
+	/**
+	 * Selects the vertices whose texture coordinates lie on a
+	 * non-zero pixel of a mask in the isomap (texture map) space.
+	 *
+	 * @param[in] mask A single-channel mask of type CV_8UC1, with the layout of the isomap.
+	 * @return The vertex ids of the selected vertices.
+	 * @throws runtime_error exception if the model has no texture coordinates.
+	 */
+	std::vector<int> getVerticesInIsomapMask(cv::Mat mask) const;
+
+	/**
+	 * Selects the vertices of the mean shape that are within a given
+	 * distance of at least one of the given landmarks.
+	 *
+	 * @param[in] landmarkIdentifiers The landmark identifiers. At the moment, these are the vertex ids.
+	 * @param[in] radius The maximum distance to a landmark, in model units.
+	 * @return The vertex ids of the selected vertices.
+	 */
+	std::vector<int> getVerticesAroundLandmarks(std::vector<std::string> landmarkIdentifiers, float radius) const;
 	
 	PcaModel getShapeModel() const;
 	PcaModel getColorModel() const;
@@ -112,7 +168,7 @@ public:
 	 * @param[in] colorCoefficients The PCA coefficients used to generate the shape sample.
 	 * @return A model instance with given coefficients.
 	 */
-	render::Mesh drawSample(std::vector<float> shapeCoefficients, std::vector<float> colorCoefficients);
+	render::Mesh drawSample(std::vector<float> shapeCoefficients, std::vector<float> colorCoefficients) const;
 
 	//void setHasTextureCoordinates(bool hasTextureCoordinates);
 	
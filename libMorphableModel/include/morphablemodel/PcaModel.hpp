@@ -153,7 +153,7 @@ public:
 	 * @param[in] coefficients The PCA coefficients used to generate the sample.
 	 * @return A model instance with given coefficients.
 	 */
-	cv::Mat drawSample(std::vector<float> coefficients);
+	cv::Mat drawSample(std::vector<float> coefficients) const;
 
 	/**
 	* Returns The PCA basis matrix, i.e. the eigenvectors.
@@ -181,6 +181,17 @@ public:
 	*/
 	cv::Mat getNormalizedPcaBasis(std::string landmarkIdentifier) const;
 
+	/**
+	* Returns The unnormalized PCA basis matrix, i.e. the eigenvectors
+	* as they are stored in the .scm files. Each column of the matrix
+	* is an eigenvector.
+	* Returns a clone of the matrix so that the original cannot
+	* be modified.
+	*
+	* @return Returns the unnormalized PCA basis matrix.
+	*/
+	cv::Mat getUnnormalizedPcaBasis() const;
+
 	/**
 	* Returns the PCA basis for a particular vertex. The vertex
 	* is specified by a landmark identifier that the model can
@@ -206,7 +217,53 @@ public:
 	*/
 	bool landmarkExists(std::string landmarkIdentifier) const;
 
+	/**
+	* Extracts a submodel that only consists of the given vertices,
+	* e.g. only the face without the neck, ears and back of the head.
+	* The mean and the bases are sliced, the triangles that have
+	* all three vertices in the subset are kept and re-indexed, the
+	* others are dropped. The eigenvalues stay the same.
+	*
+	* The submodel remembers the vertex ids of the original model, so
+	* the landmark identifiers (vertex ids of the original model) can
+	* still be used with it. Landmarks outside of the subset don't
+	* exist in the submodel.
+	*
+	* @param[in] vertexIds The vertex ids of this model to keep. They are sorted and duplicates are removed.
+	* @return The submodel.
+	* @throws out_of_range exception if a vertex id does not exist in the model.
+	*/
+	PcaModel extractSubmodel(std::vector<int> vertexIds) const;
+
+	/**
+	* Returns the vertex ids of the original model for each vertex,
+	* if this model is a submodel. Empty otherwise.
+	*
+	* @return The vertex ids of the original model.
+	*/
+	std::vector<int> getOriginalVertexIds() const;
+
+	/**
+	* Sets the vertex ids of the original model for each vertex, i.e.
+	* makes this model a submodel. Used when loading a submodel from a
+	* file, where they are stored separately.
+	*
+	* @param[in] originalVertexIds The vertex ids of the original model, one per vertex. Empty makes this model an original model again.
+	* @throws invalid_argument exception if the number of ids is not equal to the number of vertices.
+	*/
+	void setOriginalVertexIds(std::vector<int> originalVertexIds);
+
 private:
+	/**
+	* Translates a landmark identifier (the vertex id in the original
+	* model) to the vertex number in this model.
+	*
+	* @param[in] landmarkIdentifier A landmark identifier. At the moment, this is the vertex id.
+	* @return The vertex number in this model, or -1 if it doesn't exist.
+	*/
+	int getVertexNumber(std::string landmarkIdentifier) const;
+
+
 	std::mt19937 engine; ///< A Mersenne twister MT19937 engine
 	std::map<std::string, int> landmarkVertexMap; ///< Holds the translation from feature point name (e.g. "center.nose.tip") to the vertex number in the model
 	
@@ -217,6 +274,9 @@ private:
 	cv::Mat eigenvalues; ///< A col-vector of the eigenvalues (variances in the PCA space).
 
 	std::vector<std::array<int, 3>> triangleList; ///< List of triangles that make up the mesh of the model. (Note: Does every PCA model has a triangle-list? Use Mesh here instead?)
+
+	std::vector<int> originalVertexIds; ///< The vertex id in the original model of each vertex, if this is a submodel. Empty otherwise.
+	std::map<int, int> originalVertexNumbers; ///< The translation from a vertex id in the original model to the vertex number in this submodel.
 };
 
 /**
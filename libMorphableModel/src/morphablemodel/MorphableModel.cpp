@@ -10,7 +10,11 @@
 #include "opencv2/core/core.hpp"
 #include "boost/lexical_cast.hpp"
 #include "boost/filesystem/path.hpp"
+#include "boost/algorithm/string/trim.hpp"
 #include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
 #include <sstream>
 #include <fstream>
 
@@ -39,6 +43,12 @@ morphablemodel::MorphableModel MorphableModel::load(const boost::property_tree::
 		path vertexMappingFile = configTree.get<path>("vertexMapping");
 		path isomapFile = configTree.get<path>("isomap", "");
 		morphableModel = MorphableModel::loadScmModel(filename.string(), vertexMappingFile, isomapFile);
+		path vertexIdsFile = configTree.get<path>("vertexIds", ""); // only for submodels
+		if (!vertexIdsFile.empty()) {
+			vector<int> vertexIds = MorphableModel::loadVertexIds(vertexIdsFile);
+			morphableModel.shapeModel.setOriginalVertexIds(vertexIds);
+			morphableModel.colorModel.setOriginalVertexIds(vertexIds);
+		}
 	}
 	else if (filename.extension().string() == ".h5") {
 		morphableModel = MorphableModel::loadStatismoModel(filename.string());
@@ -155,7 +165,7 @@ render::Mesh MorphableModel::drawSample(float sigma /*= 1.0f*/)
 	return mean;
 }
 
-render::Mesh MorphableModel::drawSample(vector<float> shapeCoefficients, vector<float> colorCoefficients)
+render::Mesh MorphableModel::drawSample(vector<float> shapeCoefficients, vector<float> colorCoefficients) const
 {
 	render::Mesh sample;
 
@@ -233,6 +243,152 @@ vector<Vec2f> MorphableModel::loadIsomap(path isomapFile)
 	return texCoords;
 }
 
+vector<int> MorphableModel::loadVertexIds(path vertexIdsFile)
+{
+	std::ifstream file(vertexIdsFile.string());
+	if (!file.is_open()) {
+		throw std::runtime_error("MorphableModel: Could not open the vertex ids file: " + vertexIdsFile.string());
+	}
+	vector<int> vertexIds;
+	string line;
+	while (getline(file, line)) {
+		boost::algorithm::trim(line);
+		if (!line.empty()) {
+			vertexIds.push_back(lexical_cast<int>(line));
+		}
+	}
+	return vertexIds;
+}
+
+/**
+ * Writes a shape- or color model to an .scm-file, in the
+ * order and with the data types that PcaModel::loadScmModel(...)
+ * reads them.
+ */
+static void writeScmPcaModel(std::ofstream& modelFile, const PcaModel& model)
+{
+	Mat basis = model.getUnnormalizedPcaBasis();
+	Mat mean = model.getMean();
+	uint32_t numPcaCoeffs = basis.cols;
+	uint32_t numDims = basis.rows;
+	modelFile.write(reinterpret_cast<const char*>(&numPcaCoeffs), 4);
+	modelFile.write(reinterpret_cast<const char*>(&numDims), 4);
+	for (int col = 0; col < basis.cols; ++col) { // the basis is stored column by column
+		for (int row = 0; row < basis.rows; ++row) {
+			double value = basis.at<float>(row, col);
+			modelFile.write(reinterpret_cast<const char*>(&value), 8);
+		}
+	}
+	uint32_t numMean = mean.rows;
+	modelFile.write(reinterpret_cast<const char*>(&numMean), 4);
+	for (int row = 0; row < mean.rows; ++row) {
+		double value = mean.at<float>(row);
+		modelFile.write(reinterpret_cast<const char*>(&value), 8);
+	}
+	modelFile.write(reinterpret_cast<const char*>(&numPcaCoeffs), 4); // number of eigenvalues
+	for (unsigned int i = 0; i < numPcaCoeffs; ++i) {
+		double value = model.getEigenvalue(i);
+		modelFile.write(reinterpret_cast<const char*>(&value), 8);
+	}
+}
+
+void MorphableModel::saveScmModel(path modelFile, path isomapFile, path vertexIdsFile) const
+{
+	std::ofstream file(modelFile.string(), std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("MorphableModel: Could not open the model file for writing: " + modelFile.string());
+	}
+	vector<std::array<int, 3>> triangleList = shapeModel.getTriangleList();
+	uint32_t numVertices = shapeModel.getDataDimension() / 3;
+	uint32_t numTriangles = triangleList.size();
+	file.write(reinterpret_cast<const char*>(&numVertices), 4);
+	file.write(reinterpret_cast<const char*>(&numTriangles), 4);
+	for (const auto& triangle : triangleList) {
+		for (int vertex : triangle) {
+			uint32_t vertexId = vertex;
+			file.write(reinterpret_cast<const char*>(&vertexId), 4);
+		}
+	}
+	writeScmPcaModel(file, shapeModel);
+	writeScmPcaModel(file, colorModel);
+	if (!file) {
+		throw std::runtime_error("MorphableModel: Error while writing the model file: " + modelFile.string());
+	}
+
+	if (!isomapFile.empty() && hasTextureCoordinates) {
+		std::ofstream isomap(isomapFile.string());
+		for (const auto& texCoord : textureCoordinates) {
+			isomap << texCoord[0] << " " << 1.0f - texCoord[1] << std::endl; // loadIsomap(...) flips the y-coords
+		}
+	}
+	vector<int> originalVertexIds = shapeModel.getOriginalVertexIds();
+	if (!vertexIdsFile.empty() && !originalVertexIds.empty()) {
+		std::ofstream vertexIds(vertexIdsFile.string());
+		for (int vertexId : originalVertexIds) {
+			vertexIds << vertexId << std::endl;
+		}
+	}
+}
+
+MorphableModel MorphableModel::extractSubmodel(vector<int> vertexIds) const
+{
+	std::sort(begin(vertexIds), end(vertexIds));
+	vertexIds.erase(std::unique(begin(vertexIds), end(vertexIds)), end(vertexIds));
+	MorphableModel submodel;
+	submodel.shapeModel = shapeModel.extractSubmodel(vertexIds);
+	submodel.colorModel = colorModel.extractSubmodel(vertexIds);
+	submodel.hasTextureCoordinates = hasTextureCoordinates;
+	if (hasTextureCoordinates) {
+		for (int vertexId : vertexIds) {
+			submodel.textureCoordinates.push_back(textureCoordinates[vertexId]);
+		}
+	}
+	Loggers->getLogger("morphablemodel").debug("Extracted a submodel with " + lexical_cast<string>(vertexIds.size()) + " of " + lexical_cast<string>(shapeModel.getDataDimension() / 3) + " vertices and " + lexical_cast<string>(submodel.shapeModel.getTriangleList().size()) + " triangles.");
+	return submodel;
+}
+
+vector<int> MorphableModel::getVerticesInIsomapMask(Mat mask) const
+{
+	if (!hasTextureCoordinates) {
+		throw std::runtime_error("MorphableModel: The model has no texture coordinates, can't select vertices using an isomap mask.");
+	}
+	if (mask.type() != CV_8UC1) {
+		throw std::runtime_error("MorphableModel: The isomap mask has to be of type CV_8UC1.");
+	}
+	vector<int> vertexIds;
+	for (int i = 0; i < textureCoordinates.size(); ++i) {
+		// Same mapping of texture coordinates to pixels as in the renderer
+		int x = std::min(std::max(static_cast<int>(textureCoordinates[i][0] * mask.cols), 0), mask.cols - 1);
+		int y = std::min(std::max(static_cast<int>(textureCoordinates[i][1] * mask.rows), 0), mask.rows - 1);
+		if (mask.at<uchar>(y, x) != 0) {
+			vertexIds.push_back(i);
+		}
+	}
+	return vertexIds;
+}
+
+vector<int> MorphableModel::getVerticesAroundLandmarks(vector<string> landmarkIdentifiers, float radius) const
+{
+	vector<Vec3f> landmarkPoints;
+	for (const auto& landmarkIdentifier : landmarkIdentifiers) {
+		landmarkPoints.push_back(shapeModel.getMeanAtPoint(landmarkIdentifier));
+	}
+	vector<int> vertexIds;
+	float radiusSquared = radius * radius;
+	unsigned int numVertices = shapeModel.getDataDimension() / 3;
+	for (unsigned int i = 0; i < numVertices; ++i) {
+		Vec3f vertex = shapeModel.getMeanAtPoint(i);
+		for (const auto& landmarkPoint : landmarkPoints) {
+			Vec3f difference = vertex - landmarkPoint;
+			if (difference.dot(difference) <= radiusSquared) {
+				vertexIds.push_back(i);
+				break;
+			}
+		}
+	}
+	return vertexIds;
+}
+
 /*void MorphableModel::setHasTextureCoordinates(bool hasTextureCoordinates)
 {
 	this->hasTextureCoordinates = hasTextureCoordinates;
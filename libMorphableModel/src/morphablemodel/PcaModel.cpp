@@ -16,6 +16,8 @@
 #include "boost/algorithm/string.hpp"
 
 #include <fstream>
+#include <algorithm>
+#include <stdexcept>
 
 using logging::LoggerFactory;
 using cv::Mat;
@@ -416,11 +418,11 @@ Mat PcaModel::getMean() const
 Vec3f PcaModel::getMeanAtPoint(string landmarkIdentifier) const
 {
 	//int vertexId = landmarkVertexMap.at(landmarkIdentifier); // TODO hack. Do proper.
-	int vertexId = boost::lexical_cast<int>(landmarkIdentifier);
-	vertexId *= 3;
-	if (vertexId >= mean.rows) {
-		throw std::out_of_range("The given vertex id is larger than the dimension of the mean.");
+	int vertexId = getVertexNumber(landmarkIdentifier);
+	if (vertexId < 0) {
+		throw std::out_of_range("The given vertex id does not exist in the model.");
 	}
+	vertexId *= 3;
 	return Vec3f(mean.at<float>(vertexId), mean.at<float>(vertexId+1), mean.at<float>(vertexId+2)); // we could use Vec3f(mean(Range(), Range())), maybe then we don't copy the data?
 }
 
@@ -456,7 +458,7 @@ Mat PcaModel::drawSample(float sigma/*=1.0f*/)
 	*/
 }
 
-Mat PcaModel::drawSample(vector<float> coefficients)
+Mat PcaModel::drawSample(vector<float> coefficients) const
 {
 	Mat alphas(coefficients);
 	/*
@@ -485,7 +487,10 @@ cv::Mat PcaModel::getNormalizedPcaBasis() const
 cv::Mat PcaModel::getNormalizedPcaBasis(std::string landmarkIdentifier) const
 {
 	//int vertexId = landmarkVertexMap.at(landmarkIdentifier); // Todo: Hacky
-	int vertexId = boost::lexical_cast<int>(landmarkIdentifier); // Document behaviour. What to pass?
+	int vertexId = getVertexNumber(landmarkIdentifier); // Document behaviour. What to pass?
+	if (vertexId < 0) {
+		throw std::out_of_range("The given vertex id does not exist in the model.");
+	}
 	vertexId *= 3;
 	/*
 	Mat sqrtOfEigenvalues = eigenvalues.clone();
@@ -508,21 +513,90 @@ cv::Mat PcaModel::getNormalizedPcaBasis(std::string landmarkIdentifier) const
 	return normalizedPcaBasis.rowRange(vertexId, vertexId + 3);
 }
 
+cv::Mat PcaModel::getUnnormalizedPcaBasis() const
+{
+	return unnormalizedPcaBasis.clone();
+}
+
 float PcaModel::getEigenvalue(unsigned int index) const
 {
 	return eigenvalues.at<float>(index);
 }
 
 bool PcaModel::landmarkExists(std::string landmarkIdentifier) const
+{
+	return getVertexNumber(landmarkIdentifier) >= 0;
+}
+
+PcaModel PcaModel::extractSubmodel(vector<int> vertexIds) const
+{
+	std::sort(begin(vertexIds), end(vertexIds));
+	vertexIds.erase(std::unique(begin(vertexIds), end(vertexIds)), end(vertexIds));
+	int numVertices = mean.rows / 3;
+	if (!vertexIds.empty() && (vertexIds.front() < 0 || vertexIds.back() >= numVertices)) {
+		throw std::out_of_range("PcaModel: A vertex id of the submodel does not exist in the model.");
+	}
+
+	PcaModel submodel;
+	submodel.eigenvalues = eigenvalues.clone();
+	submodel.mean.create(3 * vertexIds.size(), 1, mean.type());
+	submodel.normalizedPcaBasis.create(3 * vertexIds.size(), normalizedPcaBasis.cols, normalizedPcaBasis.type());
+	submodel.unnormalizedPcaBasis.create(3 * vertexIds.size(), unnormalizedPcaBasis.cols, unnormalizedPcaBasis.type());
+	vector<int> newVertexNumbers(numVertices, -1); // the vertex number in the submodel of each vertex of this model, -1 if it's not part of it
+	for (int i = 0; i < vertexIds.size(); ++i) {
+		int vertexId = vertexIds[i];
+		newVertexNumbers[vertexId] = i;
+		mean.rowRange(3 * vertexId, 3 * vertexId + 3).copyTo(submodel.mean.rowRange(3 * i, 3 * i + 3));
+		normalizedPcaBasis.rowRange(3 * vertexId, 3 * vertexId + 3).copyTo(submodel.normalizedPcaBasis.rowRange(3 * i, 3 * i + 3));
+		unnormalizedPcaBasis.rowRange(3 * vertexId, 3 * vertexId + 3).copyTo(submodel.unnormalizedPcaBasis.rowRange(3 * i, 3 * i + 3));
+		// Chained extraction: The ids always refer to the very first model, because that's what the landmarks use
+		int originalVertexId = originalVertexIds.empty() ? vertexId : originalVertexIds[vertexId];
+		submodel.originalVertexIds.push_back(originalVertexId);
+		submodel.originalVertexNumbers.insert(std::make_pair(originalVertexId, i));
+	}
+
+	for (const auto& triangle : triangleList) {
+		array<int, 3> newTriangle = { newVertexNumbers[triangle[0]], newVertexNumbers[triangle[1]], newVertexNumbers[triangle[2]] };
+		if (newTriangle[0] >= 0 && newTriangle[1] >= 0 && newTriangle[2] >= 0) {
+			submodel.triangleList.push_back(newTriangle);
+		}
+	}
+	for (const auto& landmark : landmarkVertexMap) {
+		if (landmark.second >= 0 && landmark.second < numVertices && newVertexNumbers[landmark.second] >= 0) {
+			submodel.landmarkVertexMap.insert(std::make_pair(landmark.first, newVertexNumbers[landmark.second]));
+		}
+	}
+	return submodel;
+}
+
+vector<int> PcaModel::getOriginalVertexIds() const
+{
+	return originalVertexIds;
+}
+
+void PcaModel::setOriginalVertexIds(vector<int> originalVertexIds)
+{
+	if (!originalVertexIds.empty() && originalVertexIds.size() != mean.rows / 3) {
+		throw std::invalid_argument("PcaModel: The number of original vertex ids (" + lexical_cast<string>(originalVertexIds.size()) + ") is not equal to the number of vertices (" + lexical_cast<string>(mean.rows / 3) + ").");
+	}
+	this->originalVertexIds = originalVertexIds;
+	originalVertexNumbers.clear();
+	for (int i = 0; i < originalVertexIds.size(); ++i) {
+		originalVertexNumbers.insert(std::make_pair(originalVertexIds[i], i));
+	}
+}
+
+int PcaModel::getVertexNumber(string landmarkIdentifier) const
 {
 	int vertexId = boost::lexical_cast<int>(landmarkIdentifier);
-	vertexId *= 3;
-	if (vertexId >= mean.rows) {
-		return false;
+	if (!originalVertexIds.empty()) {
+		auto vertexNumber = originalVertexNumbers.find(vertexId);
+		return vertexNumber == originalVertexNumbers.end() ? -1 : vertexNumber->second;
 	}
-	else {
-		return true;
+	if (vertexId < 0 || 3 * vertexId >= mean.rows) {
+		return -1;
 	}
+	return vertexId;
 }
 
 cv::Mat normalizePcaBasis(cv::Mat unnormalizedBasis, cv::Mat eigenvalues)
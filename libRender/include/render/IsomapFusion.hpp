@@ -0,0 +1,140 @@
+/*
+ * IsomapFusion.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef ISOMAPFUSION_HPP_
+#define ISOMAPFUSION_HPP_
+
+#include "render/Mesh.hpp"
+
+#include "opencv2/core/core.hpp"
+
+#include <vector>
+#include <array>
+
+namespace render {
+
+/**
+ * Fuses the textures of several views of the same face (e.g. the fitted
+ * frames of a video) into one isomap. Where extractTexture(...) produces the
+ * texture of a single view, this class merges the visible texels of every
+ * frame into a running weighted average, as the frames arrive. The memory
+ * stays constant, independent of the number of frames.
+ *
+ * The weight of a texel in a frame is the product of:
+ *   - the cosine of the angle between the surface normal and the viewing
+ *     direction (to the power of angleExponent), so frontal views of a
+ *     region dominate over grazing ones,
+ *   - the distance of the texel's image position from the nearest occlusion
+ *     edge (silhouette or mesh boundary), relative to edgeDistance and capped
+ *     at 1, because the fitting is least accurate there and the background
+ *     bleeds in,
+ *   - the sharpness of the frame (mean squared Laplacian of the face region,
+ *     to the power of sharpnessExponent), so blurry frames contribute less.
+ *
+ * Unlike extractTexture(...), the visibility is checked per texel instead of
+ * per triangle, so partially occluded triangles contribute their visible part.
+ * The viewing direction is derived from the linear part of the MVP matrix,
+ * which is exact for affine cameras (as used by the fitting).
+ */
+class IsomapFusion
+{
+public:
+	/**
+	 * Constructs a new isomap fusion without any frames.
+	 *
+	 * @param[in] isomapResolution The width and height of the fused isomap.
+	 * @param[in] threadCount The number of threads that process the texels of a frame, 0 for the number of hardware threads.
+	 * @param[in] edgeDistance The distance in pixels from an occlusion edge at which texels get the full weight. 0 disables the edge weighting.
+	 * @param[in] angleExponent The exponent of the cosine of the viewing angle. 0 disables the angle weighting.
+	 * @param[in] sharpnessExponent The exponent of the frame sharpness. 0 disables the sharpness weighting.
+	 */
+	IsomapFusion(int isomapResolution = 512, unsigned int threadCount = 1, float edgeDistance = 10.0f, float angleExponent = 2.0f, float sharpnessExponent = 1.0f);
+
+	/**
+	 * Merges the visible texels of a frame into the fused isomap. The
+	 * parameters are the same as for extractTexture(...).
+	 *
+	 * @param[in] mesh The fitted mesh of the frame, with texture coordinates.
+	 * @param[in] mvpMatrix The 4x4 model-view-projection matrix (CV_32FC1) of the frame.
+	 * @param[in] viewportWidth The width of the viewport the mesh was rendered to.
+	 * @param[in] viewportHeight The height of the viewport the mesh was rendered to.
+	 * @param[in] image The frame to extract the texture from, CV_8UC3.
+	 * @param[in] depthBuffer The depth buffer (CV_64FC1) of rendering the mesh with the MVP matrix.
+	 */
+	void addFrame(const render::Mesh& mesh, cv::Mat mvpMatrix, int viewportWidth, int viewportHeight, cv::Mat image, cv::Mat depthBuffer);
+
+	/**
+	 * Removes all frames.
+	 */
+	void reset();
+
+	/**
+	 * @return The number of frames that were merged since the last reset.
+	 */
+	std::size_t getNumFrames() const;
+
+	/**
+	 * Returns the fused isomap, i.e. the weighted average of all frames.
+	 * Texels that were not visible in any frame are black.
+	 *
+	 * @return The fused isomap, CV_8UC3.
+	 */
+	cv::Mat getIsomap() const;
+
+	/**
+	 * Returns the accumulated weight of each texel. It can be used as a
+	 * confidence map of the fused isomap.
+	 *
+	 * @return The sum of the weights of all frames, CV_32FC1.
+	 */
+	cv::Mat getWeights() const;
+
+private:
+	/**
+	 * A triangle of the mesh, set up for the current frame.
+	 */
+	struct TriangleSetup
+	{
+		std::array<cv::Vec2f, 3> texel; ///< The vertices in texel coordinates of the isomap.
+		std::array<cv::Vec2f, 3> screen; ///< The vertices in screen coordinates.
+		std::array<float, 3> depth; ///< The depth of the vertices after the w-division.
+		cv::Matx22f texelToBarycentric; ///< Maps a texel position, relative to the first vertex, to the second and third barycentric coordinate.
+		cv::Matx22f screenToBarycentric; ///< Maps a screen position, relative to the first vertex, to the second and third barycentric coordinate.
+		float depthTolerance; ///< The tolerance of the depth test (a hundredth of the depth change per pixel).
+		float weight; ///< The weight of the triangle in this frame (view angle and sharpness).
+		int minX, maxX, minY, maxY; ///< The bounding box in the isomap.
+	};
+
+	/**
+	 * Merges the texels of the given rows of the isomap.
+	 */
+	void accumulateRows(int rowBegin, int rowEnd, const std::vector<TriangleSetup>& triangles, const cv::Mat& image, const cv::Mat& depthBuffer, const cv::Mat& edgeWeights);
+
+	/**
+	 * Collects the edges of the mesh and their adjacent triangles, if the
+	 * triangle list changed since the last frame.
+	 */
+	void updateEdges(const render::Mesh& mesh);
+
+	int isomapResolution; ///< The width and height of the isomap.
+	unsigned int threadCount; ///< The number of threads, 0 for the number of hardware threads.
+	float edgeDistance; ///< The distance in pixels from an occlusion edge at which texels get the full weight.
+	float angleExponent; ///< The exponent of the cosine of the viewing angle.
+	float sharpnessExponent; ///< The exponent of the frame sharpness.
+
+	std::size_t numFrames; ///< The number of frames merged since the last reset.
+	cv::Mat colorSum; ///< The weighted sum of the colors of all frames, CV_32FC3.
+	cv::Mat weightSum; ///< The sum of the weights of all frames, CV_32FC1.
+
+	std::vector<std::array<int, 3>> edgeTriangles; ///< The triangle list that the edges were collected from.
+	std::vector<std::array<int, 4>> edges; ///< The edges of the mesh: two vertex indices and the indices of the adjacent triangles (the second is -1 for boundary edges).
+};
+
+} /* namespace render */
+
+#endif /* ISOMAPFUSION_HPP_ */
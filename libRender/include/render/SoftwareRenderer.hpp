@@ -11,6 +11,8 @@
 
 #include "render/Mesh.hpp"
 #include "render/MatrixUtils.hpp"
+#include "render/VertexNormals.hpp"
+#include "render/SphericalHarmonicsLighting.hpp"
 
 #include "opencv2/core/core.hpp"
 #include "boost/optional/optional.hpp"
@@ -46,6 +48,32 @@ public:
 	// clone.
 	std::pair<cv::Mat, cv::Mat> render(Mesh mesh, cv::Mat mvp);
 
+	/**
+	 * Renders the mesh lit by the given illumination. The irradiance is
+	 * computed per vertex from the vertex normals (see VertexNormals) and
+	 * interpolated like the vertex colors, so the cost per pixel is the same
+	 * as without lighting. Without texturing, the vertex colors are multiplied
+	 * with the irradiance, with texturing the texture colors are.
+	 *
+	 * @param[in] mesh The mesh.
+	 * @param[in] mvp The model-view-projection matrix.
+	 * @param[in] lighting The illumination, in the coordinate system of the mesh.
+	 * @return The color- and depth-buffer.
+	 */
+	std::pair<cv::Mat, cv::Mat> render(const Mesh& mesh, cv::Mat mvp, const SphericalHarmonicsLighting& lighting);
+
+	/**
+	 * Renders the mesh once for each of the given illuminations. The vertices
+	 * are transformed and their normals computed only once for all of them.
+	 * The returned buffers are independent of each other.
+	 *
+	 * @param[in] mesh The mesh.
+	 * @param[in] mvp The model-view-projection matrix.
+	 * @param[in] lightings The illuminations, in the coordinate system of the mesh.
+	 * @return The color- and depth-buffer of each illumination.
+	 */
+	std::vector<std::pair<cv::Mat, cv::Mat>> render(const Mesh& mesh, cv::Mat mvp, const std::vector<SphericalHarmonicsLighting>& lightings);
+
 	cv::Vec3f projectVertex(cv::Vec4f vertex, cv::Mat mvp);
 	
 	void enableTexturing(bool doTexturing) {
@@ -63,10 +91,17 @@ private:
 	unsigned int viewportHeight = 480;
 	float aspect;
 
+	// Lighting:
+	VertexNormals vertexNormals; ///< Caches the topology of the last lit mesh.
+	bool modulateTexture = false; ///< If true, the texture colors are multiplied with the interpolated vertex colors (the irradiance).
+
 	// Texturing:
 	std::shared_ptr<Texture> currentTexture;
 	float dudx, dudy, dvdx, dvdy; // partial derivatives of U/V coordinates with respect to X/Y pixel's screen coordinates
 
+	std::vector<Vertex> transformVertices(const Mesh& mesh, cv::Mat mvp); ///< The vertex stage: Transforms the vertices to clip-space.
+	std::pair<cv::Mat, cv::Mat> rasterize(const std::vector<std::array<int, 3>>& triangles, const std::vector<Vertex>& clipSpaceVertices); ///< Clears the buffers, clips and rasterizes the triangles.
+
 	// Todo: Split this function into the general (core-part) and the texturing part.
 	// Then, utils::extractTexture can re-use the core-part.
 	boost::optional<TriangleToRasterize> processProspectiveTri(Vertex v0, Vertex v1, Vertex v2);
@@ -0,0 +1,89 @@
+/*
+ * SphericalHarmonicsLighting.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef SPHERICALHARMONICSLIGHTING_HPP_
+#define SPHERICALHARMONICSLIGHTING_HPP_
+
+#include "opencv2/core/core.hpp"
+
+#include <vector>
+#include <array>
+
+namespace render {
+
+/**
+ * Distant illumination of a Lambertian surface, represented by 2nd-order
+ * spherical harmonics (9 RGB coefficients). The irradiance at a surface point
+ * with unit normal n = (x, y, z) is
+ *   E(n) = sum_i coefficients[i] * H_i(n),
+ * where H_i are the real spherical harmonics up to order 2, convolved with the
+ * clamped cosine (Ramamoorthi and Hanrahan, An Efficient Representation for
+ * Irradiance Environment Maps, 2001) and scaled such that H_0 = 1:
+ *   H_0 = 1,
+ *   H_1 = 2/sqrt(3) * y, H_2 = 2/sqrt(3) * z, H_3 = 2/sqrt(3) * x,
+ *   H_4 = sqrt(15)/4 * xy, H_5 = sqrt(15)/4 * yz, H_6 = sqrt(5)/8 * (3z^2 - 1),
+ *   H_7 = sqrt(15)/4 * xz, H_8 = sqrt(15)/8 * (x^2 - y^2).
+ * So the coefficients (1, 0, ..., 0) leave the colors unchanged, and the
+ * first-order coefficients are the direction of the dominant light.
+ *
+ * The normals are given in the coordinate system of the mesh (the +z axis
+ * points to the camera in an unrotated view), so the light is attached to the
+ * face. The irradiance is clamped to be non-negative.
+ */
+class SphericalHarmonicsLighting
+{
+public:
+	/**
+	 * Constructs a neutral lighting, i.e. a constant irradiance of 1.
+	 */
+	SphericalHarmonicsLighting();
+
+	/**
+	 * Constructs a lighting from the SH coefficients.
+	 *
+	 * @param[in] coefficients The RGB coefficients of the basis functions H_0 to H_8.
+	 */
+	explicit SphericalHarmonicsLighting(std::array<cv::Vec3f, 9> coefficients);
+
+	/**
+	 * Creates a lighting with an ambient part and a single directional light.
+	 * The 2nd-order approximation of the directional light is smooth, a surface
+	 * facing the light gets about 1.06 times its color and a surface facing
+	 * away about 0.06 times.
+	 *
+	 * @param[in] ambient The constant RGB irradiance.
+	 * @param[in] direction The direction to the light (in mesh coordinates), doesn't need to be normalised.
+	 * @param[in] color The RGB irradiance of the light on a surface facing it.
+	 * @return The lighting.
+	 */
+	static SphericalHarmonicsLighting createDirectional(cv::Vec3f ambient, cv::Vec3f direction, cv::Vec3f color);
+
+	/**
+	 * Computes the irradiance of a single surface normal.
+	 *
+	 * @param[in] normal A unit normal.
+	 * @return The RGB irradiance.
+	 */
+	cv::Vec3f getIrradiance(const cv::Vec3f& normal) const;
+
+	/**
+	 * Computes the irradiance of many normals, four at a time with SSE if
+	 * available. The result is the same as calling getIrradiance(...) for
+	 * every normal (up to rounding).
+	 *
+	 * @param[in] normals Unit normals.
+	 * @param[out] irradiance The RGB irradiance of each normal.
+	 */
+	void getIrradiance(const std::vector<cv::Vec3f>& normals, std::vector<cv::Vec3f>& irradiance) const;
+
+	std::array<cv::Vec3f, 9> coefficients; ///< The RGB coefficients of the basis functions H_0 to H_8.
+};
+
+} /* namespace render */
+
+#endif /* SPHERICALHARMONICSLIGHTING_HPP_ */
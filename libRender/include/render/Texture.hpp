@@ -22,6 +22,17 @@ public:
 
 	void createFromFile(const std::string& fileName, unsigned int mipmapsNum = 0);
 
+	/**
+	 * Creates the texture from an image that is already in memory, e.g. an
+	 * isomap that was just extracted, so it doesn't need to be written to and
+	 * read back from a file first. The result is the same as with
+	 * createFromFile(...) on the image written as a .png.
+	 *
+	 * @param[in] image A BGR image (CV_8UC3). It is not modified.
+	 * @param[in] mipmapsNum The number of mipmaps, 0 for the maximum possible number.
+	 */
+	void createFromImage(cv::Mat image, unsigned int mipmapsNum = 0);
+
 	std::vector<cv::Mat> mipmaps;	// make Texture a friend class of renderer, then move this to private?
 	unsigned char widthLog, heightLog; // log2 of width and height of the base mip-level
 
@@ -29,6 +40,8 @@ private:
 	std::string fileName;
 	unsigned int mipmapsNum;
 
+	void createMipmaps(cv::Mat image, unsigned int mipmapsNum); ///< Creates the mipmaps from a BGR image. Used by createFromFile(...) and createFromImage(...).
+
 	inline bool isPowerOfTwo(int x)
 	{
 		return !(x & (x-1));
@@ -0,0 +1,62 @@
+/*
+ * VertexNormals.hpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+#pragma once
+
+#ifndef VERTEXNORMALS_HPP_
+#define VERTEXNORMALS_HPP_
+
+#include "render/Mesh.hpp"
+
+#include "opencv2/core/core.hpp"
+
+#include <vector>
+#include <array>
+
+namespace render {
+
+/**
+ * Computes the vertex normals of meshes. The normal of a vertex is the sum of
+ * the (unnormalised) cross products of its adjacent triangles, i.e. the face
+ * normals weighted by the triangle areas, normalised to unit length. The
+ * normals point to the side from which the triangles appear counter-clockwise,
+ * the same side the SoftwareRenderer treats as front when culling back faces.
+ *
+ * All samples of a morphable model share the same triangle list, only the
+ * vertex positions change. Therefore, the vertex-triangle adjacency is built
+ * once and re-used as long as the triangle list stays the same. The normals
+ * are then gathered per vertex from the cross products, instead of being
+ * scattered from the triangles to their vertices.
+ */
+class VertexNormals
+{
+public:
+	/**
+	 * Computes the normals of all vertices of a mesh. Vertices that are not
+	 * part of any (non-degenerate) triangle get a zero normal.
+	 *
+	 * @param[in] mesh A mesh.
+	 * @return The normal of each vertex, in the coordinate system of the mesh.
+	 */
+	std::vector<cv::Vec3f> compute(const Mesh& mesh);
+
+private:
+	/**
+	 * Builds the vertex-triangle adjacency if the triangle list or the number of
+	 * vertices differ from the cached ones.
+	 */
+	void updateTopology(const std::vector<std::array<int, 3>>& triangles, std::size_t vertexCount);
+
+	std::vector<std::array<int, 3>> triangles; ///< The triangle list of the cached topology.
+	std::size_t vertexCount = 0; ///< The number of vertices of the cached topology.
+	std::vector<int> adjacencyOffsets; ///< The adjacent triangles of vertex i are adjacentTriangles[adjacencyOffsets[i]] to adjacentTriangles[adjacencyOffsets[i + 1] - 1].
+	std::vector<int> adjacentTriangles; ///< The indices of the adjacent triangles of all vertices.
+	std::vector<cv::Vec3f> faceNormals; ///< The area-weighted face normals, re-used between calls.
+};
+
+} /* namespace render */
+
+#endif /* VERTEXNORMALS_HPP_ */
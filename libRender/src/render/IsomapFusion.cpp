@@ -0,0 +1,272 @@
+/*
+ * IsomapFusion.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "render/IsomapFusion.hpp"
+#include "render/utils.hpp"
+
+#include "logging/Tracer.hpp"
+
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include <map>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+
+using cv::Mat;
+using cv::Vec2f;
+using cv::Vec3f;
+using cv::Vec4f;
+using std::vector;
+using std::array;
+
+namespace render {
+
+IsomapFusion::IsomapFusion(int isomapResolution/*=512*/, unsigned int threadCount/*=1*/, float edgeDistance/*=10.0f*/, float angleExponent/*=2.0f*/, float sharpnessExponent/*=1.0f*/) : isomapResolution(isomapResolution), threadCount(threadCount), edgeDistance(edgeDistance), angleExponent(angleExponent), sharpnessExponent(sharpnessExponent)
+{
+	if (isomapResolution <= 0) {
+		throw std::invalid_argument("IsomapFusion: The resolution of the isomap must be positive.");
+	}
+	reset();
+}
+
+void IsomapFusion::reset()
+{
+	numFrames = 0;
+	colorSum = Mat::zeros(isomapResolution, isomapResolution, CV_32FC3);
+	weightSum = Mat::zeros(isomapResolution, isomapResolution, CV_32FC1);
+}
+
+std::size_t IsomapFusion::getNumFrames() const
+{
+	return numFrames;
+}
+
+void IsomapFusion::addFrame(const Mesh& mesh, Mat mvpMatrix, int viewportWidth, int viewportHeight, Mat image, Mat depthBuffer)
+{
+	TRACE_SCOPE("IsomapFusion::addFrame");
+	if (image.type() != CV_8UC3) {
+		throw std::invalid_argument("IsomapFusion: The image must be of type CV_8UC3.");
+	}
+	if (depthBuffer.type() != CV_64FC1 || depthBuffer.rows != viewportHeight || depthBuffer.cols != viewportWidth) {
+		throw std::invalid_argument("IsomapFusion: The depth buffer must be of type CV_64FC1 and have the size of the viewport.");
+	}
+
+	// Transform every vertex once (extractTexture(...) does it per triangle)
+	vector<Vec2f> screenPositions(mesh.vertex.size());
+	vector<float> depths(mesh.vertex.size());
+	for (size_t i = 0; i < mesh.vertex.size(); ++i) {
+		Vec4f position = Mat(mvpMatrix * Mat(mesh.vertex[i].position));
+		position = position / position[3];
+		screenPositions[i] = utils::clipToScreenSpace(Vec2f(position[0], position[1]), viewportWidth, viewportHeight);
+		depths[i] = position[2];
+	}
+
+	// The viewing direction in model space: For an affine camera, it's the direction that the x- and y-rows of the MVP matrix both map to zero
+	Vec3f cameraX(mvpMatrix.at<float>(0, 0), mvpMatrix.at<float>(0, 1), mvpMatrix.at<float>(0, 2));
+	Vec3f cameraY(mvpMatrix.at<float>(1, 0), mvpMatrix.at<float>(1, 1), mvpMatrix.at<float>(1, 2));
+	Vec3f viewingDirection = cameraX.cross(cameraY);
+	viewingDirection = viewingDirection / cv::norm(viewingDirection);
+
+	// The sharpness of the frame, measured in the region that the mesh covers
+	float sharpnessWeight = 1.0f;
+	if (sharpnessExponent != 0.0f && !screenPositions.empty()) {
+		cv::Rect region = cv::boundingRect(screenPositions) & cv::Rect(0, 0, image.cols, image.rows);
+		if (region.area() > 0) {
+			Mat grayRegion, laplacian;
+			cv::cvtColor(image(region), grayRegion, cv::COLOR_BGR2GRAY);
+			cv::Laplacian(grayRegion, laplacian, CV_32F);
+			double sharpness = cv::mean(laplacian.mul(laplacian))[0];
+			sharpnessWeight = static_cast<float>(std::pow(std::max(sharpness, 1e-6), static_cast<double>(sharpnessExponent)));
+		}
+	}
+
+	// Set up the triangles: Only the front-facing ones can be visible
+	vector<TriangleSetup> triangles;
+	triangles.reserve(mesh.tvi.size());
+	vector<bool> frontFacing(mesh.tvi.size(), false);
+	for (size_t t = 0; t < mesh.tvi.size(); ++t) {
+		const auto& triangleIndices = mesh.tvi[t];
+		TriangleSetup triangle;
+		for (int i = 0; i < 3; ++i) {
+			triangle.screen[i] = screenPositions[triangleIndices[i]];
+			triangle.depth[i] = depths[triangleIndices[i]];
+			const Vec2f& texCoord = mesh.vertex[triangleIndices[i]].texcrd;
+			// same mapping as extractTexture(...) in MeshUtils.cpp (including its shift of v by one pixel), so the fused
+			// isomap is aligned with the single-image isomaps
+			triangle.texel[i] = Vec2f(texCoord[0] * isomapResolution, texCoord[1] * isomapResolution - 1.0f);
+		}
+		Vec2f screen01 = triangle.screen[1] - triangle.screen[0];
+		Vec2f screen02 = triangle.screen[2] - triangle.screen[0];
+		float screenArea = screen01[0] * screen02[1] - screen01[1] * screen02[0];
+		if (screenArea >= 0.0f) { // not CCW in screen space (origin top-left, y goes down), see areVerticesCCWInScreenSpace(...), or degenerate
+			continue;
+		}
+		frontFacing[t] = true;
+
+		Vec2f texel01 = triangle.texel[1] - triangle.texel[0];
+		Vec2f texel02 = triangle.texel[2] - triangle.texel[0];
+		cv::Matx22f texelEdges(texel01[0], texel02[0], texel01[1], texel02[1]);
+		if (std::abs(cv::determinant(texelEdges)) < 1e-6f) {
+			continue; // the triangle has no area in the isomap
+		}
+		triangle.texelToBarycentric = texelEdges.inv();
+		triangle.screenToBarycentric = cv::Matx22f(screen01[0], screen02[0], screen01[1], screen02[1]).inv();
+		cv::Matx12f depthGradient = cv::Matx12f(triangle.depth[1] - triangle.depth[0], triangle.depth[2] - triangle.depth[0]) * triangle.screenToBarycentric;
+		triangle.depthTolerance = 0.01f * (std::abs(depthGradient(0, 0)) + std::abs(depthGradient(0, 1))) + 1e-6f;
+
+		const Vec4f& p0 = mesh.vertex[triangleIndices[0]].position;
+		const Vec4f& p1 = mesh.vertex[triangleIndices[1]].position;
+		const Vec4f& p2 = mesh.vertex[triangleIndices[2]].position;
+		Vec3f normal = Vec3f(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]).cross(Vec3f(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]));
+		float normalLength = static_cast<float>(cv::norm(normal));
+		float cosAngle = normalLength > 0.0f ? std::abs(normal.dot(viewingDirection)) / normalLength : 0.0f;
+		triangle.weight = (angleExponent != 0.0f ? std::pow(cosAngle, angleExponent) : 1.0f) * sharpnessWeight;
+		if (triangle.weight <= 0.0f) {
+			continue;
+		}
+
+		triangle.minX = std::max(static_cast<int>(std::floor(std::min(triangle.texel[0][0], std::min(triangle.texel[1][0], triangle.texel[2][0])))), 0);
+		triangle.maxX = std::min(static_cast<int>(std::ceil(std::max(triangle.texel[0][0], std::max(triangle.texel[1][0], triangle.texel[2][0])))), isomapResolution - 1);
+		triangle.minY = std::max(static_cast<int>(std::floor(std::min(triangle.texel[0][1], std::min(triangle.texel[1][1], triangle.texel[2][1])))), 0);
+		triangle.maxY = std::min(static_cast<int>(std::ceil(std::max(triangle.texel[0][1], std::max(triangle.texel[1][1], triangle.texel[2][1])))), isomapResolution - 1);
+		triangles.push_back(triangle);
+	}
+
+	// The weight of the distance from the occlusion edges: Silhouette edges (between a front- and a back-facing triangle) and the boundary of the mesh
+	Mat edgeWeights;
+	if (edgeDistance > 0.0f) {
+		updateEdges(mesh);
+		Mat edgeImage(viewportHeight, viewportWidth, CV_8UC1, cv::Scalar(255));
+		for (const auto& edge : edges) {
+			bool isOcclusionEdge = edge[3] < 0 ? frontFacing[edge[2]] : frontFacing[edge[2]] != frontFacing[edge[3]];
+			if (isOcclusionEdge) {
+				cv::line(edgeImage, cv::Point2f(screenPositions[edge[0]]), cv::Point2f(screenPositions[edge[1]]), cv::Scalar(0));
+			}
+		}
+		Mat distances;
+		cv::distanceTransform(edgeImage, distances, CV_DIST_L2, 3);
+		edgeWeights = cv::min(distances / edgeDistance, 1.0);
+	}
+
+	// Merge the texels, every thread processes its own rows of the isomap, so they don't need to be synchronised
+	unsigned int numThreads = threadCount > 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+	numThreads = std::min(numThreads, static_cast<unsigned int>(isomapResolution));
+	vector<std::thread> threads;
+	for (unsigned int i = 1; i < numThreads; ++i) {
+		int rowBegin = static_cast<int>(static_cast<long>(isomapResolution) * i / numThreads);
+		int rowEnd = static_cast<int>(static_cast<long>(isomapResolution) * (i + 1) / numThreads);
+		threads.emplace_back([=, &triangles, &image, &depthBuffer, &edgeWeights]() {
+			accumulateRows(rowBegin, rowEnd, triangles, image, depthBuffer, edgeWeights);
+		});
+	}
+	accumulateRows(0, isomapResolution / numThreads, triangles, image, depthBuffer, edgeWeights);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	++numFrames;
+}
+
+void IsomapFusion::accumulateRows(int rowBegin, int rowEnd, const vector<TriangleSetup>& triangles, const Mat& image, const Mat& depthBuffer, const Mat& edgeWeights)
+{
+	const float barycentricTolerance = -1e-4f; // include the texels on the edges
+	for (const auto& triangle : triangles) {
+		for (int y = std::max(triangle.minY, rowBegin); y <= std::min(triangle.maxY, rowEnd - 1); ++y) {
+			cv::Vec3f* colors = colorSum.ptr<cv::Vec3f>(y);
+			float* weights = weightSum.ptr<float>(y);
+			for (int x = triangle.minX; x <= triangle.maxX; ++x) {
+				// The barycentric coordinates of the texel center
+				cv::Vec2f barycentric = triangle.texelToBarycentric * (Vec2f(x + 0.5f, y + 0.5f) - triangle.texel[0]);
+				float alpha = 1.0f - barycentric[0] - barycentric[1];
+				if (alpha < barycentricTolerance || barycentric[0] < barycentricTolerance || barycentric[1] < barycentricTolerance) {
+					continue;
+				}
+				// The corresponding position in the image (the warp is affine per triangle, like in extractTexture(...))
+				Vec2f screen = alpha * triangle.screen[0] + barycentric[0] * triangle.screen[1] + barycentric[1] * triangle.screen[2];
+				int pixelX = static_cast<int>(std::floor(screen[0]));
+				int pixelY = static_cast<int>(std::floor(screen[1]));
+				if (pixelX < 0 || pixelY < 0 || pixelX >= depthBuffer.cols || pixelY >= depthBuffer.rows || pixelX >= image.cols || pixelY >= image.rows) {
+					continue;
+				}
+				// Depth test at the pixel center, where the renderer evaluated the depth
+				cv::Vec2f pixelBarycentric = triangle.screenToBarycentric * (Vec2f(pixelX + 0.5f, pixelY + 0.5f) - triangle.screen[0]);
+				float depth = (1.0f - pixelBarycentric[0] - pixelBarycentric[1]) * triangle.depth[0] + pixelBarycentric[0] * triangle.depth[1] + pixelBarycentric[1] * triangle.depth[2];
+				if (depth > depthBuffer.at<double>(pixelY, pixelX) + triangle.depthTolerance) {
+					continue; // occluded
+				}
+				float weight = triangle.weight;
+				if (!edgeWeights.empty()) {
+					weight *= edgeWeights.at<float>(pixelY, pixelX);
+				}
+				if (weight <= 0.0f) {
+					continue;
+				}
+				// Bilinear interpolation of the image, pixel centers are at +0.5
+				float sampleX = std::min(std::max(screen[0] - 0.5f, 0.0f), static_cast<float>(image.cols - 1));
+				float sampleY = std::min(std::max(screen[1] - 0.5f, 0.0f), static_cast<float>(image.rows - 1));
+				int x0 = static_cast<int>(sampleX);
+				int y0 = static_cast<int>(sampleY);
+				int x1 = std::min(x0 + 1, image.cols - 1);
+				int y1 = std::min(y0 + 1, image.rows - 1);
+				float fx = sampleX - x0;
+				float fy = sampleY - y0;
+				Vec3f color = (1.0f - fy) * ((1.0f - fx) * Vec3f(image.at<cv::Vec3b>(y0, x0)) + fx * Vec3f(image.at<cv::Vec3b>(y0, x1)))
+					+ fy * ((1.0f - fx) * Vec3f(image.at<cv::Vec3b>(y1, x0)) + fx * Vec3f(image.at<cv::Vec3b>(y1, x1)));
+				colors[x] += weight * color;
+				weights[x] += weight;
+			}
+		}
+	}
+}
+
+void IsomapFusion::updateEdges(const Mesh& mesh)
+{
+	if (edgeTriangles == mesh.tvi) {
+		return;
+	}
+	edgeTriangles = mesh.tvi;
+	edges.clear();
+	std::map<std::pair<int, int>, size_t> edgeIndices;
+	for (size_t t = 0; t < mesh.tvi.size(); ++t) {
+		for (int i = 0; i < 3; ++i) {
+			int v0 = mesh.tvi[t][i];
+			int v1 = mesh.tvi[t][(i + 1) % 3];
+			auto key = std::make_pair(std::min(v0, v1), std::max(v0, v1));
+			auto edgeIndex = edgeIndices.find(key);
+			if (edgeIndex == edgeIndices.end()) {
+				edgeIndices.insert(std::make_pair(key, edges.size()));
+				edges.push_back(array<int, 4>{ { v0, v1, static_cast<int>(t), -1 } });
+			}
+			else {
+				edges[edgeIndex->second][3] = static_cast<int>(t);
+			}
+		}
+	}
+}
+
+Mat IsomapFusion::getIsomap() const
+{
+	Mat isomap = Mat::zeros(isomapResolution, isomapResolution, CV_8UC3);
+	for (int y = 0; y < isomapResolution; ++y) {
+		for (int x = 0; x < isomapResolution; ++x) {
+			float weight = weightSum.at<float>(y, x);
+			if (weight > 0.0f) {
+				Vec3f color = colorSum.at<Vec3f>(y, x) / weight;
+				isomap.at<cv::Vec3b>(y, x) = cv::Vec3b(cv::saturate_cast<uchar>(color[0]), cv::saturate_cast<uchar>(color[1]), cv::saturate_cast<uchar>(color[2]));
+			}
+		}
+	}
+	return isomap;
+}
+
+Mat IsomapFusion::getWeights() const
+{
+	return weightSum.clone();
+}
+
+} /* namespace render */
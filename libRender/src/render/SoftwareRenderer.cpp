@@ -9,6 +9,8 @@
 
 #include "render/utils.hpp"
 
+#include "logging/Tracer.hpp"
+
 using cv::Mat;
 using cv::Vec4b;
 using cv::Vec2f;
@@ -45,25 +47,62 @@ pair<Mat, Mat> SoftwareRenderer::render(Mesh mesh, QMatrix4x4 mvp)
 
 pair<Mat, Mat> SoftwareRenderer::render(Mesh mesh, Mat mvp)
 {
-	colorBuffer = Mat::zeros(viewportHeight, viewportWidth, CV_8UC4);
-	depthBuffer = Mat::ones(viewportHeight, viewportWidth, CV_64FC1) * 1000000;
-	//depthBuffer = Mat::ones(viewportHeight, viewportWidth, CV_64FC1) * -0.88;
+	TRACE_SCOPE("SoftwareRenderer::render");
+	return rasterize(mesh.tvi, transformVertices(mesh, mvp));
+}
 
-	vector<TriangleToRasterize> trisToRaster;
+pair<Mat, Mat> SoftwareRenderer::render(const Mesh& mesh, Mat mvp, const SphericalHarmonicsLighting& lighting)
+{
+	return render(mesh, mvp, vector<SphericalHarmonicsLighting>{ lighting }).front();
+}
+
+vector<pair<Mat, Mat>> SoftwareRenderer::render(const Mesh& mesh, Mat mvp, const vector<SphericalHarmonicsLighting>& lightings)
+{
+	TRACE_SCOPE("SoftwareRenderer::render");
+	// The positions and normals don't depend on the lighting, only the vertex colors do
+	vector<Vertex> clipSpaceVertices = transformVertices(mesh, mvp);
+	vector<Vec3f> normals = vertexNormals.compute(mesh);
+	vector<Vec3f> irradiance;
+	vector<pair<Mat, Mat>> framebuffers;
+	modulateTexture = doTexturing;
+	for (const auto& lighting : lightings) {
+		lighting.getIrradiance(normals, irradiance);
+		for (std::size_t i = 0; i < clipSpaceVertices.size(); ++i) {
+			// With texturing, the interpolated irradiance is multiplied with the texture color per pixel
+			clipSpaceVertices[i].color = doTexturing ? irradiance[i] : mesh.vertex[i].color.mul(irradiance[i]);
+		}
+		framebuffers.push_back(rasterize(mesh.tvi, clipSpaceVertices)); // the buffers are re-allocated in every call, so they don't get overwritten
+	}
+	modulateTexture = false;
+	return framebuffers;
+}
 
+vector<Vertex> SoftwareRenderer::transformVertices(const Mesh& mesh, Mat mvp)
+{
 	// Vertex shader:
 	//processedVertex = shade(Vertex); // processedVertex : pos, col, tex, texweight
 	vector<Vertex> clipSpaceVertices;
+	clipSpaceVertices.reserve(mesh.vertex.size());
 	for (const auto& v : mesh.vertex) {
 		Mat mpnew = mvp * Mat(v.position);
 		clipSpaceVertices.push_back(Vertex(mpnew, v.color, v.texcrd));
 	}
+	return clipSpaceVertices;
+}
+
+pair<Mat, Mat> SoftwareRenderer::rasterize(const vector<std::array<int, 3>>& triangles, const vector<Vertex>& clipSpaceVertices)
+{
+	colorBuffer = Mat::zeros(viewportHeight, viewportWidth, CV_8UC4);
+	depthBuffer = Mat::ones(viewportHeight, viewportWidth, CV_64FC1) * 1000000;
+	//depthBuffer = Mat::ones(viewportHeight, viewportWidth, CV_64FC1) * -0.88;
+
+	vector<TriangleToRasterize> trisToRaster;
 
 	// We're in clip-space now
 	// PREPARE rasterizer:
 	// processProspectiveTriangleToRasterize:
 	// for every vertex/tri:
-	for (const auto& triIndices : mesh.tvi) {
+	for (const auto& triIndices : triangles) {
 		// Todo: Split this whole stuff up. Make a "clip" function, ... rename "processProspective..".. what is "process"... get rid of "continue;"-stuff by moving stuff inside process...
 		// classify vertices visibility with respect to the planes of the view frustum
 		// we're in clip-coords (NDC), so just check if outside [-1, 1] x ...
@@ -290,6 +329,9 @@ void SoftwareRenderer::rasterTriangle(TriangleToRasterize triangle)
 						// The Texture is in BGR, thus tex2D returns BGR
 						Vec3f textureColor = tex2D(texCoord_persp); // uses the current texture
 						pixelColor = Vec3f(textureColor[2], textureColor[1], textureColor[0]);
+						if (modulateTexture) {
+							pixelColor = pixelColor.mul(color_persp); // the interpolated irradiance
+						}
 						// other: color.mul(tex2D(texture, texCoord));
 						// Old note: for texturing, we load the texture as BGRA, so the colors get the wrong way in the next few lines...
 					}
@@ -0,0 +1,139 @@
+/*
+ * SphericalHarmonicsLighting.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "render/SphericalHarmonicsLighting.hpp"
+
+#include <cmath>
+#include <algorithm>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SPHERICALHARMONICSLIGHTING_USE_SSE
+#endif
+
+using cv::Vec3f;
+using std::vector;
+using std::array;
+
+namespace render {
+
+/**
+ * The constant factors of the basis functions H_0 to H_8.
+ */
+static const float basisScales[9] = {
+	1.0f,
+	1.1547005f, 1.1547005f, 1.1547005f, // 2 / sqrt(3)
+	0.9682458f, 0.9682458f, // sqrt(15) / 4
+	0.2795085f, // sqrt(5) / 8
+	0.9682458f, // sqrt(15) / 4
+	0.4841229f // sqrt(15) / 8
+};
+
+/**
+ * The SH coefficients of a directional light of unit irradiance, without the
+ * direction-dependent part of the basis functions (see createDirectional(...)).
+ */
+static const float directionalScales[9] = {
+	0.25f,
+	0.4330127f, 0.4330127f, 0.4330127f, // sqrt(3) / 4
+	0.9682458f, 0.9682458f, // sqrt(15) / 4
+	0.2795085f, // sqrt(5) / 8
+	0.9682458f, // sqrt(15) / 4
+	0.4841229f // sqrt(15) / 8
+};
+
+/**
+ * Evaluates the basis functions without their constant factors.
+ */
+static array<float, 9> evaluateBasis(const Vec3f& n)
+{
+	float x = n[0], y = n[1], z = n[2];
+	return array<float, 9>{ { 1.0f, y, z, x, x * y, y * z, 3.0f * z * z - 1.0f, x * z, x * x - y * y } };
+}
+
+SphericalHarmonicsLighting::SphericalHarmonicsLighting()
+{
+	coefficients.fill(Vec3f(0.0f, 0.0f, 0.0f));
+	coefficients[0] = Vec3f(1.0f, 1.0f, 1.0f);
+}
+
+SphericalHarmonicsLighting::SphericalHarmonicsLighting(array<Vec3f, 9> coefficients) : coefficients(coefficients)
+{
+}
+
+SphericalHarmonicsLighting SphericalHarmonicsLighting::createDirectional(Vec3f ambient, Vec3f direction, Vec3f color)
+{
+	float length = std::sqrt(direction.dot(direction));
+	if (length > 0.0f) {
+		direction *= 1.0f / length;
+	}
+	// The irradiance of a directional light is its color times the clamped cosine, whose SH coefficients are the basis functions at the light direction
+	array<float, 9> basis = evaluateBasis(direction);
+	array<Vec3f, 9> coefficients;
+	for (int i = 0; i < 9; ++i) {
+		coefficients[i] = color * (directionalScales[i] * basis[i]);
+	}
+	coefficients[0] += ambient;
+	return SphericalHarmonicsLighting(coefficients);
+}
+
+Vec3f SphericalHarmonicsLighting::getIrradiance(const Vec3f& normal) const
+{
+	array<float, 9> basis = evaluateBasis(normal);
+	Vec3f irradiance(0.0f, 0.0f, 0.0f);
+	for (int i = 0; i < 9; ++i) {
+		irradiance += coefficients[i] * (basisScales[i] * basis[i]);
+	}
+	return Vec3f(std::max(irradiance[0], 0.0f), std::max(irradiance[1], 0.0f), std::max(irradiance[2], 0.0f));
+}
+
+void SphericalHarmonicsLighting::getIrradiance(const vector<Vec3f>& normals, vector<Vec3f>& irradiance) const
+{
+	irradiance.resize(normals.size());
+	std::size_t i = 0;
+#ifdef SPHERICALHARMONICSLIGHTING_USE_SSE
+	// The normals are evaluated four at a time, one per SSE lane. The coefficients
+	// (including the constant factors) are broadcast to all lanes once.
+	__m128 scaledCoefficients[3][9];
+	for (int c = 0; c < 3; ++c) {
+		for (int b = 0; b < 9; ++b) {
+			scaledCoefficients[c][b] = _mm_set1_ps(coefficients[b][c] * basisScales[b]);
+		}
+	}
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 three = _mm_set1_ps(3.0f);
+	for (; i + 4 <= normals.size(); i += 4) {
+		__m128 x = _mm_setr_ps(normals[i][0], normals[i + 1][0], normals[i + 2][0], normals[i + 3][0]);
+		__m128 y = _mm_setr_ps(normals[i][1], normals[i + 1][1], normals[i + 2][1], normals[i + 3][1]);
+		__m128 z = _mm_setr_ps(normals[i][2], normals[i + 1][2], normals[i + 2][2], normals[i + 3][2]);
+		__m128 basis[9] = {
+			one, y, z, x,
+			_mm_mul_ps(x, y),
+			_mm_mul_ps(y, z),
+			_mm_sub_ps(_mm_mul_ps(three, _mm_mul_ps(z, z)), one),
+			_mm_mul_ps(x, z),
+			_mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))
+		};
+		float channels[3][4];
+		for (int c = 0; c < 3; ++c) {
+			__m128 sum = scaledCoefficients[c][0];
+			for (int b = 1; b < 9; ++b) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(scaledCoefficients[c][b], basis[b]));
+			}
+			_mm_storeu_ps(channels[c], _mm_max_ps(sum, zero));
+		}
+		for (int k = 0; k < 4; ++k) {
+			irradiance[i + k] = Vec3f(channels[0][k], channels[1][k], channels[2][k]);
+		}
+	}
+#endif
+	for (; i < normals.size(); ++i) {
+		irradiance[i] = getIrradiance(normals[i]);
+	}
+}
+
+} /* namespace render */
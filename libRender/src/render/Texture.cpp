@@ -30,6 +30,18 @@ void Texture::createFromFile(const std::string& fileName, unsigned int mipmapsNu
 		exit(EXIT_FAILURE);
 	}
 
+	this->fileName = fileName;
+	createMipmaps(image, mipmapsNum);
+}
+
+void Texture::createFromImage(cv::Mat image, unsigned int mipmapsNum)
+{
+	this->fileName = std::string();
+	createMipmaps(image, mipmapsNum);
+}
+
+void Texture::createMipmaps(cv::Mat image, unsigned int mipmapsNum)
+{
 	this->mipmapsNum = (mipmapsNum == 0 ? render::utils::getMaxPossibleMipmapsNum(image.cols, image.rows) : mipmapsNum);
 	/*if (mipmapsNum == 0)
 	{
@@ -44,7 +56,7 @@ void Texture::createFromFile(const std::string& fileName, unsigned int mipmapsNu
 	{
 		if (!isPowerOfTwo(image.cols) || !isPowerOfTwo(image.rows))
 		{
-			std::cout << "Error: Couldn't generate mipmaps for image: " << fileName << std::endl;
+			std::cout << "Error: Couldn't generate mipmaps for image: " << (fileName.empty() ? std::string("(in memory)") : fileName) << std::endl;
 			exit(EXIT_FAILURE);
 		}
 	}
@@ -68,7 +80,6 @@ void Texture::createFromFile(const std::string& fileName, unsigned int mipmapsNu
 		if (currHeight > 1)
 			currHeight >>= 1;
 	}
-	this->fileName = fileName;
 	this->widthLog = (uchar)(std::log(mipmaps[0].cols)/CV_LOG2 + 0.0001f); // std::epsilon or something? or why 0.0001f here?
 	this->heightLog = (uchar)(std::log(mipmaps[0].rows)/CV_LOG2 + 0.0001f); // Changed std::logf to std::log because it doesnt compile in linux (gcc 4.8). CHECK THAT
 }
@@ -0,0 +1,88 @@
+/*
+ * VertexNormals.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include "render/VertexNormals.hpp"
+
+#include "logging/Tracer.hpp"
+
+#include <stdexcept>
+#include <cmath>
+
+using cv::Vec3f;
+using cv::Vec4f;
+using std::vector;
+using std::array;
+
+namespace render {
+
+vector<Vec3f> VertexNormals::compute(const Mesh& mesh)
+{
+	TRACE_SCOPE("VertexNormals::compute");
+	updateTopology(mesh.tvi, mesh.vertex.size());
+
+	faceNormals.resize(triangles.size());
+	for (std::size_t i = 0; i < triangles.size(); ++i) {
+		const Vec4f& p0 = mesh.vertex[triangles[i][0]].position;
+		const Vec4f& p1 = mesh.vertex[triangles[i][1]].position;
+		const Vec4f& p2 = mesh.vertex[triangles[i][2]].position;
+		Vec3f e1(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]);
+		Vec3f e2(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]);
+		faceNormals[i] = e1.cross(e2); // its length is twice the area of the triangle
+	}
+
+	vector<Vec3f> normals(vertexCount);
+	for (std::size_t v = 0; v < vertexCount; ++v) {
+		Vec3f normal(0.0f, 0.0f, 0.0f);
+		for (int a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a) {
+			normal += faceNormals[adjacentTriangles[a]];
+		}
+		float length = std::sqrt(normal.dot(normal));
+		if (length > 0.0f) {
+			normals[v] = normal * (1.0f / length);
+		}
+		else {
+			normals[v] = normal;
+		}
+	}
+	return normals;
+}
+
+void VertexNormals::updateTopology(const vector<array<int, 3>>& triangles, std::size_t vertexCount)
+{
+	if (vertexCount == this->vertexCount && triangles == this->triangles) {
+		return;
+	}
+	for (const auto& triangle : triangles) {
+		for (int index : triangle) {
+			if (index < 0 || static_cast<std::size_t>(index) >= vertexCount) {
+				throw std::out_of_range("VertexNormals: The triangle list refers to a vertex that doesn't exist.");
+			}
+		}
+	}
+	this->triangles = triangles;
+	this->vertexCount = vertexCount;
+
+	// Counting sort of the (vertex, triangle) pairs by vertex
+	adjacencyOffsets.assign(vertexCount + 1, 0);
+	for (const auto& triangle : triangles) {
+		for (int index : triangle) {
+			++adjacencyOffsets[index + 1];
+		}
+	}
+	for (std::size_t v = 0; v < vertexCount; ++v) {
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	}
+	adjacentTriangles.resize(adjacencyOffsets[vertexCount]);
+	vector<int> positions(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (std::size_t t = 0; t < triangles.size(); ++t) {
+		for (int index : triangles[t]) {
+			adjacentTriangles[positions[index]++] = static_cast<int>(t);
+		}
+	}
+}
+
+} /* namespace render */
@@ -48,6 +48,12 @@ public:
 
 	// returns a string with its parameters (to be written to a model-file)
 	virtual std::string getParameterString() const = 0;
+
+	// true if the descriptors only depend on the locations rounded to whole pixels. Then all the
+	// locations that round to the same pixel get the same descriptor, and it only has to be extracted once.
+	virtual bool roundsLocations() const {
+		return false;
+	};
 };
 
 class SiftDescriptorExtractor : public DescriptorExtractor
@@ -218,6 +224,10 @@ public:
 		return hogDescriptors;
 	};
 
+	bool roundsLocations() const {
+		return true; // the patches are centered at cvRound(location)
+	};
+
 	std::string getParameterString() const {
 		return std::string("numCells " + boost::lexical_cast<std::string>(numCells)+" cellSize " + boost::lexical_cast<std::string>(cellSize)+" numBins " + boost::lexical_cast<std::string>(numBins));
 	};
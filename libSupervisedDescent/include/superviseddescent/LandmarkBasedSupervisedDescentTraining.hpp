@@ -57,6 +57,15 @@ public:
 		float factor = 0.5f;
 		bool regulariseAffineComponent = false;
 		bool regulariseWithEigenvalueThreshold = false;
+		int numValidationFolds = 0; // If >= 2, the factor is chosen per cascade step from factorGrid by k-fold cross-validation over the training images (and the factor above is ignored)
+		std::vector<float> factorGrid = { 0.01f, 0.03f, 0.1f, 0.3f, 0.5f, 1.0f, 3.0f, 10.0f }; // The candidate factors for the validation, same unit as factor
+	};
+
+	// Holds the parameters of the optional PCA projection of the descriptors of one cascade step. Disabled if both are 0.
+	// The number of components k has to satisfy D*k + k*out < D*out (D descriptor dimensions, out = 2 * numLandmarks), so that fitting with the projection is cheaper than without.
+	struct DescriptorProjection {
+		float retainedVariance = 0.0f; // If > 0, keep as many principal components as are needed to retain this fraction of the variance, e.g. 0.98 (truncated to the bound above)
+		int numComponents = 0; // If > 0, keep this many principal components (takes precedence over retainedVariance). Training throws if it exceeds the bound above
 	};
 
 	enum class AlignGroundtruth { // what to do with the GT LMs before mean is taken.
@@ -105,6 +114,11 @@ public:
 		this->regularisation = regularisation;
 	};
 
+	// One for each cascade step. Steps without an entry use the descriptors as they are.
+	void setDescriptorProjections(std::vector<DescriptorProjection> descriptorProjections) {
+		this->descriptorProjections = descriptorProjections;
+	};
+
 	void setAlignGroundtruth(AlignGroundtruth alignGroundtruth) {
 		this->alignGroundtruth = alignGroundtruth;
 	};
@@ -121,6 +135,7 @@ private:
 	int numSamplesPerImage = 10; ///< How many random perturbations to generate per training image
 	int numCascadeSteps = 5; ///< How many regressors to train
 	Regularisation regularisation; ///< Controls the regularisation of the regressor learning
+	std::vector<DescriptorProjection> descriptorProjections; ///< Controls the dimensionality reduction of the descriptors of each cascade step
 	AlignGroundtruth alignGroundtruth = AlignGroundtruth::NONE; ///< For mean calc: todo
 	MeanNormalization meanNormalization = MeanNormalization::UNIT_SUM_SQUARED_NORMS; ///< F...Mean: todo
 
@@ -186,6 +201,29 @@ enum class RegularizationType
  */
 cv::Mat linearRegression(cv::Mat A, cv::Mat b, RegularizationType regularizationType = RegularizationType::Automatic, float lambda = 0.5f, bool regularizeAffineComponent = true);
 
+/**
+ * Solves the regularised least-squares problem for a whole grid of lambdas and
+ * chooses the one with the lowest k-fold cross-validation error. AtA of each
+ * training fold (and of all data) is eigendecomposed only once, so the solution
+ * and validation error for each additional lambda are cheap.
+ * The rows of A and b come in consecutive groups (e.g. all perturbed samples of
+ * one image) that always stay in the same fold, so a fold never validates on
+ * samples of an image it was trained on.
+ * The last column of A is assumed to be the bias (all ones). If it should not be
+ * regularised, the problem is solved on centered data and the bias is recovered
+ * afterwards, which is equivalent.
+ *
+ * @param[in] A The data matrix, one row per sample.
+ * @param[in] b The targets, one row per sample.
+ * @param[in] lambdaFactors The candidate lambdas, as factors of the value used by RegularizationType::Automatic.
+ * @param[in] numFolds The number of folds, at least 2 and at most the number of groups.
+ * @param[in] rowsPerGroup The number of consecutive rows that form one group.
+ * @param[in] regularizeAffineComponent Flag that indicates whether to regularize the bias (last column of A) as well.
+ * @param[out] regularisationPath The evaluated lambdas, their validation errors and the chosen lambda.
+ * @return x, solved on all data with the chosen lambda.
+ */
+cv::Mat linearRegressionWithValidation(cv::Mat A, cv::Mat b, std::vector<float> lambdaFactors, int numFolds, int rowsPerGroup, bool regularizeAffineComponent, SdmLandmarkModel::RegularisationPath& regularisationPath);
+
 /**
 * Todo.
 *
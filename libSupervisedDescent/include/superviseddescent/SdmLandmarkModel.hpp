@@ -24,6 +24,12 @@
 #include "boost/algorithm/string.hpp"
 #include "boost/lexical_cast.hpp"
 
+#include <vector>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+
 extern "C" {
 	#include "superviseddescent/hog.h"
 }
@@ -61,6 +67,28 @@ public:
 		int numBins;
 	};
 
+	/**
+	 * A linear projection of the descriptors of one cascade step onto a
+	 * lower-dimensional subspace (e.g. learned by PCA). The regressor of
+	 * the step then works on the projected descriptors.
+	 */
+	struct Projection
+	{
+		cv::Mat mean; ///< 1 x numDescriptorDimensions, subtracted before projecting. Empty if the step has no projection.
+		cv::Mat basis; ///< numDescriptorDimensions x numProjectedDimensions, one basis vector per column
+	};
+
+	/**
+	 * The regularisation that was chosen for one cascade step by validation,
+	 * together with the validation curve it was chosen from.
+	 */
+	struct RegularisationPath
+	{
+		float lambda; ///< The chosen (absolute) regularisation value
+		std::vector<float> lambdas; ///< All evaluated regularisation values, in increasing order
+		std::vector<float> validationErrors; ///< The mean squared validation error for each value in lambdas
+	};
+
 	int getNumLandmarks() const;
 
 	int getNumCascadeSteps() const;
@@ -86,6 +114,42 @@ public:
 	
 	std::string getDescriptorType(int cascadeLevel);
 
+	/**
+	 * Projects the (concatenated) descriptors of the given cascade step
+	 * onto the subspace of the step, if it has one. The result is what
+	 * the regressor of that step expects.
+	 *
+	 * @param[in] cascadeLevel The cascade step.
+	 * @param[in] descriptors The descriptors, one row-vector per sample.
+	 * @return The projected descriptors, or the given ones if the step has no projection.
+	 */
+	cv::Mat projectDescriptors(int cascadeLevel, cv::Mat descriptors) const;
+
+	/**
+	 * Stores the descriptor projections of the cascade steps with the
+	 * model. A step with an empty projection uses the descriptors as
+	 * they are.
+	 *
+	 * @param[in] projections The projection of each cascade step.
+	 */
+	void setProjections(std::vector<Projection> projections);
+
+	/**
+	 * Returns the regularisation paths of all cascade steps. Empty if
+	 * the regularisation was not chosen by validation during training.
+	 *
+	 * @return The regularisation path of each cascade step.
+	 */
+	std::vector<RegularisationPath> getRegularisationPaths() const;
+
+	/**
+	 * Stores the regularisation paths of the cascade steps with the
+	 * model. They are saved and loaded together with the model.
+	 *
+	 * @param[in] regularisationPaths The regularisation path of each cascade step.
+	 */
+	void setRegularisationPaths(std::vector<RegularisationPath> regularisationPaths);
+
 	//std::vector<cv::Point2f> getLandmarksAsPoints(cv::Mat or vector<float> alphas or empty(=mean));
 	std::vector<cv::Point2f> getMeanAsPoints() const;
 
@@ -120,6 +184,8 @@ private:
 	std::vector<HogParameter> hogParameters;
 	std::vector<std::shared_ptr<DescriptorExtractor>> descriptorExtractors;
 	std::vector<std::string> descriptorTypes; //
+	std::vector<Projection> projections; // One for each cascade level, with an empty mean if the level has no projection
+	std::vector<RegularisationPath> regularisationPaths; // Empty, or one for each cascade level if the regularisation was chosen by validation
 
 };
 
@@ -208,32 +274,14 @@ public:
 			Mat currentFeatures;
 			float dynamicFaceSizeDistance = 0.0f;
 			if (true) { // adaptive
-				// dynamic face-size:
-				cv::Vec2f point1(modelShape.at<float>(8), modelShape.at<float>(8 + model.getNumLandmarks())); // reye_ic
-				cv::Vec2f point2(modelShape.at<float>(9), modelShape.at<float>(9 + model.getNumLandmarks())); // leye_ic
-				cv::Vec2f anchor1 = (point1 + point2) / 2.0f;
-				cv::Vec2f point3(modelShape.at<float>(11), modelShape.at<float>(11 + model.getNumLandmarks())); // rmouth_oc
-				cv::Vec2f point4(modelShape.at<float>(12), modelShape.at<float>(12 + model.getNumLandmarks())); // lmouth_oc
-				cv::Vec2f anchor2 = (point3 + point4) / 2.0f;
-				// dynamic window-size:
-				// From the paper: patch size $ S_p(d) $ of the d-th regressor is $ S_p(d) = S_f / ( K * (1 + e^(d-D)) ) $
-				// D = numCascades (e.g. D=5, d goes from 1 to 5 (Matlab convention))
-				// K = fixed value for shrinking
-				// S_f = the size of the face estimated from the previous updated shape s^(d-1).
-				// For S_f, can use the IED, EMD, or max(IED, EMD). We use the EMD.
-				dynamicFaceSizeDistance = cv::norm(anchor1 - anchor2);
-				float windowSize = dynamicFaceSizeDistance / 2.0f; // shrink value
-				float windowSizeHalf = windowSize / 2;
-				windowSizeHalf = std::round(windowSizeHalf * (1 / (1 + exp((cascadeStep + 1) - model.getNumCascadeSteps())))); // this is (step - numStages), numStages is 5 and step goes from 1 to 5. Because our step goes from 0 to 4, we add 1.
-				int NUM_CELL = 3; // think about if this should go in the descriptorExtractor or not. Is it Hog specific?
-				int windowSizeHalfi = static_cast<int>(windowSizeHalf) + NUM_CELL - (static_cast<int>(windowSizeHalf) % NUM_CELL); // make sure it's divisible by 3. However, this is not needed and not a good way
-				
+				int windowSizeHalfi = getAdaptiveWindowSizeHalf(modelShape, cascadeStep, dynamicFaceSizeDistance);
 				currentFeatures = model.getDescriptorExtractor(cascadeStep)->getDescriptors(image, points, windowSizeHalfi);
 			}
 			else { // non-adaptive, the descriptorExtractor has all necessary params
 				currentFeatures = model.getDescriptorExtractor(cascadeStep)->getDescriptors(image, points);
 			}
 			currentFeatures = currentFeatures.reshape(0, currentFeatures.cols * model.getNumLandmarks()).t();
+			currentFeatures = model.projectDescriptors(cascadeStep, currentFeatures); // no-op if the model has no projection for this step
 
 			//delta_shape = AAM.RF(1).Regressor(hogScale).A(1:end - 1, : )' * feature_current + AAM.RF(1).Regressor(hogScale).A(end,:)';
 			Mat regressorData = model.getRegressorData(cascadeStep);
@@ -255,7 +303,172 @@ public:
 		return modelShape;
 	};
 
+	/**
+	 * Places the model in several perturbed versions of the face-box, to
+	 * start the fitting from more than one initialisation (see
+	 * optimize(std::vector<cv::Mat>, cv::Mat, std::vector<cv::Mat>*)).
+	 * The first shape is the unperturbed alignRigid(...) result. The
+	 * others are spread over the given range of translations and scales
+	 * by a fixed low-discrepancy sequence, so the results are repeatable.
+	 *
+	 * @param[in] modelShape The shape to align, a column-vector (e.g. the mean).
+	 * @param[in] faceBox The face-box.
+	 * @param[in] numInitialisations The number of shapes to create.
+	 * @param[in] maxTranslation The maximal shift of the box, relative to its width and height.
+	 * @param[in] maxScale The maximal relative change of the box size.
+	 * @return The aligned shapes, column-vectors.
+	 */
+	std::vector<cv::Mat> alignRigidPerturbed(cv::Mat modelShape, cv::Rect faceBox, int numInitialisations, float maxTranslation = 0.1f, float maxScale = 0.1f) const {
+		if (numInitialisations < 1) {
+			throw std::invalid_argument("SdmLandmarkModelFitting: The number of initialisations must be at least one.");
+		}
+		std::vector<cv::Mat> modelShapes;
+		modelShapes.push_back(alignRigid(modelShape.clone(), faceBox));
+		const float goldenAngle = 2.3999632f; // pi * (3 - sqrt(5))
+		const float goldenRatio = 0.618034f; // (sqrt(5) - 1) / 2
+		for (int k = 1; k < numInitialisations; ++k) {
+			// the translations lie on a sunflower spiral inside the unit disc, the scales are a golden ratio sequence in [-1, 1]
+			float radius = std::sqrt(static_cast<float>(k) / (numInitialisations - 1));
+			float dx = maxTranslation * radius * std::cos(k * goldenAngle);
+			float dy = maxTranslation * radius * std::sin(k * goldenAngle);
+			float fraction = k * goldenRatio - std::floor(k * goldenRatio);
+			float scale = 1.0f + maxScale * (2.0f * fraction - 1.0f);
+			float width = faceBox.width * scale;
+			float height = faceBox.height * scale;
+			float centerX = faceBox.x + faceBox.width / 2.0f + dx * faceBox.width;
+			float centerY = faceBox.y + faceBox.height / 2.0f + dy * faceBox.height;
+			cv::Rect perturbedBox(cvRound(centerX - width / 2.0f), cvRound(centerY - height / 2.0f), cvRound(width), cvRound(height));
+			modelShapes.push_back(alignRigid(modelShape.clone(), perturbedBox));
+		}
+		return modelShapes;
+	};
+
+	/**
+	 * Fits the model from several initialisations at once and combines
+	 * the results by their coordinate-wise median, which is much less
+	 * sensitive to a badly placed face-box than a single fit.
+	 *
+	 * The initialisations run through the cascade together: In each step,
+	 * the descriptors of all initialisations and landmarks are gathered
+	 * first, locations that yield the same descriptor (e.g. the same pixel
+	 * for HOG) are extracted only once, and the shape updates of all
+	 * initialisations are computed by one matrix product with the
+	 * regressor. The image is converted to grayscale once. How much this
+	 * saves compared to K single fits depends on how many descriptors the
+	 * initialisations share and has not been measured; detect-landmarks
+	 * reports the mean fitting time for a given -k.
+	 *
+	 * @param[in] modelShapes The initial shapes, column-vectors (e.g. from alignRigidPerturbed(...)).
+	 * @param[in] image The image, converted to grayscale if it isn't.
+	 * @param[out] fittedShapes If not null, receives the fitted shape of each initialisation.
+	 * @return The coordinate-wise median of the fitted shapes, a column-vector.
+	 */
+	cv::Mat optimize(std::vector<cv::Mat> modelShapes, cv::Mat image, std::vector<cv::Mat>* fittedShapes = nullptr) {
+		if (modelShapes.empty()) {
+			throw std::invalid_argument("SdmLandmarkModelFitting: There has to be at least one initial shape.");
+		}
+		if (image.channels() == 3) {
+			cv::cvtColor(image, image, cv::COLOR_BGR2GRAY); // once, instead of once per descriptor extraction
+		}
+		const int numInitialisations = static_cast<int>(modelShapes.size());
+		const int numLandmarks = model.getNumLandmarks();
+		for (auto& modelShape : modelShapes) {
+			modelShape = modelShape.clone();
+		}
+
+		for (int cascadeStep = 0; cascadeStep < model.getNumCascadeSteps(); ++cascadeStep) {
+			std::shared_ptr<DescriptorExtractor> descriptorExtractor = model.getDescriptorExtractor(cascadeStep);
+			bool roundLocations = descriptorExtractor->roundsLocations();
+
+			// Gather the distinct (location, window size) pairs of all initialisations, grouped by the window size,
+			// as the descriptor extractor takes one window size per call
+			vector<float> dynamicFaceSizeDistances(numInitialisations);
+			std::map<int, vector<cv::Point2f>> locationsPerWindowSize;
+			std::map<std::tuple<int, float, float>, int> descriptorIndices; // (window size, x, y) -> row in the descriptors of that window size
+			vector<std::pair<int, int>> landmarkDescriptors(numInitialisations * numLandmarks); // (window size, row) of each initialisation and landmark
+			for (int k = 0; k < numInitialisations; ++k) {
+				int windowSizeHalfi = getAdaptiveWindowSizeHalf(modelShapes[k], cascadeStep, dynamicFaceSizeDistances[k]);
+				vector<cv::Point2f>& locations = locationsPerWindowSize[windowSizeHalfi];
+				for (int i = 0; i < numLandmarks; ++i) {
+					cv::Point2f location(modelShapes[k].at<float>(i), modelShapes[k].at<float>(i + numLandmarks));
+					if (roundLocations) {
+						location = cv::Point2f(cvRound(location.x), cvRound(location.y));
+					}
+					auto inserted = descriptorIndices.insert(std::make_pair(std::make_tuple(windowSizeHalfi, location.x, location.y), static_cast<int>(locations.size())));
+					if (inserted.second) {
+						locations.push_back(location);
+					}
+					landmarkDescriptors[k * numLandmarks + i] = std::make_pair(windowSizeHalfi, inserted.first->second);
+				}
+			}
+			std::map<int, Mat> descriptorsPerWindowSize;
+			for (const auto& locations : locationsPerWindowSize) {
+				descriptorsPerWindowSize[locations.first] = descriptorExtractor->getDescriptors(image, locations.second, locations.first);
+			}
+
+			// Stack the concatenated descriptors of the initialisations, one row each (same layout as in the single fit)
+			int descriptorDimensions = descriptorsPerWindowSize.begin()->second.cols;
+			Mat currentFeatures(numInitialisations, numLandmarks * descriptorDimensions, CV_32FC1);
+			for (int k = 0; k < numInitialisations; ++k) {
+				for (int i = 0; i < numLandmarks; ++i) {
+					const std::pair<int, int>& descriptor = landmarkDescriptors[k * numLandmarks + i];
+					Mat landmarkFeatures = currentFeatures.row(k).colRange(i * descriptorDimensions, (i + 1) * descriptorDimensions);
+					descriptorsPerWindowSize[descriptor.first].row(descriptor.second).copyTo(landmarkFeatures);
+				}
+			}
+			currentFeatures = model.projectDescriptors(cascadeStep, currentFeatures); // no-op if the model has no projection for this step
+
+			// One product for the updates of all initialisations
+			Mat regressorData = model.getRegressorData(cascadeStep);
+			Mat deltaShapes = currentFeatures * regressorData.rowRange(0, regressorData.rows - 1);
+			for (int k = 0; k < numInitialisations; ++k) {
+				Mat deltaShape = deltaShapes.row(k) + regressorData.row(regressorData.rows - 1);
+				modelShapes[k] = modelShapes[k] + deltaShape.t() * dynamicFaceSizeDistances[k];
+			}
+		}
+
+		// Combine the results by the coordinate-wise median
+		Mat medianShape(modelShapes[0].rows, 1, CV_32FC1);
+		vector<float> values(numInitialisations);
+		for (int row = 0; row < medianShape.rows; ++row) {
+			for (int k = 0; k < numInitialisations; ++k) {
+				values[k] = modelShapes[k].at<float>(row);
+			}
+			std::sort(values.begin(), values.end());
+			int middle = numInitialisations / 2;
+			medianShape.at<float>(row) = numInitialisations % 2 == 1 ? values[middle] : 0.5f * (values[middle - 1] + values[middle]);
+		}
+		if (fittedShapes) {
+			*fittedShapes = modelShapes;
+		}
+		return medianShape;
+	};
+
 private:
+	// Computes the adaptive window size (half of it) for the descriptors of the given
+	// cascade step, and the face size that the shape update of the step is scaled with.
+	int getAdaptiveWindowSizeHalf(cv::Mat modelShape, int cascadeStep, float& dynamicFaceSizeDistance) const {
+		// dynamic face-size:
+		cv::Vec2f point1(modelShape.at<float>(8), modelShape.at<float>(8 + model.getNumLandmarks())); // reye_ic
+		cv::Vec2f point2(modelShape.at<float>(9), modelShape.at<float>(9 + model.getNumLandmarks())); // leye_ic
+		cv::Vec2f anchor1 = (point1 + point2) / 2.0f;
+		cv::Vec2f point3(modelShape.at<float>(11), modelShape.at<float>(11 + model.getNumLandmarks())); // rmouth_oc
+		cv::Vec2f point4(modelShape.at<float>(12), modelShape.at<float>(12 + model.getNumLandmarks())); // lmouth_oc
+		cv::Vec2f anchor2 = (point3 + point4) / 2.0f;
+		// dynamic window-size:
+		// From the paper: patch size $ S_p(d) $ of the d-th regressor is $ S_p(d) = S_f / ( K * (1 + e^(d-D)) ) $
+		// D = numCascades (e.g. D=5, d goes from 1 to 5 (Matlab convention))
+		// K = fixed value for shrinking
+		// S_f = the size of the face estimated from the previous updated shape s^(d-1).
+		// For S_f, can use the IED, EMD, or max(IED, EMD). We use the EMD.
+		dynamicFaceSizeDistance = cv::norm(anchor1 - anchor2);
+		float windowSize = dynamicFaceSizeDistance / 2.0f; // shrink value
+		float windowSizeHalf = windowSize / 2;
+		windowSizeHalf = std::round(windowSizeHalf * (1 / (1 + exp((cascadeStep + 1) - model.getNumCascadeSteps())))); // this is (step - numStages), numStages is 5 and step goes from 1 to 5. Because our step goes from 0 to 4, we add 1.
+		int NUM_CELL = 3; // think about if this should go in the descriptorExtractor or not. Is it Hog specific?
+		return static_cast<int>(windowSizeHalf) + NUM_CELL - (static_cast<int>(windowSizeHalf) % NUM_CELL); // make sure it's divisible by 3. However, this is not needed and not a good way
+	};
+
 	SdmLandmarkModel model;
 };
 
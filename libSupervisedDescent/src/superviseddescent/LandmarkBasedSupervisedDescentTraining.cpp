@@ -11,6 +11,7 @@
 #include <fstream>
 #include <random>
 #include <chrono>
+#include <algorithm>
 
 #include "opencv2/imgproc/imgproc.hpp"
 #include "Eigen/Dense"
@@ -286,6 +287,8 @@ SdmLandmarkModel LandmarkBasedSupervisedDescentTraining::train(vector<Mat> train
 	// We START here with the real algorithm, everything before was data preparation and calculation of the mean
 
 	std::vector<cv::Mat> regressorData; // output
+	std::vector<SdmLandmarkModel::RegularisationPath> regularisationPaths; // output, only if the regularisation is chosen by validation
+	std::vector<SdmLandmarkModel::Projection> projections; // output, the mean stays empty for steps without a projection
 
 	// Prepare the data for the first cascade step learning. Starting from the mean initialization x0, deltaShape = gt - x0
 	Mat deltaShape = groundtruthShapes - initialShapes;
@@ -317,6 +320,36 @@ SdmLandmarkModel LandmarkBasedSupervisedDescentTraining::train(vector<Mat> train
 			}
 			++currentImage;
 		}
+		// Optional: Reduce the dimensionality of the descriptors by PCA. The regressor then learns on the projected descriptors.
+		SdmLandmarkModel::Projection projection;
+		if (currentCascadeStep < static_cast<int>(descriptorProjections.size()) && (descriptorProjections[currentCascadeStep].numComponents > 0 || descriptorProjections[currentCascadeStep].retainedVariance > 0.0f)) {
+			const DescriptorProjection& descriptorProjection = descriptorProjections[currentCascadeStep];
+			// The fitting projects (D x k) and then regresses (k x out). This only pays off if D*k + k*out < D*out, i.e. k < D*out / (D + out) (which is always less than out).
+			const long long numDescriptorDimensions = featureMatrix.cols;
+			const long long numOutputs = deltaShape.cols;
+			const int maxNumComponents = static_cast<int>((numDescriptorDimensions * numOutputs - 1) / (numDescriptorDimensions + numOutputs));
+			if (maxNumComponents < 1 || descriptorProjection.numComponents > maxNumComponents) {
+				string msg("The PCA projection of cascade step " + lexical_cast<string>(currentCascadeStep) + " has to have less than " + lexical_cast<string>(maxNumComponents + 1) + " components to be cheaper than the plain regressor (" + lexical_cast<string>(numDescriptorDimensions) + " descriptor dimensions, " + lexical_cast<string>(numOutputs) + " outputs), but " + lexical_cast<string>(descriptorProjection.numComponents) + " were requested.");
+				logger.error(msg);
+				throw std::runtime_error(msg);
+			}
+			cv::PCA pca;
+			if (descriptorProjection.numComponents > 0) {
+				pca(featureMatrix, Mat(), CV_PCA_DATA_AS_ROW, descriptorProjection.numComponents);
+			}
+			else {
+				pca.computeVar(featureMatrix, Mat(), CV_PCA_DATA_AS_ROW, descriptorProjection.retainedVariance);
+				if (pca.eigenvectors.rows > maxNumComponents) {
+					logger.warn("Retaining " + lexical_cast<string>(descriptorProjection.retainedVariance) + " of the variance needs " + lexical_cast<string>(pca.eigenvectors.rows) + " components, keeping only the first " + lexical_cast<string>(maxNumComponents) + " so that the projection is cheaper than the plain regressor.");
+					pca.eigenvectors = pca.eigenvectors.rowRange(0, maxNumComponents);
+				}
+			}
+			projection.mean = pca.mean.clone();
+			projection.basis = pca.eigenvectors.t(); // PCA stores one component per row, we project with one per column
+			logger.debug("Projected the descriptors from " + lexical_cast<string>(featureMatrix.cols) + " to " + lexical_cast<string>(projection.basis.cols) + " dimensions.");
+			featureMatrix = (featureMatrix - cv::repeat(projection.mean, featureMatrix.rows, 1)) * projection.basis;
+		}
+		projections.push_back(projection);
 		// 5. Add one row to the features
 		Mat biasColumn = Mat::ones(initialShapes.rows, 1, CV_32FC1);
 		cv::hconcat(featureMatrix, biasColumn, featureMatrix); // Other options: 1) Generate one bigger Mat and use copyTo (memory would be continuous then) or 2) implement a FeatureDescriptorExtractor::getDimension()
@@ -326,7 +359,15 @@ SdmLandmarkModel LandmarkBasedSupervisedDescentTraining::train(vector<Mat> train
 
 		// Perform the linear regression, with the specified regularization
 		start = std::chrono::system_clock::now();
-		Mat R = linearRegression(featureMatrix, deltaShape, RegularizationType::Automatic);
+		Mat R;
+		if (regularisation.numValidationFolds >= 2) {
+			SdmLandmarkModel::RegularisationPath regularisationPath;
+			R = linearRegressionWithValidation(featureMatrix, deltaShape, regularisation.factorGrid, regularisation.numValidationFolds, numSamplesPerImage + 1, regularisation.regulariseAffineComponent, regularisationPath);
+			regularisationPaths.push_back(regularisationPath);
+		}
+		else {
+			R = linearRegression(featureMatrix, deltaShape, RegularizationType::Automatic);
+		}
 		regressorData.push_back(R);
 		end = std::chrono::system_clock::now();
 		elapsed_mseconds = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
@@ -376,6 +417,8 @@ SdmLandmarkModel LandmarkBasedSupervisedDescentTraining::train(vector<Mat> train
 	descriptorExtractors.erase(begin(descriptorExtractors) + numCascadeSteps, std::end(descriptorExtractors));
 
 	SdmLandmarkModel model(modelMean, modelLandmarks, regressorData, descriptorExtractors, descriptorTypes);
+	model.setRegularisationPaths(regularisationPaths);
+	model.setProjections(projections);
 	return model;
 }
 
@@ -517,6 +560,150 @@ cv::Mat linearRegression(cv::Mat A, cv::Mat b, RegularizationType regularization
 	return AtARegInvAtb;
 }
 
+namespace {
+	typedef Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrixXf;
+
+	// The eigendecomposition of AtA of one training set. The regularised solution for any lambda is
+	// x = V * (D + lambda*I)^-1 * V^t * At * b, so only the diagonal part changes with lambda.
+	struct RegularisationPathSolver {
+		RegularisationPathSolver(const Eigen::MatrixXf& A, const Eigen::MatrixXf& b, bool center) : center(center)
+		{
+			Eigen::MatrixXf centeredA = A;
+			Eigen::MatrixXf centeredB = b;
+			if (center) { // the bias column becomes zero and is recovered in solve()
+				meanA = A.colwise().mean();
+				meanB = b.colwise().mean();
+				centeredA.rowwise() -= meanA;
+				centeredB.rowwise() -= meanB;
+			}
+			Eigen::SelfAdjointEigenSolver<Eigen::MatrixXf> eigenSolver(centeredA.transpose() * centeredA);
+			eigenvalues = eigenSolver.eigenvalues().cwiseMax(0.0f); // numerically, some might be slightly negative
+			eigenvectors = eigenSolver.eigenvectors();
+			projectedAtb = eigenvectors.transpose() * (centeredA.transpose() * centeredB);
+		};
+
+		// Returns the components of x in the eigenvector basis, i.e. V^t * x
+		Eigen::MatrixXf solveProjected(float lambda) const
+		{
+			Eigen::VectorXf inverse = (eigenvalues.array() + lambda).inverse().matrix();
+			return inverse.asDiagonal() * projectedAtb;
+		};
+
+		Eigen::MatrixXf solve(float lambda) const
+		{
+			Eigen::MatrixXf x = eigenvectors * solveProjected(lambda);
+			if (center) {
+				int bias = x.rows() - 1;
+				x.row(bias) = meanB - meanA.head(bias) * x.topRows(bias);
+			}
+			return x;
+		};
+
+		// Projects the data onto the eigenvectors once, so predictions for each lambda cost only one product
+		Eigen::MatrixXf project(const Eigen::MatrixXf& A) const
+		{
+			if (center) {
+				return (A.rowwise() - meanA) * eigenvectors;
+			}
+			return A * eigenvectors;
+		};
+
+		Eigen::MatrixXf predict(const Eigen::MatrixXf& projectedA, float lambda) const
+		{
+			Eigen::MatrixXf prediction = projectedA * solveProjected(lambda);
+			if (center) {
+				prediction.rowwise() += meanB;
+			}
+			return prediction;
+		};
+
+		bool center;
+		Eigen::RowVectorXf meanA;
+		Eigen::RowVectorXf meanB;
+		Eigen::VectorXf eigenvalues;
+		Eigen::MatrixXf eigenvectors;
+		Eigen::MatrixXf projectedAtb;
+	};
+}
+
+cv::Mat linearRegressionWithValidation(cv::Mat A, cv::Mat b, std::vector<float> lambdaFactors, int numFolds, int rowsPerGroup, bool regularizeAffineComponent, SdmLandmarkModel::RegularisationPath& regularisationPath)
+{
+	Logger logger = Loggers->getLogger("superviseddescent");
+	if (!A.isContinuous() || !b.isContinuous() || A.type() != CV_32FC1 || b.type() != CV_32FC1 || A.rows != b.rows) {
+		string msg("linearRegressionWithValidation: A and b must be continuous float matrices with the same number of rows.");
+		logger.error(msg);
+		throw std::runtime_error(msg);
+	}
+	if (lambdaFactors.empty() || rowsPerGroup < 1 || A.rows % rowsPerGroup != 0) {
+		string msg("linearRegressionWithValidation: There must be at least one lambda and the rows must consist of complete groups.");
+		logger.error(msg);
+		throw std::runtime_error(msg);
+	}
+	int numGroups = A.rows / rowsPerGroup;
+	if (numFolds < 2 || numFolds > numGroups) {
+		string msg("linearRegressionWithValidation: The number of folds must be at least 2 and at most the number of groups (" + lexical_cast<string>(numGroups) + ").");
+		logger.error(msg);
+		throw std::runtime_error(msg);
+	}
+	Eigen::MatrixXf A_Eigen = Eigen::Map<RowMajorMatrixXf>(A.ptr<float>(), A.rows, A.cols);
+	Eigen::MatrixXf b_Eigen = Eigen::Map<RowMajorMatrixXf>(b.ptr<float>(), b.rows, b.cols);
+
+	// The lambdas are given in units of the automatic regularisation, see linearRegression(...)
+	float automaticLambda = (A_Eigen.transpose() * A_Eigen).norm() / A.rows;
+	std::sort(begin(lambdaFactors), end(lambdaFactors));
+	regularisationPath.lambdas.clear();
+	for (const auto& factor : lambdaFactors) {
+		regularisationPath.lambdas.push_back(factor * automaticLambda);
+	}
+	regularisationPath.validationErrors.assign(regularisationPath.lambdas.size(), 0.0f);
+
+	// k-fold cross-validation, the groups are assigned to the folds in turn
+	std::chrono::time_point<std::chrono::system_clock> validationStart = std::chrono::system_clock::now();
+	for (int fold = 0; fold < numFolds; ++fold) {
+		int numValidationGroups = (numGroups - fold + numFolds - 1) / numFolds;
+		int numValidationRows = numValidationGroups * rowsPerGroup;
+		Eigen::MatrixXf trainingA(A.rows - numValidationRows, A.cols), trainingB(A.rows - numValidationRows, b.cols);
+		Eigen::MatrixXf validationA(numValidationRows, A.cols), validationB(numValidationRows, b.cols);
+		int trainingRow = 0, validationRow = 0;
+		for (int group = 0; group < numGroups; ++group) {
+			if (group % numFolds == fold) {
+				validationA.middleRows(validationRow, rowsPerGroup) = A_Eigen.middleRows(group * rowsPerGroup, rowsPerGroup);
+				validationB.middleRows(validationRow, rowsPerGroup) = b_Eigen.middleRows(group * rowsPerGroup, rowsPerGroup);
+				validationRow += rowsPerGroup;
+			} else {
+				trainingA.middleRows(trainingRow, rowsPerGroup) = A_Eigen.middleRows(group * rowsPerGroup, rowsPerGroup);
+				trainingB.middleRows(trainingRow, rowsPerGroup) = b_Eigen.middleRows(group * rowsPerGroup, rowsPerGroup);
+				trainingRow += rowsPerGroup;
+			}
+		}
+		RegularisationPathSolver solver(trainingA, trainingB, !regularizeAffineComponent);
+		Eigen::MatrixXf projectedValidationA = solver.project(validationA);
+		for (size_t i = 0; i < regularisationPath.lambdas.size(); ++i) {
+			float squaredError = (solver.predict(projectedValidationA, regularisationPath.lambdas[i]) - validationB).squaredNorm();
+			regularisationPath.validationErrors[i] += squaredError / (A.rows * b.cols); // each row is validated exactly once
+		}
+	}
+	std::chrono::time_point<std::chrono::system_clock> validationEnd = std::chrono::system_clock::now();
+	logger.debug("Cross-validating " + lexical_cast<string>(regularisationPath.lambdas.size()) + " lambdas with " + lexical_cast<string>(numFolds) + " folds took " + lexical_cast<string>(std::chrono::duration_cast<std::chrono::milliseconds>(validationEnd - validationStart).count()) + "ms.");
+
+	auto bestError = std::min_element(begin(regularisationPath.validationErrors), end(regularisationPath.validationErrors));
+	size_t bestIndex = std::distance(begin(regularisationPath.validationErrors), bestError);
+	regularisationPath.lambda = regularisationPath.lambdas[bestIndex];
+	for (size_t i = 0; i < regularisationPath.lambdas.size(); ++i) {
+		logger.debug("Lambda factor " + lexical_cast<string>(lambdaFactors[i]) + " (lambda " + lexical_cast<string>(regularisationPath.lambdas[i]) + "): validation error " + lexical_cast<string>(regularisationPath.validationErrors[i]));
+	}
+	logger.debug("Choosing lambda factor " + lexical_cast<string>(lambdaFactors[bestIndex]) + " (lambda " + lexical_cast<string>(regularisationPath.lambda) + ").");
+	if (bestIndex == 0 || bestIndex == lambdaFactors.size() - 1) {
+		logger.warn("The chosen lambda lies at the border of the given grid. Consider extending the grid.");
+	}
+
+	// Solve on all data with the chosen lambda
+	RegularisationPathSolver solver(A_Eigen, b_Eigen, !regularizeAffineComponent);
+	Mat x(A.cols, b.cols, CV_32FC1);
+	Eigen::Map<RowMajorMatrixXf>(x.ptr<float>(), x.rows, x.cols) = solver.solve(regularisationPath.lambda);
+	return x;
+}
+
 float calculateEigenvalueThreshold(cv::Mat matrix)
 {
 	Logger logger = Loggers->getLogger("superviseddescent");
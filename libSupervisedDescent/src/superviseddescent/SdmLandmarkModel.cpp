@@ -38,6 +38,7 @@ SdmLandmarkModel::SdmLandmarkModel(cv::Mat meanLandmarks, std::vector<std::strin
 	this->regressorData = regressorData;
 	this->descriptorExtractors = descriptorExtractors;
 	this->descriptorTypes = descriptorTypes;
+	this->projections.resize(regressorData.size());
 }
 
 int SdmLandmarkModel::getNumLandmarks() const
@@ -70,6 +71,42 @@ std::string SdmLandmarkModel::getDescriptorType(int cascadeLevel)
 	return descriptorTypes[cascadeLevel];
 }
 
+cv::Mat SdmLandmarkModel::projectDescriptors(int cascadeLevel, cv::Mat descriptors) const
+{
+	const Projection& projection = projections[cascadeLevel];
+	if (projection.mean.empty()) {
+		return descriptors;
+	}
+	Mat centeredDescriptors = descriptors - cv::repeat(projection.mean, descriptors.rows, 1);
+	return centeredDescriptors * projection.basis;
+}
+
+void SdmLandmarkModel::setProjections(std::vector<Projection> projections)
+{
+	if (projections.size() != regressorData.size()) {
+		throw std::runtime_error("SdmLandmarkModel: The number of descriptor projections must match the number of cascade steps.");
+	}
+	for (size_t i = 0; i < projections.size(); ++i) {
+		if (!projections[i].mean.empty() && projections[i].basis.cols != regressorData[i].rows - 1) {
+			throw std::runtime_error("SdmLandmarkModel: The dimension of the projection of cascade step " + lexical_cast<string>(i) + " does not match its regressor.");
+		}
+	}
+	this->projections = projections;
+}
+
+std::vector<SdmLandmarkModel::RegularisationPath> SdmLandmarkModel::getRegularisationPaths() const
+{
+	return regularisationPaths;
+}
+
+void SdmLandmarkModel::setRegularisationPaths(std::vector<RegularisationPath> regularisationPaths)
+{
+	if (!regularisationPaths.empty() && regularisationPaths.size() != regressorData.size()) {
+		throw std::runtime_error("SdmLandmarkModel: The number of regularisation paths must match the number of cascade steps.");
+	}
+	this->regularisationPaths = regularisationPaths;
+}
+
 std::vector<cv::Point2f> SdmLandmarkModel::getMeanAsPoints() const
 {
 	std::vector<cv::Point2f> landmarks;
@@ -112,8 +149,27 @@ void SdmLandmarkModel::save(boost::filesystem::path filename, std::string commen
 		// write the params for this cascade level
 		file << "cascadeStep " << i << " rows " << getRegressorData(i).rows << " cols " << getRegressorData(i).cols << std::endl;
 		file << "descriptorType " << descriptorTypes[i] << std::endl;
-		file << "descriptorPostprocessing " << "none" << std::endl;
+		const Projection& projection = projections[i];
+		if (projection.mean.empty()) {
+			file << "descriptorPostprocessing " << "none" << std::endl;
+		}
+		else {
+			file << "descriptorPostprocessing " << "projection rows " << projection.basis.rows << " cols " << projection.basis.cols << std::endl;
+		}
 		file << "descriptorParameters " << descriptorExtractors[i]->getParameterString() << std::endl;
+		// write the projection: first the mean in one line, then the basis
+		if (!projection.mean.empty()) {
+			for (int col = 0; col < projection.mean.cols; ++col) {
+				file << projection.mean.at<float>(col) << " ";
+			}
+			file << std::endl;
+			for (int row = 0; row < projection.basis.rows; ++row) {
+				for (int col = 0; col < projection.basis.cols; ++col) {
+					file << projection.basis.at<float>(row, col) << " ";
+				}
+				file << std::endl;
+			}
+		}
 		// write the regressor data
 		Mat regressor = getRegressorData(i);
 		for (int row = 0; row < regressor.rows; ++row) {
@@ -123,6 +179,19 @@ void SdmLandmarkModel::save(boost::filesystem::path filename, std::string commen
 			file << std::endl;
 		}
 	}
+	// write the regularisation paths, if the regularisation was chosen by validation (optional section, older models don't have it)
+	for (size_t i = 0; i < regularisationPaths.size(); ++i) {
+		const RegularisationPath& regularisationPath = regularisationPaths[i];
+		file << "regularisationPath " << i << " lambda " << regularisationPath.lambda << " numLambdas " << regularisationPath.lambdas.size() << std::endl;
+		for (const auto& lambda : regularisationPath.lambdas) {
+			file << lambda << " ";
+		}
+		file << std::endl;
+		for (const auto& error : regularisationPath.validationErrors) {
+			file << error << " ";
+		}
+		file << std::endl;
+	}
 	file.close();
 	return;
 }
@@ -175,7 +244,18 @@ SdmLandmarkModel SdmLandmarkModel::load(boost::filesystem::path filename)
 		boost::trim_right_if(line, boost::is_any_of("\r"));
 		boost::split(stringContainer, line, boost::is_any_of(" "));
 		string descriptorType = (stringContainer[1]);
-		std::getline(file, line); // descriptorPostprocessing none. Not in use yet.
+		std::getline(file, line); // descriptorPostprocessing none, or: descriptorPostprocessing projection rows 3168 cols 200
+		boost::trim_right_if(line, boost::is_any_of("\r"));
+		boost::split(stringContainer, line, boost::is_any_of(" "));
+		int numProjectionRows = 0; // = numDescriptorDimensions
+		int numProjectionCols = 0; // = numProjectedDimensions
+		if (stringContainer.size() == 6 && stringContainer[1] == "projection") {
+			numProjectionRows = lexical_cast<int>(stringContainer[3]);
+			numProjectionCols = lexical_cast<int>(stringContainer[5]);
+		}
+		else if (stringContainer.size() < 2 || stringContainer[1] != "none") {
+			throw std::logic_error("descriptorPostprocessing does not match 'none' or 'projection rows <rows> cols <cols>'.");
+		}
 		std::getline(file, line); // descriptorParameters
 		boost::trim_right_if(line, boost::is_any_of("\r"));
 		if (descriptorType == "OpenCVSift") { // Todo: make a load method in each descriptor
@@ -215,6 +295,27 @@ SdmLandmarkModel SdmLandmarkModel::load(boost::filesystem::path filename)
 			throw std::logic_error("descriptorType does not match 'OpenCVSift', 'vlhog-dt' or 'vlhog-uoctti'.");
 		}
 
+		Projection projection;
+		if (numProjectionRows > 0) {
+			projection.mean = Mat(1, numProjectionRows, CV_32FC1);
+			std::getline(file, line); // float1 float2 ... float3168
+			boost::trim_right_if(line, boost::is_any_of("\r"));
+			boost::split(stringContainer, line, boost::is_any_of(" "));
+			for (int col = 0; col < numProjectionRows; ++col) {
+				projection.mean.at<float>(col) = lexical_cast<float>(stringContainer[col]);
+			}
+			projection.basis = Mat(numProjectionRows, numProjectionCols, CV_32FC1);
+			for (int j = 0; j < numProjectionRows; ++j) {
+				std::getline(file, line); // float1 float2 ... float200
+				boost::trim_right_if(line, boost::is_any_of("\r"));
+				boost::split(stringContainer, line, boost::is_any_of(" "));
+				for (int col = 0; col < numProjectionCols; ++col) {
+					projection.basis.at<float>(j, col) = lexical_cast<float>(stringContainer[col]);
+				}
+			}
+		}
+		model.projections.push_back(projection);
+
 		Mat regressorData(numRows, numCols, CV_32FC1);
 		// read numRows lines
 		for (int j = 0; j < numRows; ++j) {
@@ -228,6 +329,35 @@ SdmLandmarkModel SdmLandmarkModel::load(boost::filesystem::path filename)
 		}
 		model.regressorData.push_back(regressorData);
 	}
+	// read the optional regularisation paths
+	while (std::getline(file, line)) {
+		boost::trim_right_if(line, boost::is_any_of("\r"));
+		boost::split(stringContainer, line, boost::is_any_of(" "));
+		if (stringContainer.size() != 6 || stringContainer[0] != "regularisationPath") {
+			continue;
+		}
+		RegularisationPath regularisationPath;
+		regularisationPath.lambda = lexical_cast<float>(stringContainer[3]);
+		int numLambdas = lexical_cast<int>(stringContainer[5]);
+		std::getline(file, line); // lambda1 lambda2 ...
+		boost::trim_right_if(line, boost::is_any_of("\r"));
+		boost::split(stringContainer, line, boost::is_any_of(" "));
+		for (int j = 0; j < numLambdas; ++j) { // again, stringContainer contains one more entry, the trailing whitespace
+			regularisationPath.lambdas.push_back(lexical_cast<float>(stringContainer[j]));
+		}
+		std::getline(file, line); // error1 error2 ...
+		boost::trim_right_if(line, boost::is_any_of("\r"));
+		boost::split(stringContainer, line, boost::is_any_of(" "));
+		for (int j = 0; j < numLambdas; ++j) {
+			regularisationPath.validationErrors.push_back(lexical_cast<float>(stringContainer[j]));
+		}
+		model.regularisationPaths.push_back(regularisationPath);
+	}
+	if (!model.regularisationPaths.empty() && model.regularisationPaths.size() != model.regressorData.size()) {
+		string errorMessage = "The SDM model file contains regularisation paths for only some of the cascade steps: " + filename.string();
+		logger.error(errorMessage);
+		throw std::runtime_error(errorMessage);
+	}
 
 	return model;
 }
@@ -10,6 +10,8 @@
 #include "classification/ExampleManagement.hpp"
 #include "classification/UnlimitedExampleManagement.hpp"
 #include "classification/EmptyExampleManagement.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include "svm.h"
 #include <fstream>
 #include <stdexcept>
@@ -17,6 +19,8 @@
 using classification::Kernel;
 using classification::SvmClassifier;
 using classification::ExampleManagement;
+using classification::BinaryModelWriter;
+using classification::BinaryModelReader;
 using classification::UnlimitedExampleManagement;
 using classification::EmptyExampleManagement;
 using cv::Mat;
@@ -171,4 +175,16 @@ void LibSvmClassifier::reset() {
 	negativeExamples->clear();
 }
 
+void LibSvmClassifier::saveState(BinaryModelWriter& writer) const {
+	TrainableSvmClassifier::saveState(writer);
+	positiveExamples->saveState(writer);
+	negativeExamples->saveState(writer);
+}
+
+void LibSvmClassifier::loadState(BinaryModelReader& reader) {
+	TrainableSvmClassifier::loadState(reader);
+	positiveExamples->loadState(reader);
+	negativeExamples->loadState(reader);
+}
+
 } /* namespace libsvm */
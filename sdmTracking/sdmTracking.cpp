@@ -62,6 +62,7 @@
 #include "imageio/IbugLandmarkFormatParser.hpp"
 
 #include "logging/LoggerFactory.hpp"
+#include "logging/Tracer.hpp"
 
 using namespace imageio;
 using namespace superviseddescentmodel;
@@ -74,6 +75,7 @@ using boost::lexical_cast;
 using cv::Mat;
 using logging::Logger;
 using logging::LoggerFactory;
+using logging::Tracer;
 using logging::loglevel;
 
 
@@ -109,6 +111,7 @@ int main(int argc, char *argv[])
 	path sdmModelFile;
 	path faceDetectorFilename;
 	bool trackingMode;
+	path traceFilename;
 
 	try {
 		po::options_description desc("Allowed options");
@@ -135,6 +138,8 @@ int main(int argc, char *argv[])
 				"specify the type of landmarks to load: ibug")
 			("tracking-mode,r", po::value<bool>(&trackingMode)->default_value(false)->implicit_value(true),
 				"If on, V&J will be run to initialize the model only and after the model lost tracking. If off, V&J will be run on every frame/image.")
+			("trace", po::value<path>(&traceFilename),
+				"enable the performance tracing, write the events to the given Chrome trace (.json) file and log a summary at the end")
 		;
 
 		po::positional_options_description p;
@@ -299,7 +304,11 @@ int main(int argc, char *argv[])
 	std::ofstream resultsFile("C:\\Users\\Patrik\\Documents\\GitHub\\sdm_lfpw_tr_68lm_10s_5c_RESULTS.txt");
 	vector<string> comparisonLandmarks({ "9", "31", "37", "40", "43", "46", "49", "55", "63", "67" });
 
+	if (!traceFilename.empty())
+		Tracers->setEnabled(true);
+
 	while(labeledImageSource->next()) {
+		TRACE_SCOPE("sdmTracking::frame");
 		start = std::chrono::system_clock::now();
 		appLogger.info("Starting to process " + labeledImageSource->getName().string());
 		img = labeledImageSource->getImage();
@@ -324,7 +333,10 @@ int main(int argc, char *argv[])
 		float score, notFace = 0.5;
 		
 		// face detection
-		faceCascade.detectMultiScale(img, faces, 1.2, 2, 0, cv::Size(50, 50));
+		{
+			TRACE_SCOPE("sdmTracking::faceDetection");
+			faceCascade.detectMultiScale(img, faces, 1.2, 2, 0, cv::Size(50, 50));
+		}
 		//faces.push_back({ 172, 199, 278, 278 });
 		if (faces.empty()) {
 			runRigidAlign = true;
@@ -368,7 +380,10 @@ int main(int argc, char *argv[])
 		for (int i = 0; i < lmModel.getNumLandmarks(); ++i) {
 			cv::circle(landmarksImage, Point2f(modelShape.at<float>(i, 0), modelShape.at<float>(i + lmModel.getNumLandmarks(), 0)), 3, Scalar(255.0f, 0.0f, 255.0f));
 		}
-		modelShape = modelFitter.optimize(modelShape, imgGray);
+		{
+			TRACE_SCOPE("sdmTracking::sdmOptimization");
+			modelShape = modelFitter.optimize(modelShape, imgGray);
+		}
 		for (int i = 0; i < lmModel.getNumLandmarks(); ++i) {
 			cv::circle(landmarksImage, Point2f(modelShape.at<float>(i, 0), modelShape.at<float>(i + lmModel.getNumLandmarks(), 0)), 3, Scalar(0.0f, 255.0f, 0.0f));
 		}
@@ -402,5 +417,10 @@ int main(int argc, char *argv[])
 
 	resultsFile.close();
 
+	if (!traceFilename.empty()) {
+		appLogger.info("Performance trace:\n" + Tracers->getSummary());
+		Tracers->writeChromeTrace(traceFilename.string());
+	}
+
 	return 0;
 }
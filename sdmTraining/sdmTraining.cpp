@@ -172,6 +172,7 @@ int main(int argc, char *argv[])
 	vector<string> descriptorTypes;
 	vector<shared_ptr<DescriptorExtractor>> descriptorExtractors;
 	LandmarkBasedSupervisedDescentTraining::Regularisation regularisation;
+	vector<LandmarkBasedSupervisedDescentTraining::DescriptorProjection> descriptorProjections;
 
 	// Read the stuff from the config:
 	ptree pt;
@@ -190,6 +191,16 @@ int main(int argc, char *argv[])
 		regularisation.factor = ptParameters.get<float>("regularisationFactor", 0.5f);
 		regularisation.regulariseAffineComponent = ptParameters.get<bool>("regulariseAffineComponent", false);
 		regularisation.regulariseWithEigenvalueThreshold = ptParameters.get<bool>("regulariseWithEigenvalueThreshold", false);
+		regularisation.numValidationFolds = ptParameters.get<int>("regularisationValidationFolds", 0);
+		string factorGrid = ptParameters.get<string>("regularisationFactorGrid", "");
+		if (!factorGrid.empty()) {
+			vector<string> factors;
+			boost::split(factors, factorGrid, boost::is_any_of(" "), boost::token_compress_on);
+			regularisation.factorGrid.clear();
+			for (const auto& factor : factors) {
+				regularisation.factorGrid.push_back(boost::lexical_cast<float>(factor));
+			}
+		}
 		// Read the 'featureDescriptors' sub-tree:
 		ptree ptFeatureDescriptors = ptParameters.get_child("featureDescriptors");
 		for (const auto& kv : ptFeatureDescriptors) {
@@ -227,6 +238,15 @@ int main(int argc, char *argv[])
 				throw std::logic_error("descriptorType does not match 'OpenCVSift', 'vlhog-dt' or 'vlhog-uoctti'.");
 			}
 			descriptorTypes.push_back(descriptorType);
+			LandmarkBasedSupervisedDescentTraining::DescriptorProjection descriptorProjection;
+			if (descriptorPostprocessing == "pca") {
+				descriptorProjection.retainedVariance = kv.second.get<float>("pcaRetainedVariance", 0.98f);
+				descriptorProjection.numComponents = kv.second.get<int>("pcaNumComponents", 0);
+			}
+			else if (descriptorPostprocessing != "none") {
+				throw std::logic_error("descriptorPostprocessing does not match 'none' or 'pca'.");
+			}
+			descriptorProjections.push_back(descriptorProjection);
 		}
 
 		// Get stuff from the modelLandmarks subtree:
@@ -455,6 +475,7 @@ int main(int argc, char *argv[])
 	tr.setNumSamplesPerImage(numSamplesPerImage);
 	tr.setNumCascadeSteps(numCascadeSteps);
 	tr.setRegularisation(regularisation);
+	tr.setDescriptorProjections(descriptorProjections);
 	tr.setAlignGroundtruth(LandmarkBasedSupervisedDescentTraining::AlignGroundtruth::NONE); // TODO Read from config!
 	tr.setMeanNormalization(LandmarkBasedSupervisedDescentTraining::MeanNormalization::UNIT_SUM_SQUARED_NORMS); // TODO Read from config!
 	SdmLandmarkModel model = tr.train(trainingImages, trainingGroundtruthLandmarks, trainingFaceboxes, modelLandmarks, descriptorTypes, descriptorExtractors);
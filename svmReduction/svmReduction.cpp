@@ -0,0 +1,218 @@
+/*
+ * svmReduction.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <iostream>
+#include <chrono>
+
+#include "opencv2/core/core.hpp"
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "imageio/DirectoryImageSource.hpp"
+#include "imageprocessing/GrayscaleFilter.hpp"
+#include "imageprocessing/ResizingFilter.hpp"
+#include "imageprocessing/HistEq64Filter.hpp"
+#include "imageprocessing/ConversionFilter.hpp"
+#include "imageprocessing/ChainedFilter.hpp"
+#include "classification/ReducedSetConstruction.hpp"
+#include "classification/SvmClassifier.hpp"
+#include "classification/ProbabilisticSvmClassifier.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+using namespace classification;
+using namespace imageprocessing;
+namespace po = boost::program_options;
+using imageio::DirectoryImageSource;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using boost::filesystem::path;
+using boost::lexical_cast;
+using cv::Mat;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+
+shared_ptr<SvmClassifier> loadSvm(const path& classifierFile) {
+	if (classifierFile.extension() == ".bin")
+		return SvmClassifier::loadFromBinary(classifierFile.string());
+	if (classifierFile.extension() == ".mat")
+		return SvmClassifier::loadFromMatlab(classifierFile.string());
+	return SvmClassifier::loadFromText(classifierFile.string());
+}
+
+shared_ptr<ProbabilisticSvmClassifier> loadProbabilisticSvm(const path& classifierFile, const path& logisticFile) {
+	if (classifierFile.extension() == ".bin")
+		return ProbabilisticSvmClassifier::loadFromBinary(classifierFile.string());
+	if (classifierFile.extension() == ".mat")
+		return ProbabilisticSvmClassifier::loadFromMatlab(classifierFile.string(), logisticFile.string());
+	return make_shared<ProbabilisticSvmClassifier>(SvmClassifier::loadFromText(classifierFile.string()));
+}
+
+vector<Mat> loadPatches(const path& directory, const ImageFilter& filter) {
+	vector<Mat> patches;
+	DirectoryImageSource source(directory.string());
+	while (source.next())
+		patches.push_back(filter.applyTo(source.getImage()));
+	return patches;
+}
+
+double measureMilliseconds(const SvmClassifier& svm, const vector<Mat>& patches) {
+	auto start = std::chrono::steady_clock::now();
+	double sum = 0;
+	for (const Mat& patch : patches)
+		sum += svm.computeHyperplaneDistance(patch);
+	auto duration = std::chrono::steady_clock::now() - start;
+	return sum == sum ? std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0 : 0; // use the sum, so the loop is not optimized away
+}
+
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	string classifierType;
+	path classifierFile;
+	path logisticFile;
+	path validationDirectory;
+	path outputFile;
+	size_t vectorCount;
+	int iterationCount;
+	int restartCount;
+	string feature;
+	bool floatPatches;
+	int patchWidth;
+	int patchHeight;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO","show messages with INFO loglevel or below."),
+				  "specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("type,t", po::value<string>(&classifierType)->default_value("svm"),
+				"type of the classifier: svm or psvm")
+			("classifier,c", po::value<path>(&classifierFile)->required(),
+				"classifier file (.mat, .bin or text file)")
+			("thresholds,s", po::value<path>(&logisticFile)->default_value(path()),
+				"thresholds file (.mat) containing the logistic parameters, only needed for Matlab psvm classifiers")
+			("vectors,n", po::value<size_t>(&vectorCount)->required(),
+				"number of synthetic vectors of the reduced SVM")
+			("iterations", po::value<int>(&iterationCount)->default_value(100),
+				"maximum number of fixed-point iterations per synthetic vector")
+			("restarts", po::value<int>(&restartCount)->default_value(5),
+				"number of starting points of the fixed-point iteration per synthetic vector")
+			("validation,p", po::value<path>(&validationDirectory),
+				"directory containing validation patches to measure the approximation error on")
+			("feature,f", po::value<string>(&feature)->default_value("gray"),
+				"feature space of the classifier: gray or hq64")
+			("float-patches", po::value<bool>(&floatPatches)->implicit_value(true)->default_value(false),
+				"convert the validation patches to CV_32F with values between 0 and 1")
+			("patch-width", po::value<int>(&patchWidth)->default_value(20),
+				"width the validation patches are resized to")
+			("patch-height", po::value<int>(&patchHeight)->default_value(20),
+				"height the validation patches are resized to")
+			("output,o", po::value<path>(&outputFile)->required(),
+				"output file for the reduced classifier in the binary format (.bin)")
+		;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: svmReduction [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid log level." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	Loggers->getLogger("classification").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("svmReduction").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("svmReduction");
+
+	boost::algorithm::to_lower(classifierType);
+	try {
+		shared_ptr<ProbabilisticSvmClassifier> probabilisticSvm;
+		shared_ptr<SvmClassifier> svm;
+		if (classifierType == "svm") {
+			svm = loadSvm(classifierFile);
+		} else if (classifierType == "psvm") {
+			probabilisticSvm = loadProbabilisticSvm(classifierFile, logisticFile);
+			svm = probabilisticSvm->getSvm();
+		} else {
+			appLogger.error("Unknown classifier type: " + classifierType);
+			return EXIT_FAILURE;
+		}
+
+		ReducedSetConstruction construction(iterationCount, restartCount);
+		shared_ptr<SvmClassifier> reducedSvm = construction.reduce(*svm, vectorCount);
+
+		if (!validationDirectory.empty()) {
+			ChainedFilter patchFilter;
+			patchFilter.add(make_shared<GrayscaleFilter>());
+			patchFilter.add(make_shared<ResizingFilter>(cv::Size(patchWidth, patchHeight)));
+			if (boost::iequals(feature, "hq64")) {
+				patchFilter.add(make_shared<HistEq64Filter>());
+			} else if (!boost::iequals(feature, "gray")) {
+				appLogger.error("Unknown feature space: " + feature);
+				return EXIT_FAILURE;
+			}
+			if (floatPatches)
+				patchFilter.add(make_shared<ConversionFilter>(CV_32F, 1.0 / 255.0));
+			vector<Mat> patches = loadPatches(validationDirectory, patchFilter);
+			ReducedSetConstruction::ApproximationError error = ReducedSetConstruction::computeApproximationError(*svm, *reducedSvm, patches);
+			appLogger.info("Approximation error on " + lexical_cast<string>(patches.size()) + " validation patches: mean absolute difference "
+					+ lexical_cast<string>(error.meanAbsoluteDifference) + ", maximum absolute difference " + lexical_cast<string>(error.maxAbsoluteDifference)
+					+ ", label agreement " + lexical_cast<string>(error.labelAgreement));
+			appLogger.info("Evaluation time of the original SVM (" + lexical_cast<string>(svm->getSupportVectors().size()) + " vectors): "
+					+ lexical_cast<string>(measureMilliseconds(*svm, patches)) + "ms");
+			appLogger.info("Evaluation time of the reduced SVM (" + lexical_cast<string>(reducedSvm->getSupportVectors().size()) + " vectors): "
+					+ lexical_cast<string>(measureMilliseconds(*reducedSvm, patches)) + "ms");
+		}
+
+		if (probabilisticSvm) {
+			svm->setSvmParameters(reducedSvm->getSupportVectors(), reducedSvm->getCoefficients(), reducedSvm->getBias());
+			probabilisticSvm->saveToBinary(outputFile.string());
+		} else {
+			reducedSvm->saveToBinary(outputFile.string());
+		}
+		appLogger.info("Stored the reduced classifier in " + outputFile.string());
+	} catch (const std::exception& error) {
+		appLogger.error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
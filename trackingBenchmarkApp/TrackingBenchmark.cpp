@@ -43,6 +43,8 @@
 #include "imageprocessing/ExtendedHogFilter.hpp"
 #include "imageprocessing/IntegralGradientFilter.hpp"
 #include "imageprocessing/GradientSumFilter.hpp"
+#include "imageprocessing/IntegralGradientChannelFilter.hpp"
+#include "imageprocessing/IntegralGradientSumFilter.hpp"
 #include "imageprocessing/ImagePyramid.hpp"
 #include "imageprocessing/DirectImageFeatureExtractor.hpp"
 #include "imageprocessing/FilteringFeatureExtractor.hpp"
@@ -60,6 +62,8 @@
 #include "classification/ConfidenceBasedExampleManagement.hpp"
 #include "classification/UnlimitedExampleManagement.hpp"
 #include "classification/FixedTrainableProbabilisticSvmClassifier.hpp"
+#include "classification/BinaryModelWriter.hpp"
+#include "classification/BinaryModelReader.hpp"
 #include "libsvm/LibSvmClassifier.hpp"
 #ifdef WITH_LIBLINEAR_CLASSIFIER
 	#include "liblinear/LibLinearClassifier.hpp"
@@ -67,10 +71,13 @@
 #include "condensation/ResamplingSampler.hpp"
 #include "condensation/GridSampler.hpp"
 #include "condensation/LowVarianceSampling.hpp"
+#include "condensation/KldSampleCount.hpp"
 #include "condensation/SimpleTransitionModel.hpp"
 #include "condensation/OpticalFlowTransitionModel.hpp"
 #include "condensation/PositionDependentMeasurementModel.hpp"
 #include "condensation/ExtendedHogBasedMeasurementModel.hpp"
+#include "condensation/TwoTierMeasurementModel.hpp"
+#include "condensation/StateValidator.hpp"
 #include "condensation/FilteringStateExtractor.hpp"
 #include "condensation/WeightedMeanStateExtractor.hpp"
 #include "condensation/Sample.hpp"
@@ -82,6 +89,7 @@
 #include <iostream>
 #include <chrono>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
 
 using namespace logging;
@@ -96,12 +104,13 @@ using boost::lexical_cast;
 using std::milli;
 using std::move;
 using std::ofstream;
+using std::ifstream;
 using std::ostringstream;
 using std::istringstream;
 using std::runtime_error;
 using std::invalid_argument;
 
-TrackingBenchmark::TrackingBenchmark(ptree& config) {
+TrackingBenchmark::TrackingBenchmark(ptree& config) : fineEvaluationShare(0), averageParticleCount(0) {
 	initTracking(config);
 }
 
@@ -113,14 +122,20 @@ shared_ptr<DirectPyramidFeatureExtractor> TrackingBenchmark::createPyramidExtrac
 				config.get<int>("patch.minWidth"), config.get<int>("patch.maxWidth"),
 				config.get<int>("interval"));
 		pyramidExtractor->addImageFilter(make_shared<GrayscaleFilter>());
+		pyramidExtractor->getPyramid()->setFusedConversion(config.get<bool>("fusedConversion", false));
+		if (config.get<bool>("arenaStorage", false))
+			enableArenaStorage(pyramidExtractor->getPyramid());
 		return pyramidExtractor;
 	} else if (config.get_value<string>() == "derived") {
 		if (!pyramid)
 			throw invalid_argument("base pyramid necessary for creating a derived pyramid");
-		if (needsLayerFilters)
-			return make_shared<DirectPyramidFeatureExtractor>(make_shared<ImagePyramid>(pyramid),
+		if (needsLayerFilters) {
+			shared_ptr<ImagePyramid> derivedPyramid = make_shared<ImagePyramid>(pyramid);
+			if (config.get<bool>("arenaStorage", false))
+				enableArenaStorage(derivedPyramid);
+			return make_shared<DirectPyramidFeatureExtractor>(derivedPyramid,
 					config.get<int>("patch.width"), config.get<int>("patch.height"));
-		else
+		} else
 			return make_shared<DirectPyramidFeatureExtractor>(pyramid,
 					config.get<int>("patch.width"), config.get<int>("patch.height"));
 	} else {
@@ -212,6 +227,14 @@ shared_ptr<FeatureExtractor> TrackingBenchmark::createFeatureExtractor(
 		featureExtractor->addPatchFilter(make_shared<GradientSumFilter>(config.get<int>("cellCount")));
 		featureExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
 		return wrapFeatureExtractor(make_shared<IntegralFeatureExtractor>(featureExtractor), scaleFactor);
+	} else if (config.get_value<string>() == "psurf") { // not interchangeable with surf (dense layer gradients instead of box gradients)
+		pyramidExtractor = createPyramidExtractor(config.get_child("pyramid"), pyramid, true);
+		pyramidExtractor->setPatchSize(pyramidExtractor->getPatchWidth() + 1, pyramidExtractor->getPatchHeight() + 1);
+		pyramidExtractor->addLayerFilter(make_shared<GradientFilter>(config.get<int>("gradientKernel"), config.get<int>("blurKernel")));
+		pyramidExtractor->addLayerFilter(make_shared<IntegralGradientChannelFilter>());
+		pyramidExtractor->addPatchFilter(make_shared<IntegralGradientSumFilter>(config.get<int>("cellCount")));
+		pyramidExtractor->addPatchFilter(make_shared<UnitNormFilter>(cv::NORM_L2));
+		return wrapFeatureExtractor(make_shared<IntegralFeatureExtractor>(pyramidExtractor), scaleFactor);
 	} else if (config.get_value<string>() == "lbp") {
 		pyramidExtractor = createPyramidExtractor(config.get_child("pyramid"), pyramid, true);
 		shared_ptr<LbpFilter> lbpFilter = createLbpFilter(config.get<string>("type"));
@@ -400,6 +423,33 @@ shared_ptr<TrainableProbabilisticClassifier> TrackingBenchmark::createTrainableP
 	return svm;
 }
 
+shared_ptr<PositionDependentMeasurementModel> TrackingBenchmark::createPositionDependentModel(
+		shared_ptr<ImagePyramid> pyramid, shared_ptr<TrainableProbabilisticClassifier> classifier, ptree& config) {
+	shared_ptr<FeatureExtractor> featureExtractor = createFeatureExtractor(pyramid, config.get_child("feature"));
+	shared_ptr<PositionDependentMeasurementModel> model = make_shared<PositionDependentMeasurementModel>(featureExtractor, classifier);
+	model->setFrameCounts(
+			config.get<unsigned int>("startFrameCount"),
+			config.get<unsigned int>("stopFrameCount"));
+	model->setThresholds(
+			config.get<float>("targetThreshold"),
+			config.get<float>("confidenceThreshold"));
+	model->setOffsetFactors(
+			config.get<float>("positiveOffsetFactor"),
+			config.get<float>("negativeOffsetFactor"));
+	model->setSamplingProperties(
+			config.get<unsigned int>("sampleNegativesAroundTarget"),
+			config.get<unsigned int>("sampleAdditionalNegatives"),
+			config.get<unsigned int>("sampleTestNegatives"),
+			config.get<bool>("exploitSymmetry"));
+	return model;
+}
+
+void TrackingBenchmark::enableArenaStorage(shared_ptr<ImagePyramid> pyramid) {
+	// the patch filters of all feature types create new images, so the extracted features do not reference the layers
+	pyramid->setArenaStorage(true);
+	arenaPyramids.push_back(pyramid);
+}
+
 void TrackingBenchmark::initTracking(ptree& config) {
 	// create base pyramid
 	shared_ptr<ImagePyramid> pyramid;
@@ -411,6 +461,9 @@ void TrackingBenchmark::initTracking(ptree& config) {
 				pyramidConfig->get<int>("interval"));
 		tmp.addImageFilter(make_shared<GrayscaleFilter>());
 		pyramid = tmp.getPyramid();
+		pyramid->setFusedConversion(pyramidConfig->get<bool>("fusedConversion", false));
+		if (pyramidConfig->get<bool>("arenaStorage", false))
+			enableArenaStorage(pyramid);
 	}
 
 	// create adaptive measurement model
@@ -464,27 +517,26 @@ void TrackingBenchmark::initTracking(ptree& config) {
 		measurementModel = model;
 		hogModel = model;
 	} else if (config.get<string>("adaptive.measurement") == "positionDependent") {
-		shared_ptr<FeatureExtractor> adaptiveFeatureExtractor = createFeatureExtractor(pyramid, config.get_child("adaptive.measurement.feature"));
-		shared_ptr<PositionDependentMeasurementModel> model = make_shared<PositionDependentMeasurementModel>(adaptiveFeatureExtractor, classifier);
-		model->setFrameCounts(
-				config.get<unsigned int>("adaptive.measurement.startFrameCount"),
-				config.get<unsigned int>("adaptive.measurement.stopFrameCount"));
-		model->setThresholds(
-				config.get<float>("adaptive.measurement.targetThreshold"),
-				config.get<float>("adaptive.measurement.confidenceThreshold"));
-		model->setOffsetFactors(
-				config.get<float>("adaptive.measurement.positiveOffsetFactor"),
-				config.get<float>("adaptive.measurement.negativeOffsetFactor"));
-		model->setSamplingProperties(
-				config.get<unsigned int>("adaptive.measurement.sampleNegativesAroundTarget"),
-				config.get<unsigned int>("adaptive.measurement.sampleAdditionalNegatives"),
-				config.get<unsigned int>("adaptive.measurement.sampleTestNegatives"),
-				config.get<bool>("adaptive.measurement.exploitSymmetry"));
-		measurementModel = model;
+		measurementModel = createPositionDependentModel(pyramid, classifier, config.get_child("adaptive.measurement"));
 	} else {
 		throw invalid_argument("AdaptiveTracking: invalid adaptive measurement model type: " + config.get<string>("adaptive.measurement"));
 	}
 
+	// optionally evaluate the particles coarse-to-fine, where the measurement model from above is the fine one
+	shared_ptr<StateValidator> fineValidator;
+	optional<ptree&> coarseConfig = config.get_child_optional("adaptive.coarse");
+	if (coarseConfig) {
+		if (coarseConfig->get_value<string>() != "positionDependent")
+			throw invalid_argument("TrackingBenchmark: invalid coarse measurement model type '" + coarseConfig->get_value<string>()
+					+ "', the coarse tier must be a positionDependent measurement model");
+		shared_ptr<TrainableProbabilisticClassifier> coarseClassifier = createTrainableProbabilisticClassifier(coarseConfig->get_child("classifier"));
+		shared_ptr<PositionDependentMeasurementModel> coarseModel = createPositionDependentModel(pyramid, coarseClassifier, *coarseConfig);
+		fineValidator = std::dynamic_pointer_cast<StateValidator>(measurementModel);
+		twoTierModel = make_shared<TwoTierMeasurementModel>(coarseModel, measurementModel,
+				coarseConfig->get<double>("fineFraction"), coarseConfig->get<double>("relativeThreshold"));
+		measurementModel = twoTierModel;
+	}
+
 	// create transition model
 	shared_ptr<TransitionModel> transitionModel;
 	if (config.get<string>("transition") == "simple") {
@@ -500,49 +552,130 @@ void TrackingBenchmark::initTracking(ptree& config) {
 	}
 
 	// create tracker
-	shared_ptr<ResamplingSampler> resamplingSampler = make_shared<ResamplingSampler>(
+	resamplingSampler = make_shared<ResamplingSampler>(
 			config.get<unsigned int>("adaptive.resampling.particleCount"), config.get<double>("adaptive.resampling.randomRate"),
 			make_shared<LowVarianceSampling>(), transitionModel,
 			config.get<double>("adaptive.resampling.minSize"), config.get<double>("adaptive.resampling.maxSize"));
+	optional<ptree&> kldConfig = config.get_child_optional("adaptive.resampling.kld");
+	if (kldConfig)
+		resamplingSampler->setAdaptiveCount(make_shared<KldSampleCount>(
+				kldConfig->get<size_t>("minCount"), kldConfig->get<size_t>("maxCount"),
+				kldConfig->get<double>("error"), kldConfig->get<double>("normalQuantile"),
+				kldConfig->get<double>("positionBinSize"), kldConfig->get<double>("scaleBinSize")));
 	shared_ptr<StateExtractor> stateExtractor = make_shared<FilteringStateExtractor>(make_shared<WeightedMeanStateExtractor>());
 	tracker = unique_ptr<AdaptiveCondensationTracker>(new AdaptiveCondensationTracker(
 			resamplingSampler, measurementModel, stateExtractor,
 			config.get<unsigned int>("adaptive.resampling.particleCount")));
+	if (fineValidator)
+		tracker->addValidator(fineValidator);
+}
+
+void TrackingBenchmark::adjustPatchSize(float aspectRatio) {
+	double dimension = pyramidExtractor->getPatchWidth() * pyramidExtractor->getPatchHeight();
+	double patchWidth = sqrt(dimension / aspectRatio);
+	double patchHeight = aspectRatio * patchWidth;
+	pyramidExtractor->setPatchSize(cvRound(patchWidth), cvRound(patchHeight));
+}
+
+void TrackingBenchmark::saveCheckpoint(const string& filename, size_t frames, double particleCountSum, const vector<optional<Rect>>& positions) const {
+	BinaryModelWriter writer(BinaryModelType::TRACKER_STATE);
+	tracker->saveState(writer);
+	writer.writeInt(frames);
+	writer.writeDouble(particleCountSum);
+	vector<int32_t> values;
+	values.reserve(5 * positions.size());
+	for (const optional<Rect>& position : positions) {
+		Rect bounds = position ? *position : Rect();
+		values.push_back(position ? 1 : 0);
+		values.push_back(bounds.x);
+		values.push_back(bounds.y);
+		values.push_back(bounds.width);
+		values.push_back(bounds.height);
+	}
+	writer.writeInt(positions.size());
+	writer.writeInts(values.data(), values.size());
+	// the checkpoint is written to a temporary file first, so an interruption cannot leave a broken checkpoint behind
+	writer.save(filename + ".tmp");
+	rename(path(filename + ".tmp"), path(filename));
+}
+
+void TrackingBenchmark::loadCheckpoint(const string& filename, size_t& frames, double& particleCountSum, vector<optional<Rect>>& positions) {
+	BinaryModelReader reader(filename);
+	tracker->loadState(reader);
+	frames = reader.readInt();
+	particleCountSum = reader.readDouble();
+	int positionCount = reader.readInt();
+	if (positionCount < 0)
+		throw runtime_error("invalid checkpoint " + filename);
+	Mat values = reader.readInts(5 * positionCount);
+	positions.clear();
+	for (int i = 0; i < positionCount; ++i) {
+		const int32_t* value = values.ptr<int32_t>() + 5 * i;
+		if (value[0] != 0)
+			positions.push_back(Rect(value[1], value[2], value[3], value[4]));
+		else
+			positions.push_back(optional<Rect>());
+	}
 }
 
-std::pair<double, double> TrackingBenchmark::runTest(shared_ptr<LabeledImageSource> imageSource, shared_ptr<OrderedLandmarkSink> landmarkSink, shared_ptr<OrderedLandmarkSink> learnedSink) {
+std::pair<double, double> TrackingBenchmark::runTest(shared_ptr<LabeledImageSource> imageSource, shared_ptr<OrderedLandmarkSink> landmarkSink, shared_ptr<OrderedLandmarkSink> learnedSink,
+		const string& checkpointFilename, size_t checkpointInterval, size_t interruptFrame) {
 	steady_clock::time_point start = steady_clock::now();
 	duration<double> condensationTime;
+	size_t frames = 0;
+	size_t resumedFrames = 0;
+	double particleCountSum = 0;
+	vector<optional<Rect>> positions; // the output positions so far, which are needed for resuming from a checkpoint
+	Mat frame;
 
-	// initialization via ground truth
-	if (!imageSource->next())
-		throw runtime_error("there are no images in source");
-	size_t frames = 1;
-	Mat frame = imageSource->getImage();
-	if (!imageSource->getLandmarks().isEmpty()) {
-		shared_ptr<Landmark> landmark = imageSource->getLandmarks().getLandmark();
-		Rect_<float> floatBounds = landmark->getRect();
-		Rect bounds(
-				Point(cvRound(floatBounds.tl().x), cvRound(floatBounds.tl().y)),
-				Point(cvRound(floatBounds.br().x), cvRound(floatBounds.br().y)));
-		if (landmark->isVisible() && bounds.x >= 0 && bounds.y >= 0 && bounds.br().x < frame.cols && bounds.br().y < frame.rows) {
-			if (pyramidExtractor) {
-				double dimension = pyramidExtractor->getPatchWidth() * pyramidExtractor->getPatchHeight();
-				float aspectRatio = landmark->getHeight() / landmark->getWidth();
-				double patchWidth = sqrt(dimension / aspectRatio);
-				double patchHeight = aspectRatio * patchWidth;
-				pyramidExtractor->setPatchSize(cvRound(patchWidth), cvRound(patchHeight));
-			}
-			steady_clock::time_point condensationStart = steady_clock::now();
-			optional<Rect> position = tracker->initialize(frame, bounds);
-			if (!position)
-				throw runtime_error("Adaptive tracker could not be initialized with " + lexical_cast<string>(bounds));
-			steady_clock::time_point condensationEnd = steady_clock::now();
-			condensationTime += duration_cast<milliseconds>(condensationEnd - condensationStart);
+	if (!checkpointFilename.empty() && exists(path(checkpointFilename))) {
+		// resume from the checkpoint of an interrupted run
+		loadCheckpoint(checkpointFilename, frames, particleCountSum, positions);
+		for (const optional<Rect>& position : positions) {
 			LandmarkCollection collection;
-			collection.insert(make_shared<RectLandmark>("target", *position));
+			if (position)
+				collection.insert(make_shared<RectLandmark>("target", *position));
+			else
+				collection.insert(make_shared<RectLandmark>("target"));
 			landmarkSink->add(collection);
 		}
+		for (size_t i = 0; i < frames; ++i) {
+			if (!imageSource->next())
+				throw runtime_error("the checkpoint " + checkpointFilename + " does not fit the image source");
+			if (i == 0 && pyramidExtractor && !imageSource->getLandmarks().isEmpty()) {
+				shared_ptr<Landmark> landmark = imageSource->getLandmarks().getLandmark();
+				adjustPatchSize(landmark->getHeight() / landmark->getWidth());
+			}
+		}
+		resumedFrames = frames;
+		start = steady_clock::now();
+	} else {
+		// initialization via ground truth
+		if (!imageSource->next())
+			throw runtime_error("there are no images in source");
+		frames = 1;
+		frame = imageSource->getImage();
+		if (!imageSource->getLandmarks().isEmpty()) {
+			shared_ptr<Landmark> landmark = imageSource->getLandmarks().getLandmark();
+			Rect_<float> floatBounds = landmark->getRect();
+			Rect bounds(
+					Point(cvRound(floatBounds.tl().x), cvRound(floatBounds.tl().y)),
+					Point(cvRound(floatBounds.br().x), cvRound(floatBounds.br().y)));
+			if (landmark->isVisible() && bounds.x >= 0 && bounds.y >= 0 && bounds.br().x < frame.cols && bounds.br().y < frame.rows) {
+				if (pyramidExtractor)
+					adjustPatchSize(landmark->getHeight() / landmark->getWidth());
+				steady_clock::time_point condensationStart = steady_clock::now();
+				optional<Rect> position = tracker->initialize(frame, bounds);
+				if (!position)
+					throw runtime_error("Adaptive tracker could not be initialized with " + lexical_cast<string>(bounds));
+				steady_clock::time_point condensationEnd = steady_clock::now();
+				condensationTime += duration_cast<milliseconds>(condensationEnd - condensationStart);
+				LandmarkCollection collection;
+				collection.insert(make_shared<RectLandmark>("target", *position));
+				landmarkSink->add(collection);
+				positions.push_back(position);
+			}
+		}
 	}
 
 	// adaptive tracking
@@ -552,6 +685,7 @@ std::pair<double, double> TrackingBenchmark::runTest(shared_ptr<LabeledImageSour
 		steady_clock::time_point condensationStart = steady_clock::now();
 		optional<Rect> position = tracker->process(frame);
 		steady_clock::time_point condensationEnd = steady_clock::now();
+		particleCountSum += resamplingSampler->getCount();
 		condensationTime += duration_cast<milliseconds>(condensationEnd - condensationStart);
 		LandmarkCollection collection;
 		if (position)
@@ -559,6 +693,13 @@ std::pair<double, double> TrackingBenchmark::runTest(shared_ptr<LabeledImageSour
 		else
 			collection.insert(make_shared<RectLandmark>("target"));
 		landmarkSink->add(collection);
+		positions.push_back(position);
+		if (checkpointInterval > 0 && frames % checkpointInterval == 0)
+			saveCheckpoint(checkpointFilename, frames, particleCountSum, positions);
+		if (interruptFrame > 0 && frames == interruptFrame) { // simulated interruption, the checkpoint is kept
+			tracker->reset();
+			return std::make_pair(0.0, 0.0);
+		}
 	}
 	if (hogModel) {
 		const std::unordered_map<size_t, cv::Rect>& positiveExamples = hogModel->getLearned();
@@ -572,39 +713,41 @@ std::pair<double, double> TrackingBenchmark::runTest(shared_ptr<LabeledImageSour
 			learnedSink->add(collection);
 		}
 	}
+	if (frames > 1)
+		averageParticleCount = particleCountSum / (frames - 1);
+	if (twoTierModel && twoTierModel->getCoarseEvaluationCount() > 0)
+		fineEvaluationShare = static_cast<double>(twoTierModel->getFineEvaluationCount()) / twoTierModel->getCoarseEvaluationCount();
 	tracker->reset();
+	if (!checkpointFilename.empty() && exists(path(checkpointFilename)))
+		remove(path(checkpointFilename));
 
+	// the speed only covers the frames that were processed since resuming
 	steady_clock::time_point end = steady_clock::now();
 	duration<double> time = duration_cast<milliseconds>(end - start);
-	double fps = frames / time.count();
-	double condensationFps = frames / condensationTime.count();
+	double fps = (frames - resumedFrames) / time.count();
+	double condensationFps = (frames - resumedFrames) / condensationTime.count();
 	return std::make_pair(fps, condensationFps);
 }
 
-double TrackingBenchmark::runTests(const path& resultsDirectory, size_t count, const ptree& testConfig, Logger& log) {
+void TrackingBenchmark::createTestSources(const ptree& testConfig, shared_ptr<ImageSource>& imageSource, shared_ptr<LandmarkSource>& landmarkSource,
+		shared_ptr<OrderedLandmarkSink>& landmarkSink, shared_ptr<OrderedLandmarkSink>& learnedSink, path& groundTruthFile, bool& bobot) const {
 	string testName = testConfig.get_value<string>();
 	optional<string> imageDirectory = testConfig.get_optional<string>("directory");
 	optional<string> videoFile = testConfig.get_optional<string>("file");
 	optional<string> simpleFile = testConfig.get_optional<string>("simple");
 	optional<string> bobotFile = testConfig.get_optional<string>("bobot");
-	shared_ptr<ImageSource> imageSource;
 	if (videoFile && !imageDirectory)
 		imageSource = make_shared<VideoImageSource>(*videoFile);
 	else if (!videoFile && imageDirectory)
 		imageSource = make_shared<DirectoryImageSource>(*imageDirectory);
 	else
 		throw invalid_argument("either a video file or a directory must be given for test " + testName);
-	bool bobot = false;
 	if (simpleFile && !bobotFile)
 		bobot = false;
 	else if (!simpleFile && bobotFile)
 		bobot = true;
 	else
 		throw invalid_argument("either a bobot or a simple ground truth file must be given for test " + testName);
-	shared_ptr<LandmarkSource> landmarkSource;
-	shared_ptr<OrderedLandmarkSink> landmarkSink;
-	shared_ptr<OrderedLandmarkSink> learnedSink;
-	path groundTruthFile;
 	if (bobot) {
 		shared_ptr<BobotLandmarkSource> bobotLandmarkSource = make_shared<BobotLandmarkSource>(*bobotFile, imageSource);
 		landmarkSource = bobotLandmarkSource;
@@ -617,6 +760,17 @@ double TrackingBenchmark::runTests(const path& resultsDirectory, size_t count, c
 		learnedSink = make_shared<SingleLandmarkSink>();
 		groundTruthFile = path(*simpleFile);
 	}
+}
+
+double TrackingBenchmark::runTests(const path& resultsDirectory, size_t count, const ptree& testConfig, Logger& log, size_t checkpointInterval) {
+	string testName = testConfig.get_value<string>();
+	shared_ptr<ImageSource> imageSource;
+	shared_ptr<LandmarkSource> landmarkSource;
+	shared_ptr<OrderedLandmarkSink> landmarkSink;
+	shared_ptr<OrderedLandmarkSink> learnedSink;
+	path groundTruthFile;
+	bool bobot = false;
+	createTestSources(testConfig, imageSource, landmarkSource, landmarkSink, learnedSink, groundTruthFile, bobot);
 	shared_ptr<LabeledImageSource> source = make_shared<OrderedLabeledImageSource>(imageSource, landmarkSource);
 
 	log.info("=======");
@@ -629,19 +783,26 @@ double TrackingBenchmark::runTests(const path& resultsDirectory, size_t count, c
 //	copy_file(groundTruthFile, testDirectory / "groundtruth");
 	size_t skipped = 0;
 	std::pair<double, double> fpsSum(0, 0);
+	double fineEvaluationShareSum = 0;
+	double averageParticleCountSum = 0;
 	for (size_t i = 0; i < count; ++i) {
 		source->reset();
 		string outputFilename = testDirectory.string() + "/run" + std::to_string(i);
 		string learnedFilename = testDirectory.string() + "/learned" + std::to_string(i);
-		if (exists(path(outputFilename))) {
+		string checkpointFilename = outputFilename + ".checkpoint";
+		if (exists(path(outputFilename)) && !exists(path(checkpointFilename))) {
 			skipped++;
 		} else {
+			if (exists(path(checkpointFilename)))
+				log.info("resuming run " + std::to_string(i) + " from its checkpoint");
 			landmarkSink->open(outputFilename);
 			learnedSink->open(learnedFilename);
 			try {
-				std::pair<double, double> fps = runTest(source, landmarkSink, learnedSink);
+				std::pair<double, double> fps = runTest(source, landmarkSink, learnedSink, checkpointFilename, checkpointInterval);
 				fpsSum.first += fps.first;
 				fpsSum.second += fps.second;
+				fineEvaluationShareSum += fineEvaluationShare;
+				averageParticleCountSum += averageParticleCount;
 			} catch (std::exception& exc) {
 				log.error(string("exception on run " + std::to_string(i) + ": ") + exc.what());
 			}
@@ -752,10 +913,100 @@ double TrackingBenchmark::runTests(const path& resultsDirectory, size_t count, c
 	timeOutput.setf(std::ios_base::fixed, std::ios_base::floatfield);
 	timeOutput.precision(1);
 	timeOutput << "speed: " << (fpsSum.first / count) << " fps, " << (fpsSum.second / count) << " fps (condensation only)";
+	if (resamplingSampler->getAdaptiveCount())
+		timeOutput << ", " << (averageParticleCountSum / count) << " particles on average";
+	if (twoTierModel)
+		timeOutput << ", " << (100 * fineEvaluationShareSum / count) << "% of the particles evaluated by the fine model";
 	log.info(timeOutput.str());
+	if (!arenaPyramids.empty()) { // compare the speed to a run without arena storage to see the effect on the time
+		size_t byteCount = 0;
+		size_t allocationCount = 0;
+		for (const shared_ptr<ImagePyramid>& arenaPyramid : arenaPyramids) {
+			byteCount += arenaPyramid->getArena().getByteCount();
+			allocationCount += arenaPyramid->getArena().getAllocationCount();
+		}
+		log.info("pyramid arena storage: " + std::to_string(arenaPyramids.size()) + " pyramids, "
+				+ std::to_string(byteCount / 1024) + " KiB reserved, " + std::to_string(allocationCount) + " allocations so far");
+	}
 	return 100 * averageOverlapMean;
 }
 
+bool TrackingBenchmark::verifyCheckpoint(const path& resultsDirectory, size_t checkpointFrame, const ptree& testConfig, Logger& log) {
+	string testName = testConfig.get_value<string>();
+	shared_ptr<ImageSource> imageSource;
+	shared_ptr<LandmarkSource> landmarkSource;
+	shared_ptr<OrderedLandmarkSink> landmarkSink;
+	shared_ptr<OrderedLandmarkSink> learnedSink;
+	path groundTruthFile;
+	bool bobot = false;
+	createTestSources(testConfig, imageSource, landmarkSource, landmarkSink, learnedSink, groundTruthFile, bobot);
+	shared_ptr<LabeledImageSource> source = make_shared<OrderedLabeledImageSource>(imageSource, landmarkSource);
+
+	log.info("=======");
+	log.info("Verifying the checkpoint of test " + testName + " at frame " + std::to_string(checkpointFrame));
+	path testDirectory(resultsDirectory.string() + "/" + testName);
+	if (!exists(testDirectory))
+		create_directory(testDirectory);
+	string uninterruptedFilename = testDirectory.string() + "/uninterrupted";
+	string resumedFilename = testDirectory.string() + "/resumed";
+	string checkpointFilename = resumedFilename + ".checkpoint";
+	if (exists(path(checkpointFilename)))
+		remove(path(checkpointFilename));
+
+	// uninterrupted run
+	source->reset();
+	landmarkSink->open(uninterruptedFilename);
+	learnedSink->open(testDirectory.string() + "/uninterrupted-learned");
+	runTest(source, landmarkSink, learnedSink);
+	landmarkSink->close();
+	learnedSink->close();
+
+	// run that saves a checkpoint and is interrupted right after it, followed by a run that loads the checkpoint
+	source->reset();
+	landmarkSink->open(resumedFilename);
+	learnedSink->open(testDirectory.string() + "/resumed-learned");
+	runTest(source, landmarkSink, learnedSink, checkpointFilename, checkpointFrame, checkpointFrame);
+	landmarkSink->close();
+	learnedSink->close();
+	if (!exists(path(checkpointFilename))) {
+		log.error("the sequence ended before frame " + std::to_string(checkpointFrame) + ", no checkpoint was written");
+		return false;
+	}
+	source->reset();
+	landmarkSink->open(resumedFilename);
+	learnedSink->open(testDirectory.string() + "/resumed-learned");
+	runTest(source, landmarkSink, learnedSink, checkpointFilename, checkpointFrame);
+	landmarkSink->close();
+	learnedSink->close();
+
+	// both trajectories are written one frame per line
+	ifstream uninterrupted(uninterruptedFilename);
+	ifstream resumed(resumedFilename);
+	string uninterruptedLine, resumedLine;
+	size_t line = 0;
+	size_t differences = 0;
+	optional<size_t> firstDifference;
+	while (true) {
+		bool hasUninterruptedLine = static_cast<bool>(std::getline(uninterrupted, uninterruptedLine));
+		bool hasResumedLine = static_cast<bool>(std::getline(resumed, resumedLine));
+		if (!hasUninterruptedLine && !hasResumedLine)
+			break;
+		if (hasUninterruptedLine != hasResumedLine || uninterruptedLine != resumedLine) {
+			differences++;
+			if (!firstDifference)
+				firstDifference = line;
+		}
+		line++;
+	}
+	if (differences > 0) {
+		log.error("the resumed trajectory differs from the uninterrupted one in " + std::to_string(differences)
+				+ " of " + std::to_string(line) + " lines, starting with line " + std::to_string(*firstDifference));
+		return false;
+	}
+	log.info("the resumed trajectory equals the uninterrupted one (" + std::to_string(line) + " lines)");
+	return true;
+}
+
 double TrackingBenchmark::computeOverlap(Rect_<float> a, Rect_<float> b) const {
 	double intersectionArea = (a & b).area();
 	double unionArea = a.area() + b.area() - intersectionArea;
@@ -776,9 +1027,17 @@ path getNonExistingFile(path basename) {
 }
 
 int main(int argc, char *argv[]) {
+	// optional verification mode that compares a run resumed from a checkpoint to an uninterrupted run
+	size_t verifyCheckpointFrame = 0;
+	if (argc > 2 && string(argv[1]) == "--verifycheckpoint") {
+		verifyCheckpointFrame = lexical_cast<size_t>(argv[2]);
+		argc -= 2;
+		argv += 2;
+	}
 	if (argc < 4) {
-		std::cout << "Usage: trackingBenchmarkApp directory testconfig algorithmconfig1 [algorithmconfig2 [algorithmconfig3 [...]]]" << std::endl;
+		std::cout << "Usage: trackingBenchmarkApp [--verifycheckpoint frame] directory testconfig algorithmconfig1 [algorithmconfig2 [algorithmconfig3 [...]]]" << std::endl;
 		std::cout << "where" << std::endl;
+		std::cout << " frame ... number of the frame after which a checkpoint is saved and loaded, the resulting trajectory is compared to an uninterrupted run" << std::endl;
 		std::cout << " directory ... directory to write the test results and logs into" << std::endl;
 		std::cout << " testconfig ... configuration file of the test sequences to run" << std::endl;
 		std::cout << " algorithmconfig# ... configuration file of an algorithm to test" << std::endl;
@@ -808,9 +1067,11 @@ int main(int argc, char *argv[]) {
 	// test algorithms
 	ptree testConfig, algorithmConfig;
 	read_info(argv[2], testConfig);
+	bool verificationFailed = false;
 	for (int i = 3; i < argc; ++i) {
 		read_info(argv[i], algorithmConfig);
 		size_t runcount = algorithmConfig.get<size_t>("runcount");
+		size_t checkpointInterval = algorithmConfig.get<size_t>("checkpointinterval", 0);
 		string name = algorithmConfig.get<string>("name");
 		path algorithmDirectory = directory / name;
 		if (!exists(algorithmDirectory))
@@ -825,12 +1086,29 @@ int main(int argc, char *argv[]) {
 		algorithmLog.info("Starting test runs for " + name);
 		TrackingBenchmark benchmark(algorithmConfig.get_child("tracking"));
 		auto iterators = testConfig.equal_range("test");
+		if (verifyCheckpointFrame > 0) {
+			size_t testCount = 0;
+			size_t failureCount = 0;
+			for (auto it = iterators.first; it != iterators.second; ++it) {
+				try {
+					if (!benchmark.verifyCheckpoint(algorithmDirectory, verifyCheckpointFrame, it->second, algorithmLog))
+						failureCount++;
+				} catch (std::exception& exc) {
+					algorithmLog.error(string("A wild exception appeared: ") + exc.what());
+					failureCount++;
+				}
+				testCount++;
+			}
+			appLog.info(name + ": checkpoint verification failed for " + std::to_string(failureCount) + " of " + std::to_string(testCount) + " tests");
+			verificationFailed = verificationFailed || failureCount > 0;
+			continue;
+		}
 		double scoreSum = 0;
 		size_t testCount = 0;
 		size_t exceptionCount = 0;
 		for (auto it = iterators.first; it != iterators.second; ++it) {
 			try {
-				scoreSum += benchmark.runTests(algorithmDirectory, runcount, it->second, algorithmLog);
+				scoreSum += benchmark.runTests(algorithmDirectory, runcount, it->second, algorithmLog, checkpointInterval);
 				testCount++;
 			} catch (std::exception& exc) {
 				algorithmLog.error(string("A wild exception appeared: ") + exc.what());
@@ -839,5 +1117,5 @@ int main(int argc, char *argv[]) {
 		}
 		appLog.info(name + ": " + std::to_string(scoreSum / testCount) + "%" + (exceptionCount > 0 ? " (" + std::to_string(exceptionCount) + " exceptions)" : ""));
 	}
-	return 0;
+	return verificationFailed ? 1 : 0;
 }
@@ -10,6 +10,7 @@
 
 #include "logging/Logger.hpp"
 #include "imageio/LabeledImageSource.hpp"
+#include "imageio/LandmarkSource.hpp"
 #include "imageio/OrderedLandmarkSink.hpp"
 #include "imageio/LandmarkCollection.hpp"
 #include "imageprocessing/FeatureExtractor.hpp"
@@ -25,6 +26,8 @@
 #include "condensation/OpticalFlowTransitionModel.hpp"
 #include "condensation/ResamplingSampler.hpp"
 #include "condensation/ExtendedHogBasedMeasurementModel.hpp"
+#include "condensation/PositionDependentMeasurementModel.hpp"
+#include "condensation/TwoTierMeasurementModel.hpp"
 #include "opencv2/highgui/highgui.hpp"
 #include "boost/property_tree/ptree.hpp"
 #include <memory>
@@ -50,12 +53,16 @@ public:
 
 	TrackingBenchmark(ptree& config);
 
-	double runTests(const path& resultsDirectory, size_t count, const ptree& config, logging::Logger& log);
-	std::pair<double, double> runTest(shared_ptr<LabeledImageSource> imageSource, shared_ptr<OrderedLandmarkSink> landmarkSink, shared_ptr<OrderedLandmarkSink> learnedSink);
+	double runTests(const path& resultsDirectory, size_t count, const ptree& config, logging::Logger& log, size_t checkpointInterval = 0);
+	std::pair<double, double> runTest(shared_ptr<LabeledImageSource> imageSource, shared_ptr<OrderedLandmarkSink> landmarkSink, shared_ptr<OrderedLandmarkSink> learnedSink,
+			const string& checkpointFilename = "", size_t checkpointInterval = 0, size_t interruptFrame = 0);
+	bool verifyCheckpoint(const path& resultsDirectory, size_t checkpointFrame, const ptree& config, logging::Logger& log);
 	double computeOverlap(cv::Rect_<float> a, cv::Rect_<float> b) const;
 
 private:
 
+	void createTestSources(const ptree& testConfig, shared_ptr<ImageSource>& imageSource, shared_ptr<LandmarkSource>& landmarkSource,
+			shared_ptr<OrderedLandmarkSink>& landmarkSink, shared_ptr<OrderedLandmarkSink>& learnedSink, path& groundTruthFile, bool& bobot) const;
 	shared_ptr<DirectPyramidFeatureExtractor> createPyramidExtractor(
 			ptree& config, shared_ptr<ImagePyramid> pyramid, bool needsLayerFilters);
 	shared_ptr<FeatureExtractor> createFeatureExtractor(shared_ptr<ImagePyramid> pyramid, ptree& config);
@@ -70,11 +77,22 @@ private:
 	shared_ptr<TrainableProbabilisticClassifier> createTrainableProbabilisticClassifier(ptree& config);
 	shared_ptr<TrainableProbabilisticClassifier> createTrainableProbabilisticSvm(
 			shared_ptr<TrainableSvmClassifier> trainableSvm, ptree& config);
+	shared_ptr<PositionDependentMeasurementModel> createPositionDependentModel(
+			shared_ptr<ImagePyramid> pyramid, shared_ptr<TrainableProbabilisticClassifier> classifier, ptree& config);
+	void enableArenaStorage(shared_ptr<ImagePyramid> pyramid);
 	void initTracking(ptree& config);
+	void adjustPatchSize(float aspectRatio);
+	void saveCheckpoint(const string& filename, size_t frames, double particleCountSum, const std::vector<optional<cv::Rect>>& positions) const;
+	void loadCheckpoint(const string& filename, size_t& frames, double& particleCountSum, std::vector<optional<cv::Rect>>& positions);
 
 	shared_ptr<DirectPyramidFeatureExtractor> pyramidExtractor;
+	shared_ptr<ResamplingSampler> resamplingSampler;
 	unique_ptr<AdaptiveCondensationTracker> tracker;
 	shared_ptr<ExtendedHogBasedMeasurementModel> hogModel;
+	shared_ptr<TwoTierMeasurementModel> twoTierModel;
+	std::vector<shared_ptr<ImagePyramid>> arenaPyramids;
+	double fineEvaluationShare;
+	double averageParticleCount;
 };
 
 #endif /* TRACKINGBENCHMARK_HPP_ */
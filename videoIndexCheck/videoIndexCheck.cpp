@@ -0,0 +1,164 @@
+/*
+ * videoIndexCheck.cpp
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+
+#ifdef WIN32
+	#define BOOST_ALL_DYN_LINK	// Link against the dynamic boost lib. Seems to be necessary because we use /MD, i.e. link to the dynamic CRT.
+	#define BOOST_ALL_NO_LIB	// Don't use the automatic library linking by boost with VS2010 (#pragma ...). Instead, we specify everything in cmake.
+#endif
+#include "boost/program_options.hpp"
+#include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+
+#include "imageio/VideoIndex.hpp"
+#include "imageio/IndexedVideoImageSource.hpp"
+
+#include "logging/LoggerFactory.hpp"
+
+using namespace imageio;
+namespace po = boost::program_options;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+using std::shared_ptr;
+using std::make_shared;
+using boost::lexical_cast;
+using cv::Mat;
+using logging::Logger;
+using logging::LoggerFactory;
+using logging::LogLevel;
+
+/**
+ * Checks the random access of IndexedVideoImageSource: the frames that are reached by seeking are compared to the
+ * frames of a plain sequential decoding of the video. Checked are the seek points, the frames right before and after
+ * them and a number of random frames, all visited in random order by a single image source (so that seeking forward
+ * and backward from arbitrary decoder positions is covered).
+ */
+int main(int argc, char *argv[])
+{
+	string verboseLevelConsole;
+	string video;
+	size_t interval;
+	int randomFrameCount;
+	unsigned int seed;
+
+	try {
+		po::options_description desc("Allowed options");
+		desc.add_options()
+			("help,h",
+				"produce help message")
+			("verbose,v", po::value<string>(&verboseLevelConsole)->implicit_value("DEBUG")->default_value("INFO","show messages with INFO loglevel or below."),
+				  "specify the verbosity of the console output: PANIC, ERROR, WARN, INFO, DEBUG or TRACE")
+			("video,i", po::value<string>(&video)->required(),
+				"video file to check")
+			("interval", po::value<size_t>(&interval)->default_value(100),
+				"minimum number of frames between two seek points (only used if the index has to be built)")
+			("random,r", po::value<int>(&randomFrameCount)->default_value(100),
+				"number of random frames to check in addition to the frames around the seek points")
+			("seed", po::value<unsigned int>(&seed)->default_value(0),
+				"seed of the random number generator that chooses the frames and their order")
+		;
+
+		po::variables_map vm;
+		po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+		if (vm.count("help")) {
+			cout << "Usage: videoIndexCheck [options]\n";
+			cout << desc;
+			return EXIT_SUCCESS;
+		}
+		po::notify(vm);
+	}
+	catch (po::error& e) {
+		cout << "Error while parsing command-line arguments: " << e.what() << endl;
+		cout << "Use --help to display a list of options." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	LogLevel logLevel;
+	if (boost::iequals(verboseLevelConsole, "PANIC")) logLevel = LogLevel::Panic;
+	else if (boost::iequals(verboseLevelConsole, "ERROR")) logLevel = LogLevel::Error;
+	else if (boost::iequals(verboseLevelConsole, "WARN")) logLevel = LogLevel::Warn;
+	else if (boost::iequals(verboseLevelConsole, "INFO")) logLevel = LogLevel::Info;
+	else if (boost::iequals(verboseLevelConsole, "DEBUG")) logLevel = LogLevel::Debug;
+	else if (boost::iequals(verboseLevelConsole, "TRACE")) logLevel = LogLevel::Trace;
+	else {
+		cout << "Error: Invalid log level." << endl;
+		return EXIT_SUCCESS;
+	}
+
+	Loggers->getLogger("imageio").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Loggers->getLogger("videoIndexCheck").addAppender(make_shared<logging::ConsoleAppender>(logLevel));
+	Logger appLogger = Loggers->getLogger("videoIndexCheck");
+
+	try {
+		shared_ptr<const VideoIndex> index = make_shared<VideoIndex>(video, interval);
+		appLogger.info("Index of " + lexical_cast<string>(index->getFrameCount()) + " frames with "
+				+ lexical_cast<string>(index->getSeekPointCount()) + " seek points");
+
+		// reference: signatures of the sequentially decoded frames
+		vector<uint64_t> signatures;
+		cv::VideoCapture capture(video);
+		if (!capture.isOpened()) {
+			appLogger.error("Could not open video file '" + video + "'");
+			return EXIT_FAILURE;
+		}
+		Mat frame;
+		while (capture.read(frame))
+			signatures.push_back(VideoIndex::computeSignature(frame));
+		if (signatures.size() != index->getFrameCount()) {
+			appLogger.error("Sequential decoding resulted in " + lexical_cast<string>(signatures.size())
+					+ " frames, but the index expects " + lexical_cast<string>(index->getFrameCount()));
+			return EXIT_FAILURE;
+		}
+
+		vector<size_t> frames;
+		for (size_t i = 0; i < index->getSeekPointCount(); ++i) {
+			size_t seekPointFrame = index->getSeekPoint(i).frame;
+			if (seekPointFrame > 0)
+				frames.push_back(seekPointFrame - 1);
+			frames.push_back(seekPointFrame);
+			if (seekPointFrame + 1 < signatures.size())
+				frames.push_back(seekPointFrame + 1);
+		}
+		cv::RNG rng(seed);
+		for (int i = 0; i < randomFrameCount; ++i)
+			frames.push_back(static_cast<size_t>(rng.uniform(0, static_cast<int>(signatures.size()))));
+		for (size_t i = frames.size(); i > 1; --i)
+			std::swap(frames[i - 1], frames[static_cast<size_t>(rng.uniform(0, static_cast<int>(i)))]);
+
+		IndexedVideoImageSource source(index);
+		int mismatches = 0;
+		for (size_t target : frames) {
+			source.seek(target);
+			if (!source.next()) {
+				appLogger.error("Could not get frame " + lexical_cast<string>(target) + " by seeking");
+				++mismatches;
+			} else if (VideoIndex::computeSignature(source.getImage()) != signatures[target]) {
+				appLogger.error("Frame " + lexical_cast<string>(target) + " differs from the sequentially decoded one");
+				++mismatches;
+			}
+		}
+		appLogger.info("Checked " + lexical_cast<string>(frames.size()) + " seeks: " + lexical_cast<string>(mismatches) + " mismatches");
+		if (mismatches > 0)
+			return EXIT_FAILURE;
+	}
+	catch (const std::exception& error) {
+		appLogger.error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}